@@ -0,0 +1,20 @@
+#ifdef CPP_ENGINE_BENCH
+
+#include "Systems/Execution/Engine.h"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+// The engine library refers to these (normally defined by the game's Main.cpp), nothing benchmarked here touches them
+std::unique_ptr<Engine::IEngine> g_Engine;
+
+void QuitDatAss()
+{
+}
+
+// Compare runs with e.g. `cpp_engine_bench --benchmark_out=before.json --benchmark_out_format=json`
+// and Google Benchmark's tools/compare.py benchmarks before.json after.json
+BENCHMARK_MAIN();
+
+#endif // CPP_ENGINE_BENCH
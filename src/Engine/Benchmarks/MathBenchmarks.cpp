@@ -0,0 +1,132 @@
+#ifdef CPP_ENGINE_BENCH
+
+#include "Math/matrix.h"
+#include "Math/quat4.h"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace
+{
+	constexpr size_t BatchSize = 1024;
+
+	std::vector<Matrixy4x4> MakeMatrices()
+	{
+		std::vector<Matrixy4x4> out;
+		out.reserve(BatchSize);
+		for (size_t i = 0; i < BatchSize; ++i)
+		{
+			float f = (float)i;
+			out.push_back(Matrixy4x4::MultiplyE(Matrixy4x4::RotationAxisR({ 0.f, 1.f, 0.f }, f * 0.01f), Matrixy4x4::Translate(f, f * 0.5f, -f)));
+		}
+		return out;
+	}
+
+	std::vector<floaty3> MakeDirections()
+	{
+		std::vector<floaty3> out;
+		out.reserve(BatchSize);
+		for (size_t i = 0; i < BatchSize; ++i)
+		{
+			float f = (float)i;
+			out.push_back(floaty3{ f, 1.f - f * 0.5f, f * 0.25f });
+		}
+		return out;
+	}
+}
+
+// Every chunk, light and shadow cascade multiplies its world matrix by a view projection each frame
+static void BM_MatrixMultiply(benchmark::State& state)
+{
+	auto matrices = MakeMatrices();
+	auto viewProj = Matrixy4x4::Multiply(Matrixy4x4::PerspectiveFovD(70.f, 16.f / 9.f, 0.1f, 500.f), Matrixy4x4::Translate(0.f, -10.f, 0.f));
+	std::vector<Matrixy4x4> out(BatchSize);
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < BatchSize; ++i)
+			out[i] = Matrixy4x4::Multiply(matrices[i], viewProj);
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * BatchSize);
+}
+BENCHMARK(BM_MatrixMultiply);
+
+// The same work as BM_MatrixMultiply through the batch API
+static void BM_MatrixMultiplyBatch(benchmark::State& state)
+{
+	auto matrices = MakeMatrices();
+	auto viewProj = Matrixy4x4::Multiply(Matrixy4x4::PerspectiveFovD(70.f, 16.f / 9.f, 0.1f, 500.f), Matrixy4x4::Translate(0.f, -10.f, 0.f));
+	std::vector<Matrixy4x4> viewProjs(BatchSize, viewProj);
+	std::vector<Matrixy4x4> out(BatchSize);
+
+	for (auto _ : state)
+	{
+		Matrixy4x4::MultiplyBatch(matrices.data(), viewProjs.data(), out.data(), BatchSize);
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * BatchSize);
+}
+BENCHMARK(BM_MatrixMultiplyBatch);
+
+// Transforming points one at a time (argument 0) or through TransformBatch (argument 1)
+static void BM_TransformPoints(benchmark::State& state)
+{
+	auto points = MakeDirections();
+	auto mat = MakeMatrices()[17];
+	std::vector<floaty3> out(BatchSize);
+	bool batch = state.range(0) != 0;
+
+	for (auto _ : state)
+	{
+		if (batch)
+			Matrixy4x4::TransformBatch(mat, points.data(), out.data(), BatchSize);
+		else
+			for (size_t i = 0; i < BatchSize; ++i)
+				out[i] = mat.Transform(points[i]);
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * BatchSize);
+}
+BENCHMARK(BM_TransformPoints)->ArgName("Batch")->Arg(0)->Arg(1);
+
+// Rotating block meshes and directions (see VoxelStore::UpdateRotatedMeshes and the voxel player)
+static void BM_QuatRotate(benchmark::State& state)
+{
+	auto directions = MakeDirections();
+	quat4 rotation = btQuaternion(btVector3(0.f, 1.f, 0.f), 0.3f) * btQuaternion(btVector3(1.f, 0.f, 0.f), 1.1f);
+	std::vector<floaty3> out(BatchSize);
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < BatchSize; ++i)
+			out[i] = rotation.rotate(directions[i]);
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * BatchSize);
+}
+BENCHMARK(BM_QuatRotate);
+
+// The same work as BM_QuatRotate through the batch API
+static void BM_QuatRotateBatch(benchmark::State& state)
+{
+	auto directions = MakeDirections();
+	quat4 rotation = btQuaternion(btVector3(0.f, 1.f, 0.f), 0.3f) * btQuaternion(btVector3(1.f, 0.f, 0.f), 1.1f);
+	std::vector<floaty3> out(BatchSize);
+
+	for (auto _ : state)
+	{
+		rotation.rotate(directions.data(), out.data(), BatchSize);
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * BatchSize);
+}
+BENCHMARK(BM_QuatRotateBatch);
+
+#endif // CPP_ENGINE_BENCH
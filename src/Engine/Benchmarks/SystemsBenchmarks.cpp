@@ -0,0 +1,118 @@
+#ifdef CPP_ENGINE_BENCH
+
+#include "Systems/Threading/ThreadedQueue.h"
+#include "Systems/Threading/BoundedQueue.h"
+#include "Systems/Events/Events.h"
+#include "Systems/Input/Input.h"
+#include "Drawing/Particles.h"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+// Every thread pushes then pops one value per iteration, all on one queue (like the texture loader's queue with the main thread and loaders on both ends)
+static void BM_ThreadedQueuePushPop(benchmark::State& state)
+{
+	static Threading::ThreadedQueue<uint64_t> queue;
+
+	uint64_t value = 0;
+	for (auto _ : state)
+	{
+		queue.push(value++);
+		// Every thread pushes before it pops so there is always something to take, this never waits
+		benchmark::DoNotOptimize(queue.pop());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ThreadedQueuePushPop)->ThreadRange(1, 8)->UseRealTime();
+
+// The same as BM_ThreadedQueuePushPop on the lock-free queue the chunk pipeline uses
+static void BM_BoundedQueuePushPop(benchmark::State& state)
+{
+	static Threading::BoundedQueue<uint64_t> queue{ 1024 };
+
+	uint64_t value = 0;
+	for (auto _ : state)
+	{
+		queue.push(value++);
+		uint64_t out;
+		queue.pop(out);
+		benchmark::DoNotOptimize(out);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BoundedQueuePushPop)->ThreadRange(1, 8)->UseRealTime();
+
+// Pushing then popping batches of 16 per iteration with the bulk calls
+static void BM_BoundedQueueBulk(benchmark::State& state)
+{
+	static Threading::BoundedQueue<uint64_t> queue{ 1024 };
+
+	std::array<uint64_t, 16> in{}, out{};
+	for (auto _ : state)
+	{
+		size_t pushed = 0;
+		while (pushed < in.size())
+			pushed += queue.try_push_bulk(in.data() + pushed, in.size() - pushed);
+		size_t popped = 0;
+		while (popped < out.size())
+			popped += queue.try_pop_bulk(out.data() + popped, out.size() - popped);
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_BoundedQueueBulk)->ThreadRange(1, 8)->UseRealTime();
+
+// Sending an input event to a number of listeners, the argument is how many are listening
+static void BM_EventManagerSend(benchmark::State& state)
+{
+	Events::EventManager manager;
+	size_t received = 0;
+	std::vector<std::unique_ptr<Events::ILambdaListener>> listeners;
+	for (int64_t i = 0; i < state.range(0); ++i)
+	{
+		listeners.emplace_back(std::make_unique<Events::ILambdaListener>(std::vector<Events::Event>{ Events::Event::MouseMoveEvent }, [&received](Events::IEvent*) { ++received; return false; }));
+		manager.Add(listeners.back().get());
+	}
+
+	int x = 0;
+	for (auto _ : state)
+	{
+		Event::MouseMove move{ x++, 0 };
+		benchmark::DoNotOptimize(manager.Send(&move));
+	}
+	benchmark::DoNotOptimize(received);
+	state.SetItemsProcessed(state.iterations());
+
+	// Listeners remove themselves from the manager they were added to
+	listeners.clear();
+}
+BENCHMARK(BM_EventManagerSend)->ArgName("Listeners")->Arg(1)->Arg(8)->Arg(64);
+
+// Moving and ageing a pool of velocity particles, the argument is how many particles there are (none expire)
+static void BM_VelocityParticlePoolUpdate(benchmark::State& state)
+{
+	auto count = (size_t)state.range(0);
+	Particles::VelocityParticlePool pool{ nullptr, count };
+
+	std::vector<std::pair<Particles::BasicParticle, Particles::VelocityParticleData>> particles;
+	particles.reserve(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		float f = (float)i;
+		particles.emplace_back(Particles::BasicParticle{ { f, 0.f, -f }, { 1.f, 1.f, 1.f, 1.f } }, Particles::VelocityParticleData{ { 0.f, 1.f + f * 0.001f, 0.f }, 0.f, 1e30f });
+	}
+	pool.AddParticles(std::move(particles));
+
+	for (auto _ : state)
+	{
+		pool.Update(1.f / 60.f);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_VelocityParticlePoolUpdate)->ArgName("Particles")->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
+
+#endif // CPP_ENGINE_BENCH
@@ -0,0 +1,200 @@
+#ifdef CPP_ENGINE_BENCH
+
+#include "Game/VoxelStuff/VoxelChunk.h"
+#include "Drawing/VoxelStore.h"
+#include "Helpers/MeshHelper.h"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cmath>
+#include <memory>
+
+namespace
+{
+	// The shapes of chunk the meshing benchmarks are run on
+	enum class BenchWorld
+	{
+		Empty,
+		Solid,
+		Noise,   // Rolling terrain, a surface running through the middle of the chunk
+		Parkour, // Small floating platforms, lots of exposed faces per block
+	};
+
+	// Integer hash so the noise is the same on every machine and every run
+	uint32_t Hash(int64_t x, int64_t z)
+	{
+		uint64_t h = (uint64_t)x * 0x9E3779B97F4A7C15ull ^ (uint64_t)z * 0xC2B2AE3D27D4EB4Full;
+		h ^= h >> 29;
+		h *= 0xBF58476D1CE4E5B9ull;
+		h ^= h >> 32;
+		return (uint32_t)h;
+	}
+
+	float ValueNoise(float x, float z)
+	{
+		auto x0 = (int64_t)std::floor(x), z0 = (int64_t)std::floor(z);
+		float tx = x - (float)x0, tz = z - (float)z0;
+		tx = tx * tx * (3.f - 2.f * tx);
+		tz = tz * tz * (3.f - 2.f * tz);
+		auto corner = [](int64_t cx, int64_t cz) { return (float)(Hash(cx, cz) & 0xFFFF) / 65535.f; };
+		float a = corner(x0, z0) + (corner(x0 + 1, z0) - corner(x0, z0)) * tx;
+		float b = corner(x0, z0 + 1) + (corner(x0 + 1, z0 + 1) - corner(x0, z0 + 1)) * tx;
+		return a + (b - a) * tz;
+	}
+
+	bool IsSolid(BenchWorld world, int64_t x, int64_t y, int64_t z)
+	{
+		switch (world)
+		{
+		default:
+		case BenchWorld::Empty:
+			return false;
+		case BenchWorld::Solid:
+			return true;
+		case BenchWorld::Noise:
+		{
+			float height = 16.f + 12.f * ValueNoise((float)x / 16.f, (float)z / 16.f) + 4.f * ValueNoise((float)x / 4.f, (float)z / 4.f);
+			return (float)y < height;
+		}
+		case BenchWorld::Parkour:
+		{
+			// A 3x1x3 platform in every 6x6 column, at a hashed height
+			auto cellX = (int64_t)std::floor((double)x / 6.0), cellZ = (int64_t)std::floor((double)z / 6.0);
+			auto localX = x - cellX * 6, localZ = z - cellZ * 6;
+			auto height = (int64_t)(8 + Hash(cellX, cellZ) % 32);
+			return localX < 3 && localZ < 3 && y == height;
+		}
+		}
+	}
+
+	// The store is built without any block files or atlases, with a single full cube block for the solid parts
+	Voxel::CubeID GetBenchBlock()
+	{
+		static const Voxel::CubeID id = []()
+		{
+			Voxel::VoxelStore::InitializeVoxelStore("", "", "", "");
+			auto& store = Voxel::VoxelStore::GetMutable();
+
+			auto desc = Voxel::GetEmptyBlockDesc();
+			desc.Name = "bench-stone";
+			desc.MeshName = Voxel::VoxelStore::DefaultCubeMeshName;
+			desc.FaceOpaqueness.fill(Voxel::FaceClosedNess::CLOSED_FACE);
+			store.LoadBlock(desc);
+			return (Voxel::CubeID)store.GetIDFor("bench-stone");
+		}();
+		return id;
+	}
+
+	Voxel::SerialBlock GetBlockAt(BenchWorld world, Voxel::BlockCoord coord)
+	{
+		auto x = coord.Chunk.X * Voxel::Chunk_Size + coord.Block.x;
+		auto y = coord.Chunk.Y * Voxel::Chunk_Height + coord.Block.y;
+		auto z = coord.Chunk.Z * Voxel::Chunk_Size + coord.Block.z;
+		if (!IsSolid(world, x, y, z))
+			return Voxel::VoxelStore::EmptyBlockData;
+
+		auto block = Voxel::VoxelStore::EmptyBlockData;
+		block.ID = GetBenchBlock();
+		return block;
+	}
+
+	std::unique_ptr<Voxel::ChunkData> MakeChunk(BenchWorld world, Voxel::ChunkCoord coord)
+	{
+		auto data = std::make_unique<Voxel::ChunkData>();
+		for (uint8_t x = 0; x < Voxel::Chunk_Size; ++x)
+			for (uint8_t y = 0; y < Voxel::Chunk_Height; ++y)
+				for (uint8_t z = 0; z < Voxel::Chunk_Size; ++z)
+					(*data)[x][y][z] = GetBlockAt(world, Voxel::BlockCoord{ coord, Voxel::ChunkBlockCoord{ x, y, z } });
+		return data;
+	}
+}
+
+// The whole chunk pipeline a loader thread runs per chunk: face culling, lighting, meshing, welding and the physics BVH
+static void BM_GenerateChunkMesh(benchmark::State& state)
+{
+	auto world = (BenchWorld)state.range(0);
+	constexpr Voxel::ChunkCoord coord{ 0, 0, 0 };
+	auto data = MakeChunk(world, coord);
+
+	// Neighbours are loaded but unlit, as the first chunks around the player would be
+	std::array<std::unique_ptr<Voxel::ChunkData>, 6> neighbourData;
+	Voxel::ChunkNeighbourhood around;
+	for (auto& face : Voxel::BlockFacesArray)
+	{
+		auto dir = Voxel::BlockFaceHelper::GetDirectionI(face);
+		neighbourData[(size_t)face] = MakeChunk(world, Voxel::ChunkCoord{ coord.X + dir.x, coord.Y + dir.y, coord.Z + dir.z });
+		around.Blocks[(size_t)face] = neighbourData[(size_t)face].get();
+	}
+
+	size_t indices = 0;
+	for (auto _ : state)
+	{
+		auto loaded = Voxel::GenerateChunkMesh(*data, coord, around);
+		indices = loaded->Mesh.Indices.size();
+		benchmark::DoNotOptimize(loaded.get());
+	}
+	state.counters["Indices"] = (double)indices;
+}
+BENCHMARK(BM_GenerateChunkMesh)
+	->ArgName("World")
+	->Arg((int64_t)BenchWorld::Empty)
+	->Arg((int64_t)BenchWorld::Solid)
+	->Arg((int64_t)BenchWorld::Noise)
+	->Arg((int64_t)BenchWorld::Parkour)
+	->Unit(benchmark::kMillisecond);
+
+// Welding a cube of blocks, the argument is the cube's side length (its surface grows with the square)
+static void BM_DeDuplicateVertices(benchmark::State& state)
+{
+	auto side = (uint8_t)state.range(0);
+	auto data = std::make_unique<Voxel::ChunkData>();
+	auto stone = Voxel::VoxelStore::EmptyBlockData;
+	stone.ID = GetBenchBlock();
+	for (uint8_t x = 0; x < side; ++x)
+		for (uint8_t y = 0; y < side; ++y)
+			for (uint8_t z = 0; z < side; ++z)
+				(*data)[x][y][z] = stone;
+
+	auto loaded = Voxel::GenerateChunkMesh(*data, Voxel::ChunkCoord{ 0, 0, 0 }, Voxel::ChunkNeighbourhood{});
+	auto& mesh = loaded->Mesh;
+
+	for (auto _ : state)
+	{
+		auto welded = MeshHelp::DeDuplicateVertices(Drawing::MeshView<Voxel::VoxelVertex>(mesh));
+		benchmark::DoNotOptimize(welded.Indices.data());
+	}
+	state.counters["Vertices"] = (double)mesh.vertexData.NumVertices();
+}
+BENCHMARK(BM_DeDuplicateVertices)->ArgName("Side")->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMicrosecond);
+
+// Chunk loaders hand back sparse maps, which are expanded into a full ChunkData before meshing
+static void BM_ConvertMapToData(benchmark::State& state)
+{
+	auto world = (BenchWorld)state.range(0);
+	constexpr Voxel::ChunkCoord coord{ 0, 0, 0 };
+	Voxel::RawChunkDataMap map;
+	for (uint8_t x = 0; x < Voxel::Chunk_Size; ++x)
+		for (uint8_t y = 0; y < Voxel::Chunk_Height; ++y)
+			for (uint8_t z = 0; z < Voxel::Chunk_Size; ++z)
+			{
+				auto block = GetBlockAt(world, Voxel::BlockCoord{ coord, Voxel::ChunkBlockCoord{ x, y, z } });
+				if (block.ID != Voxel::VoxelStore::EmptyBlockData.ID)
+					map.emplace(Voxel::ChunkBlockCoord{ x, y, z }, block);
+			}
+
+	for (auto _ : state)
+	{
+		auto data = Voxel::ConvertMapToData(map);
+		benchmark::DoNotOptimize(data.get());
+	}
+	state.counters["Blocks"] = (double)map.size();
+}
+BENCHMARK(BM_ConvertMapToData)
+	->ArgName("World")
+	->Arg((int64_t)BenchWorld::Noise)
+	->Arg((int64_t)BenchWorld::Parkour)
+	->Arg((int64_t)BenchWorld::Solid)
+	->Unit(benchmark::kMicrosecond);
+
+#endif // CPP_ENGINE_BENCH
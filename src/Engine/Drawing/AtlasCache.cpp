@@ -0,0 +1,293 @@
+#include "AtlasCache.h"
+
+#include "Drawing/VoxelStore.h"
+#include "Helpers/FileHelper.h"
+
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace Voxel
+{
+	namespace AtlasCache
+	{
+		namespace
+		{
+			constexpr char Magic[8] = { 'C', 'P', 'P', 'A', 'T', 'L', 'A', 'S' };
+			constexpr size_t ImageCount = AtlasTypes.size();
+
+			struct Header
+			{
+				char Magic[8];
+				uint32_t Version;
+				uint32_t Width;
+				uint32_t Height;
+				uint32_t Layers;
+				uint64_t Key;
+				uint32_t FaceCount;
+				uint32_t Reserved;
+			};
+
+			// Reads sequentially from a mapped file, failing (rather than reading past the end) on truncated files
+			struct Reader
+			{
+				const unsigned char* Data;
+				size_t Size;
+				size_t Offset = 0;
+
+				inline bool Read(void* out, size_t count)
+				{
+					if (count > Size - Offset)
+						return false;
+					std::memcpy(out, Data + Offset, count);
+					Offset += count;
+					return true;
+				}
+
+				inline bool ReadString(std::string& out)
+				{
+					uint32_t length;
+					if (!Read(&length, sizeof(length)) || length > Size - Offset)
+						return false;
+					out.assign((const char*)Data + Offset, length);
+					Offset += length;
+					return true;
+				}
+
+				inline const unsigned char* Skip(size_t count)
+				{
+					if (count > Size - Offset)
+						return nullptr;
+					auto* at = Data + Offset;
+					Offset += count;
+					return at;
+				}
+			};
+
+			void WriteString(std::ofstream& out, const std::string& str)
+			{
+				auto length = (uint32_t)str.size();
+				out.write((const char*)&length, sizeof(length));
+				out.write(str.data(), length);
+			}
+
+			std::array<std::string*, 5> GetNames(TextureNames& names)
+			{
+				return { &names.DiffuseName, &names.SpecularName, &names.EmissiveName, &names.NormalName, &names.BumpName };
+			}
+
+			std::array<const std::string*, 5> GetNames(const TextureNames& names)
+			{
+				return { &names.DiffuseName, &names.SpecularName, &names.EmissiveName, &names.NormalName, &names.BumpName };
+			}
+
+			std::array<const std::shared_ptr<Drawing::Image2DArray>*, ImageCount> GetImages(const StitchedAtlasSet& set)
+			{
+				return { &set.DiffuseImage, &set.SpecularImage, &set.EmissiveImage, &set.NormalImage, &set.BumpImage };
+			}
+
+			// Reads the header, failing if it isn't from this version or doesn't match key
+			bool ReadHeader(Reader& reader, const std::string& path, uint64_t key, Header& header)
+			{
+				if (!reader.Read(&header, sizeof(header)))
+					return false;
+
+				if (std::memcmp(header.Magic, Magic, sizeof(Magic)) != 0 || header.Version != FormatVersion)
+				{
+					DINFO("Ignoring atlas cache '" + path + "' from a different version");
+					return false;
+				}
+				if (header.Key != key)
+				{
+					DINFO("Atlas cache '" + path + "' is out of date");
+					return false;
+				}
+				return true;
+			}
+
+			// Reads every layer of the next image in the file into image, which must already have the header's dimensions
+			bool ReadImage(Reader& reader, const std::string& path, const Header& header, Drawing::Image2DArray& image)
+			{
+				auto layerSize = (size_t)header.Width * (size_t)header.Height * 4;
+				for (uint32_t layer = 0; layer < header.Layers; ++layer)
+				{
+					auto* pixels = reader.Skip(layerSize);
+					if (!pixels)
+					{
+						DWARNING("Atlas cache '" + path + "' is truncated");
+						return false;
+					}
+					image.SetLayerPixels(pixels, (int)layer);
+				}
+				return true;
+			}
+		}
+
+		uint64_t HashBytes(const void* data, size_t size, uint64_t seed)
+		{
+			// FNV-1a, but mixing in 8 bytes at a time so hashing whole images stays cheap
+			constexpr uint64_t Prime = 0x100000001b3ull;
+			auto* bytes = (const unsigned char*)data;
+			uint64_t hash = seed ^ 0xcbf29ce484222325ull;
+
+			size_t i = 0;
+			for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+			{
+				uint64_t word;
+				std::memcpy(&word, bytes + i, sizeof(word));
+				hash = (hash ^ word) * Prime;
+				hash ^= hash >> 32;
+			}
+			for (; i < size; ++i)
+				hash = (hash ^ bytes[i]) * Prime;
+
+			return (hash ^ (uint64_t)size) * Prime;
+		}
+
+		uint64_t HashString(const std::string& str, uint64_t seed)
+		{
+			return HashBytes(str.data(), str.size(), seed);
+		}
+
+		uint64_t HashFile(const std::string& path, uint64_t seed)
+		{
+			FileHelper::MappedFile file{ path };
+			if (!file)
+				return HashString(path, seed);
+			return HashBytes(file.Data(), file.Size(), seed);
+		}
+
+		std::string GetCachePath(const std::string& directory, const std::string& atlasName)
+		{
+			return (std::filesystem::path(directory) / (atlasName + ".atlascache")).string();
+		}
+
+		bool TryLoad(const std::string& path, uint64_t key, StitchedAtlasSet& out)
+		{
+			FileHelper::MappedFile file{ path };
+			if (!file)
+				return false;
+
+			Reader reader{ file.Data(), file.Size() };
+			Header header;
+			if (!ReadHeader(reader, path, key, header))
+				return false;
+
+			StitchedAtlasSet set;
+			set.AtlasName = out.AtlasName;
+			for (uint32_t i = 0; i < header.FaceCount; ++i)
+			{
+				TextureNames names;
+				for (auto* name : GetNames(names))
+				{
+					if (!reader.ReadString(*name))
+						return false;
+				}
+				std::array<float, 5> face;
+				if (!reader.Read(face.data(), sizeof(face)))
+					return false;
+				set.FaceTextureLookup[std::move(names)] = face;
+			}
+
+			std::array<std::shared_ptr<Drawing::Image2DArray>*, ImageCount> images = { &set.DiffuseImage, &set.SpecularImage, &set.EmissiveImage, &set.NormalImage, &set.BumpImage };
+			for (auto* image : images)
+			{
+				*image = std::make_shared<Drawing::Image2DArray>((GLsizei)header.Width, (GLsizei)header.Height, (size_t)header.Layers);
+				if (!ReadImage(reader, path, header, **image))
+					return false;
+			}
+
+			out = std::move(set);
+			DINFO("Loaded atlas '" + out.AtlasName + "' from cache '" + path + "'");
+			return true;
+		}
+
+		bool Save(const std::string& path, uint64_t key, const StitchedAtlasSet& set)
+		{
+			auto images = GetImages(set);
+			auto& first = *images[0];
+			if (!first)
+				return false;
+
+			Header header;
+			std::memcpy(header.Magic, Magic, sizeof(Magic));
+			header.Version = FormatVersion;
+			header.Width = (uint32_t)first->GetWidth();
+			header.Height = (uint32_t)first->GetHeight();
+			header.Layers = (uint32_t)first->GetLayerCount();
+			header.Key = key;
+			header.FaceCount = (uint32_t)set.FaceTextureLookup.size();
+			header.Reserved = 0;
+
+			std::vector<unsigned char> blank;
+			for (auto* image : images)
+			{
+				if (!*image || (*image)->GetWidth() != first->GetWidth() || (*image)->GetHeight() != first->GetHeight() || (*image)->GetLayerCount() != first->GetLayerCount())
+				{
+					DWARNING("Not caching atlas '" + set.AtlasName + "', its images are not all the same size");
+					return false;
+				}
+			}
+
+			std::error_code err;
+			auto dir = std::filesystem::path(path).parent_path();
+			if (!dir.empty())
+				std::filesystem::create_directories(dir, err);
+
+			// Written to a temporary file first so an interrupted write never leaves a truncated cache behind
+			auto tmpPath = path + ".tmp";
+			{
+				std::ofstream out{ tmpPath, std::ios::binary | std::ios::trunc };
+				if (!out)
+				{
+					DWARNING("Could not write atlas cache '" + path + "'");
+					return false;
+				}
+
+				out.write((const char*)&header, sizeof(header));
+				for (auto& [names, face] : set.FaceTextureLookup)
+				{
+					for (auto* name : GetNames(names))
+						WriteString(out, *name);
+					out.write((const char*)face.data(), sizeof(face));
+				}
+
+				for (auto* image : images)
+				{
+					for (size_t layer = 0; layer < (*image)->GetLayerCount(); ++layer)
+					{
+						auto* pixels = (*image)->GetLayerPixels((int)layer);
+						if (!pixels)
+						{
+							// Layers that were never written to are uploaded as blank
+							blank.resize((*image)->GetLayerByteSize(), 0);
+							pixels = blank.data();
+						}
+						out.write((const char*)pixels, (std::streamsize)(*image)->GetLayerByteSize());
+					}
+				}
+
+				if (!out)
+				{
+					DWARNING("Failed writing atlas cache '" + path + "'");
+					out.close();
+					std::filesystem::remove(tmpPath, err);
+					return false;
+				}
+			}
+
+			std::filesystem::rename(tmpPath, path, err);
+			if (err)
+			{
+				DWARNING("Could not replace atlas cache '" + path + "': " + err.message());
+				std::filesystem::remove(tmpPath, err);
+				return false;
+			}
+
+			DINFO("Cached atlas '" + set.AtlasName + "' to '" + path + "'");
+			return true;
+		}
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace Voxel
+{
+	struct StitchedAtlasSet;
+
+	/// <summary>
+	/// Binary cache of stitched atlases, so launches with unchanged block files and textures skip decoding and stitching
+	/// </summary>
+	/// <remarks>
+	/// A cache file holds the FaceTextureLookup table and the raw RGBA32 pixels of every layer of every image in the set, ready to upload.
+	/// Each file is keyed by a hash of everything that went into stitching it (texture names, texture contents and the stitching layout),
+	/// a file whose key doesn't match is simply ignored and overwritten by the next stitch.
+	/// Cache files are memory mapped when loaded.
+	/// </remarks>
+	namespace AtlasCache
+	{
+		// Bump whenever the file layout, or the way atlases are stitched, changes
+		constexpr uint32_t FormatVersion = 1;
+
+		// A quick non-cryptographic 64 bit hash, seed allows chaining hashes of several pieces
+		uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 0);
+		uint64_t HashString(const std::string& str, uint64_t seed = 0);
+		// Hashes the contents of a file, or just the path if it can't be read
+		uint64_t HashFile(const std::string& path, uint64_t seed = 0);
+
+		std::string GetCachePath(const std::string& directory, const std::string& atlasName);
+
+		// Loads the cache file at path into out (unloaded from GL) if it exists and was saved with the same key
+		bool TryLoad(const std::string& path, uint64_t key, StitchedAtlasSet& out);
+		// Writes a stitched set (which must still have its CPU pixels) to path, creating directories as needed
+		bool Save(const std::string& path, uint64_t key, const StitchedAtlasSet& set);
+	}
+}
@@ -0,0 +1,178 @@
+#include "Batch2D.h"
+
+#include <algorithm>
+
+namespace Drawing
+{
+	Batch2D::Batch2D()
+		: _vertices()
+		, _entries()
+		, _sorted()
+		, _runs()
+		, _transform(Matrixy2x3::Identity())
+		, _layer(0)
+		, _subLayer(0)
+		, _topLayer(0)
+	{
+	}
+
+	void Batch2D::SetLayer(uint32_t layer)
+	{
+		_layer = layer;
+		_subLayer = 0;
+		_topLayer = std::max(_topLayer, layer);
+	}
+
+	TextVertex* Batch2D::AddEntry(size_t count, GLuint texture)
+	{
+		auto first = _vertices.size();
+		_entries.push_back(Entry{ _layer, _subLayer++, texture, (uint32_t)first, (uint32_t)count });
+		_vertices.resize(first + count);
+		return _vertices.data() + first;
+	}
+
+	void Batch2D::AddTriangles(const TextVertex* vertices, size_t count, GLuint texture)
+	{
+		if (!count)
+			return;
+
+		auto* out = AddEntry(count, texture);
+		for (size_t i = 0; i < count; ++i)
+		{
+			out[i] = vertices[i];
+			out[i].Position = _transform.TransformPoint(vertices[i].Position);
+		}
+	}
+
+	void Batch2D::AddQuad(PointRect target, PointRect texCoords, floaty4 color, GLuint texture)
+	{
+		TextVertex quad[6] =
+		{
+			{ { target.left, target.top }, { texCoords.left, texCoords.top }, color },
+			{ { target.left, target.bottom }, { texCoords.left, texCoords.bottom }, color },
+			{ { target.right, target.bottom }, { texCoords.right, texCoords.bottom }, color },
+			{ { target.right, target.bottom }, { texCoords.right, texCoords.bottom }, color },
+			{ { target.right, target.top }, { texCoords.right, texCoords.top }, color },
+			{ { target.left, target.top }, { texCoords.left, texCoords.top }, color },
+		};
+		AddTriangles(quad, 6, texture);
+	}
+
+	void Batch2D::AddQuad(floaty2 a, floaty2 b, floaty2 c, floaty2 d, floaty4 color, GLuint texture)
+	{
+		// Solid quads sample the middle of the texture, which is all it is for the 1x1 white texture they're drawn with
+		floaty2 uv{ 0.5f, 0.5f };
+		TextVertex quad[6] =
+		{
+			{ a, uv, color }, { b, uv, color }, { c, uv, color },
+			{ a, uv, color }, { c, uv, color }, { d, uv, color },
+		};
+		AddTriangles(quad, 6, texture);
+	}
+
+	const std::vector<Batch2DRun>& Batch2D::Build()
+	{
+		_runs.clear();
+		_sorted.clear();
+		_sorted.reserve(_vertices.size());
+
+		std::stable_sort(_entries.begin(), _entries.end(), [](const Entry& a, const Entry& b)
+			{
+				if (a.Layer != b.Layer)
+					return a.Layer < b.Layer;
+				if (a.SubLayer != b.SubLayer)
+					return a.SubLayer < b.SubLayer;
+				return a.Texture < b.Texture;
+			});
+
+		for (auto& entry : _entries)
+		{
+			if (_runs.empty() || _runs.back().Texture != entry.Texture)
+				_runs.push_back(Batch2DRun{ entry.Texture, _sorted.size(), 0 });
+
+			_sorted.insert(_sorted.end(), _vertices.begin() + entry.First, _vertices.begin() + entry.First + entry.Count);
+			_runs.back().Count += entry.Count;
+		}
+
+		return _runs;
+	}
+
+	void Batch2D::Clear()
+	{
+		_vertices.clear();
+		_entries.clear();
+	}
+
+	void Batch2D::Reset()
+	{
+		Clear();
+		_layer = 0;
+		_subLayer = 0;
+		_topLayer = 0;
+		_transform = Matrixy2x3::Identity();
+	}
+}
+
+#ifdef CPP_ENGINE_TESTS
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+TEST(DrawingTests, Batch2DMergesSiblingsTest)
+{
+	using namespace Drawing;
+
+	constexpr GLuint White = 1, Text = 2;
+	floaty4 color{ 1.f, 1.f, 1.f, 1.f };
+
+	// Three 'buttons' side by side at the same depth, each a background then its text
+	Batch2D batch;
+	for (int i = 0; i < 3; ++i)
+	{
+		batch.SetLayer(1);
+		batch.SetTransform(Matrixy2x3::Translation((float)i * 100.f, 0.f));
+		batch.AddQuad({ 0.f, 0.f }, { 10.f, 0.f }, { 10.f, 10.f }, { 0.f, 10.f }, color, White);
+		batch.AddQuad(PointRect{ 0.f, 10.f, 10.f, 0.f }, PointRect{ 0.f, 0.f, 1.f, 1.f }, color, Text);
+	}
+
+	auto& runs = batch.Build();
+	ASSERT_EQ(runs.size(), 2u);
+	EXPECT_EQ(runs[0].Texture, White);
+	EXPECT_EQ(runs[0].Count, 18u);
+	EXPECT_EQ(runs[1].Texture, Text);
+	EXPECT_EQ(runs[1].First, 18u);
+	EXPECT_EQ(batch.GetVertices().size(), 36u);
+
+	// Transforms were applied as the quads were added
+	EXPECT_FLOAT_EQ(batch.GetVertices()[6].Position.x, 100.f);
+}
+
+TEST(DrawingTests, Batch2DLayerOrderTest)
+{
+	using namespace Drawing;
+
+	constexpr GLuint A = 1, B = 2;
+	floaty4 color{ 1.f, 1.f, 1.f, 1.f };
+
+	// A child (layer 2) must draw over its parent (layer 1) even when submitted first
+	Batch2D batch;
+	batch.SetLayer(2);
+	batch.AddQuad({ 0.f, 0.f }, { 1.f, 0.f }, { 1.f, 1.f }, { 0.f, 1.f }, color, A);
+	batch.SetLayer(1);
+	batch.AddQuad({ 0.f, 0.f }, { 1.f, 0.f }, { 1.f, 1.f }, { 0.f, 1.f }, color, B);
+	batch.AddQuad({ 0.f, 0.f }, { 1.f, 0.f }, { 1.f, 1.f }, { 0.f, 1.f }, color, A);
+
+	auto& runs = batch.Build();
+	ASSERT_EQ(runs.size(), 2u);
+	EXPECT_EQ(runs[0].Texture, B);
+	EXPECT_EQ(runs[1].Texture, A);
+	EXPECT_EQ(runs[1].Count, 12u); // The parent's last quad and the child merge, they're adjacent once sorted
+	EXPECT_EQ(batch.GetTopLayer(), 2u);
+
+	batch.Reset();
+	EXPECT_TRUE(batch.IsEmpty());
+	EXPECT_EQ(batch.GetTopLayer(), 0u);
+	EXPECT_TRUE(batch.Build().empty());
+}
+
+#endif // CPP_ENGINE_TESTS
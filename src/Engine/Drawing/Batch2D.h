@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Helpers/VectorHelper.h"
+#include "Math/matrix.h"
+
+#include "Drawing/GlyphAtlas.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace Drawing
+{
+	// A run of consecutive vertices in a built batch that all sample the same texture, drawn with one call
+	struct Batch2DRun
+	{
+		GLuint Texture;
+		size_t First;
+		size_t Count;
+	};
+
+	/// <summary>
+	/// Accumulates textured, vertex coloured triangles (sprites, filled rects and text) for one frame so they can be drawn in as few calls as possible
+	/// </summary>
+	/// <remarks>
+	/// Vertices are transformed by the current transform as they are added, so changing the transform between primitives doesn't split the batch.
+	/// Each primitive is tagged with the current layer and a sub layer that counts primitives added since the layer was last set.
+	/// Build sorts (stably) by layer, then sub layer, then texture and merges neighbours with the same texture into runs.
+	/// So a UI element's own primitives keep their order, elements deeper in the tree draw over their parents,
+	/// and the same primitive of every sibling (e.g. every button's background, then every button's text) is drawn together.
+	/// Primitives sharing a layer and sub layer are assumed not to overlap, as they may be reordered by texture.
+	/// </remarks>
+	class Batch2D
+	{
+		struct Entry
+		{
+			uint32_t Layer;
+			uint32_t SubLayer;
+			GLuint Texture;
+			uint32_t First;
+			uint32_t Count;
+		};
+
+		std::vector<TextVertex> _vertices;
+		std::vector<Entry> _entries;
+		std::vector<TextVertex> _sorted;
+		std::vector<Batch2DRun> _runs;
+		Matrixy2x3 _transform;
+		uint32_t _layer;
+		uint32_t _subLayer;
+		uint32_t _topLayer;
+
+		TextVertex* AddEntry(size_t count, GLuint texture);
+
+	public:
+		Batch2D();
+
+		// Sets the layer new primitives go into and restarts its sub layer count
+		void SetLayer(uint32_t layer);
+		inline uint32_t GetLayer() const { return _layer; }
+		// The highest layer set since the last Reset, anything set above it draws over everything so far
+		inline uint32_t GetTopLayer() const { return _topLayer; }
+
+		inline void SetTransform(const Matrixy2x3& transform) { _transform = transform; }
+
+		// Adds a triangle list (positions are transformed)
+		void AddTriangles(const TextVertex* vertices, size_t count, GLuint texture);
+		// Adds an axis aligned quad, texCoords span top left to bottom right
+		void AddQuad(PointRect target, PointRect texCoords, floaty4 color, GLuint texture);
+		// Adds a quad from 4 corners in fan order
+		void AddQuad(floaty2 a, floaty2 b, floaty2 c, floaty2 d, floaty4 color, GLuint texture);
+
+		// Sorts and merges everything added since the last Clear, the runs index into GetVertices
+		const std::vector<Batch2DRun>& Build();
+		inline const std::vector<TextVertex>& GetVertices() const { return _sorted; }
+
+		inline bool IsEmpty() const { return _entries.empty(); }
+		inline size_t GetPrimitiveCount() const { return _entries.size(); }
+
+		// Removes every primitive (keeping the layer and transform, so more can be added after a flush)
+		void Clear();
+		// Clears and goes back to layer 0 and the identity transform, keeping the allocations for next frame
+		void Reset();
+	};
+}
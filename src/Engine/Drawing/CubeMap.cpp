@@ -33,9 +33,12 @@ namespace Drawing
 		, _cpuTexs(std::move(other._cpuTexs))
 		, _width(other._width)
 		, _height(other._height)
+		, _releaseCPUAfterUpload(other._releaseCPUAfterUpload)
+		, _cpuReleased(other._cpuReleased)
 	{
 		other._width = 0;
 		other._height = 0;
+		other._cpuReleased = false;
 	}
 
 	CubeMapTexture::CubeMapTexture(const SimpleSurface& px, const SimpleSurface& nx, const SimpleSurface& py, const SimpleSurface& ny, const SimpleSurface& pz, const SimpleSurface& nz)
@@ -74,8 +77,11 @@ namespace Drawing
 		_cpuTexs = std::move(other._cpuTexs);
 		_width = other._width;
 		_height = other._height;
+		_releaseCPUAfterUpload = other._releaseCPUAfterUpload;
+		_cpuReleased = other._cpuReleased;
 		other._width = 0;
 		other._height = 0;
+		other._cpuReleased = false;
 		return *this;
 	}
 
@@ -95,7 +101,8 @@ namespace Drawing
 			if (!indexToFace(i))
 				return;
 
-		bool redo = (GLuint)px->w != _width || (GLuint)px->h != _height;
+		// Every face is replaced, so released faces are simply re-created rather than read back
+		bool redo = _cpuReleased || (GLuint)px->w != _width || (GLuint)px->h != _height;
 
 		GLuint new_width = px->w;
 		GLuint new_height = px->h;
@@ -119,6 +126,7 @@ namespace Drawing
 				SDL_SetSurfaceBlendMode(_cpuTexs[i].Get(), SDL_BLENDMODE_NONE);
 			}
 			SDL_FreeFormat(format);
+			_cpuReleased = false;
 		}
 
 		if (!redo)
@@ -134,13 +142,47 @@ namespace Drawing
 		}
 		else if (HasLoadedGL())
 		{
-			glTextureSubImage3D(_tex, 0, 0, 0, 0, (GLsizei)_width, (GLsizei)_height, 1, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*)px->pixels);
-			glTextureSubImage3D(_tex, 0, 0, 0, 1, (GLsizei)_width, (GLsizei)_height, 1, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*)nx->pixels);
-			glTextureSubImage3D(_tex, 0, 0, 0, 2, (GLsizei)_width, (GLsizei)_height, 1, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*)py->pixels);
-			glTextureSubImage3D(_tex, 0, 0, 0, 3, (GLsizei)_width, (GLsizei)_height, 1, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*)ny->pixels);
-			glTextureSubImage3D(_tex, 0, 0, 0, 4, (GLsizei)_width, (GLsizei)_height, 1, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*)pz->pixels);
-			glTextureSubImage3D(_tex, 0, 0, 0, 5, (GLsizei)_width, (GLsizei)_height, 1, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*)nz->pixels);
+			// Uploaded from the converted copies, the given surfaces may not be RGBA32
+			for (int i = 0; i < 6; ++i)
+				glTextureSubImage3D(_tex, 0, 0, 0, i, (GLsizei)_width, (GLsizei)_height, 1, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*)_cpuTexs[i]->pixels);
+			glGenerateTextureMipmap(_tex);
+
+			if (_releaseCPUAfterUpload)
+				ReleaseCPU();
+		}
+	}
+
+	void CubeMapTexture::ReleaseCPU()
+	{
+		for (auto& tex : _cpuTexs)
+			tex.Delete();
+		_cpuReleased = true;
+	}
+
+	void CubeMapTexture::EnsureCPU()
+	{
+		if (!_cpuReleased)
+			return;
+		_cpuReleased = false;
+
+		bool readBack = HasLoadedGL();
+		for (int i = 0; i < 6; ++i)
+		{
+			_cpuTexs[i] = SDL_CreateRGBSurfaceWithFormat(0, (int)_width, (int)_height, 32, SDL_PIXELFORMAT_RGBA32);
+			SDL_SetSurfaceAlphaMod(_cpuTexs[i].Get(), 0);
+			SDL_SetSurfaceBlendMode(_cpuTexs[i].Get(), SDL_BLENDMODE_NONE);
+			if (readBack)
+				glGetTextureSubImage(_tex, 0, 0, 0, i, (GLsizei)_width, (GLsizei)_height, 1, GL_RGBA, GL_UNSIGNED_BYTE, (GLsizei)(_width * _height * 4), _cpuTexs[i]->pixels);
 		}
+		if (readBack)
+			CHECK_GL_ERR("Reading back CubeMapTexture faces");
+	}
+
+	void CubeMapTexture::SetReleaseCPUAfterUpload(bool release)
+	{
+		_releaseCPUAfterUpload = release;
+		if (release && HasLoadedGL() && !_cpuReleased)
+			ReleaseCPU();
 	}
 	
 	void CubeMapTexture::Destroy()
@@ -151,6 +193,7 @@ namespace Drawing
 		}
 		_width = 0;
 		_height = 0;
+		_cpuReleased = false;
 	}
 	
 	void CubeMapTexture::LoadGL()
@@ -158,15 +201,18 @@ namespace Drawing
 		if (HasLoadedGL())
 			return;
 
+		if (!_cpuTexs[0])
+			return;
+
 		glCreateTextures(GL_TEXTURE_CUBE_MAP, 1, &_tex);
 		
-		glTextureParameteri(_tex, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTextureParameteri(_tex, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 		glTextureParameteri(_tex, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 		glTextureParameteri(_tex, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 		glTextureParameteri(_tex, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 		glTextureParameteri(_tex, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
 		
-		glTextureStorage2D(_tex, 1, GL_RGBA8, _width, _height);
+		glTextureStorage2D(_tex, GetMipLevelCount((GLsizei)_width, (GLsizei)_height), GL_RGBA8, _width, _height);
 
 		glBindTexture(GL_TEXTURE_CUBE_MAP, _tex);
 		/*glTextureSubImage3D(_tex, 0, 0, 0, 0, _width, _height, 1, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*)_cpuTexs[0]->pixels);
@@ -182,12 +228,19 @@ namespace Drawing
 		glTexSubImage2D(GL_TEXTURE_CUBE_MAP_NEGATIVE_Y, 0, 0, 0, _width, _height, GL_RGBA, GL_UNSIGNED_BYTE, _cpuTexs[3]->pixels);
 		glTexSubImage2D(GL_TEXTURE_CUBE_MAP_NEGATIVE_Z, 0, 0, 0, _width, _height, GL_RGBA, GL_UNSIGNED_BYTE, _cpuTexs[5]->pixels);
 		glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+
+		glGenerateTextureMipmap(_tex);
+
+		if (_releaseCPUAfterUpload)
+			ReleaseCPU();
 	}
 
 	void CubeMapTexture::UnloadGL()
 	{
 		if (!HasLoadedGL())
 			return;
+		// Deleting the texture would otherwise lose the only copy
+		EnsureCPU();
 		GLImage::Reset();
 	}
 }
\ No newline at end of file
@@ -24,6 +24,12 @@ namespace Drawing
 		std::array<SimpleSurface, 6> _cpuTexs; // Order: px, nx, py, ny, pz, nz
 		
 		GLuint _width, _height;
+
+		// Whether LoadGL should free _cpuTexs once uploaded, and whether it has
+		bool _releaseCPUAfterUpload = false;
+		bool _cpuReleased = false;
+
+		void ReleaseCPU();
 	public:
 		CubeMapTexture();
 		CubeMapTexture(CubeMapTexture&& other);
@@ -39,7 +45,16 @@ namespace Drawing
 		void Set(const SimpleSurface& px, const SimpleSurface& nx, const SimpleSurface& py, const SimpleSurface& ny, const SimpleSurface& pz, const SimpleSurface& nz);
 		
 		virtual void Destroy() override;
+
+		// Reads the faces back from the GPU if the CPU copy was released (or leaves them blank without a texture)
+		void EnsureCPU();
+
+		// When enabled LoadGL frees the CPU faces once the texture and its mip chain are uploaded
+		void SetReleaseCPUAfterUpload(bool release);
+
+		inline bool HasCPUPixels() const { return !_cpuReleased; }
 		
+		// Creates the texture with a full mip chain, uploads the faces and generates the mipmaps
 		void LoadGL() override;
 		void UnloadGL();
 
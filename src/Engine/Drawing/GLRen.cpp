@@ -6,6 +6,10 @@
 #include <algorithm>
 
 #include "BindingManager.h"
+#include "StreamingBuffer.h"
+#include "GpuProfiler.h"
+#include "TextDrawing.h"
+#include "GlyphAtlas.h"
 
 void GLRen::DrawImage(Drawing::SDLImage * im, PointRect target)
 {
@@ -17,6 +21,13 @@ void GLRen::DrawImage(Drawing::SDLImage * im, PointRect target)
 		im->LoadGL();
 	}
 
+	if (Batching)
+	{
+		if (im->Get())
+			Batch.AddQuad(target, { 0.f, 0.f, im->GetWidthScale(), im->GetHeightScale() }, { 1.f, 1.f, 1.f, 1.f }, im->Get());
+		return;
+	}
+
 	glUseProgram(ImageProgram.Get());
 
 	// Setup
@@ -65,17 +76,155 @@ void GLRen::DrawImage(Drawing::SDLImage * im, PointRect src, PointRect target)
 	(void)target;
 }
 
+void GLRen::DrawText(TextDrawing * text, PointRect target)
+{
+	DidWork = true;
+	if (!text || !text->CanDraw())
+		return;
+
+	const auto& vertices = text->GetVertices();
+	auto size = text->GetSize();
+	if (vertices.empty() || size.x <= 0.f || size.y <= 0.f)
+		return;
+
+	// Stretch the text's pixel box over the target, the same as DrawImage does with an image
+	float scaleX = (target.right - target.left) / size.x;
+	float scaleY = (target.bottom - target.top) / size.y;
+
+	std::vector<Drawing::TextVertex> placed{ vertices };
+	for (auto& vertex : placed)
+		vertex.Position = { target.left + vertex.Position.x * scaleX, target.top + vertex.Position.y * scaleY };
+
+	auto texture = text->GetAtlas()->GetTexture();
+	if (Batching)
+	{
+		if (texture)
+			Batch.AddTriangles(placed.data(), placed.size(), texture);
+		return;
+	}
+
+	DrawSpriteVertices(placed.data(), placed.size(), texture);
+}
+
+void GLRen::DrawText(TextDrawing * text, floaty2 target)
+{
+	if (!text)
+		return;
+	DrawText(text, { target.x, target.y + (float)text->GetHeight(), target.x + (float)text->GetWidth(), target.y });
+}
+
 void GLRen::SetTransform(Matrixy2x3 trans)
 {
 	// Convert 2D matrix to 4x4
-	CHECK_GL_ERR("Before Transform Update");
 	TransformMatrix = trans;
+
+	// Batched vertices are transformed as they're added, the uniform only needs updating before something is drawn straight away
+	if (Batching)
+	{
+		Batch.SetTransform(trans);
+		TransformStale = true;
+		return;
+	}
+	UploadTransform(TransformMatrix);
+	TransformStale = false;
+}
+
+void GLRen::UploadTransform(const Matrixy4x4 & trans)
+{
+	CHECK_GL_ERR("Before Transform Update");
 	glBindBuffer(GL_UNIFORM_BUFFER, Trans2DBuffer.Get());
-	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Matrixy4x4), TransformMatrix.ma);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Matrixy4x4), trans.ma);
 	glBindBuffer(GL_UNIFORM_BUFFER, 0);
 	CHECK_GL_ERR("Updating Transform");
 }
 
+void GLRen::BeginBatch()
+{
+	if (Batching)
+		return;
+	Batching = true;
+	Batch.Reset();
+	Batch.SetTransform(TransformMatrix);
+}
+
+void GLRen::EndBatch()
+{
+	if (!Batching)
+		return;
+	FlushBatch();
+	Batching = false;
+	Batch.Reset();
+
+	if (TransformStale)
+	{
+		UploadTransform(TransformMatrix);
+		TransformStale = false;
+	}
+}
+
+void GLRen::PrepareImmediate()
+{
+	if (Batching)
+		FlushBatch();
+	if (TransformStale)
+	{
+		UploadTransform(TransformMatrix);
+		TransformStale = false;
+	}
+}
+
+void GLRen::FlushBatch()
+{
+	if (Batch.IsEmpty())
+		return;
+
+	PROFILE_PUSH("Flush 2D Batch");
+	DidWork = true;
+
+	const auto& runs = Batch.Build();
+	const auto& vertices = Batch.GetVertices();
+
+	// Every run goes up in one upload, then each is drawn from its offset
+	auto size = (GLsizeiptr)(vertices.size() * sizeof(Drawing::TextVertex));
+	GLuint buffer;
+	GLintptr offset;
+	if (auto alloc = Drawing::StreamData(vertices.data(), size, sizeof(Drawing::TextVertex)))
+	{
+		buffer = alloc.Buffer;
+		offset = alloc.Offset;
+	}
+	else
+	{
+		glNamedBufferData(SpriteVBO.Get(), size, vertices.data(), GL_STREAM_DRAW);
+		buffer = SpriteVBO.Get();
+		offset = 0;
+	}
+
+	// Vertices are already transformed
+	UploadTransform(Matrixy4x4::Identity());
+	TransformStale = true;
+
+	glUseProgram(SpriteProgram.Get());
+	glUniform1i(SpriteSamplerLoc, 0);
+	glVertexArrayVertexBuffer(SpriteVAO.Get(), 0, buffer, offset, sizeof(Drawing::TextVertex));
+	glBindVertexArray(SpriteVAO.Get());
+
+	for (auto& run : runs)
+	{
+		glBindTextureUnit(0, run.Texture);
+		glDrawArrays(GL_TRIANGLES, (GLint)run.First, (GLsizei)run.Count);
+	}
+
+	glBindVertexArray(0);
+	glBindTextureUnit(0, 0);
+	glUseProgram(0);
+
+	CHECK_GL_ERR("FlushBatch");
+
+	Batch.Clear();
+	PROFILE_POP();
+}
+
 void GLRen::SetScissorRect(GLint x, GLint y, GLint width, GLint height)
 {
 	(void)x;
@@ -395,6 +544,10 @@ void GLRen::Present(SDL_Window *win)
 {
 	PROFILE_PUSH("GLRen Present");
 	CHECK_GL_ERR("Uncaught Error before Presenting");
+	if (Drawing::StreamingBuffer::IsInitialized())
+		Drawing::StreamingBuffer::Instance().NextFrame();
+	if (Drawing::GpuProfiler::IsInitialized())
+		Drawing::GpuProfiler::Instance().NextFrame();
 	if (DidWork) 
 		SDL_GL_SwapWindow(win); 
 	DidWork = false;
@@ -576,14 +729,104 @@ GLuint GLRen::InitDrawColor()
 	return out;
 }
 
+GLProgram GLRen::InitSprite()
+{
+	return GLProgram(
+		{
+			{"Shaders/sprite.glvs", GL_VERTEX_SHADER},
+			{"Shaders/sprite.glfs", GL_FRAGMENT_SHADER}
+		}
+		);
+}
+
+GLuint GLRen::InitSpriteVAO()
+{
+	GLuint out = 0;
+	glCreateVertexArrays(1, &out);
+
+	glEnableVertexArrayAttrib(out, 0);
+	glVertexArrayAttribFormat(out, 0, 2, GL_FLOAT, GL_FALSE, offsetof(Drawing::TextVertex, Position));
+	glVertexArrayAttribBinding(out, 0, 0);
+
+	glEnableVertexArrayAttrib(out, 1);
+	glVertexArrayAttribFormat(out, 1, 2, GL_FLOAT, GL_FALSE, offsetof(Drawing::TextVertex, TexCoord));
+	glVertexArrayAttribBinding(out, 1, 0);
+
+	glEnableVertexArrayAttrib(out, 2);
+	glVertexArrayAttribFormat(out, 2, 4, GL_FLOAT, GL_FALSE, offsetof(Drawing::TextVertex, Color));
+	glVertexArrayAttribBinding(out, 2, 0);
+	CHECK_GL_ERR("Creating Sprite VAO");
+
+	return out;
+}
+
+GLuint GLRen::InitSpriteVBO()
+{
+	GLuint out = 0;
+	glCreateBuffers(1, &out);
+	return out;
+}
+
+GLuint GLRen::InitSpriteSampler()
+{
+	GLuint out = glGetUniformLocation(SpriteProgram.Get(), "TextureThing");
+	if (out == -1)
+		throw GL_EXCEPT("glGetUniformLocation");
+	return out;
+}
+
+GLuint GLRen::InitWhiteTexture()
+{
+	unsigned char white[4] = { 255, 255, 255, 255 };
+	return Drawing::Create2DGLTexture(GL_RGBA8, 1, 1, white, GL_RGBA, GL_UNSIGNED_BYTE);
+}
+
+void GLRen::DrawSpriteVertices(const Drawing::TextVertex * vertices, size_t count, GLuint texture)
+{
+	if (!count || !texture)
+		return;
+
+	auto size = (GLsizeiptr)(count * sizeof(Drawing::TextVertex));
+	GLuint buffer;
+	GLintptr offset;
+	if (auto alloc = Drawing::StreamData(vertices, size, sizeof(Drawing::TextVertex)))
+	{
+		buffer = alloc.Buffer;
+		offset = alloc.Offset;
+	}
+	else
+	{
+		glNamedBufferData(SpriteVBO.Get(), size, vertices, GL_STREAM_DRAW);
+		buffer = SpriteVBO.Get();
+		offset = 0;
+	}
+
+	glUseProgram(SpriteProgram.Get());
+	glBindTextureUnit(0, texture);
+	glUniform1i(SpriteSamplerLoc, 0);
+
+	glVertexArrayVertexBuffer(SpriteVAO.Get(), 0, buffer, offset, sizeof(Drawing::TextVertex));
+	glBindVertexArray(SpriteVAO.Get());
+
+	glDrawArrays(GL_TRIANGLES, 0, (GLsizei)count);
+
+	glBindVertexArray(0);
+	glBindTextureUnit(0, 0);
+	glUseProgram(0);
+
+	CHECK_GL_ERR("DrawSpriteVertices");
+}
+
 GLuint GLRen::InitProjMatrix()
 {
 	ProjMat2DBinding = Drawing::BindingManager::GetNext();
 
 	GLint index1 = glGetUniformBlockIndex(Program2D.Get(), "SharedProjData");
 	GLint index2 = glGetUniformBlockIndex(this->ImageProgram.Get(), "SharedProjData");
+	GLint index3 = glGetUniformBlockIndex(SpriteProgram.Get(), "SharedProjData");
 	glUniformBlockBinding(Program2D.Get(), index1, ProjMat2DBinding);
 	glUniformBlockBinding(ImageProgram.Get(), index2, ProjMat2DBinding);
+	glUniformBlockBinding(SpriteProgram.Get(), index3, ProjMat2DBinding);
 	CHECK_GL_ERR("Binding Projection Matrix Buffer");
 
 	GLuint out = 0;
@@ -602,8 +845,10 @@ GLuint GLRen::InitTransMatrix()
 
 	GLint index1 = glGetUniformBlockIndex(Program2D.Get(), "SharedTransformData");
 	GLint index2 = glGetUniformBlockIndex(this->ImageProgram.Get(), "SharedTransformData");
+	GLint index3 = glGetUniformBlockIndex(SpriteProgram.Get(), "SharedTransformData");
 	glUniformBlockBinding(Program2D.Get(), index1, TransMat2DLoc);
 	glUniformBlockBinding(ImageProgram.Get(), index2, TransMat2DLoc);
+	glUniformBlockBinding(SpriteProgram.Get(), index3, TransMat2DLoc);
 	CHECK_GL_ERR("Binding Object Transform Buffer");
 
 	GLuint out = 0;
@@ -733,6 +978,11 @@ GLRen::GLRen(CommonResources *resources)
 	, DrawVBO(InitDrawVBO())
 	, DrawIBO(InitDrawIBO())
 	, DrawColorName(InitDrawColor())
+	, SpriteProgram(InitSprite())
+	, SpriteVAO(InitSpriteVAO())
+	, SpriteVBO(InitSpriteVBO())
+	, SpriteSamplerLoc(InitSpriteSampler())
+	, WhiteTexture(InitWhiteTexture())
 	, Proj2DBuffer(InitProjMatrix())
 	, Trans2DBuffer(InitTransMatrix())
 	, Program3D(Init3D())
@@ -743,6 +993,9 @@ GLRen::GLRen(CommonResources *resources)
 	, Lights(Program3D)
 	, m_Renv2(resources)
 {
+	Drawing::StreamingBuffer::InitializeStreamingBuffer();
+	Drawing::GpuProfiler::InitializeGpuProfiler();
+
 	glUseProgram(Program3D.Get());
 	TexMan.BlankifyTextues();
 
@@ -751,9 +1004,18 @@ GLRen::GLRen(CommonResources *resources)
 	OutputProgramLog(Program2D.Get());
 }
 
+GLRen::~GLRen()
+{
+	// The context is still current here, free the GL (and TTF) resources held by statics before it (and TTF) goes away
+	Drawing::GlyphAtlas::ReleaseAll();
+	Drawing::GpuProfiler::ReleaseGpuProfiler();
+	Drawing::StreamingBuffer::ReleaseStreamingBuffer();
+}
+
 void GLRen::DrawPoint(floaty2 point, floaty4 color)
 {
 	DidWork = true;
+	PrepareImmediate();
 	glUseProgram(Program2D.Get());
 
 	// Bind
@@ -780,6 +1042,7 @@ void GLRen::DrawPoint(floaty2 point, floaty4 color)
 void GLRen::DrawLine(floaty2 a, floaty2 b, floaty4 color)
 {
 	DidWork = true;
+	PrepareImmediate();
 	glUseProgram(Program2D.Get());
 
 	// Bind
@@ -806,6 +1069,7 @@ void GLRen::DrawLine(floaty2 a, floaty2 b, floaty4 color)
 void GLRen::DrawRectangle(floaty2 topleft, floaty2 bottomright, floaty4 color)
 {
 	DidWork = true;
+	PrepareImmediate();
 	glUseProgram(Program2D.Get());
 
 	// Bind
@@ -832,6 +1096,7 @@ void GLRen::DrawRectangle(floaty2 topleft, floaty2 bottomright, floaty4 color)
 void GLRen::DrawRectangle(floaty2 a, floaty2 b, floaty2 c, floaty2 d, floaty4 color)
 {
 	DidWork = true;
+	PrepareImmediate();
 	glUseProgram(Program2D.Get());
 
 	// Bind
@@ -858,6 +1123,11 @@ void GLRen::DrawRectangle(floaty2 a, floaty2 b, floaty2 c, floaty2 d, floaty4 co
 void GLRen::FillRectangle(floaty2 topleft, floaty2 bottomright, floaty4 color)
 {
 	DidWork = true;
+	if (Batching)
+	{
+		Batch.AddQuad({ topleft.x, bottomright.y }, bottomright, { bottomright.x, topleft.y }, topleft, color, WhiteTexture.Get());
+		return;
+	}
 	glUseProgram(Program2D.Get());
 
 	// Bind
@@ -884,6 +1154,11 @@ void GLRen::FillRectangle(floaty2 topleft, floaty2 bottomright, floaty4 color)
 void GLRen::FillRectangle(floaty2 a, floaty2 b, floaty2 c, floaty2 d, floaty4 color)
 {
 	DidWork = true;
+	if (Batching)
+	{
+		Batch.AddQuad(a, b, c, d, color, WhiteTexture.Get());
+		return;
+	}
 	glUseProgram(Program2D.Get());
 
 	// Bind
@@ -910,6 +1185,7 @@ void GLRen::FillRectangle(floaty2 a, floaty2 b, floaty2 c, floaty2 d, floaty4 co
 void GLRen::DrawTriangle(floaty2 a, floaty2 b, floaty2 c, floaty4 color)
 {
 	DidWork = true;
+	PrepareImmediate();
 	glUseProgram(Program2D.Get());
 
 	// Bind
@@ -936,6 +1212,13 @@ void GLRen::DrawTriangle(floaty2 a, floaty2 b, floaty2 c, floaty4 color)
 void GLRen::FillTriangle(floaty2 a, floaty2 b, floaty2 c, floaty4 color)
 {
 	DidWork = true;
+	if (Batching)
+	{
+		floaty2 uv{ 0.5f, 0.5f };
+		Drawing::TextVertex triangle[3] = { { a, uv, color }, { b, uv, color }, { c, uv, color } };
+		Batch.AddTriangles(triangle, 3, WhiteTexture.Get());
+		return;
+	}
 	glUseProgram(Program2D.Get());
 
 	// Bind
@@ -962,6 +1245,7 @@ void GLRen::FillTriangle(floaty2 a, floaty2 b, floaty2 c, floaty4 color)
 void GLRen::DrawVertices(std::vector<floaty2> vertices, floaty4 color)
 {
 	DidWork = true;
+	PrepareImmediate();
 	glUseProgram(Program2D.Get());
 
 	// Bind
@@ -994,6 +1278,17 @@ void GLRen::DrawVertices(std::vector<floaty2> vertices, floaty4 color)
 void GLRen::FillVertices(std::vector<floaty2> vertices, floaty4 color)
 {
 	DidWork = true;
+	if (Batching)
+	{
+		floaty2 uv{ 0.5f, 0.5f };
+		std::vector<Drawing::TextVertex> triangles;
+		auto count = vertices.size() - vertices.size() % 3;
+		triangles.reserve(count);
+		for (size_t i = 0; i < count; ++i)
+			triangles.push_back({ vertices[i], uv, color });
+		Batch.AddTriangles(triangles.data(), triangles.size(), WhiteTexture.Get());
+		return;
+	}
 	glUseProgram(Program2D.Get());
 
 	// Bind
@@ -9,6 +9,8 @@
 #include "Drawing/Graphics3D.h"
 #include "Drawing/IRen3D.h"
 #include "Drawing/Particles.h"
+#include "Drawing/GlyphAtlas.h"
+#include "Drawing/Batch2D.h"
 
 // GLRen2 Stuff
 #include "GLRen2.h"
@@ -267,6 +269,7 @@ protected:
 struct GLRen : IRen2D, IRen3D, Particles::IParticleDrawer, FullResourceHolder, Drawing::IDrawGuy, Drawing::ISorterGuy, Drawing::IMaterialGuy//, Drawing::IMatrixGuy
 {
 	GLRen(CommonResources *resources);
+	~GLRen();
 
 	/// -------------------------
 	// 2D
@@ -311,6 +314,15 @@ struct GLRen : IRen2D, IRen3D, Particles::IParticleDrawer, FullResourceHolder, D
 	/// <param name="target">The target Rectangle to fit the image into</param>
 	void DrawImage(Drawing::SDLImage *im, PointRect src, PointRect target) override;
 
+	void DrawText(TextDrawing *text, PointRect target) override;
+	void DrawText(TextDrawing *text, floaty2 target) override;
+
+	void BeginBatch() override;
+	void EndBatch() override;
+	inline void SetBatchLayer(unsigned int layer) override { Batch.SetLayer(layer); }
+	inline unsigned int GetBatchLayer() override { return Batch.GetLayer(); }
+	inline unsigned int GetTopBatchLayer() override { return Batch.GetTopLayer(); }
+
 	// Set the transform matrix to be used for rendering
 	void SetTransform(Matrixy2x3 trans) override;
 	inline floaty2 Transform(floaty2 me) override
@@ -431,6 +443,12 @@ protected:
 	GLuint InitDrawIBO();
 	GLuint InitDrawColor();
 
+	GLProgram InitSprite(); // Textured, vertex coloured triangles (used for text)
+	GLuint InitSpriteVAO();
+	GLuint InitSpriteVBO();
+	GLuint InitSpriteSampler();
+	GLuint InitWhiteTexture();
+
 	GLuint InitProjMatrix();
 	GLuint InitTransMatrix();
 
@@ -445,6 +463,14 @@ protected:
 	void UpdateDrawVerts(std::array<floaty2, 4u> vertices);
 	void UpdateDrawColor(floaty4 color);
 
+	// Draws a triangle list of sprite vertices, streamed through the StreamingBuffer where possible
+	void DrawSpriteVertices(const Drawing::TextVertex *vertices, size_t count, GLuint texture);
+
+	// Draws everything batched so far (leaving batching on), then makes sure the transform uniform is current for drawing straight away
+	void FlushBatch();
+	void PrepareImmediate();
+	void UploadTransform(const Matrixy4x4 &trans);
+
 	void UpdatePerObjectInstance(PerObjectv2Desc *desc);
 	void UpdatePerObject(Matrixy4x4 *mat);
 	void UpdatePerObject(PerObjectDesc *desc);
@@ -470,6 +496,16 @@ protected:
 	GLBuffer DrawIBO;
 	GLuint DrawColorName;
 
+	GLProgram SpriteProgram;
+	GLVertexArray SpriteVAO;
+	GLBuffer SpriteVBO; // Only used when the streaming buffer is full
+	GLuint SpriteSamplerLoc;
+	Drawing::GLImage WhiteTexture; // 1x1, so solid shapes can be batched with sprites
+
+	Drawing::Batch2D Batch;
+	bool Batching = false;
+	bool TransformStale = false; // Trans2DBuffer doesn't hold TransformMatrix (it isn't uploaded while batching)
+
 	GLuint TransMat2DLoc;
 	GLuint ProjMat2DBinding;
 
@@ -9,6 +9,8 @@
 #include "Program.h"
 #include "BindingManager.h"
 #include "CubeMap.h"
+#include "StreamingBuffer.h"
+#include "GpuProfiler.h"
 
 // Workaround to access profiler
 #include "Systems/Execution/Engine.h"
@@ -27,23 +29,26 @@ namespace Drawing
 		const auto inv = Matrixy4x4::InvertedOrIdentity(Matrixy4x4::Multiply(proj, view));
 
 		std::vector<floaty4> frustumCorners;
+		frustumCorners.reserve(8);
 		for (unsigned int x = 0; x < 2; ++x)
 		{
 			for (unsigned int y = 0; y < 2; ++y)
 			{
 				for (unsigned int z = 0; z < 2; ++z)
 				{
-					const floaty4 pt =
-						inv.Transform(floaty4(
-							2.0f * x - 1.0f,
-							2.0f * y - 1.0f,
-							2.0f * z - 1.0f,
-							1.0f));
-					frustumCorners.push_back(pt / pt.w);
+					frustumCorners.emplace_back(
+						2.0f * x - 1.0f,
+						2.0f * y - 1.0f,
+						2.0f * z - 1.0f,
+						1.0f);
 				}
 			}
 		}
 
+		Matrixy4x4::TransformBatch(inv, frustumCorners.data(), frustumCorners.data(), frustumCorners.size());
+		for (auto& pt : frustumCorners)
+			pt /= pt.w;
+
 		return frustumCorners;
 	}
 
@@ -116,8 +121,11 @@ namespace Drawing
 			cubemapSide{GL_TEXTURE_CUBE_MAP_POSITIVE_Z, { 0.f, 0.f, +1.f }, { 0.f, 1.f, 0.f } },
 			cubemapSide{GL_TEXTURE_CUBE_MAP_NEGATIVE_Z, { 0.f, 0.f, -1.f }, { 0.f, 1.f, 0.f } },
 		};
+		static constexpr std::array<const char*, 6> sideZones = { "Point Shadow +X", "Point Shadow -X", "Point Shadow +Y", "Point Shadow -Y", "Point Shadow +Z", "Point Shadow -Z" };
 		for (int i = 0; i < 6; ++i)
 		{
+			TRACE_PUSH_DYNAMIC(sideZones[i]);
+			GPU_PUSH_DYNAMIC(sideZones[i]);
 			auto& side = mapSides[i];
 			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, side.attachment, shadowTex.Get(), 0);
 			glDrawBuffer(GL_NONE);
@@ -131,11 +139,15 @@ namespace Drawing
 			Matrixy4x4 lightProjection = Matrixy4x4::PerspectiveFovD(90.f, 1.f, 0.1f, light.Range);
 
 			DrawShadowGeometry(Matrixy4x4::Multiply(lightProjection, lightView));
+			GPU_POP();
+			TRACE_POP();
 		}
 	}
 
 	void DrawCallRenderer::DrawSpotlightShadows(const Light& light, GLuint mapSize)
 	{
+		TRACE_ZONE("Spotlight Shadow");
+		GPU_ZONE("Spotlight Shadow");
 		auto shadowIndex = light.ShadowIndex;
 		auto& shadowMap = _shadowTextures[shadowIndex - 1];
 		if (!shadowMap || shadowMap->GetTarget() != GL_TEXTURE_2D)
@@ -174,8 +186,13 @@ namespace Drawing
 		std::array<GLuint, CascadeCount> cascadeMapSizes = { mapSize, mapSize, mapSize / 2 };
 
 
+		static constexpr std::array<const char*, 3> cascadeZones = { "Sun Cascade 0", "Sun Cascade 1", "Sun Cascade 2" };
+		static_assert(cascadeZones.size() == CascadeCount, "Every cascade needs a zone name");
+
 		for (size_t i = 0; i < CascadeCount; ++i)
 		{
+			TRACE_PUSH_DYNAMIC(cascadeZones[i]);
+			GPU_PUSH_DYNAMIC(cascadeZones[i]);
 			auto size = cascadeMapSizes[i];
 			auto& shadowMap = _shadowCascadeTextures[i];
 			if (shadowMap.GetTarget() != GL_TEXTURE_2D)
@@ -226,10 +243,9 @@ namespace Drawing
 			float minZ = std::numeric_limits<float>::max();
 			float maxZ = std::numeric_limits<float>::min();
 
-			for (auto& corner : corners)
+			Matrixy4x4::TransformBatch(lightView, corners.data(), corners.data(), corners.size());
+			for (auto& realCorner : corners)
 			{
-				auto realCorner = lightView.Transform(corner);
-
 				minX = std::min(minX, realCorner.x);
 				maxX = std::max(maxX, realCorner.x);
 				minY = std::min(minY, realCorner.y);
@@ -256,11 +272,15 @@ namespace Drawing
 			_shadowCascadeMatrices[i] = cascadeViewProj;
 
 			DrawShadowGeometry(cascadeViewProj);
+			GPU_POP();
+			TRACE_POP();
 		}
 	}
 
 	void DrawCallRenderer::DrawShadows(Matrixy4x4 view, Matrixy4x4 proj)
 	{
+		PROFILE_PUSH_WITH(g_Engine->Resources.Profile, "Shadows");
+		GPU_PUSH("Shadows");
 		GLint viewport[4] = { 0, 0, 0, 0 };
 		glGetIntegerv(GL_VIEWPORT, viewport);
 		glBindFramebuffer(GL_FRAMEBUFFER, _shadowFBO.Get());
@@ -310,6 +330,8 @@ namespace Drawing
 		glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
 		glBindFramebuffer(GL_FRAMEBUFFER, 0);
 		glClear(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
+		GPU_POP();
+		PROFILE_POP_WITH(g_Engine->Resources.Profile);
 	}
 
 	void DrawCallRenderer::DrawShadowGeometry(Matrixy4x4 lightViewProj)
@@ -370,13 +392,16 @@ namespace Drawing
 				auto& world = *drawcall.matrix;
 
 				perObject.WorldViewProj = Matrixy4x4::MultiplyE(world, lightViewProj);
-				UpdateBuffer(_perObjectBuffer, &perObject, sizeof(DefaultPerObjectStruct), m_bufferUpdateMode);
+				StreamUniform(PerObjectBufBinding, _perObjectBuffer, &perObject, sizeof(DefaultPerObjectStruct), m_bufferUpdateMode);
 
 				program->BindVAO();
 
 				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, drawcall.geometry->GetStorage().Buffer->GetIBO().Get());
 
 				glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)offsetData.IndicesCount, GL_UNSIGNED_INT, (GLvoid*)(offsetData.IndexStart * sizeof(GLuint)), (GLint)offsetData.IndexOffset);
+				++_stats.ShadowDrawCalls;
+				_stats.ShadowIndices += offsetData.IndicesCount;
+				_stats.ShadowVertices += offsetData.VertexCount;
 
 				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
@@ -392,7 +417,9 @@ namespace Drawing
 		(void)frustum; // Frustum culling not done
 
 		PROFILE_PUSH_WITH(g_Engine->Resources.Profile, "Renv2");
+		GPU_PUSH("Renv2");
 
+		_stats = DrawStats{};
 		GLuint lastVertexBuffer = 0;
 
 		UpdateLights(View);
@@ -412,7 +439,8 @@ namespace Drawing
 
 		DrawShadows(View, Proj);
 
-		PROFILE_PUSH_WITH(g_Engine->Resources.Profile, "Executing Draw Calls");
+		PROFILE_PUSH_WITH(g_Engine->Resources.Profile, "Main Pass");
+		GPU_PUSH("Main Pass");
 		for (auto& program_calls_pair : m_DrawCallGroups)
 		{
 			auto& program = program_calls_pair.first.GetProgram();
@@ -468,6 +496,9 @@ namespace Drawing
 				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, drawcall.geometry->GetStorage().Buffer->GetIBO().Get());
 
 				glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)offsetData.IndicesCount, GL_UNSIGNED_INT, (GLvoid*)(offsetData.IndexStart * sizeof(GLuint)), (GLint)offsetData.IndexOffset);
+				++_stats.DrawCalls;
+				_stats.Indices += offsetData.IndicesCount;
+				_stats.Vertices += offsetData.VertexCount;
 
 				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
@@ -477,8 +508,10 @@ namespace Drawing
 
 		}
 
+		GPU_POP();
 		PROFILE_POP_WITH(g_Engine->Resources.Profile);
 		glDisable(GL_CULL_FACE);
+		GPU_POP();
 		PROFILE_POP_WITH(g_Engine->Resources.Profile);
 	}
 
@@ -543,7 +576,7 @@ namespace Drawing
 		data.WorldView = Matrixy4x4::Multiply(view, world);
 		data.WorldViewProj = Matrixy4x4::Multiply(proj, data.WorldView);
 
-		UpdateBuffer(_perObjectBuffer, &data, sizeof(DefaultPerObjectStruct), m_bufferUpdateMode);
+		StreamUniform(PerObjectBufBinding, _perObjectBuffer, &data, sizeof(DefaultPerObjectStruct), m_bufferUpdateMode);
 		
 		PROFILE_POP_WITH(g_Engine->Resources.Profile);
 		CHECK_GL_ERR("Post Updating Per Object");
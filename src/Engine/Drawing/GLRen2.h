@@ -24,6 +24,17 @@ namespace Drawing
 		Matrixy4x4 WorldViewProj;
 	};
 
+	// What the last call to DrawCallRenderer::Draw submitted, Indices counts every index drawn (3 per triangle)
+	struct DrawStats
+	{
+		size_t DrawCalls = 0;
+		size_t ShadowDrawCalls = 0;
+		size_t Indices = 0;
+		size_t ShadowIndices = 0;
+		size_t Vertices = 0; // Each draw's whole vertex range, so shared vertices are only counted once per draw
+		size_t ShadowVertices = 0;
+	};
+
 	class DrawCallRenderer : public IRen3Dv2
 	{
 	public:
@@ -50,6 +61,8 @@ namespace Drawing
 
 		BufferUpdateMode m_bufferUpdateMode = BufferUpdateMode::MAP_WITH_INVALIDATE;
 
+		DrawStats _stats;
+
 		void UpdateDrawCalls();
 
 		void UpdateLights(Matrixy4x4 view);
@@ -102,6 +115,8 @@ namespace Drawing
 
 		void Draw(Matrixy4x4 View, Matrixy4x4 Proj, Voxel::CameraFrustum frustum);
 
+		inline const DrawStats& GetLastDrawStats() const { return _stats; }
+
 		// Lights v
 		Light* GetLight(size_t index) override;
 		const Light* GetLight(size_t index) const override;
@@ -64,7 +64,8 @@ namespace Drawing
 			fromDesc.BinormalSize != to.BinormalSize ||
 			fromDesc.NormalSize != to.NormalSize ||
 			fromDesc.TangentSize != to.TangentSize ||
-			fromDesc.TexCoordSize != to.TexCoordSize)
+			fromDesc.TexCoordSize != to.TexCoordSize ||
+			fromDesc.LightSize != to.LightSize)
 		{
 			DWARNING("Attempting to convert geometry from incompatible geometry types!");
 			return data;
@@ -82,8 +83,9 @@ namespace Drawing
 		size_t FromNorOffset = 0;
 		size_t FromTanOffset = 0;
 		size_t FromTexOffset = 0;
+		size_t FromLightOffset = 0;
 
-		auto fromOffsetOfLam = [&FromPosOffset, &FromBinOffset, &FromNorOffset, &FromTanOffset, &FromTexOffset](const VertexComponent& comp) -> size_t& {
+		auto fromOffsetOfLam = [&FromPosOffset, &FromBinOffset, &FromNorOffset, &FromTanOffset, &FromTexOffset, &FromLightOffset](const VertexComponent& comp) -> size_t& {
 			switch (comp)
 			{
 			default:
@@ -92,6 +94,7 @@ namespace Drawing
 			case VertexComponent::NORMAL:	return FromNorOffset;
 			case VertexComponent::BINORMAL: return FromBinOffset;
 			case VertexComponent::TEXCOORD: return FromTexOffset;
+			case VertexComponent::LIGHT:	return FromLightOffset;
 			}
 		};
 
@@ -100,8 +103,9 @@ namespace Drawing
 		size_t ToNorOffset = 0;
 		size_t ToTanOffset = 0;
 		size_t ToTexOffset = 0;
+		size_t ToLightOffset = 0;
 
-		auto toOffsetOfLam = [&ToPosOffset, &ToBinOffset, &ToNorOffset, &ToTanOffset, &ToTexOffset](const VertexComponent& comp) -> size_t& {
+		auto toOffsetOfLam = [&ToPosOffset, &ToBinOffset, &ToNorOffset, &ToTanOffset, &ToTexOffset, &ToLightOffset](const VertexComponent& comp) -> size_t& {
 			switch (comp)
 			{
 			default:
@@ -110,11 +114,12 @@ namespace Drawing
 			case VertexComponent::NORMAL:	return ToNorOffset;
 			case VertexComponent::BINORMAL: return ToBinOffset;
 			case VertexComponent::TEXCOORD: return ToTexOffset;
+			case VertexComponent::LIGHT:	return ToLightOffset;
 			}
 		};
 
 		size_t runningOffset = 0;
-		for (size_t i = 1; i < 6; ++i)
+		for (size_t i = 1; i <= VertexComponents.size(); ++i)
 		{
 			for (auto& comp : VertexComponents)
 			{
@@ -127,7 +132,7 @@ namespace Drawing
 		}
 
 		runningOffset = 0;
-		for (size_t i = 1; i < 6; ++i)
+		for (size_t i = 1; i <= VertexComponents.size(); ++i)
 		{
 			for (auto& comp : VertexComponents)
 			{
@@ -172,6 +177,7 @@ namespace Drawing
 		size += Description.BinormalSize;
 		size += Description.TangentSize;
 		size += Description.TexCoordSize;
+		size += Description.LightSize;
 		return size;
 	}
 
@@ -13,9 +13,10 @@ namespace Drawing
 		NORMAL,
 		BINORMAL,
 		TEXCOORD,
+		LIGHT,
 	};
 
-	constexpr std::array<VertexComponent, 5> VertexComponents{ VertexComponent::POSITION, VertexComponent::TANGENT, VertexComponent::NORMAL, VertexComponent::BINORMAL, VertexComponent::TEXCOORD };
+	constexpr std::array<VertexComponent, 6> VertexComponents{ VertexComponent::POSITION, VertexComponent::TANGENT, VertexComponent::NORMAL, VertexComponent::BINORMAL, VertexComponent::TEXCOORD, VertexComponent::LIGHT };
 
 	inline constexpr bool IsVectorVertexComponent(VertexComponent comp)
 	{
@@ -39,6 +40,8 @@ namespace Drawing
 			return "Binormal";
 		case VertexComponent::TEXCOORD:
 			return "Texture Coords";
+		case VertexComponent::LIGHT:
+			return "Light";
 		}
 	}
 
@@ -55,11 +58,11 @@ namespace Drawing
 	/// </summary>
 	struct GeometryDescription
 	{
-		constexpr GeometryDescription() : PositionSize(0), PositionOrder(0), TangentSize(0), TangentOrder(0), NormalSize(0), NormalOrder(0), BinormalSize(0), BinormalOrder(0), TexCoordSize(0), TexCoordOrder(0) {}
-		constexpr GeometryDescription(size_t posS, size_t posO, size_t tanS, size_t tanO, size_t normS, size_t normO, size_t binormS, size_t binormO, size_t texS, size_t texO)
-			: PositionSize(posS), PositionOrder(posO), TangentSize(tanS), TangentOrder(tanO), NormalSize(normS), NormalOrder(normO), BinormalSize(binormS), BinormalOrder(binormO), TexCoordSize(texS), TexCoordOrder(texO) {}
+		constexpr GeometryDescription() : PositionSize(0), PositionOrder(0), TangentSize(0), TangentOrder(0), NormalSize(0), NormalOrder(0), BinormalSize(0), BinormalOrder(0), TexCoordSize(0), TexCoordOrder(0), LightSize(0), LightOrder(0) {}
+		constexpr GeometryDescription(size_t posS, size_t posO, size_t tanS, size_t tanO, size_t normS, size_t normO, size_t binormS, size_t binormO, size_t texS, size_t texO, size_t lightS = 0, size_t lightO = 0)
+			: PositionSize(posS), PositionOrder(posO), TangentSize(tanS), TangentOrder(tanO), NormalSize(normS), NormalOrder(normO), BinormalSize(binormS), BinormalOrder(binormO), TexCoordSize(texS), TexCoordOrder(texO), LightSize(lightS), LightOrder(lightO) {}
 
-		constexpr size_t GetVertexSize() const { return PositionSize + TangentSize + NormalSize + BinormalSize + TexCoordSize; };
+		constexpr size_t GetVertexSize() const { return PositionSize + TangentSize + NormalSize + BinormalSize + TexCoordSize + LightSize; };
 		constexpr size_t GetVertexByteSize() const { return GetVertexSize() * sizeof(float); }
 
 		size_t PositionSize;
@@ -72,6 +75,8 @@ namespace Drawing
 		size_t BinormalOrder;
 		size_t TexCoordSize; // Set to zero to ignore Texture Coordinates
 		size_t TexCoordOrder;
+		size_t LightSize; // Set to zero to ignore baked light values (used by voxel meshes)
+		size_t LightOrder;
 
 		inline constexpr operator bool() const { return PositionSize > 0; }
 
@@ -86,7 +91,9 @@ namespace Drawing
 				&& BinormalSize == other.BinormalSize
 				&& BinormalOrder == other.BinormalOrder
 				&& TexCoordSize == other.TexCoordSize
-				&& TexCoordOrder == other.TexCoordOrder;
+				&& TexCoordOrder == other.TexCoordOrder
+				&& LightSize == other.LightSize
+				&& LightOrder == other.LightOrder;
 		}
 
 		inline bool operator!=(const GeometryDescription& other) const { return !(*this == other); }
@@ -106,6 +113,8 @@ namespace Drawing
 				return BinormalSize;
 			case VertexComponent::TEXCOORD:
 				return TexCoordSize;
+			case VertexComponent::LIGHT:
+				return LightSize;
 			}
 		}
 		inline constexpr size_t OrderOfComponent(VertexComponent comp) const
@@ -123,6 +132,8 @@ namespace Drawing
 				return BinormalOrder;
 			case VertexComponent::TEXCOORD:
 				return TexCoordOrder;
+			case VertexComponent::LIGHT:
+				return LightOrder;
 			}
 		}
 
@@ -147,6 +158,9 @@ namespace Drawing
 			case VertexComponent::TEXCOORD:
 				order = TexCoordOrder;
 				break;
+			case VertexComponent::LIGHT:
+				order = LightOrder;
+				break;
 			}
 			size_t offset = 0;
 			for (size_t tgt = 1; tgt < order; ++tgt)
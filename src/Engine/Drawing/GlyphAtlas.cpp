@@ -0,0 +1,274 @@
+#include "GlyphAtlas.h"
+
+#include "Helpers/DebugHelper.h"
+
+#include <algorithm>
+
+namespace Drawing
+{
+	std::unordered_map<std::string, std::shared_ptr<GlyphAtlas>> GlyphAtlas::_atlases;
+
+	GlyphAtlas::GlyphAtlas(SDLW::FontDesc desc)
+		: _font(desc)
+		, _pixels(SDL_CreateRGBSurfaceWithFormat(0, InitialSize, InitialSize, 32, SDL_PIXELFORMAT_RGBA32))
+		, _texture()
+		, _dirty(true)
+		, _generation(0)
+		, _penX(0)
+		, _penY(0)
+		, _rowHeight(0)
+		, _lineSkip(0)
+		, _glyphs()
+	{
+		if (_pixels)
+		{
+			SDL_FillRect(_pixels.Get(), nullptr, SDL_MapRGBA(_pixels->format, 255, 255, 255, 0));
+			SDL_SetSurfaceBlendMode(_pixels.Get(), SDL_BLENDMODE_NONE);
+		}
+		if (_font)
+			_lineSkip = TTF_FontLineSkip(_font.GetFont());
+
+		// Rasterise the printable ASCII range up front, most text never needs anything else
+		for (uint32_t c = 32; c < 127; ++c)
+			GetGlyph(c);
+	}
+
+	std::shared_ptr<GlyphAtlas> GlyphAtlas::Get(const SDLW::Font& font)
+	{
+		auto desc = font.GetDesc();
+		auto key = desc.file + ':' + std::to_string(desc.size);
+
+		auto& existing = _atlases[key];
+		if (!existing)
+			existing = std::make_shared<GlyphAtlas>(desc);
+		return existing;
+	}
+
+	void GlyphAtlas::ReleaseUnused()
+	{
+		for (auto it = _atlases.begin(); it != _atlases.end(); )
+		{
+			if (it->second.use_count() <= 1)
+				it = _atlases.erase(it);
+			else
+				++it;
+		}
+	}
+
+	void GlyphAtlas::ReleaseAll()
+	{
+		for (auto& atlas : _atlases)
+		{
+			if (atlas.second.use_count() > 1)
+				DWARNING("Glyph atlas '" + atlas.first + "' is still in use after its renderer was destroyed");
+		}
+		_atlases.clear();
+	}
+
+	const GlyphInfo* GlyphAtlas::GetGlyph(uint32_t codepoint)
+	{
+		auto it = _glyphs.find(codepoint);
+		if (it != _glyphs.end())
+			return &it->second;
+		return Rasterise(codepoint);
+	}
+
+	const GlyphInfo* GlyphAtlas::Rasterise(uint32_t codepoint)
+	{
+		if (!IsValid() || codepoint > 0xFFFF)
+			return nullptr;
+
+		int minx, maxx, miny, maxy, advance;
+		if (TTF_GlyphMetrics(_font.GetFont(), (Uint16)codepoint, &minx, &maxx, &miny, &maxy, &advance) != 0)
+			return nullptr;
+
+		GlyphInfo info{ SDL_Rect{ 0, 0, 0, 0 }, (float)advance };
+
+		// Glyphs are rendered as whole cells (pen position to advance, full line height) so they can be placed without per-glyph offsets
+		SimpleSurface rendered = TTF_RenderGlyph_Blended(_font.GetFont(), (Uint16)codepoint, SDL_Color{ 255, 255, 255, 255 });
+		if (rendered)
+		{
+			SimpleSurface converted = SDL_ConvertSurfaceFormat(rendered.Get(), SDL_PIXELFORMAT_RGBA32, 0);
+			if (!converted)
+				return nullptr;
+
+			if (_penX + converted->w + Padding > _pixels->w)
+			{
+				_penX = 0;
+				_penY += _rowHeight + Padding;
+				_rowHeight = 0;
+			}
+			while (_penY + converted->h + Padding > _pixels->h || converted->w + Padding > _pixels->w)
+			{
+				if (!Grow())
+				{
+					DWARNING("Glyph atlas for '" + _font.GetDesc().file + "' is full");
+					return nullptr;
+				}
+			}
+
+			info.Rect = SDL_Rect{ _penX, _penY, converted->w, converted->h };
+			SDL_SetSurfaceBlendMode(converted.Get(), SDL_BLENDMODE_NONE);
+			SDL_BlitSurface(converted.Get(), nullptr, _pixels.Get(), &info.Rect);
+
+			_penX += converted->w + Padding;
+			_rowHeight = std::max(_rowHeight, converted->h);
+			_dirty = true;
+		}
+
+		return &(_glyphs[codepoint] = info);
+	}
+
+	bool GlyphAtlas::Grow()
+	{
+		// Alternate between doubling height and width, keeping the atlas roughly square
+		int width = _pixels->w, height = _pixels->h;
+		if (height > width)
+			width *= 2;
+		else
+			height *= 2;
+		if (width > MaxSize || height > MaxSize)
+			return false;
+
+		SimpleSurface grown = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+		if (!grown)
+			return false;
+		SDL_FillRect(grown.Get(), nullptr, SDL_MapRGBA(grown->format, 255, 255, 255, 0));
+		SDL_SetSurfaceBlendMode(grown.Get(), SDL_BLENDMODE_NONE);
+		SDL_BlitSurface(_pixels.Get(), nullptr, grown.Get(), nullptr);
+
+		// Glyph rects (in pixels) are unchanged, but every texture coordinate has to be worked out again
+		_pixels = std::move(grown);
+		_texture.Reset();
+		_dirty = true;
+		++_generation;
+		return true;
+	}
+
+	floaty2 GlyphAtlas::LayoutText(const std::string& text, floaty4 color, float wrapLength, std::vector<TextVertex>& out)
+	{
+		float lineSkip = (float)_lineSkip;
+		float x = 0.f, y = 0.f, width = 0.f;
+
+		// Where the current line could be broken (just after its last space), as an index into out and a pen position
+		size_t breakVertex = (size_t)-1;
+		float breakX = 0.f;
+
+		for (size_t i = 0; i < text.size(); )
+		{
+			auto codepoint = NextCodepoint(text, i);
+			if (codepoint == '\n')
+			{
+				width = std::max(width, x);
+				x = 0.f;
+				y += lineSkip;
+				breakVertex = (size_t)-1;
+				continue;
+			}
+
+			auto* glyph = GetGlyph(codepoint);
+			if (!glyph)
+				glyph = GetGlyph('?');
+			if (!glyph)
+				continue;
+
+			if (wrapLength > 0.f && x > 0.f && x + glyph->Advance > wrapLength && codepoint != ' ')
+			{
+				if (breakVertex != (size_t)-1)
+				{
+					// Move the partial word down onto the next line
+					width = std::max(width, breakX);
+					for (size_t v = breakVertex; v < out.size(); ++v)
+					{
+						out[v].Position.x -= breakX;
+						out[v].Position.y += lineSkip;
+					}
+					x -= breakX;
+				}
+				else
+				{
+					width = std::max(width, x);
+					x = 0.f;
+				}
+				y += lineSkip;
+				breakVertex = (size_t)-1;
+			}
+
+			if (glyph->Rect.w && glyph->Rect.h)
+			{
+				float atlasWidth = (float)_pixels->w, atlasHeight = (float)_pixels->h;
+				float u0 = (float)glyph->Rect.x / atlasWidth, u1 = (float)(glyph->Rect.x + glyph->Rect.w) / atlasWidth;
+				float v0 = (float)glyph->Rect.y / atlasHeight, v1 = (float)(glyph->Rect.y + glyph->Rect.h) / atlasHeight;
+				float x1 = x + (float)glyph->Rect.w, y1 = y + (float)glyph->Rect.h;
+
+				out.push_back(TextVertex{ { x, y }, { u0, v0 }, color });
+				out.push_back(TextVertex{ { x, y1 }, { u0, v1 }, color });
+				out.push_back(TextVertex{ { x1, y1 }, { u1, v1 }, color });
+				out.push_back(TextVertex{ { x1, y1 }, { u1, v1 }, color });
+				out.push_back(TextVertex{ { x1, y }, { u1, v0 }, color });
+				out.push_back(TextVertex{ { x, y }, { u0, v0 }, color });
+			}
+
+			x += glyph->Advance;
+			if (codepoint == ' ')
+			{
+				breakVertex = out.size();
+				breakX = x;
+			}
+		}
+
+		width = std::max(width, x);
+		return { width, y + lineSkip };
+	}
+
+	GLuint GlyphAtlas::GetTexture()
+	{
+		if (!_pixels)
+			return 0;
+
+		if (!_texture.Get())
+		{
+			GLuint tex = 0;
+			glCreateTextures(GL_TEXTURE_2D, 1, &tex);
+			glTextureStorage2D(tex, 1, GL_RGBA8, _pixels->w, _pixels->h);
+			glTextureParameteri(tex, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTextureParameteri(tex, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTextureParameteri(tex, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTextureParameteri(tex, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			_texture.Reset(tex);
+			_dirty = true;
+		}
+
+		if (_dirty)
+		{
+			glTextureSubImage2D(_texture.Get(), 0, 0, 0, _pixels->w, _pixels->h, GL_RGBA, GL_UNSIGNED_BYTE, _pixels->pixels);
+			CHECK_GL_ERR("Uploading glyph atlas");
+			_dirty = false;
+		}
+
+		return _texture.Get();
+	}
+
+	uint32_t NextCodepoint(const std::string& str, size_t& index)
+	{
+		constexpr uint32_t Replacement = 0xFFFD;
+		auto lead = (unsigned char)str[index++];
+		if (lead < 0x80)
+			return lead;
+
+		int extra;
+		uint32_t codepoint;
+		if ((lead & 0xE0) == 0xC0) { extra = 1; codepoint = lead & 0x1F; }
+		else if ((lead & 0xF0) == 0xE0) { extra = 2; codepoint = lead & 0x0F; }
+		else if ((lead & 0xF8) == 0xF0) { extra = 3; codepoint = lead & 0x07; }
+		else return Replacement;
+
+		for (int i = 0; i < extra; ++i)
+		{
+			if (index >= str.size() || ((unsigned char)str[index] & 0xC0) != 0x80)
+				return Replacement;
+			codepoint = (codepoint << 6) | ((unsigned char)str[index++] & 0x3F);
+		}
+		return codepoint;
+	}
+}
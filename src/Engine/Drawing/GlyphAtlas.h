@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Helpers/SDLHelper.h"
+#include "Helpers/VectorHelper.h"
+
+#include "Systems/SDLWrapping/SDLWrappers.h"
+#include "Drawing/Image.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+
+namespace Drawing
+{
+	// A vertex of a laid out glyph quad, positions are in pixels from the top left of the text
+	struct TextVertex
+	{
+		floaty2 Position;
+		floaty2 TexCoord;
+		floaty4 Color;
+	};
+
+	struct GlyphInfo
+	{
+		SDL_Rect Rect; // Where the glyph's cell is in the atlas, in pixels
+		float Advance;
+	};
+
+	/// <summary>
+	/// Every glyph of one font (at one size) rasterised once into a shared texture
+	/// </summary>
+	/// <remarks>
+	/// Glyphs are rasterised (white, with coverage in alpha) the first time they are laid out and packed into rows of the atlas.
+	/// When the atlas is full it doubles in size, which changes every texture coordinate, so text checks GetGeneration and lays itself out again when it changes.
+	/// Pixels are only uploaded to GL when GetTexture is called after new glyphs have been added.
+	/// Atlases stay cached after the last text using them goes away, so short lived text doesn't rasterise its font again each time,
+	/// until <see cref="ReleaseUnused"/> is called when fonts are resized or replaced, or <see cref="ReleaseAll"/> when the renderer is destroyed.
+	/// </remarks>
+	class GlyphAtlas
+	{
+		static std::unordered_map<std::string, std::shared_ptr<GlyphAtlas>> _atlases;
+
+		SDLW::Font _font; // The atlas' own copy, so resizing the configured font doesn't pull it out from under us
+		SimpleSurface _pixels;
+		GLImage _texture;
+		bool _dirty;
+		uint32_t _generation;
+
+		int _penX, _penY, _rowHeight;
+		int _lineSkip;
+
+		std::unordered_map<uint32_t, GlyphInfo> _glyphs;
+
+		const GlyphInfo* Rasterise(uint32_t codepoint);
+		bool Grow();
+
+	public:
+		static constexpr int InitialSize = 256;
+		static constexpr int MaxSize = 4096;
+		static constexpr int Padding = 1;
+
+		explicit GlyphAtlas(SDLW::FontDesc desc);
+
+		GlyphAtlas(const GlyphAtlas&) = delete;
+		GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+		// Returns the atlas for a font's file and size, creating it the first time
+		static std::shared_ptr<GlyphAtlas> Get(const SDLW::Font& font);
+		// Frees the cached atlases that no text is using
+		static void ReleaseUnused();
+		// Frees every cached atlas, must be called before the GL context is destroyed and TTF_Quit
+		static void ReleaseAll();
+
+		// Returns a glyph, rasterising it if it's the first time it has been used, or nullptr if the font can't render it
+		const GlyphInfo* GetGlyph(uint32_t codepoint);
+
+		/**
+		* Appends 6 vertices (2 triangles) per visible glyph of a UTF-8 string to out, wrapping lines (at spaces where possible) wider than wrapLength if it is positive.
+		* Returns the size of the laid out text in pixels.
+		*/
+		floaty2 LayoutText(const std::string& text, floaty4 color, float wrapLength, std::vector<TextVertex>& out);
+
+		// Uploads any glyphs added since the last call, must be called on the GL thread
+		GLuint GetTexture();
+
+		inline uint32_t GetGeneration() const { return _generation; }
+		inline int GetLineSkip() const { return _lineSkip; }
+		inline bool IsValid() const { return _font && _pixels; }
+	};
+
+	// Decodes the UTF-8 codepoint at index, advancing index past it. Invalid bytes decode as U+FFFD
+	uint32_t NextCodepoint(const std::string& str, size_t& index);
+}
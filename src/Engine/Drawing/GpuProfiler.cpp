@@ -0,0 +1,175 @@
+#include "GpuProfiler.h"
+
+#include <limits>
+
+namespace Drawing
+{
+	std::unique_ptr<GpuProfiler> GpuProfiler::_instance = nullptr;
+	GpuProfiler::Accessor GpuProfiler::Instance{};
+
+	constexpr uint32_t UnfinishedQuery = std::numeric_limits<uint32_t>::max();
+	constexpr GLsizei QueryAllocationSize = 64;
+
+	GpuProfiler::GpuProfiler()
+	{
+		CHECK_GL_ERR("Before creating GPU profiler");
+
+		if (!(GLEW_VERSION_3_3 || GLEW_ARB_timer_query))
+		{
+			DWARNING("Timer queries not supported, GPU zones will not be timed");
+			return;
+		}
+
+		GLint bits = 0;
+		glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &bits);
+		if (!bits)
+		{
+			DWARNING("Timestamp queries have no precision on this implementation, GPU zones will not be timed");
+			return;
+		}
+
+		_supported = true;
+		_track = Profiling::RegisterTrack("GPU");
+		Calibrate();
+
+		CHECK_GL_ERR("After creating GPU profiler");
+	}
+
+	GpuProfiler::~GpuProfiler()
+	{
+		for (auto& frame : _frames)
+		{
+			if (frame.Queries.size())
+				glDeleteQueries((GLsizei)frame.Queries.size(), frame.Queries.data());
+			frame.Queries.clear();
+		}
+	}
+
+	uint32_t GpuProfiler::WriteTimestamp(Frame& frame)
+	{
+		if (frame.UsedQueries == frame.Queries.size())
+		{
+			auto oldSize = frame.Queries.size();
+			frame.Queries.resize(oldSize + QueryAllocationSize);
+			glGenQueries(QueryAllocationSize, frame.Queries.data() + oldSize);
+		}
+
+		auto index = (uint32_t)frame.UsedQueries++;
+		glQueryCounter(frame.Queries[index], GL_TIMESTAMP);
+		return index;
+	}
+
+	void GpuProfiler::Calibrate()
+	{
+		GLint64 gpuNow = 0;
+		glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+		_clockOffset = (int64_t)Profiling::Now() - (int64_t)gpuNow;
+		_framesSinceCalibration = 0;
+	}
+
+	bool GpuProfiler::Resolve(Frame& frame)
+	{
+		if (!frame.UsedQueries)
+			return true;
+
+		// Queries finish in the order they were issued, so if the last is available they all are
+		GLint available = 0;
+		glGetQueryObjectiv(frame.Queries[frame.UsedQueries - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			return false;
+
+		_lastResults.clear();
+		for (auto& zone : frame.Zones)
+		{
+			if (zone.EndQuery == UnfinishedQuery)
+				continue;
+
+			GLuint64 begin = 0, end = 0;
+			glGetQueryObjectui64v(frame.Queries[zone.BeginQuery], GL_QUERY_RESULT, &begin);
+			glGetQueryObjectui64v(frame.Queries[zone.EndQuery], GL_QUERY_RESULT, &end);
+
+			auto toTrace = [&](GLuint64 gpuTime) { return (uint64_t)std::max<int64_t>((int64_t)gpuTime + _clockOffset, 0); };
+			_lastResults.push_back(Profiling::ZoneRecord{ zone.ID, zone.Depth, toTrace(begin), toTrace(std::max(begin, end)) });
+		}
+
+		Profiling::RecordZones(_track, _lastResults.data(), _lastResults.size());
+		return true;
+	}
+
+	void GpuProfiler::BeginZone(Profiling::ZoneID zone)
+	{
+		auto& frame = _frames[_frame];
+		if (!_supported || _overflow || _open.size() >= MaxDepth || frame.Zones.size() >= MaxZonesPerFrame)
+		{
+			++_overflow;
+			return;
+		}
+
+		_open.push_back((uint32_t)frame.Zones.size());
+		frame.Zones.push_back(Zone{ zone, (uint32_t)(_open.size() - 1), UnfinishedQuery, UnfinishedQuery });
+		frame.Zones.back().BeginQuery = WriteTimestamp(frame);
+	}
+
+	void GpuProfiler::EndZone()
+	{
+		if (_overflow)
+		{
+			--_overflow;
+			return;
+		}
+		if (_open.empty())
+			return;
+
+		auto& frame = _frames[_frame];
+		frame.Zones[_open.back()].EndQuery = WriteTimestamp(frame);
+		_open.pop_back();
+	}
+
+	void GpuProfiler::NextFrame()
+	{
+		if (!_supported)
+			return;
+
+		if (_open.size())
+			DWARNING("GPU zones were left open at the end of the frame, they will not be timed");
+		_open.clear();
+		_overflow = 0;
+
+		_frame = (_frame + 1) % FrameCount;
+		auto& frame = _frames[_frame];
+		if (!Resolve(frame))
+			++_droppedFrames;
+		frame.UsedQueries = 0;
+		frame.Zones.clear();
+
+		if (++_framesSinceCalibration >= CalibrationInterval)
+			Calibrate();
+	}
+
+	void GpuProfiler::InitializeGpuProfiler()
+	{
+		_instance = std::make_unique<GpuProfiler>();
+	}
+
+	void GpuProfiler::ReleaseGpuProfiler()
+	{
+		_instance = nullptr;
+	}
+
+	bool GpuProfiler::IsInitialized()
+	{
+		return _instance && _instance->IsValid();
+	}
+
+	void GpuBeginZone(Profiling::ZoneID zone)
+	{
+		if (GpuProfiler::IsInitialized())
+			GpuProfiler::Instance().BeginZone(zone);
+	}
+
+	void GpuEndZone()
+	{
+		if (GpuProfiler::IsInitialized())
+			GpuProfiler::Instance().EndZone();
+	}
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Helpers/GLHelper.h"
+#include "Helpers/TraceHelper.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#ifdef EC_TRACE
+#define GPU_PUSH(x) Drawing::GpuBeginZone(TRACE_ZONE_ID(x))
+// For names built at runtime, see TRACE_PUSH_DYNAMIC
+#define GPU_PUSH_DYNAMIC(x) Drawing::GpuBeginZone(Profiling::RegisterZone(x))
+#define GPU_POP() Drawing::GpuEndZone()
+#define GPU_ZONE(x) Drawing::ScopedGpuZone TRACE_CONCAT(gpuZone_, __LINE__){ TRACE_ZONE_ID(x) }
+#else
+#define GPU_PUSH(x) ((int)0)
+#define GPU_PUSH_DYNAMIC(x) ((int)0)
+#define GPU_POP() ((int)0)
+#define GPU_ZONE(x) ((int)0)
+#endif // EC_TRACE
+
+namespace Drawing
+{
+	/// <summary>
+	/// Times GPU work with timestamp queries, so passes show what they cost to execute rather than what they cost to issue
+	/// </summary>
+	/// <remarks>
+	/// Each zone writes a GL_TIMESTAMP query when it begins and another when it ends, so zones can nest (GL_TIME_ELAPSED queries can't).
+	/// Queries are pooled per frame and FrameCount frames are kept in flight, a frame's results are only read back when its pool is about to be reused.
+	/// If they still aren't available then that frame's results are dropped rather than waiting on the GPU.
+	/// Resolved zones are converted to the trace clock and recorded on a "GPU" track, so they line up with the CPU zones of the same names.
+	/// </remarks>
+	class GpuProfiler
+	{
+		static std::unique_ptr<GpuProfiler> _instance;
+	public:
+		class Accessor
+		{
+		public:
+			inline GpuProfiler& operator()() const { return *_instance; }
+			inline operator GpuProfiler& () const { return *_instance; }
+		} static Instance;
+
+		static constexpr size_t FrameCount = 3;
+		// Zones past these in a frame aren't timed (but are still balanced)
+		static constexpr size_t MaxZonesPerFrame = 256;
+		static constexpr uint32_t MaxDepth = 32;
+		// Frames between re-measuring the offset from the GPU clock to the trace clock
+		static constexpr size_t CalibrationInterval = 300;
+
+	private:
+		struct Zone
+		{
+			Profiling::ZoneID ID;
+			uint32_t Depth;
+			uint32_t BeginQuery; // Indices into the frame's queries
+			uint32_t EndQuery;
+		};
+
+		struct Frame
+		{
+			std::vector<GLuint> Queries;
+			size_t UsedQueries = 0;
+			std::vector<Zone> Zones;
+		};
+
+		std::array<Frame, FrameCount> _frames;
+		size_t _frame = 0;
+		std::vector<uint32_t> _open; // Indices into the current frame's zones
+		uint32_t _overflow = 0;
+
+		bool _supported = false;
+		Profiling::TrackID _track = 0;
+		int64_t _clockOffset = 0; // Trace clock minus GPU clock, in nanoseconds
+		size_t _framesSinceCalibration = 0;
+		size_t _droppedFrames = 0;
+		std::vector<Profiling::ZoneRecord> _lastResults;
+
+		uint32_t WriteTimestamp(Frame& frame);
+		void Calibrate();
+		bool Resolve(Frame& frame);
+
+	public:
+		GpuProfiler();
+		~GpuProfiler();
+
+		GpuProfiler(const GpuProfiler&) = delete;
+		GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+		inline bool IsValid() const { return _supported; }
+
+		void BeginZone(Profiling::ZoneID zone);
+		void EndZone();
+
+		// Closes the current frame's queries, then reads back the oldest frame's if they're ready
+		// Must be called exactly once per frame, after all of the frame's draw calls have been issued
+		void NextFrame();
+
+		// The most recently resolved frame's zones, in the trace clock (so a few frames behind)
+		inline const std::vector<Profiling::ZoneRecord>& GetLastResults() const { return _lastResults; }
+		// Frames whose results weren't ready by the time their queries were needed again
+		inline size_t GetDroppedFrames() const { return _droppedFrames; }
+
+		static void InitializeGpuProfiler();
+		// Deletes the queries, must be called while the context is still current
+		static void ReleaseGpuProfiler();
+		static bool IsInitialized();
+	};
+
+	// Begin/end a zone on the GpuProfiler, if there is one
+	void GpuBeginZone(Profiling::ZoneID zone);
+	void GpuEndZone();
+
+	struct ScopedGpuZone
+	{
+		explicit ScopedGpuZone(Profiling::ZoneID zone) { GpuBeginZone(zone); }
+		~ScopedGpuZone() { GpuEndZone(); }
+
+		ScopedGpuZone(const ScopedGpuZone&) = delete;
+		ScopedGpuZone& operator=(const ScopedGpuZone&) = delete;
+	};
+}
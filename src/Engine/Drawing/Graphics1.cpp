@@ -81,45 +81,45 @@ void G1::IGSpace::PhysicsCull(std::vector<std::shared_ptr<btCollisionObject>>& o
 
 void G1::IGSpace::BeforeDrawShapes(IShape * shape)
 {
-	PROFILE_PUSH("Shape " + shape->GetName());
-	if (shape)
-	{
-		shape->BeforeDraw();
+	if (!shape)
+		return;
 
-		for (auto& child : shape->Children())
-		{
-			BeforeDrawShapes(child.get());
-		}
+	PROFILE_PUSH_CACHED(shape->TraceZone, "Shape " + shape->GetName());
+	shape->BeforeDraw();
+
+	for (auto& child : shape->Children())
+	{
+		BeforeDrawShapes(child.get());
 	}
 	PROFILE_POP();
 }
 
 void G1::IGSpace::DrawShapes(IShape *shape)
 {
-	PROFILE_PUSH("Draw " + shape->GetName());
-	if (shape)
-	{
-		shape->Draw();
+	if (!shape)
+		return;
 
-		for (auto &child : shape->Children())
-		{
-			DrawShapes(child.get());
-		}
+	PROFILE_PUSH_CACHED(shape->TraceDrawZone, "Draw " + shape->GetName());
+	shape->Draw();
+
+	for (auto &child : shape->Children())
+	{
+		DrawShapes(child.get());
 	}
 	PROFILE_POP();
 }
 
 void G1::IGSpace::AfterDrawShapes(IShape * shape)
 {
-	PROFILE_PUSH("Shape " + shape->GetName());
-	if (shape)
-	{
-		shape->AfterDraw();
+	if (!shape)
+		return;
 
-		for (auto& child : shape->Children())
-		{
-			AfterDrawShapes(child.get());
-		}
+	PROFILE_PUSH_CACHED(shape->TraceZone, "Shape " + shape->GetName());
+	shape->AfterDraw();
+
+	for (auto& child : shape->Children())
+	{
+		AfterDrawShapes(child.get());
 	}
 	PROFILE_POP();
 }
@@ -2,6 +2,7 @@
 
 #include "Helpers/TransferHelper.h"
 #include "Helpers/PointerHelper.h"
+#include "Helpers/TraceHelper.h"
 
 #include "Camera.h"
 #include "Systems/Events/EventsBase.h"
@@ -198,7 +199,11 @@ namespace G1
 
 		inline IGSpace *GetContainer() const { return Container; }
 		inline virtual std::string GetName() const { return Name; }
-		inline void SetName(const std::string& newname) { Name = newname; }
+		inline void SetName(const std::string& newname) { Name = newname; TraceZone.Reset(); TraceDrawZone.Reset(); }
+
+		// Profiler zones named after this shape, so its name is only looked up the first time it's drawn
+		Profiling::CachedZone TraceZone;
+		Profiling::CachedZone TraceDrawZone;
 	};
 	
 
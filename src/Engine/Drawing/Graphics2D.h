@@ -18,6 +18,7 @@
 #include <array>
 
 struct IRen2D;
+struct TextDrawing;
 
 struct ScissorThingo
 {
@@ -82,6 +83,20 @@ struct IRen2D
 	/// <param name="target">The target Rectangle to fit the image into</param>
 	virtual void DrawImage(Drawing::SDLImage *im, PointRect src, PointRect target) = 0;
 
+	/// Draw laid out text, its box (GetWidth by GetHeight pixels) is stretched to fit the target Rect (will be transformed)
+	virtual void DrawText(TextDrawing *text, PointRect target) = 0;
+	/// Draw text at its natural size with its bottom left at target, the same as DrawImage
+	virtual void DrawText(TextDrawing *text, floaty2 target) = 0;
+
+	/// Between BeginBatch and EndBatch, filled shapes, images and text are collected and drawn together (sorted by layer, then texture) at EndBatch
+	/// Anything that can't be batched (lines, outlines) flushes what has been collected so far and is drawn straight away
+	virtual void BeginBatch() = 0;
+	virtual void EndBatch() = 0;
+	/// Higher layers draw over lower ones, primitives in the same layer keep their order unless they are at the same position in it (see Drawing::Batch2D)
+	virtual void SetBatchLayer(unsigned int layer) = 0;
+	virtual unsigned int GetBatchLayer() = 0;
+	virtual unsigned int GetTopBatchLayer() = 0;
+
 	// Set the transform matrix to be used for rendering
 	virtual void SetTransform(Matrixy2x3 trans) = 0;
 	virtual floaty2 Transform(floaty2 me) = 0;
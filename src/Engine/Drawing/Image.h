@@ -23,6 +23,15 @@ namespace Drawing
 
 	GLuint Create2DGLTexture(GLenum internalFormat, GLuint width, GLuint height, GLvoid* initialDat = nullptr, GLenum initialFormat = GL_RGBA, GLenum initialType = GL_FLOAT, GLenum minFilter = GL_NEAREST, GLenum maxFilter = GL_NEAREST);
 
+	// Number of levels in a full mip chain, down to 1x1
+	inline GLsizei GetMipLevelCount(GLsizei width, GLsizei height)
+	{
+		GLsizei levels = 1;
+		for (auto size = width > height ? width : height; size > 1; size /= 2)
+			++levels;
+		return levels;
+	}
+
 	/**
 	* Base class used for textures
 	*/
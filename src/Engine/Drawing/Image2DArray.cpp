@@ -1,5 +1,7 @@
 #include "Image2DArray.h"
 
+#include <cstring>
+
 namespace Drawing
 {
     SDL_Surface* Image2DArray::CreateSurface()
@@ -19,11 +21,25 @@ namespace Drawing
         }
     }
 
+    void Image2DArray::ReleaseCPU()
+    {
+        // The layer count is still needed, so the surfaces are freed but their slots kept
+        for (auto& surf : _cpuSurfaces)
+        {
+            SDL_FreeSurface(surf);
+            surf = nullptr;
+        }
+        _cpuReleased = true;
+    }
+
     Image2DArray::Image2DArray()
         : GLImage()
         , _cpuSurfaces()
         , _width(0)
         , _height(0)
+        , _releaseCPUAfterUpload(false)
+        , _cpuReleased(false)
+        , _mipsStale(false)
     {
     }
 
@@ -32,6 +48,9 @@ namespace Drawing
         , _cpuSurfaces(initialLayers, nullptr, std::allocator<SDL_Surface*>())
         , _width(width)
         , _height(height)
+        , _releaseCPUAfterUpload(false)
+        , _cpuReleased(false)
+        , _mipsStale(false)
     {
     }
 
@@ -40,6 +59,9 @@ namespace Drawing
         , _cpuSurfaces(std::move(surfaces))
         , _width(_cpuSurfaces.size() && _cpuSurfaces[0] ? _cpuSurfaces[0]->w : 0)
         , _height(_cpuSurfaces.size() && _cpuSurfaces[0] ? _cpuSurfaces[0]->h : 0)
+        , _releaseCPUAfterUpload(false)
+        , _cpuReleased(false)
+        , _mipsStale(false)
     {
         VerifySurfaceFormats();
     }
@@ -49,10 +71,14 @@ namespace Drawing
         , _cpuSurfaces(std::move(other._cpuSurfaces))
         , _width(other._width)
         , _height(other._height)
+        , _releaseCPUAfterUpload(other._releaseCPUAfterUpload)
+        , _cpuReleased(other._cpuReleased)
+        , _mipsStale(other._mipsStale)
     {
         other._tex = 0;
         other._width = 0;
         other._height = 0;
+        other._cpuReleased = false;
     }
 
     Image2DArray::~Image2DArray()
@@ -72,6 +98,7 @@ namespace Drawing
         _cpuSurfaces.clear();
         _width = 0;
         _height = 0;
+        _cpuReleased = false;
     }
 
     Image2DArray& Image2DArray::operator=(Image2DArray&& other)
@@ -83,10 +110,14 @@ namespace Drawing
         _tex = other._tex;
         _width = other._width;
         _height = other._height;
+        _releaseCPUAfterUpload = other._releaseCPUAfterUpload;
+        _cpuReleased = other._cpuReleased;
+        _mipsStale = other._mipsStale;
 
         other._tex = 0;
         other._width = 0;
         other._height = 0;
+        other._cpuReleased = false;
 
         return *this;
     }
@@ -102,6 +133,7 @@ namespace Drawing
             surf->h != _height)
             return;
 
+        EnsureCPU();
         if (!_cpuSurfaces[targetLayer])
         {
             _cpuSurfaces[targetLayer] = CreateSurface();
@@ -128,25 +160,66 @@ namespace Drawing
         if (src->w > _width || src->h > _height)
             return;
 
+        EnsureCPU();
         if (!_cpuSurfaces[targetLayer])
         {
             _cpuSurfaces[targetLayer] = CreateSurface();
         }
 		
-        SimpleSurface tmp = SDL_ConvertSurface(src, _cpuSurfaces[targetLayer]->format, 0);
-        SDL_BlitSurface(tmp.Get(), &srcRect, _cpuSurfaces[targetLayer], &dstRect);
+        // Sources already in the layer's format (eg. pre-converted on a loading thread) are blitted directly
+        SimpleSurface tmp;
+        if (src->format->format != _cpuSurfaces[targetLayer]->format->format)
+        {
+            tmp = SDL_ConvertSurface(src, _cpuSurfaces[targetLayer]->format, 0);
+            src = tmp.Get();
+        }
+        SDL_BlitSurface(src, &srcRect, _cpuSurfaces[targetLayer], &dstRect);
 
         if (HasLoadedGL())
         {
             glTextureSubImage3D(_tex, 0, 0, 0, targetLayer, _width, _height, 1, GL_RGBA, GL_UNSIGNED_BYTE, _cpuSurfaces[targetLayer]->pixels);
+            _mipsStale = true;
+        }
+    }
+
+    void Image2DArray::SetLayerPixels(const void* pixels, int targetLayer)
+    {
+        if (!pixels)
+            return;
+        if (targetLayer < 0 || targetLayer >= _cpuSurfaces.size())
+            return;
+
+        EnsureCPU();
+        if (!_cpuSurfaces[targetLayer])
+        {
+            _cpuSurfaces[targetLayer] = CreateSurface();
+        }
+
+        // RGBA32 surfaces have no row padding, so the layer can be copied in one go
+        auto* surface = _cpuSurfaces[targetLayer];
+        std::memcpy(surface->pixels, pixels, GetLayerByteSize());
+
+        if (HasLoadedGL())
+        {
+            glTextureSubImage3D(_tex, 0, 0, 0, targetLayer, _width, _height, 1, GL_RGBA, GL_UNSIGNED_BYTE, surface->pixels);
+            _mipsStale = true;
         }
     }
 
+    const void* Image2DArray::GetLayerPixels(int layer) const
+    {
+        if (layer < 0 || layer >= _cpuSurfaces.size() || !_cpuSurfaces[layer])
+            return nullptr;
+        return _cpuSurfaces[layer]->pixels;
+    }
+
     void Image2DArray::AddLayer()
     {
+        // The GL texture is re-created at the new size, so the existing layers must be on the CPU to be re-uploaded
         bool wasLoaded = HasLoadedGL();
         if (wasLoaded)
             UnLoadGL();
+        EnsureCPU();
 
         _cpuSurfaces.emplace_back(CreateSurface());
 
@@ -158,7 +231,28 @@ namespace Drawing
 
     void Image2DArray::EnsureCPU()
     {
-        // TODO: this
+        if (!_cpuReleased)
+            return;
+        _cpuReleased = false;
+
+        // Without a texture there is nothing to read back, the layers come back blank
+        bool readBack = HasLoadedGL();
+        auto layerSize = (GLsizei)GetLayerByteSize();
+        for (int i = 0; i < _cpuSurfaces.size(); ++i)
+        {
+            _cpuSurfaces[i] = CreateSurface();
+            if (readBack)
+                glGetTextureSubImage(_tex, 0, 0, 0, i, _width, _height, 1, GL_RGBA, GL_UNSIGNED_BYTE, layerSize, _cpuSurfaces[i]->pixels);
+        }
+        if (readBack)
+            CHECK_GL_ERR("Reading back Texture2DArray pixels");
+    }
+
+    void Image2DArray::SetReleaseCPUAfterUpload(bool release)
+    {
+        _releaseCPUAfterUpload = release;
+        if (release && HasLoadedGL() && !_cpuReleased)
+            ReleaseCPU();
     }
 
     void Image2DArray::LoadGL()
@@ -168,7 +262,7 @@ namespace Drawing
 
         glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &_tex);
 
-        glTextureStorage3D(_tex, 2, GL_RGBA8, _width, _height, (GLsizei)_cpuSurfaces.size());
+        glTextureStorage3D(_tex, GetMipLevelCount(_width, _height), GL_RGBA8, _width, _height, (GLsizei)_cpuSurfaces.size());
 
         glTextureParameteri(_tex, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTextureParameteri(_tex, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -179,6 +273,13 @@ namespace Drawing
 
         for (int i = 0; i < _cpuSurfaces.size(); ++i)
             glTextureSubImage3D(_tex, 0, 0, 0, i, _width, _height, 1, GL_RGBA, GL_UNSIGNED_BYTE, _cpuSurfaces[i] ? _cpuSurfaces[i]->pixels : nullptr);
+
+        if (_cpuSurfaces.size())
+            glGenerateTextureMipmap(_tex);
+        _mipsStale = false;
+
+        if (_releaseCPUAfterUpload)
+            ReleaseCPU();
     }
 
     void Image2DArray::UnLoadGL()
@@ -186,6 +287,9 @@ namespace Drawing
         if (!HasLoadedGL())
             return;
 
+        // Deleting the texture would otherwise lose the only copy
+        EnsureCPU();
+
         glDeleteTextures(1, &_tex);
 
         _tex = 0;
@@ -193,9 +297,14 @@ namespace Drawing
 
     void Image2DArray::GenerateMipmaps()
     {
-        LoadGL();
-        if (HasLoadedGL())
+        if (!HasLoadedGL())
+        {
+            LoadGL();
+            return;
+        }
+        if (_mipsStale)
             glGenerateTextureMipmap(_tex);
+        _mipsStale = false;
     }
 
     bool Image2DArray::HasLoadedGL()
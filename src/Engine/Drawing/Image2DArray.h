@@ -3,6 +3,7 @@
 * Contains the Image2DArray class.
 * 
 * The Image2DArray class is used to maintain a CPU and GPU copy of an OpenGL GL_TEXTURE_2D_ARRAY
+* The CPU copy can optionally be released once uploaded, see SetReleaseCPUAfterUpload
 * 
 */
 
@@ -28,8 +29,15 @@ namespace Drawing
 		GLsizei _width;
 		GLsizei _height;
 
+		// Whether LoadGL should free the CPU surfaces once uploaded, and whether it has (the GPU then holds the only copy)
+		bool _releaseCPUAfterUpload;
+		bool _cpuReleased;
+		// Set when a layer is uploaded after LoadGL, the mip chain is only regenerated once a batch of edits calls GenerateMipmaps
+		bool _mipsStale;
+
 		SDL_Surface* CreateSurface();
 		void VerifySurfaceFormats();
+		void ReleaseCPU();
 
 	public:
 		Image2DArray();
@@ -56,7 +64,7 @@ namespace Drawing
 		/**
 		* Copy pixels from a source SDL_Surface to a specified rect in a specified layer.
 		* Does nothing if specified rect is too large, out of bounds or 0 dimensions, or the specified layer is out of bounds.
-		* This will also update the OpenGL representation if it has been loaded
+		* This will also update the OpenGL representation (the top mip level only, see GenerateMipmaps) if it has been loaded
 		*/
 		void SetArea(SDL_Surface* src, SDL_Rect dstRect, int targetLayer);
 
@@ -72,6 +80,22 @@ namespace Drawing
 		*/
 		void SetArea(SDL_Surface* src, SDL_Rect srcRect, SDL_Rect dstRect, int targetLayer);
 
+		/**
+		* Copies tightly packed RGBA32 pixels (width * height * 4 bytes) into a specified layer.
+		* Does nothing if the layer is out of bounds. This will also update the OpenGL representation (the top mip level only, see GenerateMipmaps) if it has been loaded
+		*/
+		void SetLayerPixels(const void* pixels, int targetLayer);
+
+		/**
+		* Returns a layer's tightly packed RGBA32 CPU pixels, or nullptr if the layer is out of bounds or has no CPU pixels (including after they were released)
+		*/
+		const void* GetLayerPixels(int layer) const;
+
+		inline size_t GetLayerCount() const { return _cpuSurfaces.size(); }
+		inline GLsizei GetWidth() const { return _width; }
+		inline GLsizei GetHeight() const { return _height; }
+		inline size_t GetLayerByteSize() const { return (size_t)_width * (size_t)_height * 4; }
+
 		/**
 		* Adds a layer to the CPU image. Will re-create the OpenGL image if GL is loaded
 		*/
@@ -82,17 +106,30 @@ namespace Drawing
 		* Use in the case that the CPU copy of pixel data has been freed and you need it back from the GPU.
 		* Essentially just copies all GPU data into CPU memory.
 		* 
-		* Use before manipulating cpu textures if you know it only exists on the GPU
+		* Use before manipulating cpu textures if you know it only exists on the GPU.
+		* The setters (and AddLayer/UnLoadGL) call this themselves.
 		*/ 
 		void EnsureCPU();
 
 		/**
-		* Creates the GL_TEXTURE_2D_ARRAY texture and uploads the pixels.
+		* When enabled LoadGL frees the CPU surfaces once the texture (and its mip chain) is uploaded, so the pixels only live on the GPU.
+		* Edits afterwards read the pixels back with EnsureCPU first, which is slow, so only enable this for images that are uploaded once and left alone.
+		*/
+		void SetReleaseCPUAfterUpload(bool release);
+
+		inline bool HasCPUPixels() const { return !_cpuReleased; }
+
+		/**
+		* Creates the GL_TEXTURE_2D_ARRAY texture with a full mip chain, uploads the pixels and generates the mipmaps.
 		* Does nothing if OpenGL has already been loaded.
 		*/
 		void LoadGL() override;
 		void UnLoadGL();
 
+		/**
+		* Regenerates the mip chain from the top level if layers were uploaded since it was last generated.
+		* LoadGL already does this, so it is only needed once after a batch of edits to a loaded image.
+		*/
 		void GenerateMipmaps();
 
 		bool HasLoadedGL();
@@ -1,6 +1,8 @@
 #include "Particles.h"
 
 #include "Drawing/Image.h"
+#include "Drawing/StreamingBuffer.h"
+#include "Drawing/GpuProfiler.h"
 
 #include "Helpers/GLHelper.h"
 
@@ -48,6 +50,7 @@ namespace Particles
 		GLint GetTexScale();
 
 		GLBuffer CreateInstanceBuffer(size_t instancecount);
+		void BindInstanceAttributes(GLuint buffer, GLintptr offset);
 		GLBuffer CreateVertexBuffer();
 		GLBuffer CreateViewProjBuffer();
 		GLVertexArray CreateVertexArray();
@@ -92,23 +95,31 @@ namespace Particles
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
 
 		ViewProjBuffer viewproj = { View, Proj };
-		glBindBuffer(GL_UNIFORM_BUFFER, m_ViewProjBuffer.Get());
-		glBufferSubData(GL_UNIFORM_BUFFER, NULL, sizeof(ViewProjBuffer), (GLvoid *)&viewproj);
-		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		Drawing::StreamUniform(m_ViewProjLocation, m_ViewProjBuffer, &viewproj, sizeof(ViewProjBuffer), BufferUpdateMode::SUB_DATA);
 	}
 
 	void DrawGuy::Draw(std::shared_ptr<Drawing::SDLImage> texture, const std::vector<BasicParticle> &particles, size_t count)
 	{
 		if (!count)
 			return;
-		if (count > m_InstanceSize)
+
+		// Particles change every frame, so prefer writing them straight into the streaming buffer over a glBufferSubData copy
+		if (auto alloc = Drawing::StreamData(particles.data(), (GLsizeiptr)(sizeof(BasicParticle) * count), alignof(BasicParticle)))
 		{
-			m_InstanceBuffer = CreateInstanceBuffer(particles.size());
+			BindInstanceAttributes(alloc.Buffer, alloc.Offset);
 		}
+		else
+		{
+			if (count > m_InstanceSize)
+			{
+				m_InstanceBuffer = CreateInstanceBuffer(particles.size());
+			}
 
-		glBindBuffer(GL_ARRAY_BUFFER, m_InstanceBuffer.Get());
-		glBufferSubData(GL_ARRAY_BUFFER, NULL, sizeof(BasicParticle) * count, (GLvoid *)particles.data());
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+			glBindBuffer(GL_ARRAY_BUFFER, m_InstanceBuffer.Get());
+			glBufferSubData(GL_ARRAY_BUFFER, NULL, sizeof(BasicParticle) * count, (GLvoid *)particles.data());
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			BindInstanceAttributes(m_InstanceBuffer.Get(), 0);
+		}
 
 		if (texture)
 		{
@@ -159,19 +170,24 @@ namespace Particles
 
 		glBindBuffer(GL_ARRAY_BUFFER, out);
 		glBufferData(GL_ARRAY_BUFFER, sizeof(BasicParticle) * instancecount, NULL, GL_STREAM_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-		glBindBuffer(GL_ARRAY_BUFFER, out);
+		BindInstanceAttributes(out, 0);
+
+		return out;
+	}
+	void DrawGuy::BindInstanceAttributes(GLuint buffer, GLintptr offset)
+	{
 		glBindVertexArray(m_VAO.Get());
+		glBindBuffer(GL_ARRAY_BUFFER, buffer);
 		glEnableVertexAttribArray(2);
-		glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(floaty3), (GLvoid *)offsetof(BasicParticle, BasicParticle::Position));
+		glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(BasicParticle), (GLvoid *)(offset + offsetof(BasicParticle, BasicParticle::Position)));
 		glVertexAttribDivisor(2, 1);
 		glEnableVertexAttribArray(3);
-		glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(floaty4), (GLvoid *)offsetof(BasicParticle, BasicParticle::Color));
+		glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(BasicParticle), (GLvoid *)(offset + offsetof(BasicParticle, BasicParticle::Color)));
 		glVertexAttribDivisor(3, 1);
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
 		glBindVertexArray(0);
-
-		return out;
 	}
 	GLBuffer DrawGuy::CreateVertexBuffer()
 	{
@@ -684,6 +700,8 @@ std::vector<const Particles::BasicParticle *> Particles::ParticleManager::GetExt
 
 void Particles::ParticleManager::DrawParticles()
 {
+	TRACE_ZONE("Particles");
+	GPU_ZONE("Particles");
 	for (auto &pool : m_VelocityParticles.m_Pools)
 		m_DrawGuy->Draw(pool.first, pool.second.m_ParticlesDraw, pool.second.m_ActiveCount);
 
@@ -13,6 +13,7 @@
 
 #include "GLRen2.h"
 #include "BindingManager.h"
+#include "StreamingBuffer.h"
 
 namespace Drawing
 {
@@ -243,6 +244,7 @@ namespace Drawing
 					getCompOrderSize(geo[TangentTag], geoDesc.TangentOrder, geoDesc.TangentSize, "tangent");
 					getCompOrderSize(geo[NormalTag], geoDesc.NormalOrder, geoDesc.NormalSize, "normal");
 					getCompOrderSize(geo[TexCoordTag], geoDesc.TexCoordOrder, geoDesc.TexCoordSize, "tex coords");
+					getCompOrderSize(geo[LightTag], geoDesc.LightOrder, geoDesc.LightSize, "light");
 
 					desc.InputDesc = geoDesc;
 
@@ -853,7 +855,7 @@ namespace Drawing
 
 		const auto& bytes = material.ToByteForm();
 
-		UpdateBuffer(_matBuffer, (void*)bytes.data(), bytes.size(), updateMode);
+		StreamUniform(_matBufBinding, _matBuffer, bytes.data(), (GLsizeiptr)bytes.size(), updateMode);
 	}
 
 	void Program::SetShadowMatrices(const std::vector<Matrixy4x4>& matrices, ShadowCascadeBuffer cascadeBuffer, BufferUpdateMode updateMode)
@@ -861,7 +863,7 @@ namespace Drawing
 		if (!_shadowMatrixBuffer || !_shadowCascadeBuffer)
 			return;
 
-		UpdateBuffer(_shadowMatrixBuffer, (void*)matrices.data(), matrices.size() * sizeof(Matrixy4x4), updateMode);
-		UpdateBuffer(_shadowCascadeBuffer, (void*)&cascadeBuffer, sizeof(ShadowCascadeBuffer), updateMode);
+		StreamUniform(_shadowMatrixBinding, _shadowMatrixBuffer, matrices.data(), (GLsizeiptr)(matrices.size() * sizeof(Matrixy4x4)), updateMode);
+		StreamUniform(_shadowCascadeBinding, _shadowCascadeBuffer, &cascadeBuffer, sizeof(ShadowCascadeBuffer), updateMode);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,217 @@
+#include "StreamingBuffer.h"
+
+#include <cstring>
+#include <algorithm>
+
+namespace Drawing
+{
+	std::unique_ptr<StreamingBuffer> StreamingBuffer::_instance = nullptr;
+	StreamingBuffer::Accessor StreamingBuffer::Instance{};
+
+	constexpr GLbitfield StreamingBufferFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	inline GLsizeiptr AlignUp(GLsizeiptr value, GLsizeiptr alignment)
+	{
+		if (alignment <= 1)
+			return value;
+		return ((value + alignment - 1) / alignment) * alignment;
+	}
+
+	void StreamingBuffer::Create(GLsizeiptr regionSize)
+	{
+		CHECK_GL_ERR("Before creating streaming buffer");
+
+		if (!(GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage))
+		{
+			DWARNING("Persistent buffer mapping not supported, dynamic buffers will not be streamed");
+			return;
+		}
+		// The ring is created, mapped and unmapped through the named (DSA) buffer functions
+		if (!(GLEW_VERSION_4_5 || GLEW_ARB_direct_state_access))
+		{
+			DWARNING("Direct state access not supported, dynamic buffers will not be streamed");
+			return;
+		}
+
+		GLuint buf = 0;
+		glCreateBuffers(1, &buf);
+		glNamedBufferStorage(buf, regionSize * (GLsizeiptr)RegionCount, nullptr, StreamingBufferFlags);
+		auto mapped = glMapNamedBufferRange(buf, 0, regionSize * (GLsizeiptr)RegionCount, StreamingBufferFlags);
+		if (!mapped)
+		{
+			DERROR("Failed to persistently map streaming buffer, OpenGL Error: " + GET_GL_ERR);
+			glDeleteBuffers(1, &buf);
+			return;
+		}
+
+		_buffer.Reset(buf);
+		_mapped = static_cast<unsigned char*>(mapped);
+		_regionSize = regionSize;
+		_head = 0;
+		_region = 0;
+		_fences.fill(nullptr);
+
+		CHECK_GL_ERR("After creating streaming buffer");
+	}
+
+	void StreamingBuffer::Destroy()
+	{
+		for (auto& fence : _fences)
+		{
+			if (fence)
+				glDeleteSync(fence);
+			fence = nullptr;
+		}
+
+		if (_mapped)
+			glUnmapNamedBuffer(_buffer.Get());
+		_mapped = nullptr;
+		_buffer.Reset();
+		_regionSize = 0;
+		_head = 0;
+	}
+
+	void StreamingBuffer::WaitForRegion(size_t region)
+	{
+		auto& fence = _fences[region];
+		if (!fence)
+			return;
+
+		GLbitfield flags = 0;
+		while (true)
+		{
+			auto result = glClientWaitSync(fence, flags, 1000000); // 1ms
+			if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)
+				break;
+			if (result == GL_WAIT_FAILED)
+			{
+				DERROR("Waiting on streaming buffer fence failed!");
+				break;
+			}
+			flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+		}
+
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+
+	StreamingBuffer::StreamingBuffer(GLsizeiptr regionSize)
+	{
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &_uniformAlignment);
+		if (_uniformAlignment < 1)
+			_uniformAlignment = 256;
+
+		Create(regionSize);
+	}
+
+	StreamingBuffer::~StreamingBuffer()
+	{
+		Destroy();
+	}
+
+	StreamAllocation StreamingBuffer::Allocate(GLsizeiptr size, GLsizeiptr alignment)
+	{
+		if (!_mapped || size <= 0)
+			return {};
+
+		auto offset = AlignUp(_head, alignment);
+		if (offset + size > _regionSize)
+		{
+			// Remember how much this frame wanted so NextFrame can grow the buffer
+			_requestedRegionSize = std::max(_requestedRegionSize, offset + size);
+			return {};
+		}
+
+		_head = offset + size;
+
+		StreamAllocation out;
+		out.Buffer = _buffer.Get();
+		out.Offset = (GLintptr)(_region * _regionSize + offset);
+		out.Data = _mapped + out.Offset;
+		out.Size = size;
+		return out;
+	}
+
+	StreamAllocation StreamingBuffer::Write(const void* data, GLsizeiptr size, GLsizeiptr alignment)
+	{
+		auto alloc = Allocate(size, alignment);
+		if (alloc)
+			std::memcpy(alloc.Data, data, (size_t)size);
+		return alloc;
+	}
+
+	bool StreamingBuffer::BindUniform(GLuint binding, const void* data, GLsizeiptr size)
+	{
+		auto alloc = Write(data, size, _uniformAlignment);
+		if (!alloc)
+			return false;
+
+		glBindBufferRange(GL_UNIFORM_BUFFER, binding, alloc.Buffer, alloc.Offset, alloc.Size);
+		return true;
+	}
+
+	void StreamingBuffer::NextFrame()
+	{
+		if (!_mapped)
+			return;
+
+		_fences[_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+		if (_requestedRegionSize > _regionSize && _regionSize < MaxRegionSize)
+		{
+			auto newSize = _regionSize;
+			while (newSize < _requestedRegionSize && newSize < MaxRegionSize)
+				newSize *= 2;
+			newSize = std::min(newSize, MaxRegionSize);
+
+			DINFO("Growing streaming buffer regions from " + std::to_string(_regionSize) + " to " + std::to_string(newSize) + " bytes");
+
+			for (size_t i = 0; i < RegionCount; ++i)
+				WaitForRegion(i);
+			Destroy();
+			Create(newSize);
+			_requestedRegionSize = 0;
+			return;
+		}
+		_requestedRegionSize = 0;
+
+		_region = (_region + 1) % RegionCount;
+		_head = 0;
+		WaitForRegion(_region);
+	}
+
+	void StreamingBuffer::InitializeStreamingBuffer(GLsizeiptr regionSize)
+	{
+		_instance = std::make_unique<StreamingBuffer>(regionSize);
+	}
+
+	void StreamingBuffer::ReleaseStreamingBuffer()
+	{
+		_instance = nullptr;
+	}
+
+	bool StreamingBuffer::IsInitialized()
+	{
+		return _instance && _instance->IsValid();
+	}
+
+	void StreamUniform(GLuint binding, const GLBuffer& fallback, const void* data, GLsizeiptr size, BufferUpdateMode fallbackMode)
+	{
+		if (StreamingBuffer::IsInitialized() && StreamingBuffer::Instance().BindUniform(binding, data, size))
+			return;
+
+		if (!fallback)
+			return;
+
+		glBindBufferBase(GL_UNIFORM_BUFFER, binding, fallback.Get());
+		UpdateBuffer(fallback, const_cast<void*>(data), (GLuint)size, fallbackMode);
+	}
+
+	StreamAllocation StreamData(const void* data, GLsizeiptr size, GLsizeiptr alignment)
+	{
+		if (!StreamingBuffer::IsInitialized())
+			return {};
+
+		return StreamingBuffer::Instance().Write(data, size, alignment);
+	}
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Helpers/GLHelper.h"
+
+#include <array>
+#include <memory>
+
+namespace Drawing
+{
+	// A region of the streaming buffer handed out for this frame
+	// Data is a persistently mapped (coherent) pointer, writes to it are visible to the GPU without flushing
+	struct StreamAllocation
+	{
+		void* Data = nullptr;
+		GLuint Buffer = 0;
+		GLintptr Offset = 0;
+		GLsizeiptr Size = 0;
+
+		inline explicit operator bool() const { return Data; }
+	};
+
+	/// <summary>
+	/// Triple buffered ring of persistently mapped memory used for all per-frame dynamic data (uniforms, instance data, staging uploads)
+	/// </summary>
+	/// <remarks>
+	/// The buffer is split into RegionCount regions, one per frame in flight.
+	/// Each frame allocates linearly out of the current region, at the end of the frame (see <see cref="NextFrame"/>) a fence is placed for that region and the next region is waited on before it is reused.
+	/// If a region runs out of space the allocation fails (returns an empty allocation) and the caller is expected to fall back to a regular buffer update.
+	/// The next call to NextFrame will then grow the buffer so the following frames fit.
+	/// </remarks>
+	class StreamingBuffer
+	{
+		static std::unique_ptr<StreamingBuffer> _instance;
+	public:
+		class Accessor
+		{
+		public:
+			inline StreamingBuffer& operator()() const { return *_instance; }
+			inline operator StreamingBuffer& () const { return *_instance; }
+		} static Instance;
+
+		static constexpr size_t RegionCount = 3;
+		static constexpr GLsizeiptr DefaultRegionSize = 8 * 1024 * 1024;
+		static constexpr GLsizeiptr MaxRegionSize = 64 * 1024 * 1024;
+
+	private:
+		GLBuffer _buffer;
+		unsigned char* _mapped = nullptr;
+		GLsizeiptr _regionSize = 0;
+		GLsizeiptr _head = 0;
+		GLsizeiptr _requestedRegionSize = 0;
+		size_t _region = 0;
+		std::array<GLsync, RegionCount> _fences{};
+		GLint _uniformAlignment = 256;
+
+		void Create(GLsizeiptr regionSize);
+		void Destroy();
+		void WaitForRegion(size_t region);
+
+	public:
+		StreamingBuffer(GLsizeiptr regionSize = DefaultRegionSize);
+		~StreamingBuffer();
+
+		StreamingBuffer(const StreamingBuffer&) = delete;
+		StreamingBuffer& operator=(const StreamingBuffer&) = delete;
+
+		inline bool IsValid() const { return _mapped; }
+		inline GLuint GetBuffer() const { return _buffer.Get(); }
+		inline GLint GetUniformAlignment() const { return _uniformAlignment; }
+
+		// Reserves size bytes in the current frame's region, returns an empty allocation if the region is full
+		StreamAllocation Allocate(GLsizeiptr size, GLsizeiptr alignment = 16);
+
+		// Allocates and copies data in
+		StreamAllocation Write(const void* data, GLsizeiptr size, GLsizeiptr alignment = 16);
+
+		// Writes data aligned for use as a uniform block and binds it with glBindBufferRange
+		bool BindUniform(GLuint binding, const void* data, GLsizeiptr size);
+
+		// Fences the current region, then advances to (and waits for) the next one
+		// Must be called exactly once per frame, after all of the frame's draw calls have been issued
+		void NextFrame();
+
+		static void InitializeStreamingBuffer(GLsizeiptr regionSize = DefaultRegionSize);
+		// Unmaps and deletes the buffer, must be called while the context is still current
+		static void ReleaseStreamingBuffer();
+		static bool IsInitialized();
+	};
+
+	// Streams a uniform block through the StreamingBuffer if possible
+	// Otherwise rebinds the fallback buffer to the binding and updates it with the given mode
+	void StreamUniform(GLuint binding, const GLBuffer& fallback, const void* data, GLsizeiptr size, BufferUpdateMode fallbackMode);
+
+	// Streams data into a new allocation, or returns an empty allocation if there is no StreamingBuffer or it is full
+	StreamAllocation StreamData(const void* data, GLsizeiptr size, GLsizeiptr alignment = 16);
+}
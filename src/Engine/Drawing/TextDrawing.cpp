@@ -9,18 +9,31 @@ void TextDrawing::Update() noexcept
 	SDLW::Font *font = mResources->UIConfig->GetTextFormat(FontName);	
 	if (font && font->GetFont())
 	{
-		Destroy();
+		Atlas = Drawing::GlyphAtlas::Get(*font);
+	}
+	else
+	{
+		Atlas = nullptr;
+	}
 
-		SimpleSurface text = TTF_RenderUTF8_Blended_Wrapped(font->GetFont(), Text.c_str(), (SDL_Color)Color, (Uint32)*mResources->WindowWidth);
+	Vertices.clear();
+	Size = { 0.f, 0.f };
+	if (!Atlas || !Atlas->IsValid())
+		return;
 
-		if (!text)
-		{
-			DERROR("Creating new Text Texture failed with: " + TTF_GetError());
-			return;
-		}
+	auto color = (SDL_Color)Color;
+	floaty4 color4{ (float)color.r / 255.f, (float)color.g / 255.f, (float)color.b / 255.f, (float)color.a / 255.f };
 
-		Reset(text.Release());
-	}
+	Size = Atlas->LayoutText(Text, color4, (float)*mResources->WindowWidth, Vertices);
+	// The layout may have added glyphs, growing the atlas, so the generation is read afterwards
+	AtlasGeneration = Atlas->GetGeneration();
+}
+
+const std::vector<Drawing::TextVertex>& TextDrawing::GetVertices()
+{
+	if (Atlas && Atlas->GetGeneration() != AtlasGeneration)
+		Update();
+	return Vertices;
 }
 
 floaty2 CharacterPosition(const SDLW::Font& font, std::string text, size_t index, float linespacing, float wraplength)
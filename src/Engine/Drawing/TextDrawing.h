@@ -4,28 +4,54 @@
 #include "Helpers/SDLHelper.h"
 
 #include "Systems/SDLWrapping/SDLWrappers.h"
-#include "Drawing/Image.h"
+#include "Systems/Execution/ResourceHolder.h"
+#include "Drawing/GlyphAtlas.h"
 #include "Math/floaty.h"
 
-struct TextDrawing : Drawing::SDLImage
+#include <memory>
+#include <vector>
+#include <cmath>
+
+/**
+* A string of text laid out as quads over a GlyphAtlas of its font.
+* Changing the text, colour or font only rewrites the vertices, glyphs are rasterised once per font and size (the first time they are used).
+* Draw with IRen2D::DrawText.
+*/
+struct TextDrawing : FullResourceHolder
 {
-	TextDrawing(CommonResources *resources, Stringy text, Stringy fontrefname, ConfigColorTemp color) : SDLImage({ resources, fontrefname + ':' + text }), Text(std::move(text)), Color(color(resources)), FontName(std::move(fontrefname)) { Update(); }
+	TextDrawing(CommonResources *resources, Stringy text, Stringy fontrefname, ConfigColorTemp color) : FullResourceHolder(resources), FontName(std::move(fontrefname)), Text(std::move(text)), Color(color(resources)) { Update(); }
 	~TextDrawing() {}
 	
 	void Update() noexcept;
 	inline void SetFontName(Stringy fontname) { FontName = std::move(fontname); Update(); }
 	inline void SetColor(SDL_Color color) { Color = color; Update(); }
 	inline void SetColor(Stringy colorname) { Color = std::move(colorname); Update(); }
-	inline void SetText(Stringy text) { Text = std::move(text); Update(); }
+	inline void SetText(Stringy text) { if (text == Text) return; Text = std::move(text); Update(); }
 	inline void SetColor(ConfigColor color) { Color = color; Update(); }
 
 	inline const Stringy& GetText() const noexcept { return Text; }
 
+	// Size of the laid out text in pixels
+	inline int GetWidth() const noexcept { return (int)std::ceil(Size.x); }
+	inline int GetHeight() const noexcept { return (int)std::ceil(Size.y); }
+	inline floaty2 GetSize() const noexcept { return Size; }
+
+	inline bool CanDraw() const noexcept { return Atlas && Vertices.size(); }
+
+	// Glyph quads (6 vertices each) with positions in pixels from the top left, laid out again first if the atlas has been resized since
+	const std::vector<Drawing::TextVertex>& GetVertices();
+	inline const std::shared_ptr<Drawing::GlyphAtlas>& GetAtlas() const noexcept { return Atlas; }
+
 protected:
 	Stringy FontName;
 	Stringy Text;
 	ConfigColor Color;
 	bool NeedUpdate{ false };
+
+	std::shared_ptr<Drawing::GlyphAtlas> Atlas;
+	std::vector<Drawing::TextVertex> Vertices;
+	uint32_t AtlasGeneration{ 0 };
+	floaty2 Size{ 0.f, 0.f };
 };
 
-floaty2 CharacterPosition(const SDLW::Font& font, std::string string, size_t index, float linespacing = 0.f, float wraplength = 0.f);
\ No newline at end of file
+floaty2 CharacterPosition(const SDLW::Font& font, std::string string, size_t index, float linespacing = 0.f, float wraplength = 0.f);
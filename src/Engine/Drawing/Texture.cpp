@@ -1,14 +1,102 @@
 #include "Texture.h"
 
 #include "Drawing/VoxelStore.h"
+#include "Drawing/StreamingBuffer.h"
+
+#include "Systems/Threading/ThreadPool.h"
 
 #include <filesystem>
 #include <string>
 #include <array>
 #include <algorithm>
+#include <thread>
 
 namespace Drawing
 {
+	StreamedImage::StreamedImage(std::string filename)
+		: GLImage(0, GL_TEXTURE_2D)
+		, _filename(std::move(filename))
+		, _state(State::UNREQUESTED)
+		, _surface()
+		, _isPlaceholder(false)
+		, _prioritised(false)
+	{
+	}
+
+	StreamedImage::~StreamedImage()
+	{
+		// GLImage's destructor would otherwise delete the placeholder
+		Destroy();
+	}
+
+	void StreamedImage::Destroy()
+	{
+		if (_isPlaceholder)
+			_tex = 0;
+		_isPlaceholder = false;
+		GLImage::Destroy();
+	}
+
+	void StreamedImage::LoadGL()
+	{
+		if (GetState() == State::UPLOADED)
+			return;
+
+		auto& store = TextureStore::Instance();
+		if (!_prioritised)
+		{
+			_prioritised = true;
+			store.QueueDecode(shared_from_this(), true);
+		}
+
+		if (!_tex)
+		{
+			_tex = store.GetPlaceholder();
+			_isPlaceholder = true;
+		}
+	}
+
+	size_t StreamedImage::Upload()
+	{
+		if (GetState() != State::DECODED || !_surface)
+			return 0;
+
+		auto* surface = _surface.Get();
+		auto width = (GLsizei)surface->w;
+		auto height = (GLsizei)surface->h;
+		auto size = (GLsizeiptr)surface->pitch * surface->h;
+
+		GLuint tex = 0;
+		glCreateTextures(GL_TEXTURE_2D, 1, &tex);
+		glTextureStorage2D(tex, GetMipLevelCount(width, height), GL_RGBA8, width, height);
+
+		glTextureParameteri(tex, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTextureParameteri(tex, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		// Staged through the streaming buffer as a pixel unpack buffer, so the copy into the texture doesn't stall on client memory
+		// Falls back to a plain upload if there's no room left this frame
+		auto staging = StreamData(surface->pixels, size, 4);
+		if (staging)
+		{
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging.Buffer);
+			glTextureSubImage2D(tex, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, (const void*)(intptr_t)staging.Offset);
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		}
+		else
+		{
+			glTextureSubImage2D(tex, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, surface->pixels);
+		}
+		glGenerateTextureMipmap(tex);
+		CHECK_GL_ERR("Uploading streamed texture '" + _filename + "'");
+
+		Destroy();
+		_tex = tex;
+		_surface.Delete();
+		_state.store(State::UPLOADED, std::memory_order_release);
+
+		return (size_t)size;
+	}
+
 	std::unique_ptr<TextureStore> TextureStore::_instance = nullptr;
 	TextureStore::Accessor TextureStore::Instance;
 
@@ -19,10 +107,13 @@ namespace Drawing
 		std::filesystem::path p = fileName;
 		auto name = p.filename().string();
 
-		std::shared_ptr<SDLImage> img = std::make_shared<SDLImage>(Drawing::ImageInfo{ nullptr, name }, SDLImage::LoadSurface(fileName), 4);
+		// Only the name is recorded here, the pixels are decoded on the decode threads
+		auto img = std::make_shared<StreamedImage>(fileName);
+		if (!_opts.LazyLoad)
+			QueueDecode(img, false);
 
 		_store[name] = ImageState{ fileName, name, std::move(img) };
-		DINFO("Loaded texture: " + fileName);
+		DINFO("Found texture: " + fileName);
 	}
 
 	void TextureStore::LoadImageDirectory(const std::string& directory)
@@ -47,7 +138,82 @@ namespace Drawing
 		}
 	}
 
+	void TextureStore::QueueDecode(std::shared_ptr<StreamedImage> image, bool visible)
+	{
+		auto expected = StreamedImage::State::UNREQUESTED;
+		image->_state.compare_exchange_strong(expected, StreamedImage::State::QUEUED);
+		if (image->GetState() != StreamedImage::State::QUEUED)
+			return;
+
+		// An image already waiting in the background queue is added to the visible queue as well, whichever is reached first decodes it
+		{
+			std::lock_guard<std::mutex> lock(_pendingMutex);
+			(visible ? _visiblePending : _backgroundPending).push_back(std::move(image));
+		}
+		_decodePool->Submit([this]() { DecodeNext(); });
+	}
+
+	void TextureStore::DecodeNext()
+	{
+		std::shared_ptr<StreamedImage> image;
+		{
+			std::lock_guard<std::mutex> lock(_pendingMutex);
+			auto& queue = _visiblePending.size() ? _visiblePending : _backgroundPending;
+			if (queue.empty())
+				return;
+			image = std::move(queue.front());
+			queue.pop_front();
+		}
+
+		if (_stopping.load(std::memory_order_relaxed))
+			return;
+
+		auto expected = StreamedImage::State::QUEUED;
+		if (!image->_state.compare_exchange_strong(expected, StreamedImage::State::DECODING))
+			return;
+
+		TRACE_ZONE("Decode Texture");
+		SimpleSurface loaded = SDLImage::LoadSurface(image->_filename);
+		if (loaded)
+			image->_surface = SDL_ConvertSurfaceFormat(loaded.Get(), SDL_PIXELFORMAT_RGBA32, 0);
+
+		if (!image->_surface)
+		{
+			DWARNING("Failed to decode texture: " + image->_filename);
+			image->_state.store(StreamedImage::State::FAILED, std::memory_order_release);
+			return;
+		}
+
+		image->_state.store(StreamedImage::State::DECODED, std::memory_order_release);
+		_decoded.push(std::move(image));
+	}
+
+	GLuint TextureStore::GetPlaceholder()
+	{
+		if (!_placeholder)
+		{
+			unsigned char grey[4] = { 128, 128, 128, 255 };
+			_placeholder = std::make_unique<GLImage>(Create2DGLTexture(GL_RGBA8, 1, 1, grey, GL_RGBA, GL_UNSIGNED_BYTE));
+		}
+		return _placeholder->Get();
+	}
+
 	TextureStore::TextureStore(const std::string& textureDirectory)
+		: TextureStore(textureDirectory, LoadOpts{})
+	{
+	}
+
+	TextureStore::TextureStore(const std::string& textureDirectory, LoadOpts opts)
+		: _store()
+		, _opts(opts)
+		, _uploadBudget(DefaultUploadBudget)
+		, _placeholder()
+		, _pendingMutex()
+		, _visiblePending()
+		, _backgroundPending()
+		, _decoded()
+		, _stopping(false)
+		, _decodePool(std::make_unique<Threading::ThreadPool>(opts.DecodeThreads, "Texture Decode"))
 	{
 		LoadImageDirectory(textureDirectory);
 
@@ -58,6 +224,13 @@ namespace Drawing
 		_store["default-normal"] = TextureStore::ImageState{ "default normal texture.jpeg", "default-normal", std::move(surf) };
 	}
 
+	TextureStore::~TextureStore()
+	{
+		// Queued decodes become no-ops, so the pool only waits on the ones already running
+		_stopping = true;
+		_decodePool.reset();
+	}
+
 	bool TextureStore::TryGetTexture(const std::string& name, std::shared_ptr<GLImage>& out) 
 	{
 		auto it = _store.find(name);
@@ -66,7 +239,8 @@ namespace Drawing
 
 		if (!it->second.Image)
 		{
-			it->second.Image = std::make_shared<SDLImage>(ImageInfo{ nullptr, it->second.Name }, SDLImage::LoadSurface(it->second.Filename), 4);
+			// Never decoded here, the image is streamed in once it is drawn
+			it->second.Image = std::make_shared<StreamedImage>(it->second.Filename);
 		}
 
 		out = it->second.Image;
@@ -91,12 +265,56 @@ namespace Drawing
 		return true;
 	}
 
+	SimpleSurface TextureStore::TakeDecodedSurface(const std::string& name)
+	{
+		auto it = _store.find(name);
+		if (it == _store.end())
+			return SimpleSurface();
+		auto image = std::dynamic_pointer_cast<StreamedImage>(it->second.Image);
+		if (!image)
+			return SimpleSurface();
+
+		// Drawing it again has to queue it again
+		image->_prioritised = false;
+
+		auto expected = StreamedImage::State::QUEUED;
+		if (image->_state.compare_exchange_strong(expected, StreamedImage::State::UNREQUESTED))
+			return SimpleSurface(); // Left in the pending queues, DecodeNext skips images that are no longer queued
+
+		while (image->GetState() == StreamedImage::State::DECODING)
+			std::this_thread::yield();
+
+		// Left in the decoded queue, Upload skips images that are no longer decoded
+		expected = StreamedImage::State::DECODED;
+		if (!image->_state.compare_exchange_strong(expected, StreamedImage::State::UNREQUESTED))
+			return SimpleSurface();
+		return std::move(image->_surface);
+	}
+
+	void TextureStore::UpdateStreaming()
+	{
+		size_t uploaded = 0;
+		std::shared_ptr<StreamedImage> image;
+		while (uploaded < _uploadBudget && _decoded.try_pop(image))
+			uploaded += image->Upload();
+	}
+
 	void TextureStore::InitializeStore(const std::string& textureDirectory)
+	{
+		InitializeStore(textureDirectory, LoadOpts{});
+	}
+
+	void TextureStore::InitializeStore(const std::string& textureDirectory, LoadOpts opts)
 	{
 		if (_instance)
 			return;
 
-		_instance = std::make_unique<TextureStore>(textureDirectory);
+		_instance = std::make_unique<TextureStore>(textureDirectory, opts);
+	}
+
+	bool TextureStore::IsInitialized()
+	{
+		return _instance.get();
 	}
 
 	TextureReference::TextureReference(std::string textureName)
@@ -4,12 +4,78 @@
 #include "Drawing/Image.h"
 #include "Drawing/Image2DArray.h"
 
+#include "Systems/Threading/ThreadedQueue.h"
+
 #include <string>
 #include <unordered_map>
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+namespace Threading
+{
+	class ThreadPool;
+}
 
 namespace Drawing
 {
-	// Most likely to implement lazy loading
+	class TextureStore;
+
+	/**
+	* A texture that is decoded on a background thread, then uploaded by TextureStore::UpdateStreaming within its per frame budget.
+	* Until it has been uploaded it binds as the store's placeholder texture, binding it (via LoadGL) moves it to the front of the decode queue.
+	*/
+	class StreamedImage : public GLImage, public std::enable_shared_from_this<StreamedImage>
+	{
+	public:
+		enum class State
+		{
+			UNREQUESTED = 0,
+			QUEUED = 1,
+			DECODING = 2,
+			DECODED = 3,
+			UPLOADED = 4,
+			FAILED = 5,
+		};
+
+	private:
+		friend class TextureStore;
+
+		std::string _filename;
+		std::atomic<State> _state;
+		SimpleSurface _surface; // Decoded RGBA32 pixels, written by the decoding thread and freed once uploaded
+		bool _isPlaceholder; // Whether _tex is the store's placeholder (which this image does not own)
+		bool _prioritised;
+
+		// Creates the texture from the decoded pixels, returns how many bytes were uploaded
+		size_t Upload();
+
+	public:
+		StreamedImage(std::string filename);
+		virtual ~StreamedImage();
+
+		StreamedImage(const StreamedImage&) = delete;
+		StreamedImage& operator=(const StreamedImage&) = delete;
+
+		virtual void Destroy() override;
+
+		/**
+		* Requests the image be decoded ahead of those that haven't been drawn, binding the placeholder until it is ready.
+		* Never blocks on the decode.
+		*/
+		void LoadGL() override;
+
+		inline State GetState() const { return _state.load(std::memory_order_acquire); }
+		inline bool IsReady() const { return GetState() == State::UPLOADED; }
+		inline const std::string& GetFilename() const { return _filename; }
+
+		inline virtual GLenum GetTarget() const override { return GL_TEXTURE_2D; }
+	};
+
+	/**
+	* Holds every named texture, streaming textures loaded from disk in the background.
+	* Textures found at startup are not decoded on the loading thread, they are queued for decoding on worker threads (or, with LazyLoad, decoded when first drawn).
+	*/
 	class TextureStore
 	{
 		static std::unique_ptr<TextureStore> _instance;
@@ -29,17 +95,45 @@ namespace Drawing
 			std::shared_ptr<GLImage> Image;
 		};
 
+	public:
 		struct LoadOpts
 		{
-			bool LazyLoad;
+			bool LazyLoad = false; // Only decode textures once they are first drawn, rather than queueing them all at startup
+			size_t DecodeThreads = 2;
 		};
 
+		// Default number of bytes of texture data uploaded per UpdateStreaming
+		static constexpr size_t DefaultUploadBudget = 4 * 1024 * 1024;
+
+	private:
+		friend class StreamedImage;
+
 		std::unordered_map<std::string, ImageState> _store;
+		LoadOpts _opts;
+		size_t _uploadBudget;
+
+		std::unique_ptr<GLImage> _placeholder;
+
+		// Images waiting for a decode thread, images that have been drawn are taken first
+		std::mutex _pendingMutex;
+		std::deque<std::shared_ptr<StreamedImage>> _visiblePending;
+		std::deque<std::shared_ptr<StreamedImage>> _backgroundPending;
+		Threading::ThreadedQueue<std::shared_ptr<StreamedImage>> _decoded;
+		std::atomic<bool> _stopping;
+
+		// Declared last so its workers are stopped before anything they use is destroyed
+		std::unique_ptr<Threading::ThreadPool> _decodePool;
 
 		void LoadImage(const std::string& fileName);
 		void LoadImageDirectory(const std::string& directory);
+
+		void QueueDecode(std::shared_ptr<StreamedImage> image, bool visible);
+		void DecodeNext();
+		GLuint GetPlaceholder();
 	public:
 		TextureStore(const std::string& textureDirectory);
+		TextureStore(const std::string& textureDirectory, LoadOpts opts);
+		~TextureStore();
 
 		/**
 		* Returns whether a texture of a specific name exists and is not empty
@@ -58,7 +152,26 @@ namespace Drawing
 		*/
 		bool AddTexture(const std::string& name, std::shared_ptr<GLImage> in);
 
+		/**
+		* Takes the decoded RGBA32 pixels of a streamed texture for use elsewhere (eg. stitching into an atlas) so the file isn't decoded twice.
+		* Waits for a decode that is already running, and calls off one that is only queued (returning an empty surface, the caller decodes it instead).
+		* Also returns an empty surface if the texture isn't streamed, or was already uploaded and so has no pixels left.
+		* The texture goes back to unrequested, it is only decoded again (and uploaded as its own texture) if it is drawn. Must be called on the GL thread.
+		*/
+		SimpleSurface TakeDecodedSurface(const std::string& name);
+
+		/**
+		* Uploads textures that have finished decoding, stopping once the upload budget is used up (at least one texture is uploaded if any are waiting).
+		* Must be called on the GL thread, once per frame.
+		*/
+		void UpdateStreaming();
+
+		inline void SetUploadBudget(size_t bytes) { _uploadBudget = bytes; }
+		inline size_t GetUploadBudget() const { return _uploadBudget; }
+
 		static void InitializeStore(const std::string& textureDirectory);
+		static void InitializeStore(const std::string& textureDirectory, LoadOpts opts);
+		static bool IsInitialized();
 	};
 
 
@@ -1,5 +1,7 @@
 #include "VertexBuffer.h"
 
+#include "StreamingBuffer.h"
+
 namespace Drawing
 {
     std::shared_ptr<VertexBuffer> VertexBuffer::_staticBuffer{ nullptr };
@@ -12,6 +14,19 @@ namespace Drawing
             return GL_STATIC_DRAW;
     }
 
+    void VertexBuffer::Upload(const GLBuffer& buf, const void* data, GLsizeiptr size)
+    {
+        // Stage through the streaming buffer so the copy happens on the GPU timeline instead of the driver copying (and possibly stalling on) client memory
+        if (auto staging = StreamData(data, size))
+        {
+            glNamedBufferData(buf.Get(), size, nullptr, GetGLUsage());
+            glCopyNamedBufferSubData(staging.Buffer, buf.Get(), staging.Offset, 0, size);
+            return;
+        }
+
+        glNamedBufferData(buf.Get(), size, data, GetGLUsage());
+    }
+
     /**
     * TODO: All of this crap
     */
@@ -62,7 +77,7 @@ namespace Drawing
             _indices = mesh.Indices;
 
             _meshOffsets.clear();
-            _meshOffsets.emplace_back(InternalMeshData{ MeshOffsetData{ 0, 0, (GLsizei)mesh.Indices.size() }, (GLuint)mesh.vertexData.NumVertices(), 1 });
+            _meshOffsets.emplace_back(InternalMeshData{ MeshOffsetData{ 0, 0, (GLsizei)mesh.Indices.size(), (GLuint)mesh.vertexData.NumVertices() }, 1 });
             if (_nextKey == 1)
                 _nextKey = 2;
             return 1;
@@ -84,7 +99,7 @@ namespace Drawing
         data.Data.IndexOffset = offset;
         data.Data.IndexStart = start;
         data.Data.IndicesCount = (GLsizei)mesh.Indices.size();
-        data.VertexCount = (GLuint)mesh.vertexData.NumVertices();
+        data.Data.VertexCount = (GLuint)mesh.vertexData.NumVertices();
         data.Key = _nextKey++;
 
         _meshOffsets.emplace_back(std::move(data));
@@ -122,13 +137,13 @@ namespace Drawing
 
         for (auto it = _meshOffsets.begin() + (foundOffset + 1); it != _meshOffsets.end(); ++it)
         {
-            it->Data.IndexOffset -= desc.VertexCount;
+            it->Data.IndexOffset -= desc.Data.VertexCount;
             it->Data.IndexStart -= desc.Data.IndicesCount;
         }
 
         size_t size = _vertices.VertexByteSize();
 
-        _vertices.Vertices.erase(_vertices.Vertices.begin() + desc.Data.IndexOffset * size, _vertices.Vertices.begin() + ((size_t)desc.Data.IndexOffset + desc.VertexCount) * size);
+        _vertices.Vertices.erase(_vertices.Vertices.begin() + desc.Data.IndexOffset * size, _vertices.Vertices.begin() + ((size_t)desc.Data.IndexOffset + desc.Data.VertexCount) * size);
         _indices.erase(_indices.begin() + desc.Data.IndexStart, _indices.begin() + desc.Data.IndexStart + desc.Data.IndicesCount);
 
         _meshOffsets.erase(_meshOffsets.begin() + foundOffset);
@@ -169,16 +184,13 @@ namespace Drawing
             return;
 
         GLuint bufs[2] = { 0 };
-        glGenBuffers(2, bufs);
+        glCreateBuffers(2, bufs);
 
         _VBO.Reset(bufs[0]);
         _IBO.Reset(bufs[1]);
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _IBO.Get());
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * _indices.size(), _indices.data(), GetGLUsage());
-
-        glBindBuffer(GL_ARRAY_BUFFER, _VBO.Get());
-        glBufferData(GL_ARRAY_BUFFER, _vertices.Vertices.size(), _vertices.Vertices.data(), GetGLUsage());
+        Upload(_IBO, _indices.data(), (GLsizeiptr)(sizeof(GLuint) * _indices.size()));
+        Upload(_VBO, _vertices.Vertices.data(), (GLsizeiptr)_vertices.Vertices.size());
 
         _dirty = false;
     }
@@ -11,9 +11,10 @@ namespace Drawing
 {
 	struct MeshOffsetData
 	{
-		GLuint IndexOffset;
+		GLuint IndexOffset; // The mesh's first vertex, added to each of its indices
 		GLuint IndexStart;
 		GLsizei IndicesCount;
+		GLuint VertexCount;
 	};
 
 	class VertexBuffer
@@ -21,7 +22,6 @@ namespace Drawing
 		struct InternalMeshData
 		{
 			MeshOffsetData Data;
-			GLuint VertexCount;
 			size_t Key;
 		};
 
@@ -38,6 +38,7 @@ namespace Drawing
 		bool _dirty = true;
 
 		GLenum GetGLUsage();
+		void Upload(const GLBuffer& buf, const void* data, GLsizeiptr size);
 
 
 		VertexBuffer& operator=(VertexBuffer&& other);
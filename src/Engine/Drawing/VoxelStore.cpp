@@ -12,10 +12,12 @@
 
 #include "Systems/Execution/Engine.h"
 #include "Systems/Importing/SimpleMeshImport.h"
+#include "Systems/Threading/ThreadPool.h"
 
 #include "Game/VoxelStuff/VoxelTypes.h"
 #include "Game/VoxelStuff/VoxelWorld.h"
 #include "Drawing/Texture.h"
+#include "Drawing/AtlasCache.h"
 
 const Voxel::SerialBlock Voxel::VoxelStore::EmptyBlockData = Voxel::SerialBlock{};
 
@@ -25,6 +27,7 @@ const Voxel::SerialBlock Voxel::VoxelStore::EmptyBlockData = Voxel::SerialBlock{
 /// - Mesh
 /// - Textures
 /// - WantsUpdate
+/// - LightEmission
 /// - Name
 /// - AtlasName
 /// 3 Stages:
@@ -88,7 +91,7 @@ namespace Voxel
 		}
 	}
 
-	void VoxelStore::LoadBlockFile(const std::string& path)
+	std::vector<BlockDescription> VoxelStore::ParseBlockFile(const std::string& path)
 	{
 		/**
 		* Loads a YAML file into one or more BlockDescription(s).
@@ -97,6 +100,7 @@ namespace Voxel
 		* - block-name: [string block id]
 		* - atlas: [name of atlas containing textures]
 		* - wants-update: [true/false/1/0] (describes whether to instantiate an ICube from this block rather then leave as a SerialBlock
+		* - light-emission: [0-15] (optional, the block light level this block emits, defaults to 0)
 		* EITHER:
 		* - faces: [opaque/semi-opaque/transparent]
 		* OR:
@@ -117,7 +121,10 @@ namespace Voxel
 		*   - neg-y: [texture file name]
 		*   - pos-z: [texture file name]
 		*   - neg-z: [texture file name]
+		* 
+		* Only reads the file, so may be called from any thread. The descriptions still need to be loaded with AddParsedBlock.
 		*/
+		std::vector<BlockDescription> out;
 		if (std::filesystem::exists(path))
 		{
 			try
@@ -130,13 +137,13 @@ namespace Voxel
 				if (!blocks)
 				{
 					DINFO("Block file '" + path + "' is empty!");
-					return;
+					return out;
 				}
 
 				if (!blocks.IsSequence())
 				{
 					DWARNING("Block file '" + path + "' does not contain a sequence under the blocks tag!");
-					return;
+					return out;
 				}
 
 				for (auto it = blocks.begin(); it != blocks.end(); ++it)
@@ -185,6 +192,24 @@ namespace Voxel
 						}
 					}
 
+					desc.LightEmission = 0;
+
+					auto lightEmissionNode = node["light-emission"];
+					if (lightEmissionNode)
+					{
+						UINT emission = 0;
+						if (!lightEmissionNode.IsScalar() || !StringHelper::IfUINT(lightEmissionNode.Scalar(), &emission))
+						{
+							DWARNING("Block '" + desc.Name + "' has invalid 'light-emission' tag! Expected a light level from 0 to " + std::to_string(MaxLightLevel));
+						}
+						else
+						{
+							if (emission > MaxLightLevel)
+								DWARNING("Block '" + desc.Name + "' has a 'light-emission' of " + std::to_string(emission) + ", clamping to " + std::to_string(MaxLightLevel));
+							desc.LightEmission = (uint8_t)std::min<UINT>(emission, MaxLightLevel);
+						}
+					}
+
 					auto facesNode = node["faces"];
 					if (!facesNode)
 					{
@@ -324,9 +349,6 @@ namespace Voxel
 					getTextureGroup(tex["bump"],		faces); faces = desc.GetFacesFor(Voxel::AtlasType::EMISSIVE);
 					getTextureGroup(tex["emissive"],	faces);
 
-					if (std::any_of(desc.FaceTextures.begin(), desc.FaceTextures.end(), [](const TextureNames& s) { return s.DiffuseName.size(); }))
-						_unstitchedDescriptions.emplace_back(desc);
-
 					auto meshNode = node["mesh"];
 					desc.MeshName = DefaultCubeMeshName;
 					if (meshNode)
@@ -342,7 +364,7 @@ namespace Voxel
 						}
 					}
 
-					LoadBlock(desc);
+					out.emplace_back(std::move(desc));
 				}
 			}
 			catch (YAML::Exception& e)
@@ -350,6 +372,21 @@ namespace Voxel
 				DERROR("Exception when loading block file '" + path + "': " + e.what());
 			}
 		}
+		return out;
+	}
+
+	void VoxelStore::AddParsedBlock(const BlockDescription& desc)
+	{
+		if (std::any_of(desc.FaceTextures.begin(), desc.FaceTextures.end(), [](const TextureNames& s) { return s.DiffuseName.size(); }))
+			_unstitchedDescriptions.emplace_back(desc);
+
+		LoadBlock(desc);
+	}
+
+	void VoxelStore::LoadBlockFile(const std::string& path)
+	{
+		for (auto& desc : ParseBlockFile(path))
+			AddParsedBlock(desc);
 	}
 
 	void VoxelStore::LoadAtlasDirectory(const std::string& directory)
@@ -374,15 +411,26 @@ namespace Voxel
 		}
 	}
 
-	void VoxelStore::LoadBlockDirectory(const std::string& directory)
+	void VoxelStore::LoadBlockDirectory(const std::string& directory, Threading::ThreadPool& pool)
 	{
 		if (std::filesystem::exists(directory))
 		{
 			if (std::filesystem::is_directory(directory))
 			{
+				// Files are parsed in parallel, then loaded in directory order so block IDs don't depend on thread timing
+				std::vector<std::string> files;
 				for (auto& item : std::filesystem::directory_iterator(directory))
 				{
-					LoadBlockFile(item.path().string());
+					files.push_back(item.path().string());
+				}
+
+				std::vector<std::vector<BlockDescription>> parsed(files.size());
+				pool.ParallelFor(files.size(), [&files, &parsed](size_t i) { parsed[i] = ParseBlockFile(files[i]); });
+
+				for (auto& fileBlocks : parsed)
+				{
+					for (auto& desc : fileBlocks)
+						AddParsedBlock(desc);
 				}
 			}
 			else
@@ -396,18 +444,16 @@ namespace Voxel
 		}
 	}
 
-	void VoxelStore::LoadMeshFromFile(const std::string& path)
+	bool VoxelStore::ImportBlockMesh(const std::string& path, VoxelBlockMesh& voxelVerts)
 	{
 		auto simpleMeshes = Importing::ImportAllSimpleMeshes(path);
 
 		if (!simpleMeshes.size())
 		{
 			DWARNING("Could not load meshes from file '" + path + "'");
-			return;
+			return false;
 		}
 
-		VoxelBlockMesh voxelVerts;
-
 		const static std::array<std::string, 6> blockFaceNames = { "pos-y", "neg-z", "pos-x", "neg-y", "pos-z", "neg-x" };
 		std::vector<int> remainingBlockFaceIndices = { 0, 1, 2, 3, 4, 5 };
 		for (auto& mesh : simpleMeshes)
@@ -432,24 +478,41 @@ namespace Voxel
 		if (remainingBlockFaceIndices.size())
 		{
 			DWARNING("Mesh in file '" + path + "' does not contain 6 meshes of names 'pos-y', 'neg-z', 'pos-x', 'neg-y', 'pos-z' and 'neg-x'!");
-			return;
+			return false;
 		}
 
-		auto p = std::filesystem::path(path);
-		auto name = p.stem().string();
+		auto name = std::filesystem::path(path).stem().string();
 		DINFO("Loaded mesh '" + name + "' (from '" + path + "') with face vertex counts of " + std::to_string(voxelVerts.FaceVertices[0].size()) + ", " + std::to_string(voxelVerts.FaceVertices[1].size()) + ", " + std::to_string(voxelVerts.FaceVertices[2].size()) + ", " + std::to_string(voxelVerts.FaceVertices[3].size()) + ", " + std::to_string(voxelVerts.FaceVertices[4].size()) + ", " + std::to_string(voxelVerts.FaceVertices[5].size()) + ".");
-		_voxelMeshLookup[name] = std::move(voxelVerts);
+		return true;
+	}
+
+	void VoxelStore::LoadMeshFromFile(const std::string& path)
+	{
+		VoxelBlockMesh mesh;
+		if (ImportBlockMesh(path, mesh))
+			_voxelMeshLookup[std::filesystem::path(path).stem().string()] = std::move(mesh);
 	}
 
-	void VoxelStore::LoadMeshesFromDirectory(const std::string& path)
+	void VoxelStore::LoadMeshesFromDirectory(const std::string& path, Threading::ThreadPool& pool)
 	{
 		if (std::filesystem::exists(path))
 		{
 			if (std::filesystem::is_directory(path))
 			{
+				std::vector<std::string> files;
 				for (auto& item : std::filesystem::directory_iterator(path))
 				{
-					LoadMeshFromFile(item.path().string());
+					files.push_back(item.path().string());
+				}
+
+				std::vector<VoxelBlockMesh> meshes(files.size());
+				std::vector<char> imported(files.size(), (char)false);
+				pool.ParallelFor(files.size(), [&files, &meshes, &imported](size_t i) { imported[i] = ImportBlockMesh(files[i], meshes[i]); });
+
+				for (size_t i = 0; i < files.size(); ++i)
+				{
+					if (imported[i])
+						_voxelMeshLookup[std::filesystem::path(files[i]).stem().string()] = std::move(meshes[i]);
 				}
 			}
 			else
@@ -520,13 +583,13 @@ namespace Voxel
 		}
 	}
 
-	void VoxelStore::StitchUnstitched(const std::string& faceTexDir)
+	void VoxelStore::StitchUnstitched(const std::string& faceTexDir, Threading::ThreadPool& pool)
 	{
 		// Currently this must be called once and must be called upon creation
 		if (_unstitchedDescriptions.size())
 		{
 			UnStitchedAtlasSet unstitchedDiffuse{ "global", std::move(_unstitchedDescriptions) };
-			StitchAndLoadAtlas(unstitchedDiffuse, faceTexDir);
+			StitchAndLoadAtlas(unstitchedDiffuse, faceTexDir, &pool);
 		}
 	}
 
@@ -555,21 +618,25 @@ namespace Voxel
 
 	VoxelStore::VoxelStore(const std::string& prestitchedDirectory, const std::string& blockDirectory, const std::string& faceTexDir, const std::string& meshDir, std::vector<UnStitchedAtlasSet> builtInAtlases)
 	{
+		// File parsing, mesh importing and image decoding fan out across the pool, everything touching the store or GL stays on this thread
+		Threading::ThreadPool pool{ 0, "Voxel Store" };
+		_atlasCacheDirectory = prestitchedDirectory;
+
 		LoadBlock(GetEmptyBlockDesc()); // Load empty block description first
-		LoadMeshesFromDirectory(meshDir);
+		LoadMeshesFromDirectory(meshDir, pool);
 		LoadDefaultCube();
-		LoadBlockDirectory(blockDirectory);
-		(void)prestitchedDirectory;//LoadAtlasDirectory(prestitchedDirectory); No! Not Yet My Boi! (not implemented)
+		LoadBlockDirectory(blockDirectory, pool);
+		//LoadAtlasDirectory(prestitchedDirectory); No! Not Yet My Boi! (not implemented, the directory holds AtlasCache files for now)
 
-		StitchUnstitched(faceTexDir);
+		StitchUnstitched(faceTexDir, pool);
 
 		for (int i = 0; i < builtInAtlases.size(); ++i)
 		{
-			StitchAndLoadAtlas(builtInAtlases[i], faceTexDir);
+			StitchAndLoadAtlas(builtInAtlases[i], faceTexDir, &pool);
 		}
 	}
 
-	void VoxelStore::StitchAndLoadAtlas(const UnStitchedAtlasSet& set, const std::string& faceTexDir)
+	void VoxelStore::StitchAndLoadAtlas(const UnStitchedAtlasSet& set, const std::string& faceTexDir, Threading::ThreadPool* pool)
 	{
 		if (set.Blocks.empty())
 			return;
@@ -582,7 +649,7 @@ namespace Voxel
 			}
 		}
 
-		auto ptr = std::make_shared<StitchedAtlasSet>(StichAtlas(set, faceTexDir));
+		auto ptr = std::make_shared<StitchedAtlasSet>(StichAtlas(set, faceTexDir, pool));
 
 		_atlasLookup[set.AtlasPrefix] = ptr;
 
@@ -601,15 +668,23 @@ namespace Voxel
 						vert.TexCoord = ptr->ConvertTexCoords(desc.FaceTexNames[faceI], (floaty2)vert.TexCoord);
 					}
 				}
+				UpdateRotatedMeshes(desc.BlockData.ID);
 			}
 		}
 	}
 
-	StitchedAtlasSet VoxelStore::StichAtlas(const UnStitchedAtlasSet& set, const std::string& faceTexDir)
+	StitchedAtlasSet VoxelStore::StichAtlas(const UnStitchedAtlasSet& set, const std::string& faceTexDir, Threading::ThreadPool* pool)
 	{
 		if (set.Blocks.empty())
 			return StitchedAtlasSet{ set.AtlasPrefix, nullptr, nullptr, nullptr, nullptr, nullptr, std::unordered_map<TextureNames, std::array<float, 5>>{} };
 
+		std::unique_ptr<Threading::ThreadPool> ownPool;
+		if (!pool)
+		{
+			ownPool = std::make_unique<Threading::ThreadPool>(0, "Atlas Stitch");
+			pool = ownPool.get();
+		}
+
 		MidStitchData data{};
 		int faceSize = DefaultFaceSize;
 		float faceSizef = (float)DefaultFaceSize;
@@ -632,130 +707,196 @@ namespace Voxel
 		auto& spec = stitched.SpecularImage;
 		auto& emis = stitched.EmissiveImage;
 
-		VoxelBlock block;
-		block.AtlasName = set.AtlasPrefix;
+		// Every distinct set of face textures takes one slot in the atlas, in the order they are first used
+		std::vector<const TextureNames*> faces;
+		for (auto& desc : set.Blocks)
+		{
+			for (auto& textureNames : desc.FaceTextures)
+			{
+				if (stitched.FaceTextureLookup.emplace(textureNames, std::array<float, 5>{}).second)
+					faces.push_back(&textureNames);
+			}
+		}
 
-		auto getSurfaceFromFile = [&faceSize, &faceTexDir](const std::string& fileName)
+		// Each face has a surface per image, in this order
+		constexpr size_t ImagesPerFace = 5;
+		const std::array<std::shared_ptr<Drawing::Image2DArray>*, ImagesPerFace> images = { &dif, &spec, &emis, &norm, &bump };
+		auto fileNameOf = [&faces](size_t surfaceIndex) -> const std::string&
 		{
-			if (fileName == "empty" || fileName == "")
+			auto& names = *faces[surfaceIndex / ImagesPerFace];
+			switch (surfaceIndex % ImagesPerFace)
 			{
-				SDL_Surface* p = SDL_CreateRGBSurfaceWithFormat(0, faceSize, faceSize, 32, SDL_PIXELFORMAT_RGBA32);
-				SDL_FillRect(p, nullptr, SDL_MapRGBA(p->format, 0, 0, 0, 0xff));
-				return SimpleSurface(p);
+			default:
+			case 0: return names.DiffuseName;
+			case 1: return names.SpecularName;
+			case 2: return names.EmissiveName;
+			case 3: return names.NormalName;
+			case 4: return names.BumpName;
 			}
-			if (std::shared_ptr<Drawing::GLImage> img; Drawing::TextureStore::Instance().TryGetTexture(fileName, img))
+		};
+
+		// Textures the TextureStore holds CPU pixels for are used as is, looked up here as the store isn't thread safe
+		// Streamed ones hand over their pixels if they've been decoded, otherwise their decode is called off and they're decoded below instead
+		std::vector<SimpleSurface> surfaces(faces.size() * ImagesPerFace);
+		std::vector<bool> inMemory(surfaces.size(), false); // Not from a file, so hashed by their pixels for the cache
+		std::vector<size_t> toDecode;
+		for (size_t i = 0; i < surfaces.size(); ++i)
+		{
+			auto& fileName = fileNameOf(i);
+			if (fileName != "empty" && fileName != "")
 			{
-				if (auto* p = dynamic_cast<Drawing::SDLImage*>(img.get()))
+				auto& textures = Drawing::TextureStore::Instance();
+				if (std::shared_ptr<Drawing::GLImage> img; textures.TryGetTexture(fileName, img))
 				{
-					return SimpleSurface(p->GetSurface(), false);
+					if (auto* p = dynamic_cast<Drawing::SDLImage*>(img.get()))
+					{
+						surfaces[i] = SimpleSurface(p->GetSurface(), false);
+						inMemory[i] = true;
+						continue;
+					}
+					if (auto decoded = textures.TakeDecodedSurface(fileName); decoded.Get())
+					{
+						surfaces[i] = std::move(decoded);
+						continue;
+					}
 				}
 			}
-			std::filesystem::path p{ fileName };
-			if (p.is_relative())
-				p = faceTexDir / p;
-			return SimpleSurface(Drawing::SDLImage::LoadSurface(p.string()));
+			toDecode.push_back(i);
+		}
+
+		auto resolvePath = [&faceTexDir](const std::string& fileName)
+		{
+			std::filesystem::path path{ fileName };
+			if (path.is_relative())
+				path = faceTexDir / path;
+			return path.string();
+		};
+
+		// GL uploads stay on this (the GL) thread
+		// Atlases backed by a cache file drop their CPU pixels once uploaded, edits read them back from the GPU
+		auto uploadImages = [](StitchedAtlasSet& set, const std::string& cachePath)
+		{
+			for (auto type : AtlasTypes)
+			{
+				auto& image = set.GetImageFromType(type);
+				if (cachePath.size())
+					image->SetReleaseCPUAfterUpload(true);
+				image->LoadGL();
+			}
 		};
 
-		auto addFaceFunc = [&data, &faceSize, &faceSizef, &faceCount, &atlasLayerSize, &faceTexDir, &dif, &norm, &bump, &spec, &emis, &getSurfaceFromFile]
-		(std::array<float, 5>& face,
-			const std::string& difFaceFile,
-			const std::string& specFaceFile,
-			const std::string& emisFaceFile,
-			const std::string& normFaceFile,
-			const std::string& bumpFaceFile,
-			bool exists)
-		{
-			SimpleSurface difFaceSurf = (exists ? nullptr : getSurfaceFromFile(difFaceFile));
-			SimpleSurface specFaceSurf = getSurfaceFromFile(specFaceFile);
-			SimpleSurface emisFaceSurf = getSurfaceFromFile(emisFaceFile);
-			SimpleSurface normFaceSurf = getSurfaceFromFile(normFaceFile);
-			SimpleSurface bumpFaceSurf = getSurfaceFromFile(bumpFaceFile);
-			if (!difFaceSurf)
-				return;
+		// The cache is keyed on everything stitching depends on: the layout, which textures make up each face and the contents of those textures
+		std::string cachePath;
+		uint64_t cacheKey = 0;
+		if (_atlasCacheDirectory.size())
+		{
+			std::vector<uint64_t> surfaceHashes(surfaces.size(), 0);
+			pool->ParallelFor(surfaces.size(), [&surfaces, &inMemory, &surfaceHashes, &fileNameOf, &resolvePath](size_t i)
+				{
+					auto& fileName = fileNameOf(i);
+					if (auto* surface = surfaces[i].Get(); surface && inMemory[i])
+					{
+						auto hash = AtlasCache::HashBytes(&surface->format->format, sizeof(surface->format->format), (uint64_t)surface->w * 65536 + (uint64_t)surface->h);
+						for (int y = 0; y < surface->h; ++y)
+							hash = AtlasCache::HashBytes((const unsigned char*)surface->pixels + (size_t)y * surface->pitch, (size_t)surface->w * surface->format->BytesPerPixel, hash);
+						surfaceHashes[i] = hash;
+					}
+					else if (fileName != "empty" && fileName != "")
+					{
+						surfaceHashes[i] = AtlasCache::HashFile(resolvePath(fileName));
+					}
+				});
+
+			const uint32_t layout[] = { AtlasCache::FormatVersion, (uint32_t)faceSize, (uint32_t)faceCount };
+			cacheKey = AtlasCache::HashBytes(layout, sizeof(layout));
+			for (size_t i = 0; i < surfaces.size(); ++i)
+			{
+				cacheKey = AtlasCache::HashString(fileNameOf(i), cacheKey);
+				cacheKey = AtlasCache::HashBytes(&surfaceHashes[i], sizeof(surfaceHashes[i]), cacheKey);
+			}
+
+			cachePath = AtlasCache::GetCachePath(_atlasCacheDirectory, set.AtlasPrefix);
+			if (AtlasCache::TryLoad(cachePath, cacheKey, stitched))
+			{
+				uploadImages(stitched, cachePath);
+				return stitched;
+			}
+		}
+
+		// Everything else is decoded and converted to the atlas' format on the pool, leaving just the copying to this thread
+		pool->ParallelFor(toDecode.size(), [&toDecode, &surfaces, &fileNameOf, &resolvePath, faceSize](size_t i)
+			{
+				auto index = toDecode[i];
+				auto& fileName = fileNameOf(index);
+				if (fileName == "empty" || fileName == "")
+				{
+					SDL_Surface* p = SDL_CreateRGBSurfaceWithFormat(0, faceSize, faceSize, 32, SDL_PIXELFORMAT_RGBA32);
+					SDL_FillRect(p, nullptr, SDL_MapRGBA(p->format, 0, 0, 0, 0xff));
+					surfaces[index] = SimpleSurface(p);
+					return;
+				}
+
+				SimpleSurface surface{ Drawing::SDLImage::LoadSurface(resolvePath(fileName)) };
+				if (surface && surface->format->format != SDL_PIXELFORMAT_RGBA32)
+					surface = SimpleSurface(SDL_ConvertSurfaceFormat(surface.Get(), SDL_PIXELFORMAT_RGBA32, 0));
+				surfaces[index] = std::move(surface);
+			});
+
+		for (size_t faceI = 0; faceI < faces.size(); ++faceI)
+		{
+			auto* faceSurfaces = &surfaces[faceI * ImagesPerFace];
+			if (!faceSurfaces[0]) // Faces without a diffuse texture are left out of the atlas
+				continue;
+
 			SDL_Rect dst;
 			dst.x = data.curX * faceSize + data.curX * 2;
 			dst.y = data.curY * faceSize + data.curY * 2;
 			dst.w = faceSize;
 			dst.h = faceSize;
 
-			auto doFaceThing = [&dst, &data, &faceSize, &faceCount](const std::shared_ptr<Drawing::Image2DArray>& img, const SimpleSurface& surface)
+			for (size_t imageI = 0; imageI < ImagesPerFace; ++imageI)
 			{
+				auto& img = *images[imageI];
+				auto* surface = faceSurfaces[imageI].Get();
 				if (!surface)
-					return;
+					continue;
 
-				img->SetArea(surface.Get(), dst, data.curLayer);
+				img->SetArea(surface, dst, data.curLayer);
 
 				if (data.curX > 0)
-					img->SetArea(surface.Get(), SDL_Rect{ 0, 0, 1, faceSize }, SDL_Rect{ dst.x - 1, dst.y, 1, faceSize }, data.curLayer);
+					img->SetArea(surface, SDL_Rect{ 0, 0, 1, faceSize }, SDL_Rect{ dst.x - 1, dst.y, 1, faceSize }, data.curLayer);
 				if (data.curY > 0)
-					img->SetArea(surface.Get(), SDL_Rect{ 0, 0, faceSize, 1 }, SDL_Rect{ dst.x, dst.y - 1, faceSize, 1 }, data.curLayer);
+					img->SetArea(surface, SDL_Rect{ 0, 0, faceSize, 1 }, SDL_Rect{ dst.x, dst.y - 1, faceSize, 1 }, data.curLayer);
 				if (data.curX < faceCount - 1)
-					img->SetArea(surface.Get(), SDL_Rect{ faceSize - 1, 0, 1, faceSize }, SDL_Rect{ dst.x + faceSize, dst.y, 1, faceSize }, data.curLayer);
+					img->SetArea(surface, SDL_Rect{ faceSize - 1, 0, 1, faceSize }, SDL_Rect{ dst.x + faceSize, dst.y, 1, faceSize }, data.curLayer);
 				if (data.curY < faceCount - 1)
-					img->SetArea(surface.Get(), SDL_Rect{ 0, faceSize - 1, faceSize, 1 }, SDL_Rect{ dst.x, dst.y + faceSize, faceSize, 1 }, data.curLayer);
-			};
+					img->SetArea(surface, SDL_Rect{ 0, faceSize - 1, faceSize, 1 }, SDL_Rect{ dst.x, dst.y + faceSize, faceSize, 1 }, data.curLayer);
+			}
 
-			doFaceThing(dif, difFaceSurf);
-			doFaceThing(norm, normFaceSurf);
-			doFaceThing(bump, bumpFaceSurf);
-			doFaceThing(spec, specFaceSurf);
-			doFaceThing(emis, emisFaceSurf);
+			auto& face = stitched.FaceTextureLookup[*faces[faceI]];
+			face[0] = (float)dst.x / atlasLayerSize;
+			face[1] = (float)dst.y / atlasLayerSize;
+			face[2] = face[0] + faceSizef / atlasLayerSize;
+			face[3] = face[1] + faceSizef / atlasLayerSize;
+			face[4] = (float)data.curLayer;
 
-			if (!exists)
+			if (++data.curX >= faceCount)
 			{
-				face[0] = (float)dst.x / atlasLayerSize;
-				face[1] = (float)dst.y / atlasLayerSize;
-				face[2] = face[0] + faceSizef / atlasLayerSize;
-				face[3] = face[1] + faceSizef / atlasLayerSize;
-				face[4] = (float)data.curLayer;
-
-				if (++data.curX >= faceCount)
+				data.curX = 0;
+				if (++data.curY >= faceCount)
 				{
-					data.curX = 0;
-					if (++data.curY >= faceCount)
-					{
-						dif->AddLayer();
-						norm->AddLayer();
-						bump->AddLayer();
-						spec->AddLayer();
-						emis->AddLayer();
-						++data.curLayer;
-						data.curY = 0;
-					}
+					for (auto* image : images)
+						(*image)->AddLayer();
+					++data.curLayer;
+					data.curY = 0;
 				}
 			}
-		};
-		
-		for (int i = 0; i < set.Blocks.size(); ++i)
-		{
-			auto& desc = set.Blocks[i];
-
-			block.Name = desc.Name;
-			for (int j = 0; j < 6; ++j)
-			{
-				auto& textureNames = desc.FaceTextures[j];
-				addFaceFunc(
-					stitched.FaceTextureLookup[textureNames], 
-					textureNames.DiffuseName, 
-					textureNames.SpecularName,
-					textureNames.EmissiveName, 
-					textureNames.NormalName, 
-					textureNames.BumpName,
-					stitched.FaceTextureLookup.count(textureNames)
-				);
-			}
 		}
 
-		stitched.DiffuseImage->LoadGL();
-		stitched.DiffuseImage->GenerateMipmaps();
-		stitched.NormalImage->LoadGL();
-		stitched.NormalImage->GenerateMipmaps();
-		stitched.BumpImage->LoadGL();
-		stitched.BumpImage->GenerateMipmaps();
-		stitched.SpecularImage->LoadGL();
-		stitched.SpecularImage->GenerateMipmaps();
-		stitched.EmissiveImage->LoadGL();
-		stitched.EmissiveImage->GenerateMipmaps();
+		if (cachePath.size() && !AtlasCache::Save(cachePath, cacheKey, stitched))
+			cachePath.clear();
+
+		uploadImages(stitched, cachePath);
 
 		return stitched;
 	}
@@ -784,17 +925,77 @@ namespace Voxel
 		vox.AtlasName = desc.AtlasName;
 		vox.FaceTexNames = desc.FaceTextures;
 		vox.WantsUpdate = desc.WantsUpdate;
+		vox.LightEmission = desc.LightEmission;
+		UpdatePropertyTables(index);
 		
 		auto* mesh = GetBlockVertices(desc.MeshName);
 		if (mesh)
 		{
 			vox.Mesh = *mesh;
 		}
+		UpdateRotatedMeshes(index);
 		
 		// Set other properties for blocks here
 		// FaceTexCoords are set when loading an atlas
 	}
 
+	void VoxelStore::UpdateRotatedMeshes(size_t ID)
+	{
+		if ((ID + 1) * BlockRotationCount > _rotatedMeshes.size())
+			_rotatedMeshes.resize((ID + 1) * BlockRotationCount);
+
+		auto& mesh = _descriptions[ID].Mesh;
+		auto& rotations = GetBlockRotations();
+		for (uint8_t r = 0; r < BlockRotationCount; ++r)
+		{
+			auto& rotated = _rotatedMeshes[ID * BlockRotationCount + r];
+			auto& rot = rotations[r];
+			for (auto face : BlockFacesArray)
+			{
+				auto to = (size_t)RotateFaceBy(face, r);
+				auto& verts = rotated.FaceVertices[to];
+				verts = mesh.FaceVertices[(size_t)face];
+				for (auto& vert : verts)
+				{
+					vert.Position = rot.rotate(vert.Position);
+					vert.Normal = rot.rotate(vert.Normal);
+					vert.Tangent = rot.rotate(vert.Tangent);
+					vert.Binormal = rot.rotate(vert.Binormal);
+				}
+				rotated.FaceIndices[to] = mesh.FaceIndices[(size_t)face];
+			}
+		}
+	}
+
+	void VoxelStore::UpdatePropertyTables(size_t ID)
+	{
+		if (ID >= _closedFaces.size())
+		{
+			_closedFaces.resize(ID + 1, (uint8_t)0);
+			_openFaces.resize(ID + 1, AllFaces);
+			_blockFlags.resize(ID + 1, (uint8_t)0);
+			_lightEmission.resize(ID + 1, (uint8_t)0);
+		}
+
+		auto& block = _descriptions[ID];
+		uint8_t closed = 0, open = 0;
+		for (size_t face = 0; face < 6; ++face)
+		{
+			if (block.FaceOpaqueness[face] == FaceClosedNess::CLOSED_FACE)
+				closed |= (uint8_t)(1u << face);
+			else if (block.FaceOpaqueness[face] == FaceClosedNess::OPEN_FACE)
+				open |= (uint8_t)(1u << face);
+		}
+		_closedFaces[ID] = closed;
+		_openFaces[ID] = open;
+
+		uint8_t flags = 0;
+		if (block.WantsUpdate)
+			flags |= FLAG_WANTS_UPDATE;
+		_blockFlags[ID] = flags;
+		_lightEmission[ID] = block.LightEmission;
+	}
+
 	bool VoxelStore::TryGetAtlas(const std::string& name, std::shared_ptr<StitchedAtlasSet>& out) const
 	{
 		auto it = _atlasLookup.find(name);
@@ -970,6 +1171,7 @@ namespace Voxel
 		desc.Data.Data.Rotation = quat4::identity();
 		desc.FaceOpaqueness = { FaceClosedNess::OPEN_FACE, FaceClosedNess::OPEN_FACE, FaceClosedNess::OPEN_FACE, FaceClosedNess::OPEN_FACE, FaceClosedNess::OPEN_FACE, FaceClosedNess::OPEN_FACE };
 		desc.WantsUpdate = false;
+		desc.LightEmission = 0;
 		desc.FaceTextures = { TextureNames{}, TextureNames{}, TextureNames{}, TextureNames{}, TextureNames{}, TextureNames{} };
 		return desc;
 	}
@@ -42,6 +42,11 @@
 
 #include "AtlasTypes.h"
 
+namespace Threading
+{
+	class ThreadPool;
+}
+
 namespace Voxel
 {
 	// Forward declare VoxelChunk to use as pointer
@@ -107,6 +112,7 @@ namespace Voxel
 
 		std::array<FaceClosedNess, 6> FaceOpaqueness;
 		bool WantsUpdate;
+		uint8_t LightEmission; // Block light level (0-15) this block emits, baked into chunk meshes by the light propagation
 	};
 }
 
@@ -183,6 +189,7 @@ namespace Voxel
 		SerialBlock Data;
 		std::array<FaceClosedNess, 6> FaceOpaqueness;
 		bool WantsUpdate;
+		uint8_t LightEmission;
 		std::string MeshName;
 
 		std::array<TextureNames, 6> FaceTextures;
@@ -259,16 +266,38 @@ namespace Voxel
 		std::unordered_map<std::string, std::unique_ptr<ICube>> _voxelUpdateBlockLookup;
 		std::vector<VoxelBlock> _descriptions;
 		std::vector<BlockDescription> _unstitchedDescriptions;
+		std::string _atlasCacheDirectory; // Where stitched atlases are cached (see AtlasCache), empty to disable caching
+
+		// Dense ID-indexed copies of the block properties hot loops (meshing, lighting, chunk setup) need
+		// Kept in sync with _descriptions by LoadBlock, so those loops never touch the (large) VoxelBlocks
+		enum BlockFlags : uint8_t
+		{
+			FLAG_WANTS_UPDATE = 0x1,
+		};
+		std::vector<uint8_t> _closedFaces; // Bit (1 << face) set for each CLOSED_FACE face
+		std::vector<uint8_t> _openFaces; // Bit (1 << face) set for each OPEN_FACE face
+		std::vector<uint8_t> _blockFlags;
+		std::vector<uint8_t> _lightEmission;
+
+		// Each block's mesh pre-rotated into all BlockRotationCount orientations, indexed by ID * BlockRotationCount + rotation index
+		// The faces of each variant are indexed by the direction they face after rotation, so meshing only has to translate them
+		std::vector<VoxelBlockMesh> _rotatedMeshes;
+
+		void UpdatePropertyTables(size_t ID);
+		void UpdateRotatedMeshes(size_t ID);
 
 		void LoadAtlas(const std::string& path);
 		void LoadBlockFile(const std::string& path);
+		static std::vector<BlockDescription> ParseBlockFile(const std::string& path);
+		void AddParsedBlock(const BlockDescription& desc);
 		void LoadAtlasDirectory(const std::string& directory);
-		void LoadBlockDirectory(const std::string& directory);
+		void LoadBlockDirectory(const std::string& directory, Threading::ThreadPool& pool);
 		void LoadMeshFromFile(const std::string& path);
-		void LoadMeshesFromDirectory(const std::string& path);
+		static bool ImportBlockMesh(const std::string& path, VoxelBlockMesh& out);
+		void LoadMeshesFromDirectory(const std::string& path, Threading::ThreadPool& pool);
 		void LoadDefaultCube();
 
-		void StitchUnstitched(const std::string& faceTexDir);
+		void StitchUnstitched(const std::string& faceTexDir, Threading::ThreadPool& pool);
 
 		void CheckForNoAtlasses() const;
 
@@ -276,7 +305,7 @@ namespace Voxel
 	public:
 		/**
 		* Instantiates, loads and stitches voxel atlases from disk.
-		* Loads Pre-Stitched Atlases from prestitchedDirectory, (currently not implemented)
+		* Caches stitched atlases in prestitchedDirectory, and loads them from there instead of re-stitching when their source textures haven't changed (an empty string disables the cache)
 		* Loads Block Descriptions (see example_block_file.yaml) from blockDirectory,
 		* When stitching atlases, the texture files described in Block Descriptions are assumed to be stored in faceTexDir (faceTexDir is pre-pended to non-absolute texture filenames)
 		* Also Stitches any atlases in builtInAtlases. (Uses faceTexDir for textures)
@@ -286,8 +315,9 @@ namespace Voxel
 
 		// Loading stuff
 		// v
-		void StitchAndLoadAtlas(const UnStitchedAtlasSet& set, const std::string& faceTexDir);
-		StitchedAtlasSet StichAtlas(const UnStitchedAtlasSet& set, const std::string& faceTexDir);
+		// Images are decoded on pool (or a temporary pool if null), GL uploads happen on the calling thread
+		void StitchAndLoadAtlas(const UnStitchedAtlasSet& set, const std::string& faceTexDir, Threading::ThreadPool* pool = nullptr);
+		StitchedAtlasSet StichAtlas(const UnStitchedAtlasSet& set, const std::string& faceTexDir, Threading::ThreadPool* pool = nullptr);
 
 		/**
 		* Partially Loads a BlockDescription into a VoxelBlock.
@@ -316,9 +346,29 @@ namespace Voxel
 		// ^
 		// Block Lookup
 
+		// Block property tables
+		// Cheap lookups for per-voxel loops, unknown IDs behave like the empty block (all faces open, no flags)
+		// v
+		static constexpr uint8_t AllFaces = 0x3F;
+		inline uint8_t GetClosedFaces(size_t ID) const { return ID < _closedFaces.size() ? _closedFaces[ID] : (uint8_t)0; }
+		inline uint8_t GetOpenFaces(size_t ID) const { return ID < _openFaces.size() ? _openFaces[ID] : AllFaces; }
+		inline bool IsFaceClosed(size_t ID, BlockFace face) const { return GetClosedFaces(ID) & (1u << (unsigned)face); }
+		inline bool IsFaceOpen(size_t ID, BlockFace face) const { return GetOpenFaces(ID) & (1u << (unsigned)face); }
+		inline bool BlocksLight(size_t ID) const { return GetClosedFaces(ID) == AllFaces; } // Light only passes through blocks with a face that isn't closed
+		inline bool WantsUpdate(size_t ID) const { return ID < _blockFlags.size() && (_blockFlags[ID] & FLAG_WANTS_UPDATE); }
+		inline uint8_t GetLightEmission(size_t ID) const { return ID < _lightEmission.size() ? _lightEmission[ID] : (uint8_t)0; }
+		// ^
+		// Block property tables
+
 		// Mesh stuff
 		// v
 		const VoxelBlockMesh* GetBlockVertices(const std::string& name) const;
+		// Returns the block's mesh rotated by an axis aligned rotation index (see GetBlockRotationIndex), with faces indexed by their rotated direction
+		inline const VoxelBlockMesh* GetRotatedMesh(size_t ID, uint8_t rotation) const
+		{
+			auto index = ID * BlockRotationCount + rotation;
+			return index < _rotatedMeshes.size() ? &_rotatedMeshes[index] : nullptr;
+		}
 
 		floaty3 ConvertToAtlasTexCoords(const std::string& atlasName, const TextureNames& texNames, floaty2 uv) const;
 		// ^ 
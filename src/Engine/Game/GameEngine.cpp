@@ -14,13 +14,22 @@
 
 #include <iostream>
 
-Engine::GameEngine::GameEngine() : IWindowEngine() 
+namespace
+{
+	// Where the VoxelStore loads (and caches) its atlases, blocks, face textures and meshes from, both at startup and on ReloadMeshes
+	constexpr const char *VoxelPreStitchedDir = "PreStitched";
+	constexpr const char *VoxelBlockDir = "Blocks";
+	constexpr const char *VoxelFaceTextureDir = "Textures";
+	constexpr const char *VoxelMeshDir = "Meshes";
+}
+
+Engine::GameEngine::GameEngine(Uint32 windowFlags) : IWindowEngine(windowFlags)
 { 
 	Drawing::VertexBuffer::InitializeStaticBuffer();
 	Drawing::MaterialStore::InitializeStore("Materials");
 	Drawing::ProgramStore::InitializeStore("Programs");
 	Drawing::TextureStore::InitializeStore("Textures");
-	Voxel::VoxelStore::InitializeVoxelStore("PreStitched not implemented", "Blocks", "Textures", "Meshes");
+	Voxel::VoxelStore::InitializeVoxelStore(VoxelPreStitchedDir, VoxelBlockDir, VoxelFaceTextureDir, VoxelMeshDir);
 
 	// Generate a UV Sphere
 	auto sphereMesh = GeoGen::GeometryGenerator::CreateSphere(0.5f, 16, 6);
@@ -53,6 +62,8 @@ void Engine::GameEngine::BeforeDraw()
 	if (Window_Focused)
 		SDL_GetMouseState(&MousePos.x, &MousePos.y);
 
+	Drawing::TextureStore::Instance().UpdateStreaming();
+
 	if (CurrentScene)
 		CurrentScene->BeforeDraw();
 }
@@ -67,15 +78,13 @@ void Engine::GameEngine::AfterDraw()
 {
 	if (CurrentScene)
 		CurrentScene->AfterDraw();
-
-	Ren.Present(Win.Get());
 }
 
 extern void QuitDatAss();
 
-Debug::DebugReturn Engine::GameEngine::Request(Requests::Request & action)
+void Engine::GameEngine::RegisterRequests(Requests::RequestRoutes & routes)
 {
-	if (action.Name == "FullQuit")
+	routes.Add("FullQuit", [](Requests::Request &) -> Debug::DebugReturn
 	{
 		std::cout << "You are trying to completely quit the app, this will *NOT* save any data, type IWANTTOQUIT to continue" << std::endl;
 		Stringy c;
@@ -86,24 +95,61 @@ Debug::DebugReturn Engine::GameEngine::Request(Requests::Request & action)
 			std::cout << "You failed to type IWANTTOQUIT, cancelling quit" << std::endl;
 		
 		return true;
-	}
-	else if (action.Name == "FullQuitNoWarningNoSave" || action.Name == "ExitGame")
+	});
+	auto quit = [](Requests::Request &) -> Debug::DebugReturn
 	{
 		QuitDatAss();
 		return true;
-	}
-	else if (action.Name == "ReloadMaterials")
+	};
+	routes.Add("FullQuitNoWarningNoSave", quit);
+	routes.Add("ExitGame", quit);
+	routes.Add("ReloadMaterials", [](Requests::Request &) -> Debug::DebugReturn
 	{
 		Drawing::MaterialStore::Instance().Reload("Materials");
 		return true;
-	}
-	else if (action.Name == "ReloadMeshes")
+	});
+	routes.Add("ReloadMeshes", [](Requests::Request &) -> Debug::DebugReturn
 	{
 		DINFO("Reloading voxel meshes...");
-		Voxel::VoxelStore::ReloadMeshes("PreStitched not implemented", "Blocks", "Textures", "Meshes");
+		Voxel::VoxelStore::ReloadMeshes(VoxelPreStitchedDir, VoxelBlockDir, VoxelFaceTextureDir, VoxelMeshDir);
 		return true;
-	}
-	return false;
+	});
+	routes.Add("FrameStats", [this](Requests::Request &) -> Debug::DebugReturn
+	{
+		DINFO(Stats.Describe());
+		return true;
+	});
+	routes.Add("ResetFrameStats", [this](Requests::Request &) -> Debug::DebugReturn
+	{
+		Stats.Reset();
+		return true;
+	});
+	routes.Add("ToggleFrameGraph", [this](Requests::Request &) -> Debug::DebugReturn
+	{
+		Stats.SetGraphVisible(!Stats.IsGraphVisible());
+		return true;
+	});
+	routes.Add("SetHitchThreshold", [this](Requests::Request &action) -> Debug::DebugReturn
+	{
+		if (action.Params.empty())
+			return "SetHitchThreshold needs a threshold in milliseconds";
+		try
+		{
+			Stats.SetHitchThreshold(std::stod(action.Params[0]));
+		}
+		catch (const std::exception &)
+		{
+			return "'" + action.Params[0] + "' is not a valid threshold";
+		}
+		return true;
+	});
+	routes.Add("WriteTrace", [](Requests::Request &action) -> Debug::DebugReturn
+	{
+		auto filename = action.Params.size() ? action.Params[0] : Stringy("trace.json");
+		if (!Profiling::WriteChromeTrace(filename))
+			return "Could not write the trace to '" + filename + "'";
+		return true;
+	});
 }
 #endif
 
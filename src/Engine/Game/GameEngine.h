@@ -9,14 +9,14 @@ namespace Engine
 {
 	struct GameEngine : public IWindowEngine, public Requests::IRequestable
 	{
-		GameEngine();
+		GameEngine(Uint32 windowFlags = DefaultWindowFlags);
 		virtual ~GameEngine() {};
 		
 		virtual void BeforeDraw() override;
 		virtual void Draw() override;
 		virtual void AfterDraw() override;
 		
-		Debug::DebugReturn Request(Requests::Request &action) override;
+		void RegisterRequests(Requests::RequestRoutes &routes) override;
 		inline Stringy GetName() const override { return "GameEngine instance"; }
 	protected:
 
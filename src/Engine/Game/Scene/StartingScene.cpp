@@ -61,18 +61,18 @@ void Scene::StartingScene::AfterDraw()
 	UIRoot.AfterDraw();
 }
 
-Debug::DebugReturn Scene::StartingScene::Request(Requests::Request & action)
+void Scene::StartingScene::RegisterRequests(Requests::RequestRoutes & routes)
 {
-	if (action.Name == "NewGame")
+	routes.Add("NewGame", [this](Requests::Request &) -> Debug::DebugReturn
 	{
 		NewGame();
 		return true;
-	}
-	else if (action.Name == "ContinueGame")
+	});
+	routes.Add("ContinueGame", [this](Requests::Request &) -> Debug::DebugReturn
 	{
 		return Continue();
-	}
-	else if (action.Name == "LoadGame")
+	});
+	routes.Add("LoadGame", [this](Requests::Request &action) -> Debug::DebugReturn
 	{
 		if (action.Params.size())
 		{
@@ -82,8 +82,9 @@ Debug::DebugReturn Scene::StartingScene::Request(Requests::Request & action)
 				return LoadGame((unsigned int)in);
 			}
 		}
-	}
-	else if (action.Name ==  "UI")
+		return false;
+	});
+	routes.Add("UI", [this](Requests::Request &action) -> Debug::DebugReturn
 	{
 		if (action.Params.size())
 		{
@@ -103,9 +104,8 @@ Debug::DebugReturn Scene::StartingScene::Request(Requests::Request & action)
 				return true;
 			}
 		}
-	}
-
-	return false;
+		return false;
+	});
 }
 
 void Scene::StartingScene::NewGame()
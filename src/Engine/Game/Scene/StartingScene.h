@@ -27,7 +27,7 @@ namespace Scene
 
 		inline virtual std::unique_ptr<IScene> Clone() override { return std::make_unique<StartingScene>(mResources, NextScene->Clone()); }
 
-		virtual Debug::DebugReturn Request(Requests::Request &action) override;
+		virtual void RegisterRequests(Requests::RequestRoutes &routes) override;
 		inline virtual Stringy GetName() const override { return "StartingScene instance"; }
 
 	protected:
@@ -43,6 +43,9 @@ namespace Voxel
 
 		std::unique_ptr<IScene> Clone() override;
 
+		inline Voxel::VoxelPlayer* GetPlayer() { return m_Player.get(); }
+		inline Voxel::VoxelWorld* GetWorld() { return m_World.get(); }
+
 	protected:
 
 		// G Space
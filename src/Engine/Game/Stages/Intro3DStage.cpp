@@ -49,14 +49,13 @@ void PrologueStage::AfterDraw()
 	Environment.AfterDraw();
 }
 
-Debug::DebugReturn PrologueStage::Request(Requests::Request &request)
+void PrologueStage::RegisterRequests(Requests::RequestRoutes &routes)
 {
-	if (request.Name == "EndLevel")
+	routes.Add("EndLevel", [this](Requests::Request &) -> Debug::DebugReturn
 	{
 		Manager->ChangeStageTo("Level2");
 		return true;
-	}
-	return false;
+	});
 }
 
 std::string PrologueStage::GetName() const
@@ -21,7 +21,7 @@ struct PrologueStage : IStage, FullResourceHolder, Requests::IRequestable
 	void Draw() override;
 	void AfterDraw() override;
 
-	virtual Debug::DebugReturn Request(Requests::Request &request) override;
+	virtual void RegisterRequests(Requests::RequestRoutes &routes) override;
 	virtual std::string GetName() const override;
 
 protected:
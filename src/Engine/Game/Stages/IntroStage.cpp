@@ -59,16 +59,16 @@ size_t TerminalSequence::GetIndex(double localtime) const
 	return (size_t)percentage;
 }
 
-void TerminalSequence::DrawTheText(std::string amount) const
+void TerminalSequence::DrawTheText(std::string amount)
 {
 	if (amount.size())
 	{
 		floaty2 target = floaty2::TLtoGL({ 25.f, 25.f }, { *mResources->HalfWindowWidth, *mResources->HalfWindowHeight });
 
-		TextDrawing text = { mResources, amount, "Terminal", "Terminal" };
+		Text.SetText(amount);
 
 		mResources->Ren2->SetTransform(Matrixy2x3::Identity());
-		mResources->Ren2->DrawImage(&text, target);
+		mResources->Ren2->DrawText(&Text, target);
 	}
 }
 
@@ -8,6 +8,7 @@
 #include <Systems/Events/EventsBase.h>
 #include <Systems/Sequence/TimeSequence.h>
 #include <Systems/Sequence/TerminalSequence.h>
+#include <Drawing/TextDrawing.h>
 
 
 
@@ -27,19 +28,20 @@ protected:
 
 struct TerminalSequence : Sequence::ITimedSequenceElement, virtual FullResourceHolder, TextBrushHolder, NormalFontHolder
 {
-	TerminalSequence(CommonResources *resources) : FullResourceHolder(resources), TextBrushHolder("Terminal"), NormalFontHolder("Terminal") { EnsureFormat(); EnsureBrush(); }
-	TerminalSequence(CommonResources *resources, Stringy content) : FullResourceHolder(resources), TextBrushHolder("Terminal"), NormalFontHolder("Terminal"), Content(content) { EnsureFormat(); EnsureBrush(); }
+	TerminalSequence(CommonResources *resources) : FullResourceHolder(resources), TextBrushHolder("Terminal"), NormalFontHolder("Terminal"), Text(resources, "", "Terminal", "Terminal") { EnsureFormat(); EnsureBrush(); }
+	TerminalSequence(CommonResources *resources, Stringy content) : FullResourceHolder(resources), TextBrushHolder("Terminal"), NormalFontHolder("Terminal"), Content(content), Text(resources, "", "Terminal", "Terminal") { EnsureFormat(); EnsureBrush(); }
 
 	virtual double Apply(double localtime) override;	
 
 	void EnsureFormat();
 	void EnsureBrush();
 	size_t GetIndex(double localtime) const;
-	void DrawTheText(Stringy amount) const;
+	void DrawTheText(Stringy amount);
 	inline void SetContent(Stringy content) { Content = content; }
 
 protected:
 	Stringy Content{ "Default Terminal Message" };
+	TextDrawing Text; // Only laid out again when the displayed part of Content grows
 
 	double Duration{ 10.f };
 };
@@ -57,14 +57,13 @@ namespace Precipice
 		m_Environment.AfterDraw();
 	}
 
-	Debug::DebugReturn IntroStage::Request(Requests::Request &request)
+	void IntroStage::RegisterRequests(Requests::RequestRoutes &routes)
 	{
-		if (request.Name == "EndLevel")
+		routes.Add("EndLevel", [this](Requests::Request &) -> Debug::DebugReturn
 		{
 			Manager->ChangeStageTo("Precipice2");
 			return true;
-		}
-		return false;
+		});
 	}
 
 	std::string IntroStage::GetName() const
@@ -135,14 +134,13 @@ namespace Precipice
 		m_Environment.AfterDraw();
 	}
 
-	Debug::DebugReturn SecondStage::Request(Requests::Request &request)
+	void SecondStage::RegisterRequests(Requests::RequestRoutes &routes)
 	{
-		if (request.Name == "EndLevel")
+		routes.Add("EndLevel", [this](Requests::Request &) -> Debug::DebugReturn
 		{
 			Manager->ChangeStageTo("Precipice3");
 			return true;
-		}
-		return false;
+		});
 	}
 
 	std::string SecondStage::GetName() const
@@ -192,14 +190,13 @@ namespace Precipice
 	{
 		m_Environment.AfterDraw();
 	}
-	Debug::DebugReturn ThirdStage::Request(Requests::Request &request)
+	void ThirdStage::RegisterRequests(Requests::RequestRoutes &routes)
 	{
-		if (request.Name == "EndLevel")
+		routes.Add("EndLevel", [](Requests::Request &) -> Debug::DebugReturn
 		{
 			DINFO("Woo you won");
 			return true;
-		}
-		return false;
+		});
 	}
 	std::string ThirdStage::GetName() const
 	{
@@ -22,7 +22,7 @@ namespace Precipice
 		void Draw() override;
 		void AfterDraw() override;
 
-		virtual Debug::DebugReturn Request(Requests::Request &request) override;
+		virtual void RegisterRequests(Requests::RequestRoutes &routes) override;
 		virtual std::string GetName() const override;
 
 	protected:
@@ -43,7 +43,7 @@ namespace Precipice
 		void Draw() override;
 		void AfterDraw() override;
 
-		virtual Debug::DebugReturn Request(Requests::Request &request) override;
+		virtual void RegisterRequests(Requests::RequestRoutes &routes) override;
 		virtual std::string GetName() const override;
 
 	protected:
@@ -64,7 +64,7 @@ namespace Precipice
 		void Draw() override;
 		void AfterDraw() override;
 
-		virtual Debug::DebugReturn Request(Requests::Request &request) override;
+		virtual void RegisterRequests(Requests::RequestRoutes &routes) override;
 		virtual std::string GetName() const override;
 
 	protected:
@@ -178,7 +178,7 @@ void UI1I::SizedUITextBox::IDraw()
 	mResources->Ren2->SetTransform(this->LocalToWorld);
 	
 	floaty4 bounds = m_Position.GetTransformedBounds(m_ParentBounds);
-	mResources->Ren2->DrawImage(&Text, LocalBounds);
+	mResources->Ren2->DrawText(&Text, LocalBounds);
 }
 
 void UI1I::UIImage::IDraw()
@@ -21,7 +21,7 @@ void Options::SliderOption::IDraw()
 	x += m_Active.Margin;
 	//float y = LocalBounds.top - m_Active.Margin - m_Active.Border;
 	float halfheight = 0.5f * (float)m_Name.GetHeight();
-	Ren->DrawImage(&m_Name, { x, 0.8f * halfheight, x + (float)m_Name.GetWidth(), -1.2f * halfheight });
+	Ren->DrawText(&m_Name, { x, 0.8f * halfheight, x + (float)m_Name.GetWidth(), -1.2f * halfheight });
 	x += (float)m_Name.GetWidth();
 		
 	x += m_Active.NameValueGap;
@@ -30,7 +30,7 @@ void Options::SliderOption::IDraw()
 	if (m_Info.Display & SliderThings::Value)
 	{
 		halfheight = 0.5f * (float)m_Value.GetHeight();
-		Ren->DrawImage(&m_Value, { x, 0.8f * halfheight, x + (float)m_Value.GetWidth(), - 1.2f * halfheight });
+		Ren->DrawText(&m_Value, { x, 0.8f * halfheight, x + (float)m_Value.GetWidth(), - 1.2f * halfheight });
 		x += ValueReservedSpace;
 		x += m_Active.Margin;
 	}
@@ -5,6 +5,8 @@
 
 #include "VoxelWorld.h"
 #include "VoxelTypes.h"
+#include "VoxelLight.h"
+#include "VoxelFaceCulling.h"
 #include "Drawing/VoxelStore.h"
 #include "Drawing/IRen3Dv2.h"
 
@@ -50,6 +52,7 @@ namespace Voxel
 		, m_Data()
 		, m_UpdateBlocks()
 	{
+		Publish(std::make_shared<const ChunkData>());
 	}
 
 	Voxel::VoxelChunk::VoxelChunk(G1::IGSpace* container, CommonResources* resources, VoxelWorld* world, floaty3 origin, RawChunkDataMap initial_dat, ChunkCoord coord)
@@ -74,7 +77,11 @@ namespace Voxel
 		}
 		PROFILE_POP();*/
 		auto p = ConvertMapToData(initial_dat);
-		SetFrom(GenerateChunkMesh(*p, coord, [world = this->m_World](BlockCoord coord) { return world->GetCubeDataAt(coord); }));
+		// Neighbours are only read through their published blocks
+		m_World->PublishChunkEdits();
+		auto loaded = GenerateChunkMesh(*p, coord, m_World->GetNeighbourhood(coord));
+		loaded->ChunkDat = std::move(p);
+		SetFrom(std::move(loaded));
 		PROFILE_PUSH("Submitting DrawCall");
 		auto name = std::string("Chunk (") + std::to_string(coord.X) + ", " + std::to_string(coord.Y) + ", " + std::to_string(coord.Z) + ")";
 		m_DrawCall = resources->Ren3v2->SubmitDrawCall(Drawing::DrawCallv2{ m_Mesh, m_Material, std::make_shared<Matrixy4x4>(Matrixy4x4::Translate(m_Origin)), name, true });
@@ -105,7 +112,10 @@ namespace Voxel
 		for (auto& block : m_UpdateBlocks)
 		{
 			if (block.second)
+			{
 				block.second->OnUnloaded();
+				Untrack(block.second.get());
+			}
 		}
 		if (m_Body)
 		{
@@ -118,11 +128,7 @@ namespace Voxel
 		if (m_Culler)
 			m_Culler->Flush();
 
-		for (auto& updateBlockPair : m_UpdateBlocks)
-		{
-			if (updateBlockPair.second)
-				updateBlockPair.second->BeforeDraw();
-		}
+		// Update blocks are ticked by the world's BlockTickScheduler, not per chunk
 
 		if (m_Dirty)
 		{
@@ -133,11 +139,6 @@ namespace Voxel
 
 	void Voxel::VoxelChunk::AfterDraw()
 	{
-		for (auto& updateBlockPair : m_UpdateBlocks)
-		{
-			if (updateBlockPair.second)
-				updateBlockPair.second->AfterDraw();
-		}
 	}
 
 	void Voxel::VoxelChunk::UpdateOrigin(floaty3 origin)
@@ -155,9 +156,17 @@ namespace Voxel
 	void Voxel::VoxelChunk::set(uint8_t x, uint8_t y, uint8_t z, std::unique_ptr<Voxel::ICube> val)
 	{
 		ChunkBlockCoord key{ x, y, z };
-		m_Data[x][y][z] = val->GetBlockData();
-		auto& block = m_UpdateBlocks[key] = std::move(val);
+		auto& data = EditBlocks();
+		auto before = data[x][y][z];
+		data[x][y][z] = val->GetBlockData();
+		if (AffectsLight(before, data[x][y][z]))
+			MarkLightChanged(Vector::inty3{ x, y, z });
+		auto& block = m_UpdateBlocks[key];
+		if (block)
+			Untrack(block.get());
+		block = std::move(val);
 		block->Attach(m_World, this, key);
+		Track(block.get());
 		block->OnLoaded();
 		block->OnPlaced();
 		m_Dirty = true;
@@ -175,9 +184,14 @@ namespace Voxel
 		{
 			curIt->second->OnDestroyed();
 			curIt->second->OnUnloaded();
+			Untrack(curIt->second.get());
 			m_UpdateBlocks.erase(curIt);
 		}
-		m_Data[coord.x][coord.y][coord.z] = block;
+		auto& data = EditBlocks();
+		auto before = data[coord.x][coord.y][coord.z];
+		data[coord.x][coord.y][coord.z] = block;
+		if (AffectsLight(before, block))
+			MarkLightChanged(Vector::inty3{ coord.x, coord.y, coord.z });
 		auto desc = VoxelStore::Instance().GetDescOrEmpty(block.ID);
 		if (desc->WantsUpdate)
 		{
@@ -185,6 +199,7 @@ namespace Voxel
 			if (tmp)
 			{
 				auto& newBlock = m_UpdateBlocks[coord] = std::move(tmp);
+				Track(newBlock.get());
 				newBlock->OnLoaded();
 				newBlock->OnPlaced();
 			}
@@ -207,7 +222,7 @@ namespace Voxel
 
 	const SerialBlock& VoxelChunk::get_data(ChunkBlockCoord coord) const
 	{
-		return m_Data[coord.x][coord.y][coord.z];
+		return Blocks()[coord.x][coord.y][coord.z];
 	}
 
 	ChunkCoord VoxelChunk::GetCoord() const
@@ -217,7 +232,7 @@ namespace Voxel
 
 	const ChunkData& VoxelChunk::GetSerialChunkData() const
 	{
-		return m_Data;
+		return Blocks();
 	}
 
 	std::unique_ptr<ICube> VoxelChunk::take(ChunkBlockCoord coord)
@@ -226,8 +241,13 @@ namespace Voxel
 		if (it != m_UpdateBlocks.end())
 		{
 			it->second->OnUnloaded();
-			it->second->Detach(std::move(m_Data[coord.x][coord.y][coord.z]));
-			m_Data[coord.x][coord.y][coord.z] = SerialBlock{};
+			Untrack(it->second.get());
+			auto& data = EditBlocks();
+			auto before = data[coord.x][coord.y][coord.z];
+			it->second->Detach(before);
+			data[coord.x][coord.y][coord.z] = SerialBlock{};
+			if (AffectsLight(before, SerialBlock{}))
+				MarkLightChanged(Vector::inty3{ coord.x, coord.y, coord.z });
 			return std::move(it->second);
 		}
 		return nullptr;
@@ -248,8 +268,11 @@ namespace Voxel
 	{
 		if (constructCubes)
 		{
-			m_Data = std::move(preLoadedChunk->ChunkDat);
+			m_Edits = nullptr;
+			Publish(std::move(preLoadedChunk->ChunkDat));
 			auto& vox = Voxel::VoxelStore::Instance();
+			for (auto& block : m_UpdateBlocks)
+				Untrack(block.second.get());
 			m_UpdateBlocks.clear();
 			for (uint8_t x = 0; x < Chunk_Size; ++x)
 			{
@@ -257,12 +280,11 @@ namespace Voxel
 				{
 					for (uint8_t z = 0; z < Chunk_Size; ++z)
 					{
-						auto& block = m_Data[x][y][z];
-						const VoxelBlock* desc;
-						if (vox.TryGetDescription(block.ID, desc) && desc->WantsUpdate)
+						auto& block = (*m_Data)[x][y][z];
+						if (vox.WantsUpdate(block.ID))
 						{
 							auto pos = ChunkBlockCoord{ x,y,z };
-							auto tmp = vox.CreateCube(m_World, this, pos, preLoadedChunk->ChunkDat[x][y][z]);
+							auto tmp = vox.CreateCube(m_World, this, pos, block);
 							if (tmp)
 							{
 								 m_UpdateBlocks[pos] = std::move(tmp);
@@ -273,8 +295,19 @@ namespace Voxel
 			}
 			for (auto& block : m_UpdateBlocks)
 			{
+				Track(block.second.get());
 				block.second->OnLoaded();
 			}
+
+			PublishLight(std::move(preLoadedChunk->Light));
+		}
+		else
+		{
+			// Changes made before this was requested are lit in its light
+			auto request = preLoadedChunk->LightRequest;
+			auto covered = std::find_if(m_LightChanges.begin(), m_LightChanges.end(), [request](auto& change) { return change.first > request; });
+			m_LightChanges.erase(m_LightChanges.begin(), covered);
+			PublishLight(std::move(preLoadedChunk->Light));
 		}
 
 		auto m = Drawing::Mesh{ std::move(preLoadedChunk->Mesh), Drawing::MeshStorageType::DEDICATED_BUFFER };
@@ -328,7 +361,79 @@ namespace Voxel
 
 		auto& world = *m_World;
 
-		world.ReloadChunkAt(m_Coord, m_Data);
+		// Only the blocks around light changes are re-lit, unless there's no light to start from
+		std::vector<Vector::inty3> lightChanges;
+		if (m_Light)
+		{
+			lightChanges.reserve(m_LightChanges.size());
+			for (auto& change : m_LightChanges)
+				lightChanges.push_back(change.second);
+		}
+
+		// Every chunk's edits are published first so the loading thread reads up to date neighbours, and the request shares this chunk's published blocks instead of copying them
+		world.PublishChunkEdits();
+		world.ReloadChunkAt(m_Coord, m_Data, m_Light, std::move(lightChanges), m_LightRequests++);
+	}
+
+	void VoxelChunk::PublishEdits()
+	{
+		if (m_Edits)
+			Publish(std::shared_ptr<const ChunkData>(std::move(m_Edits)));
+	}
+
+	const ChunkData& VoxelChunk::Blocks() const
+	{
+		return m_Edits ? *m_Edits : *m_Data;
+	}
+
+	ChunkData& VoxelChunk::EditBlocks()
+	{
+		// The published blocks may be being read, so the first edit since they were published copies them
+		if (!m_Edits)
+		{
+			m_Edits = std::make_unique<ChunkData>(*m_Data);
+			if (m_World)
+				m_World->QueueChunkPublish(m_Coord);
+		}
+		return *m_Edits;
+	}
+
+	void VoxelChunk::Publish(std::shared_ptr<const ChunkData> data)
+	{
+		auto old = std::move(m_Data);
+		m_Data = std::move(data);
+		m_PublishedData.store(m_Data.get(), std::memory_order_release);
+		if (old && m_World)
+			m_World->RetireChunkData(std::move(old));
+	}
+
+	void VoxelChunk::PublishLight(std::shared_ptr<const ChunkLightMap> light)
+	{
+		if (light == m_Light)
+			return;
+		auto old = std::move(m_Light);
+		m_Light = std::move(light);
+		m_PublishedLight.store(m_Light.get(), std::memory_order_release);
+		if (old && m_World)
+			m_World->RetireChunkData(std::move(old));
+	}
+
+	void VoxelChunk::MarkLightChanged(Vector::inty3 at)
+	{
+		m_LightChanges.emplace_back(m_LightRequests, at);
+		m_Dirty = true;
+	}
+
+	void VoxelChunk::Track(ICube* cube)
+	{
+		if (m_World && cube)
+			m_World->GetBlockTicks().Add(cube);
+	}
+
+	void VoxelChunk::Untrack(ICube* cube)
+	{
+		if (m_World && cube)
+			m_World->GetBlockTicks().Remove(cube);
 	}
 
 	std::string VoxelChunk::CreateChunkName(ChunkCoord coord)
@@ -344,7 +449,7 @@ namespace Voxel
 		return std::make_unique<ChunkyFrustumCuller>(origin, floaty3{ Voxel::Chunk_Size, Voxel::Chunk_Height, Voxel::Chunk_Size });
 	}
 
-	std::unique_ptr<LoadedChunk> GenerateChunkMeshT(const ChunkData& data, ChunkCoord coord, std::function<SerialBlock(BlockCoord coord)> blockDataFunc)
+	std::unique_ptr<LoadedChunk> GenerateChunkMeshT(const ChunkData& data, ChunkCoord coord, const ChunkNeighbourhood& around, std::shared_ptr<const ChunkLightMap> previousLight, const std::vector<Vector::inty3>& lightChanges)
 	{
 		std::unique_ptr<Voxel::LoadedChunk> chunk = std::make_unique<Voxel::LoadedChunk>();
 
@@ -356,78 +461,54 @@ namespace Voxel
 		// Actual generate mesh
 		// v
 
-		// Simplest method: just add 3 vertices and 3 indices for each exposed face of a block
-
-		auto convertRelToCoord = [coord](int x, int y, int z)
-		{
-			BlockCoord co;
-			co.Chunk = coord;
-			co.Block.x = (uint32_t)x;
-			co.Block.y = (uint32_t)y;
-			co.Block.z = (uint32_t)z;
-			if (x < 0)
-			{
-				--co.Chunk.X;
-				co.Block.x = Chunk_Size - 1;
-			}
-			if (y < 0)
-			{
-				--co.Chunk.Y;
-				co.Block.y = Chunk_Height - 1;
-			}
-			if (z < 0)
-			{
-				--co.Chunk.Z;
-				co.Block.z = Chunk_Size - 1;
-			}
-			if (x >= (int)Chunk_Size)
-			{
-				++co.Chunk.X;
-				co.Block.x = 0;
-			}
-			if (y >= (int)Chunk_Height)
-			{
-				++co.Chunk.Y;
-				co.Block.y = 0;
-			}
-			if (z >= (int)Chunk_Size)
-			{
-				++co.Chunk.Z;
-				co.Block.z = 0;
-			}
-			return co;
-		};
-
 		auto& vox = Voxel::VoxelStore::Instance();
 
-		auto cubeAtHasFace = [&blockDataFunc, &data, &convertRelToCoord, &vox, coord](int chunkRelativeX, int chunkRelativeY, int chunkRelativeZ, BlockFace face)
-		{
-			if (chunkRelativeX < 0 || chunkRelativeY < 0 || chunkRelativeZ < 0 ||
-				chunkRelativeX >= Chunk_Size || chunkRelativeY >= Chunk_Height || chunkRelativeZ >= Chunk_Size)
-				return vox.GetDescOrEmpty(blockDataFunc(convertRelToCoord(chunkRelativeX, chunkRelativeY, chunkRelativeZ)).ID)->FaceOpaqueness[(int)face] == FaceClosedNess::CLOSED_FACE;
-			return vox.GetDescOrEmpty(data[chunkRelativeX][chunkRelativeY][chunkRelativeZ].ID)->FaceOpaqueness[(int)face] == FaceClosedNess::CLOSED_FACE;
-		};
+		// Exposed faces are worked out for the whole chunk up front, a column of blocks at a time
+		TRACE_PUSH("Face Culling");
+		auto faces = ComputeChunkFaceMasks(data, around);
+		TRACE_POP();
 
-		auto origin = coord;
+		// Light is flood filled before meshing so each face can be given the light of the space it faces
+		// Chunks that already have light (and so are being remeshed) only re-flood the blocks around what changed
+		TRACE_PUSH("Lighting");
+		if (!previousLight)
+		{
+			chunk->Light = std::make_shared<ChunkLightMap>(ComputeChunkLight(data, around));
+		}
+		else if (lightChanges.empty())
+		{
+			chunk->Light = std::move(previousLight);
+		}
+		else
+		{
+			auto updated = std::make_shared<ChunkLightMap>(*previousLight);
+			UpdateChunkLight(*updated, data, around, lightChanges);
+			chunk->Light = std::move(updated);
+		}
+		TRACE_POP();
+		auto& light = *chunk->Light;
 
-		auto AddVerticesFunc = [&vertices, &indices, origin](const VoxelBlock* block, int chunkRelativeX, int chunkRelativeY, int chunkRelativeZ, BlockFace face, const CubeData& data)
+		// Block meshes are pre-rotated by the VoxelStore, with faces indexed by the direction they face in the world
+		// So adding a face is a copy and translate
+		auto AddVerticesFunc = [&vertices, &indices, &light](const VoxelBlockMesh* mesh, int chunkRelativeX, int chunkRelativeY, int chunkRelativeZ, BlockFace face)
 		{
 			// Generate vertices
 			constexpr auto blockOffset = floaty3{ 0.5f * BlockSize, 0.5f * BlockSize, 0.5f * BlockSize }; // Offset necessary to make any origin cubes actually on the origin
 			auto base = floaty3{ (float)chunkRelativeX * BlockSize, (float)chunkRelativeY * BlockSize, (float)chunkRelativeZ * BlockSize } + blockOffset;
 
-			auto& verts = block->Mesh.FaceVertices[(size_t)face];
-			auto& block_indices = block->Mesh.FaceIndices[(size_t)face];
-			
-			auto rot = data.Rotation;
+			auto& verts = mesh->FaceVertices[(size_t)face];
+			auto& block_indices = mesh->FaceIndices[(size_t)face];
+
+			// A face is lit by the block it faces, or the block itself for blocks light can get inside of
+			auto facing = Vector::inty3{ chunkRelativeX, chunkRelativeY, chunkRelativeZ } + BlockFaceHelper::GetDirectionI(face);
+			auto faceLight = light.GetNormalized(facing.x, facing.y, facing.z);
+			auto ownLight = light.GetNormalized(chunkRelativeX, chunkRelativeY, chunkRelativeZ);
+			faceLight = floaty2{ std::max(faceLight.x, ownLight.x), std::max(faceLight.y, ownLight.y) };
 
 			auto index_base = (unsigned int)vertices.size();
 			for (Voxel::VoxelVertex vert : verts)
 			{
-				vert.Position = rot.rotate(vert.Position);
-				vert.Normal = rot.rotate(vert.Normal);
-				vert.Tangent = rot.rotate(vert.Tangent);
-				vert.Binormal = rot.rotate(vert.Binormal);
+				vert.Light = faceLight;
 				vert.Position += base;
 				vertices.push_back(vert);
 			}
@@ -438,50 +519,41 @@ namespace Voxel
 			}
 		};
 
+		TRACE_PUSH("Mesh");
 		for (int x = 0; x < Chunk_Size; ++x)
 		{
-			for (int y = 0; y < Chunk_Height; ++y)
+			for (int z = 0; z < Chunk_Size; ++z)
 			{
-				for (int z = 0; z < Chunk_Size; ++z)
+				for (auto column = faces.GetAnyVisible(x, z); column; column &= column - 1)
 				{
+					int y = LowestBit(column);
 					auto& blockDat = data[x][y][z];
-					if (blockDat.ID == 0)
-						continue;
-					const Voxel::VoxelBlock *desc;
-					if (!Voxel::VoxelStore::Instance().TryGetDescription(blockDat.ID, desc))
-						continue;
 
-					// go through neighbours check if there is a block there
-					// if there isn't add triangles to mesh
+					// Faces are in rotated (world) directions, the rotation only picks which pre-rotated mesh to copy from
+					auto mesh = vox.GetRotatedMesh(blockDat.ID, GetBlockRotationIndex(blockDat.Data.Rotation));
+					if (!mesh)
+						continue;
 
 					for (auto& face : BlockFacesArray)
 					{
-						if (desc->FaceOpaqueness[(size_t)face] == FaceClosedNess::OPEN_FACE)
-						{
-							AddVerticesFunc(desc, x, y, z, face, blockDat.Data);
-							continue;
-						}
-
-						auto rot = blockDat.Data.Rotation;
-
-						auto dir = BlockFaceHelper::GetDirectionI(face);
-						auto rotatedDir = rot.rotate(dir);
-						auto rotatedFace = Voxel::RotateFace(face, rot);
-						Vector::inty3 neighbourPos = Vector::inty3{ x, y, z } + rotatedDir;					
-						if (!cubeAtHasFace(neighbourPos.x, neighbourPos.y, neighbourPos.z, rotatedFace))
-							AddVerticesFunc(desc, x, y, z, face, blockDat.Data);
+						if (faces.IsVisible(face, x, y, z))
+							AddVerticesFunc(mesh, x, y, z, face);
 					}
 				}
 			}
 		}
 
+		TRACE_POP();
+
 		// ^
 		// Mesh
 		// De Duplication
 		// v
 
+		TRACE_PUSH("Weld");
 		chunk->Mesh = Drawing::RawMesh{ Drawing::VertexData::FromGeneric(Voxel::VoxelVertexDesc, vertices.begin(), vertices.end()), indices };
 		auto deDupedMesh = MeshHelp::DeDuplicateVertices(Drawing::MeshView<Voxel::VoxelVertex>(chunk->Mesh));
+		TRACE_POP();
 
 		// ^
 		// De Dup
@@ -490,6 +562,7 @@ namespace Voxel
 
 		if (deDupedMesh.vertexData.NumVertices())
 		{
+			TRACE_ZONE("BVH");
 			size_t numVerts = deDupedMesh.vertexData.NumVertices();
 			// Copy vertices to permanent buffer
 			chunk->PhysicsPositions = std::make_unique<std::vector<floaty3>>();
@@ -551,8 +624,8 @@ namespace Voxel
 		//	m_Mesh = std::make_shared<Drawing::Mesh>(std::move(mesh));
 	}
 
-	std::unique_ptr<LoadedChunk> GenerateChunkMesh(const ChunkData& data, ChunkCoord coord, std::function<SerialBlock(Voxel::BlockCoord coord)> blockDataFunc)
+	std::unique_ptr<LoadedChunk> GenerateChunkMesh(const ChunkData& data, ChunkCoord coord, const ChunkNeighbourhood& around, std::shared_ptr<const ChunkLightMap> previousLight, const std::vector<Vector::inty3>& lightChanges)
 	{
-		return GenerateChunkMeshT(data, coord, std::move(blockDataFunc));
+		return GenerateChunkMeshT(data, coord, around, std::move(previousLight), lightChanges);
 	}
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "VoxelTypes.h"
 #include "VoxelCube.h"
 #include "VoxelChunkCuller.h"
+#include "VoxelNeighbourhood.h"
 
 #include "Drawing/Mesh.h"
 #include "Drawing/Geometry.h"
@@ -18,6 +19,7 @@
 #include <functional>
 #include <unordered_map>
 #include <climits>
+#include <atomic>
 
 namespace std
 {
@@ -26,10 +28,10 @@ namespace std
 	{
 		inline size_t operator()(const Voxel::ChunkCoord &in) const
 		{
-			size_t out = 0;
-			out |= (((size_t)in.X + (size_t)LLONG_MAX) >> 42) >> 42;
-			out |= (((size_t)in.Y + (size_t)LLONG_MAX) >> 42) << 21;
-			out |= (((size_t)in.Z + (size_t)LLONG_MAX) >> 42) << 42;
+			// Large primes spatial hash, every axis contributes to every bit
+			size_t out = (size_t)in.X * (size_t)73856093ull;
+			out ^= (size_t)in.Y * (size_t)19349663ull;
+			out ^= (size_t)in.Z * (size_t)83492791ull;
 			return out;
 		}
 	};
@@ -62,10 +64,9 @@ namespace std
 namespace Voxel
 {
 	class VoxelWorld;
+	class ChunkLightMap;
 
 	typedef std::unordered_map<ChunkBlockCoord, SerialBlock> RawChunkDataMap;
-
-	typedef std::array<std::array<std::array<SerialBlock, Chunk_Size>, Chunk_Height>, Chunk_Size> ChunkData;
 	std::unique_ptr<ChunkData> ConvertMapToData(const RawChunkDataMap& m);
 
 	struct IChunkLoader
@@ -89,12 +90,18 @@ namespace Voxel
 	struct LoadedChunk
 	{
 		ChunkCoord Coord;
-		ChunkData ChunkDat;
+		std::shared_ptr<const ChunkData> ChunkDat;
 		std::unique_ptr<std::vector<floaty3>> PhysicsPositions;
 		std::unique_ptr<std::vector<unsigned int>> PhysicsIndices;
 		std::shared_ptr<btTriangleIndexVertexArray> PhysicsTriangles;
 		std::shared_ptr<btBvhTriangleMeshShape> PhysicsShape;
 		Drawing::RawMesh Mesh;
+		// Kept by the chunk so later edits only re-light the blocks around them, see UpdateChunkLight
+		std::shared_ptr<const ChunkLightMap> Light;
+		// Which of the chunk's recompute requests this is the result of (see VoxelChunk::RecomputeMesh)
+		uint64_t LightRequest = 0;
+		// When the chunk was queued for loading (Profiling::Now), 0 for recomputed chunks
+		uint64_t QueuedAt = 0;
 	};
 
 	class VoxelChunk : public G1::IShape, public BulletHelp::INothingInterface
@@ -123,9 +130,17 @@ namespace Voxel
 
 		ICube* get(uint8_t x, uint8_t y, uint8_t z);
 		ICube* get(ChunkBlockCoord coord);
+		// Main thread only (the only thread that writes blocks), includes blocks set since the last PublishEdits
 		const SerialBlock& get_data(ChunkBlockCoord coord) const;
 		ChunkCoord GetCoord() const;
 
+		// The published blocks and light, read without locking so safe from registered readers of the world's chunks (see ChunkGrid)
+		// Blocks set on the main thread aren't seen until they're published, light is null until the chunk is first lit
+		inline const ChunkData* ReadBlocks() const { return m_PublishedData.load(std::memory_order_acquire); }
+		inline const ChunkLightMap* ReadLight() const { return m_PublishedLight.load(std::memory_order_acquire); }
+		// Main thread only
+		inline const ChunkLightMap* GetLight() const { return m_Light.get(); }
+
 		const ChunkData& GetSerialChunkData() const;
 
 		// Use with caution, will remove the block from this chunk
@@ -135,7 +150,14 @@ namespace Voxel
 
 		void SetFrom(std::unique_ptr<LoadedChunk> preLoadedChunk, bool constructCubes = true);
 
+		// Makes the blocks set since the last call visible to other threads, see VoxelWorld::PublishChunkEdits
+		void PublishEdits();
+
 		void RecomputeMesh();
+		// Flags the chunk to be remeshed before it is next drawn
+		inline void MarkDirty() { m_Dirty = true; }
+		// Flags the chunk to be remeshed with the light re-flooded around a changed block (chunk relative, one outside the chunk for a neighbour's seed)
+		void MarkLightChanged(Vector::inty3 at);
 
 	protected:
 		
@@ -143,7 +165,23 @@ namespace Voxel
 
 		std::unique_ptr<ChunkyFrustumCuller> CreateCuller(floaty3 origin);
 
-		ChunkData m_Data;
+		// Registers/unregisters update blocks with the world's tick scheduler
+		void Track(ICube* cube);
+		void Untrack(ICube* cube);
+
+		// The blocks as the main thread sees them, and a copy of them for the main thread to set blocks in
+		const ChunkData& Blocks() const;
+		ChunkData& EditBlocks();
+		// Replace the published blocks/light, the old ones are retired until no reader can be using them
+		void Publish(std::shared_ptr<const ChunkData> data);
+		void PublishLight(std::shared_ptr<const ChunkLightMap> light);
+
+		// The published blocks, never written once published so other threads read them without locks
+		std::shared_ptr<const ChunkData> m_Data;
+		// Mirrors m_Data for other threads
+		std::atomic<const ChunkData*> m_PublishedData{ nullptr };
+		// Copy of m_Data with the blocks set since it was last published, null if none have been
+		std::unique_ptr<ChunkData> m_Edits;
 		std::unordered_map<ChunkBlockCoord, std::unique_ptr<ICube>> m_UpdateBlocks;
 		floaty3 m_Origin;
 		VoxelWorld *m_World = nullptr;
@@ -167,7 +205,16 @@ namespace Voxel
 		Drawing::DrawCallReference m_DrawCall;
 
 		bool m_Dirty = false;
+
+		// The light the current mesh was built with, published for neighbours to be seeded from
+		std::shared_ptr<const ChunkLightMap> m_Light;
+		std::atomic<const ChunkLightMap*> m_PublishedLight{ nullptr };
+		// Blocks whose light changed since m_Light, each with the number of recompute requests made before it
+		// Results of requests made after a change have it lit, so changes are dropped as those results arrive
+		std::vector<std::pair<uint64_t, Vector::inty3>> m_LightChanges;
+		uint64_t m_LightRequests = 0;
 	};
 
-	std::unique_ptr<LoadedChunk> GenerateChunkMesh(const ChunkData& chunk, ChunkCoord coord, std::function<SerialBlock(BlockCoord)> blockDataFunc);
+	// Re-lights only around lightChanges if given the chunk's previous light, otherwise computes its light from scratch
+	std::unique_ptr<LoadedChunk> GenerateChunkMesh(const ChunkData& chunk, ChunkCoord coord, const ChunkNeighbourhood& around, std::shared_ptr<const ChunkLightMap> previousLight = nullptr, const std::vector<Vector::inty3>& lightChanges = {});
 }
\ No newline at end of file
@@ -0,0 +1,202 @@
+#pragma once
+
+#include "VoxelChunk.h"
+
+#include "Systems/Threading/EpochDomain.h"
+
+#include <vector>
+#include <memory>
+#include <atomic>
+
+namespace Voxel
+{
+	struct ChunkSlot
+	{
+		// Owned by the main thread
+		ChunkCoord Coord = { 0, 0, 0 };
+		bool InUse = false; // In use with a null Chunk means the chunk is being loaded
+		std::unique_ptr<VoxelChunk> Chunk;
+
+		// Readable from any thread, mirrors Chunk once the chunk is fully constructed
+		std::atomic<VoxelChunk*> Published{ nullptr };
+	};
+
+	/// <summary>
+	/// Fixed size toroidal grid of chunk slots, indexed by chunk coord modulo the grid size along each axis
+	/// </summary>
+	/// <remarks>
+	/// The resident chunks of a VoxelWorld always form a box of (2 * HalfBonus + 1) chunks along each axis around the centre,
+	/// so every coord within that box maps to a distinct slot, and lookups are a modulo and a compare with no hashing or allocation.
+	/// A slot remembers which coord it currently holds so stale coords (ones that map to the same slot but have moved out of the box) don't match.
+	/// Out of box chunks must be released before the chunks replacing them are reserved.
+	/// 
+	/// All modification (and Find/SlotFor) is main thread only.
+	/// Get is wait-free and may be called from any thread, chunks released from the grid are kept alive until every registered reader thread has announced a quiescent state (see <see cref="Threading::EpochDomain"/>).
+	/// </remarks>
+	class ChunkGrid
+	{
+		int64_t m_SizeX, m_SizeY, m_SizeZ;
+		std::vector<ChunkSlot> m_Slots;
+
+		Threading::EpochDomain m_Readers;
+		std::vector<std::pair<uint64_t, std::unique_ptr<VoxelChunk>>> m_Retired;
+		// Blocks and light chunks replaced while readers may still be using them, see VoxelChunk::Publish
+		std::vector<std::pair<uint64_t, std::shared_ptr<const void>>> m_RetiredData;
+
+		static inline int64_t Wrap(int64_t val, int64_t size)
+		{
+			auto out = val % size;
+			return out < 0 ? out + size : out;
+		}
+
+	public:
+		ChunkGrid(size_t halfX, size_t halfY, size_t halfZ)
+			: m_SizeX((int64_t)halfX * 2 + 1)
+			, m_SizeY((int64_t)halfY * 2 + 1)
+			, m_SizeZ((int64_t)halfZ * 2 + 1)
+			, m_Slots((size_t)(m_SizeX * m_SizeY * m_SizeZ))
+		{
+		}
+
+		inline size_t IndexOf(ChunkCoord coord) const
+		{
+			return (size_t)((Wrap(coord.X, m_SizeX) * m_SizeY + Wrap(coord.Y, m_SizeY)) * m_SizeZ + Wrap(coord.Z, m_SizeZ));
+		}
+
+		// The slot the coord maps to, which may be holding a different coord
+		inline ChunkSlot& SlotFor(ChunkCoord coord) { return m_Slots[IndexOf(coord)]; }
+		inline const ChunkSlot& SlotFor(ChunkCoord coord) const { return m_Slots[IndexOf(coord)]; }
+
+		// Returns the slot holding the coord, or nullptr if the coord is not in the grid
+		inline ChunkSlot* Find(ChunkCoord coord)
+		{
+			auto& slot = SlotFor(coord);
+			return slot.InUse && slot.Coord == coord ? &slot : nullptr;
+		}
+
+		inline const ChunkSlot* Find(ChunkCoord coord) const
+		{
+			auto& slot = SlotFor(coord);
+			return slot.InUse && slot.Coord == coord ? &slot : nullptr;
+		}
+
+		// Returns the loaded chunk at coord, or nullptr if it is not in the grid or still loading
+		// Safe from any thread, non-main threads must be registered readers and only use the chunk until their next quiescent state
+		inline VoxelChunk* Get(ChunkCoord coord) const
+		{
+			auto chunk = SlotFor(coord).Published.load(std::memory_order_acquire);
+			return chunk && chunk->GetCoord() == coord ? chunk : nullptr;
+		}
+
+		// Gives a reserved slot its loaded chunk and makes it visible to readers
+		inline VoxelChunk* Publish(ChunkCoord coord, std::unique_ptr<VoxelChunk> chunk)
+		{
+			auto slot = Find(coord);
+			if (!slot)
+				return nullptr;
+			slot->Chunk = std::move(chunk);
+			slot->Published.store(slot->Chunk.get(), std::memory_order_release);
+			return slot->Chunk.get();
+		}
+
+		// Marks the coord as loading, returns false if its slot is already in use
+		inline bool Reserve(ChunkCoord coord)
+		{
+			auto& slot = SlotFor(coord);
+			if (slot.InUse)
+				return false;
+			slot.Coord = coord;
+			slot.InUse = true;
+			slot.Chunk = nullptr;
+			return true;
+		}
+
+		// Frees the slot holding coord, the chunk it held (if any) is retired until readers are done with it
+		inline void Release(ChunkCoord coord)
+		{
+			auto slot = Find(coord);
+			if (!slot)
+				return;
+			slot->InUse = false;
+			slot->Published.store(nullptr, std::memory_order_release);
+			if (slot->Chunk)
+				m_Retired.emplace_back(m_Readers.Retire(), std::move(slot->Chunk));
+		}
+
+		// Keeps a chunk's replaced blocks or light alive until readers are done with them
+		inline void RetireData(std::shared_ptr<const void> data)
+		{
+			if (data)
+				m_RetiredData.emplace_back(m_Readers.Retire(), std::move(data));
+		}
+
+		inline void Clear()
+		{
+			for (auto& slot : m_Slots)
+				if (slot.InUse)
+					Release(slot.Coord);
+		}
+
+		// Returns the retired chunks no reader can still be using, retired block data no reader can still be using is freed
+		inline std::vector<std::unique_ptr<VoxelChunk>> Reclaim()
+		{
+			for (size_t i = m_RetiredData.size(); i-- > 0; )
+			{
+				if (!m_Readers.IsSafe(m_RetiredData[i].first))
+					continue;
+				std::swap(m_RetiredData[i], m_RetiredData.back());
+				m_RetiredData.pop_back();
+			}
+
+			std::vector<std::unique_ptr<VoxelChunk>> out;
+			for (size_t i = m_Retired.size(); i-- > 0; )
+			{
+				if (!m_Readers.IsSafe(m_Retired[i].first))
+					continue;
+				out.emplace_back(std::move(m_Retired[i].second));
+				std::swap(m_Retired[i], m_Retired.back());
+				m_Retired.pop_back();
+			}
+			return out;
+		}
+
+		// Waits for readers to finish with every retired chunk, then returns them
+		inline std::vector<std::unique_ptr<VoxelChunk>> ReclaimAll()
+		{
+			std::vector<std::unique_ptr<VoxelChunk>> out;
+			for (auto& retired : m_Retired)
+			{
+				m_Readers.WaitUntilSafe(retired.first);
+				out.emplace_back(std::move(retired.second));
+			}
+			m_Retired.clear();
+			for (auto& retired : m_RetiredData)
+				m_Readers.WaitUntilSafe(retired.first);
+			m_RetiredData.clear();
+			return out;
+		}
+
+		// Waits for readers to finish with any retired copy of coord, then returns it
+		inline std::unique_ptr<VoxelChunk> ReclaimNow(ChunkCoord coord)
+		{
+			for (size_t i = 0; i < m_Retired.size(); ++i)
+			{
+				if (!(m_Retired[i].second->GetCoord() == coord))
+					continue;
+				m_Readers.WaitUntilSafe(m_Retired[i].first);
+				auto out = std::move(m_Retired[i].second);
+				std::swap(m_Retired[i], m_Retired.back());
+				m_Retired.pop_back();
+				return out;
+			}
+			return nullptr;
+		}
+
+		inline Threading::EpochDomain& GetReaders() { return m_Readers; }
+
+		inline std::vector<ChunkSlot>::iterator begin() { return m_Slots.begin(); }
+		inline std::vector<ChunkSlot>::iterator end() { return m_Slots.end(); }
+		inline std::vector<ChunkSlot>::const_iterator begin() const { return m_Slots.begin(); }
+		inline std::vector<ChunkSlot>::const_iterator end() const { return m_Slots.end(); }
+	};
+}
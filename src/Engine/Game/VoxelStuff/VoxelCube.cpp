@@ -8,6 +8,7 @@
 
 #include "Drawing/VoxelStore.h"
 #include "Game/VoxelStuff/VoxelChunk.h"
+#include "Game/VoxelStuff/VoxelWorld.h"
 
 //std::weak_ptr<btBoxShape> Voxel::VoxelCube::s_Shape;
 
@@ -118,3 +119,31 @@ Voxel::SerialBlock Voxel::ICube::TakeBlockData()
 	}
 	return EmptyData;
 }
+
+bool Voxel::ICube::WantsUpdate() const
+{
+	return VoxelStore::Instance().WantsUpdate(GetBlockData().ID);
+}
+
+void Voxel::ICube::Wake()
+{
+	if (m_World)
+		m_World->GetBlockTicks().Wake(this);
+}
+
+void Voxel::ICube::Sleep()
+{
+	if (m_World)
+		m_World->GetBlockTicks().Sleep(this);
+}
+
+void Voxel::ICube::WakeIn(Time::TimeType seconds)
+{
+	if (m_World)
+		m_World->GetBlockTicks().WakeIn(this, seconds);
+}
+
+bool Voxel::ICube::IsAwake() const
+{
+	return m_World && m_World->GetBlockTicks().IsAwake(this);
+}
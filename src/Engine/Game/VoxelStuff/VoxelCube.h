@@ -5,6 +5,7 @@
 
 #include "VoxelChunkCuller.h"
 #include "VoxelTypes.h"
+#include "VoxelTickScheduler.h"
 
 #include "Helpers/BulletHelper.h"
 #include "Helpers/VectorHelper.h"
@@ -40,7 +41,15 @@ namespace Voxel
 		SerialBlock TakeBlockData();
 
 		virtual std::unique_ptr<ICube> Clone(VoxelWorld* world, VoxelChunk* chunk, ChunkBlockCoord pos) const = 0;
-		inline virtual bool WantsUpdate() const { return false; }
+		// Whether this block starts awake when loaded, sleeping blocks get no BeforeDraw/AfterDraw calls until woken
+		// Defaults to the block's wants-update in the VoxelStore, blocks that only tick when woken override it to return false
+		virtual bool WantsUpdate() const;
+
+		// Tick scheduling (see BlockTickScheduler)
+		void Wake();
+		void Sleep();
+		void WakeIn(Time::TimeType seconds); // Sleep, and wake after the given number of (scaled) seconds
+		bool IsAwake() const;
 
 		// OnPlaced is called when this block is placed into the world
 		inline virtual void OnPlaced() {}
@@ -59,6 +68,10 @@ namespace Voxel
 		Voxel::VoxelChunk* m_Chunk = nullptr;
 		Voxel::ChunkBlockCoord m_Pos;
 		std::unique_ptr<SerialBlock> m_Data;
+
+	private:
+		friend class BlockTickScheduler;
+		uint32_t m_TickSlot = BlockTickScheduler::InvalidSlot;
 	};
 
 	struct VoxelCube : ICube, virtual G1::IShape, BulletHelp::INothingInterface
@@ -0,0 +1,243 @@
+#include "VoxelFaceCulling.h"
+
+#include "Drawing/VoxelStore.h"
+
+#include <array>
+
+namespace Voxel
+{
+	ChunkFaceMasks::ChunkFaceMasks()
+		: m_Visible((size_t)6 * Chunk_Size * Chunk_Size, (Column)0)
+		, m_AnyVisible((size_t)Chunk_Size * Chunk_Size, (Column)0)
+	{
+	}
+
+	ChunkFaceMasks ComputeChunkFaceMasks(const ChunkData& data, const ChunkNeighbourhood& around)
+	{
+		using Column = ChunkFaceMasks::Column;
+		constexpr int Size = (int)Chunk_Size;
+		constexpr int Height = (int)Chunk_Height;
+		constexpr int Padded = Size + 2;
+
+		ChunkFaceMasks out;
+		auto& vox = VoxelStore::Instance();
+
+		// Closed face columns for the chunk and the ring of blocks around it, one set per face
+		// These are shifted up a bit (bit y + 1 for block y) so the blocks above and below the chunk fit in the same column
+		std::vector<Column> closed((size_t)6 * Padded * Padded, (Column)0);
+		auto closedIndex = [](size_t face, int x, int z) { return (face * Padded + (size_t)(x + 1)) * Padded + (size_t)(z + 1); };
+
+		// Blocks, and their open faces (in rotated directions), within the chunk
+		std::vector<Column> solid((size_t)Size * Size, (Column)0);
+		std::vector<Column> open((size_t)6 * Size * Size, (Column)0);
+
+		auto addClosed = [&closed, &closedIndex, &vox](int x, int y, int z, size_t ID)
+		{
+			auto faces = vox.GetClosedFaces(ID);
+			if (!faces)
+				return;
+			auto bit = (Column)1 << (y + 1);
+			for (size_t face = 0; face < 6; ++face)
+			{
+				if (faces & (1u << face))
+					closed[closedIndex(face, x, z)] |= bit;
+			}
+		};
+
+		auto addOutside = [&addClosed, &around](int x, int y, int z, BlockFace towards)
+		{
+			auto blocks = around.GetBlocks(towards);
+			if (!blocks)
+				return;
+			auto at = ToNeighbour(Vector::inty3{ x, y, z }, towards);
+			addClosed(x, y, z, (*blocks)[at.x][at.y][at.z].ID);
+		};
+
+		// Gather
+		// v
+
+		for (int x = 0; x < Size; ++x)
+		{
+			for (int z = 0; z < Size; ++z)
+			{
+				auto& column = solid[(size_t)x * Size + (size_t)z];
+				for (int y = 0; y < Height; ++y)
+				{
+					auto& block = data[x][y][z];
+					if (block.ID == 0)
+						continue;
+
+					column |= (Column)1 << y;
+					addClosed(x, y, z, block.ID);
+
+					auto openFaces = vox.GetOpenFaces(block.ID);
+					if (!openFaces)
+						continue;
+					openFaces = RotateFaceMask(openFaces, GetBlockRotationIndex(block.Data.Rotation));
+					for (size_t face = 0; face < 6; ++face)
+					{
+						if (openFaces & (1u << face))
+							open[(face * Size + (size_t)x) * Size + (size_t)z] |= (Column)1 << y;
+					}
+				}
+
+				addOutside(x, -1, z, BlockFace::DOWN);
+				addOutside(x, Height, z, BlockFace::UP);
+			}
+		}
+
+		for (int i = 0; i < Size; ++i)
+		{
+			for (int y = 0; y < Height; ++y)
+			{
+				addOutside(-1, y, i, BlockFace::LEFT);
+				addOutside(Size, y, i, BlockFace::RIGHT);
+				addOutside(i, y, -1, BlockFace::FORWARD);
+				addOutside(i, y, Size, BlockFace::BACK);
+			}
+		}
+
+		// ^
+		// Gather
+		// Cull
+		// v
+
+		for (int x = 0; x < Size; ++x)
+		{
+			for (int z = 0; z < Size; ++z)
+			{
+				auto blocks = solid[(size_t)x * Size + (size_t)z];
+				if (!blocks)
+					continue;
+
+				// The closed face of the neighbour in each direction, lined up with bit y
+				std::array<Column, 6> neighbours;
+				neighbours[(size_t)BlockFace::UP] = closed[closedIndex((size_t)BlockFace::UP, x, z)] >> 2;
+				neighbours[(size_t)BlockFace::DOWN] = closed[closedIndex((size_t)BlockFace::DOWN, x, z)];
+				neighbours[(size_t)BlockFace::RIGHT] = closed[closedIndex((size_t)BlockFace::RIGHT, x + 1, z)] >> 1;
+				neighbours[(size_t)BlockFace::LEFT] = closed[closedIndex((size_t)BlockFace::LEFT, x - 1, z)] >> 1;
+				neighbours[(size_t)BlockFace::BACK] = closed[closedIndex((size_t)BlockFace::BACK, x, z + 1)] >> 1;
+				neighbours[(size_t)BlockFace::FORWARD] = closed[closedIndex((size_t)BlockFace::FORWARD, x, z - 1)] >> 1;
+
+				Column any = 0;
+				for (size_t face = 0; face < 6; ++face)
+				{
+					auto visible = blocks & (~neighbours[face] | open[(face * Size + (size_t)x) * Size + (size_t)z]) & ChunkFaceMasks::ColumnMask;
+					out.m_Visible[ChunkFaceMasks::IndexOf((BlockFace)face, x, z)] = visible;
+					any |= visible;
+				}
+				out.m_AnyVisible[(size_t)x * Size + (size_t)z] = any;
+			}
+		}
+
+		// ^
+		// Cull
+
+		return out;
+	}
+}
+
+#ifdef CPP_ENGINE_TESTS
+
+#include <gtest/gtest.h>
+
+namespace
+{
+	Voxel::CubeID GetCullTestBlock(const std::string& name, std::array<Voxel::FaceClosedNess, 6> faces)
+	{
+		Voxel::VoxelStore::InitializeVoxelStore("", "", "", "");
+		auto& store = Voxel::VoxelStore::GetMutable();
+		if (auto id = store.GetIDFor(name))
+			return (Voxel::CubeID)id;
+
+		auto desc = Voxel::GetEmptyBlockDesc();
+		desc.Name = name;
+		desc.MeshName = Voxel::VoxelStore::DefaultCubeMeshName;
+		desc.FaceOpaqueness = faces;
+		store.LoadBlock(desc);
+		return (Voxel::CubeID)store.GetIDFor(name);
+	}
+}
+
+TEST(VoxelFaceCullingTests, MasksMatchNeighbourCheck)
+{
+	using namespace Voxel;
+	constexpr auto Closed = FaceClosedNess::CLOSED_FACE;
+	constexpr auto Semi = FaceClosedNess::SEMI_CLOSED_FACE;
+	constexpr auto Open = FaceClosedNess::OPEN_FACE;
+
+	// A full cube, a slab open on top, and a pane that hides nothing (faces in BlockFace order)
+	const CubeID stone = GetCullTestBlock("cull-test-stone", { Closed, Closed, Closed, Closed, Closed, Closed });
+	const CubeID slab = GetCullTestBlock("cull-test-slab", { Open, Closed, Closed, Closed, Closed, Closed });
+	const CubeID pane = GetCullTestBlock("cull-test-pane", { Semi, Semi, Semi, Semi, Semi, Semi });
+
+	// Hand placed blocks in the corners of the chunk and just outside them, so both inside and cross-chunk neighbours are checked
+	// Slabs are rotated so their open face points in different directions
+	auto blockAt = [&](int x, int y, int z)
+	{
+		auto block = VoxelStore::EmptyBlockData;
+		auto nearEdge = [](int v, int size) { return v < 3 || v >= size - 3; };
+		if (!nearEdge(x, Chunk_Size) || !nearEdge(y, Chunk_Height) || !nearEdge(z, Chunk_Size))
+			return block;
+
+		auto pick = (unsigned)(x * 7 + y * 3 + z * 5 + 64) % 5u;
+		const CubeID ids[] = { 0, stone, slab, slab, pane };
+		block.ID = ids[pick];
+		if (pick == 3)
+			block.Data.Rotation = GetBlockRotations()[(unsigned)(x + y + z + 64) % BlockRotationCount];
+		return block;
+	};
+
+	auto makeChunk = [&blockAt](Vector::inty3 origin)
+	{
+		auto data = std::make_unique<ChunkData>();
+		for (int x = 0; x < (int)Chunk_Size; ++x)
+			for (int y = 0; y < (int)Chunk_Height; ++y)
+				for (int z = 0; z < (int)Chunk_Size; ++z)
+					(*data)[x][y][z] = blockAt(origin.x + x, origin.y + y, origin.z + z);
+		return data;
+	};
+
+	auto data = makeChunk({ 0, 0, 0 });
+	std::array<std::unique_ptr<ChunkData>, 6> neighbours;
+	ChunkNeighbourhood around;
+	for (auto& face : BlockFacesArray)
+	{
+		auto dir = BlockFaceHelper::GetDirectionI(face);
+		neighbours[(size_t)face] = makeChunk({ dir.x * (int)Chunk_Size, dir.y * (int)Chunk_Height, dir.z * (int)Chunk_Size });
+		around.Blocks[(size_t)face] = neighbours[(size_t)face].get();
+	}
+
+	auto masks = ComputeChunkFaceMasks(*data, around);
+
+	// The per-face check meshing used before the masks: a face is drawn if it is open, or the neighbour in its direction doesn't close it off
+	auto& vox = VoxelStore::Instance();
+	size_t visibleFaces = 0;
+	for (int x = 0; x < (int)Chunk_Size; ++x)
+	{
+		for (int y = 0; y < (int)Chunk_Height; ++y)
+		{
+			for (int z = 0; z < (int)Chunk_Size; ++z)
+			{
+				auto& block = (*data)[x][y][z];
+				auto openFaces = block.ID ? RotateFaceMask(vox.GetOpenFaces(block.ID), GetBlockRotationIndex(block.Data.Rotation)) : 0;
+				bool anyVisible = false;
+				for (auto& face : BlockFacesArray)
+				{
+					auto neighbour = Vector::inty3{ x, y, z } + BlockFaceHelper::GetDirectionI(face);
+					bool expected = block.ID && ((openFaces & (1u << (unsigned)face)) || !vox.IsFaceClosed(blockAt(neighbour.x, neighbour.y, neighbour.z).ID, face));
+					EXPECT_EQ(masks.IsVisible(face, x, y, z), expected) << "block (" << x << ", " << y << ", " << z << ") face " << (int)face;
+					anyVisible |= expected;
+					visibleFaces += expected;
+				}
+				EXPECT_EQ((bool)((masks.GetAnyVisible(x, z) >> y) & 1u), anyVisible);
+			}
+		}
+	}
+
+	// The layout has to actually cull some faces and keep others for this to mean anything
+	EXPECT_GT(visibleFaces, 0u);
+	EXPECT_LT(visibleFaces, (size_t)6 * 8 * 27);
+}
+
+#endif
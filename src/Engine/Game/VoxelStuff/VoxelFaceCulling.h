@@ -0,0 +1,68 @@
+#pragma once
+
+#include "VoxelValues.h"
+#include "VoxelTypes.h"
+#include "VoxelNeighbourhood.h"
+
+#include <vector>
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Voxel
+{
+	/// <summary>
+	/// Which faces of every block in a chunk are exposed, and so need to be meshed
+	/// </summary>
+	/// <remarks>
+	/// Visibility is stored as one bit per block in columns running along Y (bit y for the block at height y), one set of columns per BlockFace.
+	/// Faces are in world (rotated) directions, matching the pre-rotated meshes from VoxelStore::GetRotatedMesh.
+	/// </remarks>
+	class ChunkFaceMasks
+	{
+	public:
+		typedef uint64_t Column;
+		static_assert(Chunk_Height + 2 <= 64, "A Column must fit a chunk's height plus a block either side");
+
+		static constexpr Column ColumnMask = ((Column)1 << Chunk_Height) - 1;
+
+		ChunkFaceMasks();
+
+		inline Column GetVisible(BlockFace face, int x, int z) const { return m_Visible[IndexOf(face, x, z)]; }
+		// Blocks in the column with at least one visible face
+		inline Column GetAnyVisible(int x, int z) const { return m_AnyVisible[(size_t)x * Chunk_Size + (size_t)z]; }
+		inline bool IsVisible(BlockFace face, int x, int y, int z) const { return (GetVisible(face, x, z) >> y) & 1u; }
+
+		friend ChunkFaceMasks ComputeChunkFaceMasks(const ChunkData& data, const ChunkNeighbourhood& around);
+
+	private:
+		static inline size_t IndexOf(BlockFace face, int x, int z) { return ((size_t)face * Chunk_Size + (size_t)x) * Chunk_Size + (size_t)z; }
+
+		std::vector<Column> m_Visible;
+		std::vector<Column> m_AnyVisible;
+	};
+
+	/// <summary>
+	/// Works out which faces of a chunk's blocks are exposed, using the blocks one past each side of the chunk from its neighbours
+	/// </summary>
+	/// <remarks>
+	/// A face is exposed if it is an open face of its block, or the neighbouring block in its direction doesn't have a closed face there.
+	/// Closed faces are gathered into bitmask columns once, then whole columns are culled at a time:
+	/// Up and Down compare a column against itself shifted a bit, the sideways faces AND against the neighbouring column.
+	/// </remarks>
+	ChunkFaceMasks ComputeChunkFaceMasks(const ChunkData& data, const ChunkNeighbourhood& around);
+
+	// Index of the lowest set bit of a non-zero column
+	inline int LowestBit(ChunkFaceMasks::Column column)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward64(&index, column);
+		return (int)index;
+#else
+		return __builtin_ctzll(column);
+#endif
+	}
+}
@@ -0,0 +1,456 @@
+#include "VoxelLight.h"
+
+#include "Drawing/VoxelStore.h"
+
+#include <algorithm>
+#include <climits>
+
+namespace Voxel
+{
+	ChunkLightMap::ChunkLightMap()
+		: m_Light((size_t)SizeX * (size_t)SizeY * (size_t)SizeZ, (uint8_t)0)
+	{
+	}
+
+	bool AffectsLight(const SerialBlock& before, const SerialBlock& after)
+	{
+		auto& vox = VoxelStore::Instance();
+		return vox.GetLightEmission(before.ID) != vox.GetLightEmission(after.ID) || vox.BlocksLight(before.ID) != vox.BlocksLight(after.ID);
+	}
+
+	namespace
+	{
+		constexpr int Pad = ChunkLightMap::Padding;
+		constexpr int SizeX = ChunkLightMap::SizeX;
+		constexpr int SizeY = ChunkLightMap::SizeY;
+		constexpr int SizeZ = ChunkLightMap::SizeZ;
+		constexpr size_t StrideX = (size_t)SizeY * SizeZ;
+		constexpr size_t StrideY = (size_t)SizeZ;
+
+		// An inclusive box of chunk relative coordinates that light is being flooded through
+		struct LightBox
+		{
+			int Min[3];
+			int Max[3];
+
+			static constexpr LightBox Chunk()
+			{
+				return LightBox{ { 0, 0, 0 }, { (int)Chunk_Size - 1, (int)Chunk_Height - 1, (int)Chunk_Size - 1 } };
+			}
+
+			// The chunk and the neighbours' blocks it is seeded from
+			static constexpr LightBox Whole()
+			{
+				return LightBox{ { -Pad, -Pad, -Pad }, { (int)Chunk_Size + Pad - 1, (int)Chunk_Height + Pad - 1, (int)Chunk_Size + Pad - 1 } };
+			}
+
+			inline bool Contains(int x, int y, int z) const
+			{
+				return x >= Min[0] && y >= Min[1] && z >= Min[2] && x <= Max[0] && y <= Max[1] && z <= Max[2];
+			}
+		};
+
+		// The level a block gets from a lit neighbour, see FloodFill
+		inline uint8_t SpreadLevel(uint8_t level, bool fullDown)
+		{
+			if (fullDown && level == MaxLightLevel)
+				return level;
+			return level > 1 ? (uint8_t)(level - 1) : (uint8_t)0;
+		}
+
+		// Reads opacity for every block in the box, emitting blocks are given their level and queued to seed the block light flood fill
+		void GatherBlocks(std::vector<uint8_t>& light, std::vector<bool>& opaque, std::vector<uint32_t>& queue, const ChunkData& data, const LightBox& box)
+		{
+			auto& vox = VoxelStore::Instance();
+			for (int x = box.Min[0]; x <= box.Max[0]; ++x)
+			{
+				for (int y = box.Min[1]; y <= box.Max[1]; ++y)
+				{
+					for (int z = box.Min[2]; z <= box.Max[2]; ++z)
+					{
+						auto id = data[x][y][z].ID;
+						if (id == 0)
+							continue;
+
+						auto index = ChunkLightMap::IndexOf(x, y, z);
+						opaque[index] = vox.BlocksLight(id);
+						auto emission = vox.GetLightEmission(id);
+						if (emission)
+						{
+							light[index] = (uint8_t)((light[index] & 0xF0) | emission);
+							queue.push_back((uint32_t)index);
+						}
+					}
+				}
+			}
+		}
+
+		// Copies the neighbours' light into the blocks just outside the chunk that touch the box
+		// Seeds touching only the rest of the chunk are left as they were, so FindStaleSeeds still sees them as stale if they are
+		void ReadSeeds(std::vector<uint8_t>& light, const ChunkNeighbourhood& around, const LightBox& box)
+		{
+			for (auto& face : BlockFacesArray)
+			{
+				auto neighbour = around.GetLight(face);
+				auto dir = BlockFaceHelper::GetDirectionI(face);
+				ForEachBlockOnSide(face, [&](int x, int y, int z)
+				{
+					if (!box.Contains(x, y, z))
+						return;
+					Vector::inty3 seed{ x + dir.x, y + dir.y, z + dir.z };
+					auto from = ToNeighbour(seed, face);
+					light[ChunkLightMap::IndexOf(seed.x, seed.y, seed.z)] = neighbour ? neighbour->GetPacked(from.x, from.y, from.z) : ChunkLightMap::MissingLight(face);
+				});
+			}
+		}
+
+		// Propagates the nibble at shift from every queued block, each neighbour gets one level less than its brightest neighbour
+		// Light only spreads into blocks inside the box, so blocks outside it keep their levels
+		// If fullDown is set full strength light travels straight down without losing a level
+		void FloodFill(std::vector<uint8_t>& light, const std::vector<bool>& opaque, std::vector<uint32_t>& queue, int shift, bool fullDown, const LightBox& box)
+		{
+			for (size_t head = 0; head < queue.size(); ++head)
+			{
+				auto index = (size_t)queue[head];
+				auto level = (uint8_t)((light[index] >> shift) & 0xF);
+				if (level <= 1)
+					continue;
+
+				int x = (int)(index / StrideX) - Pad;
+				int y = (int)((index / StrideY) % SizeY) - Pad;
+				int z = (int)(index % StrideY) - Pad;
+
+				auto spread = [&](int nx, int ny, int nz, size_t neighbour, uint8_t newLevel)
+				{
+					if (!box.Contains(nx, ny, nz) || opaque[neighbour])
+						return;
+					auto cur = (uint8_t)((light[neighbour] >> shift) & 0xF);
+					if (cur >= newLevel)
+						return;
+					light[neighbour] = (uint8_t)((light[neighbour] & ~(0xF << shift)) | (newLevel << shift));
+					queue.push_back((uint32_t)neighbour);
+				};
+
+				auto next = SpreadLevel(level, false);
+				spread(x - 1, y, z, index - StrideX, next);
+				spread(x + 1, y, z, index + StrideX, next);
+				spread(x, y - 1, z, index - StrideY, SpreadLevel(level, fullDown));
+				spread(x, y + 1, z, index + StrideY, next);
+				spread(x, y, z - 1, index - 1, next);
+				spread(x, y, z + 1, index + 1, next);
+			}
+			queue.clear();
+		}
+
+		// Queues the lit blocks touching the outside of each face of the box, so their light floods back into it
+		void SeedAroundBox(const std::vector<uint8_t>& light, std::vector<uint32_t>& queue, int shift, const LightBox& box)
+		{
+			constexpr auto whole = LightBox::Whole();
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				int a = (axis + 1) % 3, b = (axis + 2) % 3;
+				for (int side : { box.Min[axis] - 1, box.Max[axis] + 1 })
+				{
+					if (side < whole.Min[axis] || side > whole.Max[axis])
+						continue;
+
+					int pos[3];
+					pos[axis] = side;
+					for (pos[a] = box.Min[a]; pos[a] <= box.Max[a]; ++pos[a])
+					{
+						for (pos[b] = box.Min[b]; pos[b] <= box.Max[b]; ++pos[b])
+						{
+							auto index = ChunkLightMap::IndexOf(pos[0], pos[1], pos[2]);
+							if (((light[index] >> shift) & 0xF) > 1)
+								queue.push_back((uint32_t)index);
+						}
+					}
+				}
+			}
+		}
+
+		// Floods the box (which must be dark) from the emitters in it and the light around it, including the neighbours' seeds
+		void FloodBox(std::vector<uint8_t>& light, const ChunkData& data, const ChunkNeighbourhood& around, const LightBox& box)
+		{
+			ReadSeeds(light, around, box);
+
+			// Opacity outside the box is never read, light doesn't spread out of it
+			std::vector<bool> opaque((size_t)SizeX * SizeY * SizeZ, false);
+			std::vector<uint32_t> queue;
+
+			GatherBlocks(light, opaque, queue, data, box);
+
+			SeedAroundBox(light, queue, 0, box);
+			FloodFill(light, opaque, queue, 0, false, box);
+
+			SeedAroundBox(light, queue, 4, box);
+			FloodFill(light, opaque, queue, 4, true, box);
+		}
+	}
+
+	ChunkLightMap ComputeChunkLight(const ChunkData& data, const ChunkNeighbourhood& around)
+	{
+		ChunkLightMap out;
+		FloodBox(out.m_Light, data, around, LightBox::Chunk());
+		return out;
+	}
+
+	void UpdateChunkLight(ChunkLightMap& out, const ChunkData& data, const ChunkNeighbourhood& around, const std::vector<Vector::inty3>& changed)
+	{
+		if (changed.empty())
+			return;
+
+		constexpr auto chunk = LightBox::Chunk();
+
+		// Light_Reach around every change, and all the way down for the shadows sky light casts
+		LightBox box{ { INT_MAX, chunk.Min[1], INT_MAX }, { INT_MIN, INT_MIN, INT_MIN } };
+		for (auto& change : changed)
+		{
+			box.Min[0] = std::min(box.Min[0], change.x - Light_Reach);
+			box.Min[2] = std::min(box.Min[2], change.z - Light_Reach);
+			box.Max[0] = std::max(box.Max[0], change.x + Light_Reach);
+			box.Max[1] = std::max(box.Max[1], change.y + Light_Reach);
+			box.Max[2] = std::max(box.Max[2], change.z + Light_Reach);
+		}
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			box.Min[axis] = std::max(box.Min[axis], chunk.Min[axis]);
+			box.Max[axis] = std::min(box.Max[axis], chunk.Max[axis]);
+			if (box.Min[axis] > box.Max[axis])
+				return;
+		}
+
+		auto& light = out.m_Light;
+		for (int x = box.Min[0]; x <= box.Max[0]; ++x)
+			for (int y = box.Min[1]; y <= box.Max[1]; ++y)
+				std::fill_n(light.begin() + ChunkLightMap::IndexOf(x, y, box.Min[2]), box.Max[2] - box.Min[2] + 1, (uint8_t)0);
+
+		FloodBox(light, data, around, box);
+	}
+
+	bool FindStaleSeeds(const ChunkLightMap& light, const ChunkData& data, BlockFace towards, const ChunkLightMap* neighbourLight, const ChunkData* neighbourData, Vector::inty3& min, Vector::inty3& max)
+	{
+		auto& vox = VoxelStore::Instance();
+		auto dir = BlockFaceHelper::GetDirectionI(towards);
+		bool stale = false;
+		min = Vector::inty3{ INT_MAX, INT_MAX, INT_MAX };
+		max = Vector::inty3{ INT_MIN, INT_MIN, INT_MIN };
+
+		ForEachBlockOnSide(towards, [&](int x, int y, int z)
+		{
+			Vector::inty3 seed{ x + dir.x, y + dir.y, z + dir.z };
+			auto from = ToNeighbour(seed, towards);
+			auto was = light.GetPacked(seed.x, seed.y, seed.z);
+			auto now = neighbourLight ? neighbourLight->GetPacked(from.x, from.y, from.z) : ChunkLightMap::MissingLight(towards);
+			if (was == now)
+				return;
+
+			auto id = data[x][y][z].ID;
+			auto seedId = neighbourData ? (*neighbourData)[from.x][from.y][from.z].ID : (CubeID)0;
+			// Matches ComputeChunkFaceMasks, ignoring rotation as any open face is enough to count
+			bool faceDrawn = id != 0 && (vox.GetOpenFaces(id) || !vox.IsFaceClosed(seedId, towards));
+			auto own = light.GetPacked(x, y, z);
+			bool affects = false;
+			for (int shift : { 0, 4 })
+			{
+				auto ownLevel = (uint8_t)((own >> shift) & 0xF);
+				auto wasLevel = (uint8_t)((was >> shift) & 0xF);
+				auto nowLevel = (uint8_t)((now >> shift) & 0xF);
+				if (wasLevel == nowLevel)
+					continue;
+
+				// A block's faces are lit by the brighter of it and the block they face
+				if (faceDrawn && std::max(wasLevel, nowLevel) > ownLevel)
+					affects = true;
+
+				// The seed can now light the block brighter, or may have been what lit it
+				if (!vox.BlocksLight(id))
+				{
+					bool fullDown = shift == 4 && towards == BlockFace::UP;
+					auto wasGives = SpreadLevel(wasLevel, fullDown);
+					auto nowGives = SpreadLevel(nowLevel, fullDown);
+					if (nowGives > ownLevel || (nowGives < wasGives && wasGives >= ownLevel))
+						affects = true;
+				}
+			}
+			if (!affects)
+				return;
+
+			stale = true;
+			min = Vector::inty3{ std::min(min.x, seed.x), std::min(min.y, seed.y), std::min(min.z, seed.z) };
+			max = Vector::inty3{ std::max(max.x, seed.x), std::max(max.y, seed.y), std::max(max.z, seed.z) };
+		});
+		return stale;
+	}
+}
+
+#ifdef CPP_ENGINE_TESTS
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <tuple>
+
+namespace
+{
+	Voxel::CubeID GetLightTestBlock(const std::string& name, bool blocksLight, uint8_t emission)
+	{
+		Voxel::VoxelStore::InitializeVoxelStore("", "", "", "");
+		auto& store = Voxel::VoxelStore::GetMutable();
+		if (auto id = store.GetIDFor(name))
+			return (Voxel::CubeID)id;
+
+		auto desc = Voxel::GetEmptyBlockDesc();
+		desc.Name = name;
+		desc.MeshName = Voxel::VoxelStore::DefaultCubeMeshName;
+		desc.FaceOpaqueness.fill(blocksLight ? Voxel::FaceClosedNess::CLOSED_FACE : Voxel::FaceClosedNess::OPEN_FACE);
+		desc.LightEmission = emission;
+		store.LoadBlock(desc);
+		return (Voxel::CubeID)store.GetIDFor(name);
+	}
+}
+
+TEST(VoxelLightTests, UpdateMatchesRecompute)
+{
+	using namespace Voxel;
+
+	const CubeID ids[] = { 0, GetLightTestBlock("light-test-stone", true, 0), GetLightTestBlock("light-test-lamp", true, 14), GetLightTestBlock("light-test-glass", false, 0), GetLightTestBlock("light-test-torch", false, 10) };
+
+	// Random blocks through the chunk and the sides of its neighbours, with a leaky roof so there are sky shadows
+	std::mt19937 rng(5);
+	std::map<std::tuple<int, int, int>, CubeID> world;
+	for (int i = 0; i < 40000; ++i)
+		world[{ (int)(rng() % 64) - 16, (int)(rng() % 80) - 16, (int)(rng() % 64) - 16 }] = ids[1 + rng() % 4];
+	for (int x = -16; x < (int)Chunk_Size + 16; ++x)
+		for (int z = -16; z < (int)Chunk_Size + 16; ++z)
+			if (rng() % 3)
+				world[{ x, (int)Chunk_Height - 10, z }] = ids[1];
+
+	auto blockAt = [&world](int x, int y, int z)
+	{
+		auto block = VoxelStore::EmptyBlockData;
+		if (auto it = world.find({ x, y, z }); it != world.end())
+			block.ID = it->second;
+		return block;
+	};
+
+	// The chunk and its face neighbours, which are lit with nothing around them
+	struct TestChunk
+	{
+		Vector::inty3 Origin;
+		std::unique_ptr<ChunkData> Data = std::make_unique<ChunkData>();
+		ChunkLightMap Light;
+	};
+	auto fill = [&blockAt](TestChunk& chunk)
+	{
+		for (int x = 0; x < (int)Chunk_Size; ++x)
+			for (int y = 0; y < (int)Chunk_Height; ++y)
+				for (int z = 0; z < (int)Chunk_Size; ++z)
+					(*chunk.Data)[x][y][z] = blockAt(chunk.Origin.x + x, chunk.Origin.y + y, chunk.Origin.z + z);
+	};
+
+	TestChunk centre;
+	centre.Origin = { 0, 0, 0 };
+	std::array<TestChunk, 6> neighbours;
+	ChunkNeighbourhood around;
+	for (auto& face : BlockFacesArray)
+	{
+		auto& neighbour = neighbours[(size_t)face];
+		auto dir = BlockFaceHelper::GetDirectionI(face);
+		neighbour.Origin = { dir.x * (int)Chunk_Size, dir.y * (int)Chunk_Height, dir.z * (int)Chunk_Size };
+		fill(neighbour);
+		neighbour.Light = ComputeChunkLight(*neighbour.Data, ChunkNeighbourhood{});
+		around.Blocks[(size_t)face] = neighbour.Data.get();
+		around.Light[(size_t)face] = &neighbour.Light;
+	}
+	fill(centre);
+	auto light = ComputeChunkLight(*centre.Data, around);
+
+	auto staleSeeds = [&](std::vector<Vector::inty3>& out)
+	{
+		bool any = false;
+		for (auto& face : BlockFacesArray)
+		{
+			Vector::inty3 min, max;
+			if (!FindStaleSeeds(light, *centre.Data, face, around.GetLight(face), around.GetBlocks(face), min, max))
+				continue;
+			out.push_back(min);
+			out.push_back(max);
+			any = true;
+		}
+		return any;
+	};
+
+	for (int round = 0; round < 20; ++round)
+	{
+		// Changes both inside the chunk and near its sides in its neighbours, which are re-lit and then passed in as stale seeds
+		std::vector<Vector::inty3> changed;
+		for (int i = 0, count = 1 + (int)(rng() % 3); i < count; ++i)
+		{
+			Vector::inty3 at{ (int)(rng() % 48) - 8, (int)(rng() % 64) - 8, (int)(rng() % 48) - 8 };
+			world[{ at.x, at.y, at.z }] = ids[rng() % 5];
+			if (at.x >= 0 && at.y >= 0 && at.z >= 0 && at.x < (int)Chunk_Size && at.y < (int)Chunk_Height && at.z < (int)Chunk_Size)
+				changed.push_back(at);
+		}
+		fill(centre);
+		for (auto& neighbour : neighbours)
+		{
+			fill(neighbour);
+			neighbour.Light = ComputeChunkLight(*neighbour.Data, ChunkNeighbourhood{});
+		}
+		staleSeeds(changed);
+
+		UpdateChunkLight(light, *centre.Data, around, changed);
+		auto expected = ComputeChunkLight(*centre.Data, around);
+
+		size_t mismatched = 0;
+		for (int x = 0; x < (int)Chunk_Size; ++x)
+			for (int y = 0; y < (int)Chunk_Height; ++y)
+				for (int z = 0; z < (int)Chunk_Size; ++z)
+					if (light.GetPacked(x, y, z) != expected.GetPacked(x, y, z))
+						++mismatched;
+		ASSERT_EQ(mismatched, 0u) << "round " << round;
+
+		// Everything the update was given is re-read, so no seed that matters is left stale
+		std::vector<Vector::inty3> left;
+		ASSERT_FALSE(staleSeeds(left)) << "round " << round;
+	}
+}
+
+TEST(VoxelLightTests, BuriedSeedsArentStale)
+{
+	using namespace Voxel;
+
+	const CubeID stone = GetLightTestBlock("light-test-stone", true, 0);
+	auto solid = std::make_unique<ChunkData>();
+	for (auto& plane : *solid)
+		for (auto& column : plane)
+			for (auto& block : column)
+				block.ID = stone;
+
+	// Lit with nothing above, so it was seeded with open sky
+	auto light = ComputeChunkLight(*solid, ChunkNeighbourhood{});
+	EXPECT_EQ(light.GetSkyLight(0, (int)Chunk_Height, 0), MaxLightLevel);
+	EXPECT_EQ(light.GetSkyLight(0, (int)Chunk_Height - 1, 0), 0);
+
+	// Solid ground loading above it changes every seed along the top, but none of them can be seen or light anything
+	auto above = ComputeChunkLight(*solid, ChunkNeighbourhood{});
+	Vector::inty3 min, max;
+	EXPECT_FALSE(FindStaleSeeds(light, *solid, BlockFace::UP, &above, solid.get(), min, max));
+
+	// Open air replacing the ground above does light it
+	ChunkNeighbourhood under;
+	under.Blocks[(size_t)BlockFace::UP] = solid.get();
+	under.Light[(size_t)BlockFace::UP] = &above;
+	light = ComputeChunkLight(*solid, under);
+	EXPECT_FALSE(FindStaleSeeds(light, *solid, BlockFace::UP, &above, solid.get(), min, max));
+
+	auto air = std::make_unique<ChunkData>();
+	auto airLight = ComputeChunkLight(*air, ChunkNeighbourhood{});
+	ASSERT_TRUE(FindStaleSeeds(light, *solid, BlockFace::UP, &airLight, air.get(), min, max));
+	EXPECT_EQ(min.y, (int)Chunk_Height);
+	EXPECT_EQ(max.y, (int)Chunk_Height);
+}
+
+#endif
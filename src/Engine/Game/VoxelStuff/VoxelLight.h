@@ -0,0 +1,99 @@
+#pragma once
+
+#include "VoxelValues.h"
+#include "VoxelTypes.h"
+#include "VoxelNeighbourhood.h"
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+namespace Voxel
+{
+	/// <summary>
+	/// Block light and sky light levels for a chunk, and the light of its neighbours' blocks it was seeded with
+	/// </summary>
+	/// <remarks>
+	/// Levels are stored as a nibble pair per block, block light in the low nibble and sky light in the high nibble.
+	/// Coordinates are chunk relative, and may be one block outside the chunk on every side.
+	/// Those blocks belong to the neighbours sharing a face with the chunk, and hold the light the neighbour had when this map was flooded
+	/// (see <see cref="FindStaleSeeds"/>), the edges and corners of that ring are never used and stay dark.
+	/// </remarks>
+	class ChunkLightMap
+	{
+	public:
+		static constexpr int Padding = 1;
+		static constexpr int SizeX = (int)Chunk_Size + Padding * 2;
+		static constexpr int SizeY = (int)Chunk_Height + Padding * 2;
+		static constexpr int SizeZ = (int)Chunk_Size + Padding * 2;
+
+		ChunkLightMap();
+
+		static inline bool InBounds(int x, int y, int z)
+		{
+			return x >= -Padding && y >= -Padding && z >= -Padding
+				&& x < (int)Chunk_Size + Padding && y < (int)Chunk_Height + Padding && z < (int)Chunk_Size + Padding;
+		}
+
+		static inline size_t IndexOf(int x, int y, int z)
+		{
+			return ((size_t)(x + Padding) * SizeY + (size_t)(y + Padding)) * SizeZ + (size_t)(z + Padding);
+		}
+
+		// Both levels as stored, see MissingLight
+		inline uint8_t GetPacked(int x, int y, int z) const { return InBounds(x, y, z) ? m_Light[IndexOf(x, y, z)] : (uint8_t)0; }
+		inline uint8_t GetBlockLight(int x, int y, int z) const { return (uint8_t)(GetPacked(x, y, z) & 0xF); }
+		inline uint8_t GetSkyLight(int x, int y, int z) const { return (uint8_t)(GetPacked(x, y, z) >> 4); }
+
+		// The packed light assumed for the blocks of a neighbour that isn't loaded, which is dark except for open sky above the chunk
+		static constexpr uint8_t MissingLight(BlockFace towards) { return towards == BlockFace::UP ? (uint8_t)(MaxLightLevel << 4) : (uint8_t)0; }
+
+		// Returns the block and sky light of a block as 0-1 values, as they are baked into VoxelVertex::Light
+		inline floaty2 GetNormalized(int x, int y, int z) const
+		{
+			return { (float)GetBlockLight(x, y, z) / (float)MaxLightLevel, (float)GetSkyLight(x, y, z) / (float)MaxLightLevel };
+		}
+
+		friend ChunkLightMap ComputeChunkLight(const ChunkData& data, const ChunkNeighbourhood& around);
+		friend void UpdateChunkLight(ChunkLightMap& light, const ChunkData& data, const ChunkNeighbourhood& around, const std::vector<Vector::inty3>& changed);
+
+	private:
+		std::vector<uint8_t> m_Light;
+	};
+
+	/// <summary>
+	/// Flood fills block light and sky light through a chunk, seeded by its own emitters and by the light of its neighbours' blocks along its sides
+	/// </summary>
+	/// <remarks>
+	/// Block light is seeded from every block with a LightEmission and loses one level per block travelled.
+	/// Sky light loses one level per block travelled sideways or up, but full strength sky light travels straight down without losing any.
+	/// Neither is flooded out of the chunk, light reaches further by its neighbours being re-lit with this chunk's light as their seeds (see <see cref="FindStaleSeeds"/>).
+	/// Neighbours that aren't loaded are assumed to be dark, apart from open sky above the chunk (see <see cref="ChunkLightMap::MissingLight"/>).
+	/// Chunks keep the map this produces, so edits afterwards only re-flood the blocks around them (see <see cref="UpdateChunkLight"/>).
+	/// </remarks>
+	ChunkLightMap ComputeChunkLight(const ChunkData& data, const ChunkNeighbourhood& around);
+
+	/// <summary>
+	/// Re-floods only the part of a chunk's light map that blocks changed since it was computed can affect
+	/// </summary>
+	/// <remarks>
+	/// changed holds chunk relative positions, which are one block outside the chunk for seeds from a neighbour that changed.
+	/// A changed block can only alter light within Light_Reach of it, except that sky light shadows fall all the way down,
+	/// so the region cleared and re-flooded is the box Light_Reach around the changes that extends down to the bottom of the chunk.
+	/// The light just outside that box is unchanged (apart from neighbours' seeds touching it, which are re-read), and is flooded back into it along with any emitters inside it.
+	/// </remarks>
+	void UpdateChunkLight(ChunkLightMap& light, const ChunkData& data, const ChunkNeighbourhood& around, const std::vector<Vector::inty3>& changed);
+
+	/// <summary>
+	/// Finds the seeds a chunk's light was flooded with from its neighbour towards a side that no longer match the neighbour's light
+	/// </summary>
+	/// <remarks>
+	/// The neighbour's light and blocks are null if it isn't loaded.
+	/// Seeds that can't change the chunk's light or the light of its drawn faces are ignored, so a neighbour that changes doesn't re-light every chunk around it.
+	/// Returns whether any seed is stale, with min and max set to the chunk relative corners of the stale seeds to pass to <see cref="UpdateChunkLight"/>.
+	/// </remarks>
+	bool FindStaleSeeds(const ChunkLightMap& light, const ChunkData& data, BlockFace towards, const ChunkLightMap* neighbourLight, const ChunkData* neighbourData, Vector::inty3& min, Vector::inty3& max);
+
+	// Whether replacing before with after can change the light around it
+	bool AffectsLight(const SerialBlock& before, const SerialBlock& after);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "VoxelValues.h"
+#include "VoxelTypes.h"
+
+#include <array>
+
+namespace Voxel
+{
+	class ChunkLightMap;
+
+	/// <summary>
+	/// The blocks and light of the six chunks sharing a face with a chunk, fetched a chunk at a time for meshing and lighting it
+	/// </summary>
+	/// <remarks>
+	/// Indexed by the BlockFace pointing from the chunk towards the neighbour, null for neighbours that aren't loaded.
+	/// Only face neighbours are needed, as culling and lighting only look one block along each axis out of the chunk.
+	/// On the loading thread these point to the neighbours' published data, so are only valid until its next quiescent state (see ChunkGrid).
+	/// </remarks>
+	struct ChunkNeighbourhood
+	{
+		std::array<const ChunkData*, 6> Blocks{};
+		std::array<const ChunkLightMap*, 6> Light{};
+
+		inline const ChunkData* GetBlocks(BlockFace towards) const { return Blocks[(size_t)towards]; }
+		inline const ChunkLightMap* GetLight(BlockFace towards) const { return Light[(size_t)towards]; }
+	};
+
+	// Calls func(x, y, z) for every block of a chunk on its side facing towards
+	template<class Func>
+	void ForEachBlockOnSide(BlockFace towards, Func&& func)
+	{
+		auto dir = BlockFaceHelper::GetDirectionI(towards);
+		const int step[3] = { dir.x, dir.y, dir.z };
+		int min[3] = { 0, 0, 0 };
+		int max[3] = { (int)Chunk_Size - 1, (int)Chunk_Height - 1, (int)Chunk_Size - 1 };
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			if (step[axis] < 0)
+				max[axis] = min[axis];
+			else if (step[axis] > 0)
+				min[axis] = max[axis];
+		}
+
+		for (int x = min[0]; x <= max[0]; ++x)
+			for (int y = min[1]; y <= max[1]; ++y)
+				for (int z = min[2]; z <= max[2]; ++z)
+					func(x, y, z);
+	}
+
+	// Converts chunk relative coords of the block one past a chunk's side facing towards into coords within that neighbour
+	inline Vector::inty3 ToNeighbour(Vector::inty3 at, BlockFace towards)
+	{
+		auto dir = BlockFaceHelper::GetDirectionI(towards);
+		return { at.x - dir.x * (int)Chunk_Size, at.y - dir.y * (int)Chunk_Height, at.z - dir.z * (int)Chunk_Size };
+	}
+}
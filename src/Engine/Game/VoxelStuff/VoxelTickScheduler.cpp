@@ -0,0 +1,278 @@
+#include "VoxelTickScheduler.h"
+
+#include "VoxelCube.h"
+
+#include "Helpers/ProfileHelper.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+
+namespace Voxel
+{
+	BlockTickScheduler::BlockTickScheduler(double budgetSeconds)
+		: m_Budget(budgetSeconds)
+	{
+	}
+
+	void BlockTickScheduler::Add(ICube* cube)
+	{
+		if (!cube || cube->m_TickSlot != InvalidSlot)
+			return;
+
+		uint32_t slot;
+		if (m_FreeSlots.size())
+		{
+			slot = m_FreeSlots.back();
+			m_FreeSlots.pop_back();
+		}
+		else
+		{
+			slot = (uint32_t)m_Slots.size();
+			m_Slots.emplace_back();
+		}
+
+		m_Slots[slot].Cube = cube;
+		m_Slots[slot].AwakeIndex = InvalidSlot;
+		cube->m_TickSlot = slot;
+		++m_Stats.Registered;
+
+		if (cube->WantsUpdate())
+			SetAwake(slot, true);
+	}
+
+	void BlockTickScheduler::Remove(ICube* cube)
+	{
+		if (!cube || cube->m_TickSlot == InvalidSlot)
+			return;
+
+		auto slot = cube->m_TickSlot;
+		SetAwake(slot, false);
+		auto& s = m_Slots[slot];
+		s.Cube = nullptr;
+		++s.Generation; // Invalidates any scheduled wakes and tick snapshots
+		m_FreeSlots.push_back(slot);
+		cube->m_TickSlot = InvalidSlot;
+		--m_Stats.Registered;
+	}
+
+	void BlockTickScheduler::Wake(ICube* cube)
+	{
+		if (!cube || cube->m_TickSlot == InvalidSlot)
+			return;
+		++m_Slots[cube->m_TickSlot].WakeTicket;
+		SetAwake(cube->m_TickSlot, true);
+	}
+
+	void BlockTickScheduler::Sleep(ICube* cube)
+	{
+		if (!cube || cube->m_TickSlot == InvalidSlot)
+			return;
+		++m_Slots[cube->m_TickSlot].WakeTicket;
+		SetAwake(cube->m_TickSlot, false);
+	}
+
+	void BlockTickScheduler::WakeIn(ICube* cube, Time::TimeType seconds)
+	{
+		if (!cube || cube->m_TickSlot == InvalidSlot)
+			return;
+
+		auto slot = cube->m_TickSlot;
+		auto& s = m_Slots[slot];
+		SetAwake(slot, false);
+		m_Wakes.push_back(ScheduledWake{ m_Now + seconds, SlotRef{ slot, s.Generation }, ++s.WakeTicket });
+		std::push_heap(m_Wakes.begin(), m_Wakes.end(), std::greater<ScheduledWake>());
+	}
+
+	bool BlockTickScheduler::IsAwake(const ICube* cube) const
+	{
+		return cube && cube->m_TickSlot != InvalidSlot && m_Slots[cube->m_TickSlot].AwakeIndex != InvalidSlot;
+	}
+
+	void BlockTickScheduler::BeforeDraw(Time::TimeType runningTime)
+	{
+		PROFILE_PUSH("Block Ticks");
+		m_Now = runningTime;
+
+		// Wake everything due, stale entries (from removed or rescheduled cubes) are dropped
+		while (m_Wakes.size() && m_Wakes.front().At <= m_Now)
+		{
+			auto wake = m_Wakes.front();
+			std::pop_heap(m_Wakes.begin(), m_Wakes.end(), std::greater<ScheduledWake>());
+			m_Wakes.pop_back();
+			auto slot = Resolve(wake.Ref);
+			if (slot && slot->WakeTicket == wake.Ticket)
+				SetAwake(wake.Ref.Slot, true);
+		}
+
+		// Snapshot the awake list so cubes can sleep, wake or be removed while ticking
+		// Start where the budget cut off last frame so every awake cube gets a turn
+		m_Ticking.clear();
+		m_TickedCount = 0;
+		auto count = m_Awake.size();
+		if (count)
+		{
+			auto start = m_Cursor % count;
+			m_Ticking.reserve(count);
+			for (size_t i = 0; i < count; ++i)
+			{
+				auto slot = m_Awake[(start + i) % count];
+				m_Ticking.push_back(SlotRef{ slot, m_Slots[slot].Generation });
+			}
+		}
+
+		using clock = std::chrono::steady_clock;
+		auto begin = clock::now();
+		double elapsed = 0.0;
+		for (auto& ref : m_Ticking)
+		{
+			if (m_Budget > 0.0 && elapsed >= m_Budget)
+				break;
+
+			++m_TickedCount;
+			if (auto slot = Resolve(ref))
+				slot->Cube->BeforeDraw();
+
+			elapsed = std::chrono::duration<double>(clock::now() - begin).count();
+		}
+
+		m_Cursor += m_TickedCount;
+		m_Stats.Awake = m_Awake.size();
+		m_Stats.Scheduled = m_Wakes.size();
+		m_Stats.Ticked = m_TickedCount;
+		m_Stats.Deferred = m_Ticking.size() - m_TickedCount;
+		m_Stats.Seconds = elapsed;
+		PROFILE_POP();
+	}
+
+	void BlockTickScheduler::AfterDraw()
+	{
+		for (size_t i = 0; i < m_TickedCount; ++i)
+		{
+			if (auto slot = Resolve(m_Ticking[i]))
+				slot->Cube->AfterDraw();
+		}
+		m_Ticking.clear();
+		m_TickedCount = 0;
+	}
+
+	BlockTickScheduler::Slot* BlockTickScheduler::Resolve(SlotRef ref)
+	{
+		auto& slot = m_Slots[ref.Slot];
+		if (!slot.Cube || slot.Generation != ref.Generation)
+			return nullptr;
+		return &slot;
+	}
+
+	void BlockTickScheduler::SetAwake(uint32_t slot, bool awake)
+	{
+		auto& s = m_Slots[slot];
+		if (awake == (s.AwakeIndex != InvalidSlot))
+			return;
+
+		if (awake)
+		{
+			s.AwakeIndex = (uint32_t)m_Awake.size();
+			m_Awake.push_back(slot);
+			return;
+		}
+
+		// Swap remove, fixing up the index of the slot moved into the gap
+		auto index = s.AwakeIndex;
+		auto moved = m_Awake.back();
+		m_Awake[index] = moved;
+		m_Slots[moved].AwakeIndex = index;
+		m_Awake.pop_back();
+		s.AwakeIndex = InvalidSlot;
+	}
+}
+
+#ifdef CPP_ENGINE_TESTS
+
+#include <gtest/gtest.h>
+
+#include "Drawing/VoxelStore.h"
+
+namespace
+{
+	// Counts its ticks, its block data is given to it directly rather than read from a chunk
+	struct TickCountingCube : Voxel::ICube
+	{
+		TickCountingCube(Voxel::SerialBlock data)
+			: G1::IShape(nullptr, "Tick Counting Cube")
+			, Voxel::ICube(nullptr, nullptr, Voxel::ChunkBlockCoord{})
+		{
+			Detach(data);
+		}
+
+		void BeforeDraw() override { ++BeforeTicks; }
+		void AfterDraw() override { ++AfterTicks; }
+
+		std::unique_ptr<ICube> Clone(Voxel::VoxelWorld*, Voxel::VoxelChunk*, Voxel::ChunkBlockCoord) const override
+		{
+			return std::make_unique<TickCountingCube>(GetBlockData());
+		}
+
+		int BeforeTicks = 0;
+		int AfterTicks = 0;
+	};
+
+	Voxel::SerialBlock GetTickTestBlock(const std::string& name, bool wantsUpdate)
+	{
+		Voxel::VoxelStore::InitializeVoxelStore("", "", "", "");
+		auto& store = Voxel::VoxelStore::GetMutable();
+		if (!store.GetIDFor(name))
+		{
+			auto desc = Voxel::GetEmptyBlockDesc();
+			desc.Name = name;
+			desc.MeshName = Voxel::VoxelStore::DefaultCubeMeshName;
+			desc.WantsUpdate = wantsUpdate;
+			store.LoadBlock(desc);
+		}
+
+		auto block = Voxel::VoxelStore::EmptyBlockData;
+		block.ID = (Voxel::CubeID)store.GetIDFor(name);
+		return block;
+	}
+}
+
+TEST(BlockTickSchedulerTests, UpdateBlocksAreTicked)
+{
+	Voxel::BlockTickScheduler ticks;
+	TickCountingCube update(GetTickTestBlock("tick-test-update", true));
+	TickCountingCube still(GetTickTestBlock("tick-test-still", false));
+
+	// Blocks with wants-update start awake, others sleep until woken
+	ticks.Add(&update);
+	ticks.Add(&still);
+	EXPECT_TRUE(ticks.IsAwake(&update));
+	EXPECT_FALSE(ticks.IsAwake(&still));
+
+	ticks.BeforeDraw(0.f);
+	ticks.AfterDraw();
+	EXPECT_EQ(update.BeforeTicks, 1);
+	EXPECT_EQ(update.AfterTicks, 1);
+	EXPECT_EQ(still.BeforeTicks, 0);
+
+	ticks.Wake(&still);
+	ticks.BeforeDraw(0.1f);
+	ticks.AfterDraw();
+	EXPECT_EQ(update.BeforeTicks, 2);
+	EXPECT_EQ(still.BeforeTicks, 1);
+	EXPECT_EQ(still.AfterTicks, 1);
+
+	// Sleeping blocks are skipped until their scheduled wake up
+	ticks.WakeIn(&update, 1.f);
+	ticks.BeforeDraw(0.5f);
+	ticks.AfterDraw();
+	EXPECT_EQ(update.BeforeTicks, 2);
+	ticks.BeforeDraw(1.2f);
+	ticks.AfterDraw();
+	EXPECT_EQ(update.BeforeTicks, 3);
+
+	ticks.Remove(&update);
+	ticks.Remove(&still);
+	EXPECT_EQ(ticks.GetStats().Registered, 0u);
+}
+
+#endif
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Systems/Time/Time.h"
+
+#include <vector>
+#include <cstdint>
+#include <limits>
+
+namespace Voxel
+{
+	struct ICube;
+
+	/// <summary>
+	/// World wide scheduler deciding which update blocks (ICubes) receive BeforeDraw/AfterDraw each frame
+	/// </summary>
+	/// <remarks>
+	/// Every loaded ICube is registered, but only awake blocks are ticked. Awake blocks are kept in one contiguous list,
+	/// sleeping blocks cost nothing per frame unless they have a scheduled wake up, which sits in a min-heap ordered by wake time.
+	/// Blocks start awake if ICube::WantsUpdate returns true, and can Sleep/Wake/WakeIn themselves (or each other) at any time.
+	///
+	/// Ticking stops once the per-frame budget is used up, blocks that missed out are ticked first next frame.
+	/// A block ticked in BeforeDraw always gets the matching AfterDraw that frame, even if it was put to sleep in between.
+	///
+	/// Main thread only.
+	/// </remarks>
+	class BlockTickScheduler
+	{
+	public:
+		static constexpr uint32_t InvalidSlot = std::numeric_limits<uint32_t>::max();
+
+		struct TickStats
+		{
+			size_t Registered = 0;
+			size_t Awake = 0;
+			size_t Scheduled = 0; // Pending wake ups, including ones that have since been cancelled
+			size_t Ticked = 0; // Blocks ticked last frame
+			size_t Deferred = 0; // Awake blocks skipped last frame due to the budget
+			double Seconds = 0.0; // Time spent in BeforeDraw ticks last frame
+		};
+
+		BlockTickScheduler(double budgetSeconds = 0.0);
+		BlockTickScheduler(const BlockTickScheduler&) = delete;
+		BlockTickScheduler& operator=(const BlockTickScheduler&) = delete;
+
+		// Registers a newly loaded cube, it starts awake if it WantsUpdate
+		void Add(ICube* cube);
+		// Unregisters a cube that is being unloaded or destroyed, safe to call during ticking
+		void Remove(ICube* cube);
+
+		void Wake(ICube* cube);
+		void Sleep(ICube* cube);
+		// Puts the cube to sleep and wakes it after the given (scaled) number of seconds
+		void WakeIn(ICube* cube, Time::TimeType seconds);
+		bool IsAwake(const ICube* cube) const;
+
+		// Ticks awake cubes, waking any scheduled cubes due at runningTime first
+		void BeforeDraw(Time::TimeType runningTime);
+		// Gives the cubes ticked in BeforeDraw their AfterDraw
+		void AfterDraw();
+
+		// Maximum time spent ticking cubes per frame, 0 for no limit
+		inline void SetBudget(double seconds) { m_Budget = seconds; }
+		inline double GetBudget() const { return m_Budget; }
+
+		inline const TickStats& GetStats() const { return m_Stats; }
+
+	protected:
+		struct Slot
+		{
+			ICube* Cube = nullptr;
+			uint32_t Generation = 0;
+			uint32_t AwakeIndex = InvalidSlot; // Index into m_Awake, or InvalidSlot when sleeping
+			uint32_t WakeTicket = 0; // Bumped whenever the cube's schedule changes, so only its latest scheduled wake counts
+		};
+
+		// Heap entries and tick snapshots refer to slots by generation so removed cubes are never touched
+		struct SlotRef
+		{
+			uint32_t Slot;
+			uint32_t Generation;
+		};
+
+		struct ScheduledWake
+		{
+			Time::TimeType At;
+			SlotRef Ref;
+			uint32_t Ticket;
+
+			inline bool operator>(const ScheduledWake& other) const { return At > other.At; }
+		};
+
+		std::vector<Slot> m_Slots;
+		std::vector<uint32_t> m_FreeSlots;
+		std::vector<uint32_t> m_Awake;
+		std::vector<ScheduledWake> m_Wakes;
+		std::vector<SlotRef> m_Ticking;
+		size_t m_TickedCount = 0;
+		size_t m_Cursor = 0;
+
+		Time::TimeType m_Now = 0.f;
+		double m_Budget = 0.0;
+		TickStats m_Stats;
+
+		Slot* Resolve(SlotRef ref);
+		void SetAwake(uint32_t slot, bool awake);
+	};
+}
@@ -57,6 +57,81 @@ quat4 Voxel::GetFaceRotation(int x, int y, int z)
 	return quat4(bQuat);
 }
 
+namespace
+{
+	constexpr uint8_t NoRotation = 0xFF;
+
+	struct BlockRotationTables
+	{
+		std::array<quat4, Voxel::BlockRotationCount> Rotations;
+		std::array<std::array<Voxel::BlockFace, 6>, Voxel::BlockRotationCount> FaceRemap;
+		std::array<std::array<uint8_t, 6>, 6> IndexOf; // Indexed by [rotated Up][rotated Forward], an orientation is fully described by those two faces
+	};
+
+	const BlockRotationTables& GetRotationTables()
+	{
+		static const BlockRotationTables tables = []()
+		{
+			using namespace Voxel;
+			BlockRotationTables t;
+			for (auto& row : t.IndexOf)
+				row.fill(NoRotation);
+
+			// The 64 combinations of quarter turns cover all 24 orientations, (0, 0, 0) comes first so the identity is index 0
+			uint8_t count = 0;
+			for (int x = 0; x < 4; ++x)
+			{
+				for (int y = 0; y < 4; ++y)
+				{
+					for (int z = 0; z < 4; ++z)
+					{
+						auto rot = GetFaceRotation(x, y, z);
+						auto& index = t.IndexOf[(size_t)RotateFace(BlockFace::Up, rot)][(size_t)RotateFace(BlockFace::Forward, rot)];
+						if (index != NoRotation)
+							continue;
+
+						index = count;
+						t.Rotations[count] = rot;
+						for (auto face : BlockFacesArray)
+							t.FaceRemap[count][(size_t)face] = RotateFace(face, rot);
+						++count;
+					}
+				}
+			}
+			return t;
+		}();
+		return tables;
+	}
+}
+
+const std::array<quat4, Voxel::BlockRotationCount>& Voxel::GetBlockRotations()
+{
+	return GetRotationTables().Rotations;
+}
+
+uint8_t Voxel::GetBlockRotationIndex(const quat4& rot)
+{
+	auto index = GetRotationTables().IndexOf[(size_t)RotateFace(BlockFace::Up, rot)][(size_t)RotateFace(BlockFace::Forward, rot)];
+	return index == NoRotation ? (uint8_t)0 : index; // Only degenerate (eg. zero) quaternions miss
+}
+
+Voxel::BlockFace Voxel::RotateFaceBy(BlockFace face, uint8_t rotationIndex)
+{
+	return GetRotationTables().FaceRemap[rotationIndex][(size_t)face];
+}
+
+uint8_t Voxel::RotateFaceMask(uint8_t mask, uint8_t rotationIndex)
+{
+	auto& remap = GetRotationTables().FaceRemap[rotationIndex];
+	uint8_t out = 0;
+	for (size_t face = 0; face < 6; ++face)
+	{
+		if (mask & (1u << face))
+			out |= (uint8_t)(1u << (unsigned)remap[face]);
+	}
+	return out;
+}
+
 floaty3 Voxel::BlockFaceHelper::GetDirection(BlockFace face)
 {
 	switch (face)
@@ -323,4 +398,31 @@ TEST(VoxelStuffTests, GetFaceRotationTests)
 	EXPECT_EQ(BlockFaceHelper::GetNearest(BlockFaceHelper::GetDirection(BlockFace::Back)), BlockFace::Back);
 }
 
+TEST(VoxelStuffTests, BlockRotationTableTests)
+{
+	using namespace Voxel;
+
+	auto& rotations = GetBlockRotations();
+	EXPECT_TRUE(rotations[0].approximately_equal(quat4::identity()));
+
+	for (uint8_t i = 0; i < BlockRotationCount; ++i)
+	{
+		EXPECT_EQ(GetBlockRotationIndex(rotations[i]), i);
+
+		uint8_t seen = 0;
+		for (auto face : BlockFacesArray)
+		{
+			auto rotated = RotateFaceBy(face, i);
+			EXPECT_EQ(rotated, RotateFace(face, rotations[i]));
+			seen |= (uint8_t)(1u << (unsigned)rotated);
+		}
+		EXPECT_EQ(seen, 0x3F); // Every rotation is a permutation of the faces
+		EXPECT_EQ(RotateFaceMask(0x3F, i), 0x3F);
+	}
+
+	auto index = GetBlockRotationIndex(GetFaceRotation(1, 0, 0));
+	EXPECT_EQ(RotateFaceBy(BlockFace::Forward, index), BlockFace::Up);
+	EXPECT_EQ(RotateFaceMask((uint8_t)(1u << (unsigned)BlockFace::Forward), index), (uint8_t)(1u << (unsigned)BlockFace::Up));
+}
+
 #endif
\ No newline at end of file
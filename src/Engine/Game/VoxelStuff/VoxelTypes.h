@@ -83,6 +83,23 @@ namespace Voxel
 		return BlockFaceHelper::GetNearest(rotDir);
 	}
 
+	// Number of distinct axis aligned orientations a block can have
+	constexpr uint8_t BlockRotationCount = 24;
+
+	/// <summary>
+	/// The 24 axis aligned block rotations (every distinct result of GetFaceRotation), index 0 is the identity
+	/// </summary>
+	const std::array<quat4, BlockRotationCount>& GetBlockRotations();
+
+	// Snaps a rotation to the index of the nearest axis aligned block rotation, judged by where it sends the Up and Forward faces
+	uint8_t GetBlockRotationIndex(const quat4& rot);
+
+	// Table driven RotateFace for an axis aligned block rotation index
+	BlockFace RotateFaceBy(BlockFace face, uint8_t rotationIndex);
+
+	// Rotates a face bitmask (bit (1 << face) per face) by an axis aligned block rotation index
+	uint8_t RotateFaceMask(uint8_t mask, uint8_t rotationIndex);
+
 	struct ChunkCoord
 	{
 		int64_t X;
@@ -167,6 +184,8 @@ namespace Voxel
 		inline bool operator!=(const SerialBlock& other) const { return !(*this == other); }
 	};
 
+	typedef std::array<std::array<std::array<SerialBlock, Chunk_Size>, Chunk_Height>, Chunk_Size> ChunkData;
+
 	struct NamedBlock
 	{
 		std::string Name;
@@ -180,6 +199,7 @@ namespace Voxel
 		floaty3 Binormal;
 		floaty3 Tangent;
 		floaty3 TexCoord;
+		floaty2 Light; // Baked block light and sky light, both 0-1
 
 		inline bool operator==(const VoxelVertex& other) const
 		{
@@ -187,7 +207,8 @@ namespace Voxel
 				&& Normal == other.Normal
 				&& Binormal == other.Binormal
 				&& Tangent == other.Tangent
-				&& TexCoord == other.TexCoord;
+				&& TexCoord == other.TexCoord
+				&& Light == other.Light;
 		}
 
 		inline bool operator!=(const VoxelVertex& other) const
@@ -208,6 +229,8 @@ namespace Voxel
 			desc.TangentOrder = 4;
 			desc.TexCoordSize = 3;
 			desc.TexCoordOrder = 5;
+			desc.LightSize = 2;
+			desc.LightOrder = 6;
 			return desc;
 		}
 	};
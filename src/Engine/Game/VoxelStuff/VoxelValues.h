@@ -15,4 +15,9 @@ namespace Voxel
 	constexpr double Chunk_Width_Double = (double)Chunk_Size * (double)BlockSize;
 	constexpr float Chunk_Tallness = (float)Chunk_Height * BlockSize;
 	constexpr double Chunk_Tallness_Double = (double)Chunk_Height * (double)BlockSize;
+
+	// Block and sky light levels go from 0 (dark) to MaxLightLevel, losing one level per block travelled
+	constexpr uint8_t MaxLightLevel = 15u;
+	// How far (in blocks) light can travel from its source, and so how far outside a chunk can affect its lighting
+	constexpr int Light_Reach = MaxLightLevel - 1;
 }
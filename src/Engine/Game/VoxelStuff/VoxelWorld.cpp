@@ -8,16 +8,33 @@
 #include "Systems/Time/Time.h"
 
 #include "VoxelAbility.h"
+#include "VoxelLight.h"
 #include "Drawing/VoxelStore.h"
+#include "Drawing/StreamingBuffer.h"
 
+#include <array>
 #include <vector>
 #include <algorithm>
 #include <cstdlib>
 #include <execution>
 
-Voxel::SerialBlock GetBlockIdInWorld(const Voxel::VoxelWorld* world, Voxel::BlockCoord coord)
+// Pushes as much of the overflow (oldest first) as fits in the queue, keeping the rest for next time
+template<class T>
+void FlushOverflow(Threading::BoundedQueue<T>& queue, std::vector<T>& overflow)
 {
-	return world->GetCubeDataAt(coord);
+	if (overflow.empty())
+		return;
+	auto pushed = queue.try_push_bulk(overflow.data(), overflow.size());
+	overflow.erase(overflow.begin(), overflow.begin() + pushed);
+}
+
+// Queues a request behind any overflowing ones so requests stay in order
+template<class T>
+void PushOrOverflow(Threading::BoundedQueue<T>& queue, std::vector<T>& overflow, T request)
+{
+	if (overflow.empty() && queue.try_push(request))
+		return;
+	overflow.emplace_back(std::move(request));
 }
 
 Voxel::VoxelWorld::VoxelWorld(G1::IShapeThings things, WorldStuff stuff)
@@ -27,6 +44,8 @@ Voxel::VoxelWorld::VoxelWorld(G1::IShapeThings things, WorldStuff stuff)
 	, m_LoadingStuff(std::make_shared<LoadingStuff>())
 	, m_LoadingThread()
 	, m_ChunkLoadingOffsets(CalculateOffsets(stuff.HalfBonusWidth, stuff.HalfBonusHeight, stuff.HalfBonusDepth))
+	, m_BlockTicks(stuff.BlockTickBudget)
+	, m_Chunks(stuff.HalfBonusWidth, stuff.HalfBonusHeight, stuff.HalfBonusDepth)
 {
 	m_Stuff.ChunkLeniance = Math::min<size_t>()(m_Stuff.ChunkLeniance, m_Stuff.HalfBonusWidth);
 	m_Stuff.ChunkLeniance = Math::min<size_t>()(m_Stuff.ChunkLeniance, m_Stuff.HalfBonusHeight);
@@ -39,7 +58,8 @@ Voxel::VoxelWorld::VoxelWorld(G1::IShapeThings things, WorldStuff stuff)
 		m_Stuff.m_ChunkUnloader = this;
 
 	LoadingOtherStuff funcs;
-	funcs.GetBlockIdFunc = [this](BlockCoord coord) { return GetBlockIdInWorld(this, coord); };
+	funcs.GetNeighboursFunc = [this](ChunkCoord coord) { return GetNeighbourhood(coord); };
+	funcs.ChunkReaders = &m_Chunks.GetReaders();
 	funcs.GetChunkDataFunc = [gen = m_Stuff.m_ChunkLoader, mem = m_Stuff.m_ChunkMemory, &mem_lock = this->m_ChunkMemoryMutex](ChunkCoord coord) -> std::unique_ptr<Voxel::ChunkData> 
 		{
 			if (mem)
@@ -59,6 +79,10 @@ Voxel::VoxelWorld::VoxelWorld(G1::IShapeThings things, WorldStuff stuff)
 Voxel::VoxelWorld::~VoxelWorld()
 {
 	m_LoadingStuff->QuitVal.store(true);
+	// Wake the loading thread whether it's waiting for work or for room to hand a chunk back
+	m_LoadingStuff->WorkReady.NotifyAll();
+	m_LoadingStuff->Loaded.close();
+	m_LoadingStuff->Recomputed.close();
 	m_LoadingThread.join();
 }
 
@@ -384,28 +408,23 @@ floaty3 Voxel::VoxelWorld::Update(floaty3 New_Centre)
 
 	//PROFILE_POP();
 
-	PROFILE_PUSH("New Chunk Loading");
-
 	auto centre = GetChunkCoordFromPhys(New_Centre);
 
 	int64_t centre_x = centre.X;
 	int64_t centre_y = centre.Y;
 	int64_t centre_z = centre.Z;
 
-	Load(centre);
-	for (auto& offset : m_ChunkLoadingOffsets)
-	{
-		Load({ centre_x + offset.X, centre_y + offset.Y, centre_z + offset.Z });
-	}
-
-	PROFILE_POP();
+	// Unload first, chunks entering the area reuse the grid slots of the chunks leaving it
 	PROFILE_PUSH("Chunk Unloading");
 	PROFILE_PUSH("Distance Selection");
 	std::vector<ChunkCoord> to_unload;
 	
-	for (auto& chunkPair : m_Chunks)
+	for (auto& slot : m_Chunks)
 	{
-		auto& chunkCoord = chunkPair.first;
+		if (!slot.InUse)
+			continue;
+
+		auto& chunkCoord = slot.Coord;
 		
 		if (chunkCoord.X > (centre_x + (int64_t)m_Stuff.HalfBonusWidth ) || chunkCoord.X < (centre_x - (int64_t)m_Stuff.HalfBonusWidth) ||
 			chunkCoord.Y > (centre_y + (int64_t)m_Stuff.HalfBonusHeight) || chunkCoord.Y < (centre_y - (int64_t)m_Stuff.HalfBonusHeight) ||
@@ -419,9 +438,22 @@ floaty3 Voxel::VoxelWorld::Update(floaty3 New_Centre)
 	for (auto& chunkCoord : to_unload)
 		Unload(chunkCoord);
 	
+	PROFILE_POP();
+	PROFILE_PUSH("Reclaiming");
+	ReclaimChunks();
 	PROFILE_POP();
 	PROFILE_POP();
 
+	PROFILE_PUSH("New Chunk Loading");
+
+	Load(centre);
+	for (auto& offset : m_ChunkLoadingOffsets)
+	{
+		Load({ centre_x + offset.X, centre_y + offset.Y, centre_z + offset.Z });
+	}
+
+	PROFILE_POP();
+
 	return { 0.f, 0.f, 0.f };
 }
 
@@ -429,10 +461,11 @@ void Voxel::VoxelWorld::BeforeDraw()
 {
 	PROFILE_PUSH("VoxelWorld BeforeDraw");
 	PROFILE_PUSH("Chunks");
-	for (auto &chunk : m_Chunks)
-		if (chunk.second)
-			chunk.second->BeforeDraw();
+	for (auto &slot : m_Chunks)
+		if (slot.Chunk)
+			slot.Chunk->BeforeDraw();
 	PROFILE_POP();
+	m_BlockTicks.BeforeDraw(mResources->Time->GetRunningTime());
 	PROFILE_PUSH("Entities");
 	for (auto &entity : m_DynamicEntities)
 		entity.second->BeforeDraw();
@@ -465,13 +498,10 @@ void Voxel::VoxelWorld::Draw()
 void Voxel::VoxelWorld::AfterDraw()
 {
 	PROFILE_PUSH("VoxelWorld AfterDraw");
-	for (auto &chunk : m_Chunks)
-		if (chunk.second)
-		{
-			PROFILE_PUSH_AGG("Chunk");
-			chunk.second->AfterDraw();
-			PROFILE_POP();
-		}
+	// Chunks have nothing to do after drawing, only their awake update blocks do
+	PROFILE_PUSH("Block Ticks");
+	m_BlockTicks.AfterDraw();
+	PROFILE_POP();
 	PROFILE_PUSH("Entities");
 	for (auto &entity : m_DynamicEntities)
 		entity.second->AfterDraw();
@@ -533,11 +563,11 @@ void Voxel::VoxelWorld::SetCubeLater(BlockCoord coord, const NamedBlock& block)
 
 void Voxel::VoxelWorld::SetCube(BlockCoord coords, std::unique_ptr<ICube> cube)
 {
-	std::unique_lock lock(m_ChunksMutex);
-	auto it = m_Chunks.find(coords.Chunk);
-	if (it != m_Chunks.end() && it->second)
+	if (auto chunk = m_Chunks.Get(coords.Chunk))
 	{
-		it->second->set(coords.Block.x, coords.Block.y, coords.Block.z, std::move(cube));
+		auto before = chunk->get_data(coords.Block);
+		chunk->set(coords.Block.x, coords.Block.y, coords.Block.z, std::move(cube));
+		DirtyNeighbours(coords, before, chunk->get_data(coords.Block));
 	}
 	else
 	{
@@ -547,11 +577,11 @@ void Voxel::VoxelWorld::SetCube(BlockCoord coords, std::unique_ptr<ICube> cube)
 
 void Voxel::VoxelWorld::SetCube(BlockCoord coord, const Voxel::SerialBlock& block)
 {
-	std::unique_lock lock(m_ChunksMutex);
-	auto it = m_Chunks.find(coord.Chunk);
-	if (it != m_Chunks.end() && it->second)
+	if (auto chunk = m_Chunks.Get(coord.Chunk))
 	{
-		it->second->set(coord.Block, block);
+		auto before = chunk->get_data(coord.Block);
+		chunk->set(coord.Block, block);
+		DirtyNeighbours(coord, before, block);
 	}
 	else
 	{
@@ -566,35 +596,46 @@ void Voxel::VoxelWorld::SetCube(BlockCoord coord, const NamedBlock& block)
 
 Voxel::ICube* Voxel::VoxelWorld::GetCubeAt(BlockCoord coord)
 {
-	std::shared_lock lock(m_ChunksMutex);
-	auto it = m_Chunks.find(coord.Chunk);
-	if (it != m_Chunks.end() && it->second)
+	if (auto chunk = m_Chunks.Get(coord.Chunk))
 	{
-		return it->second->get(coord.Block.x, coord.Block.y, coord.Block.z);
+		return chunk->get(coord.Block.x, coord.Block.y, coord.Block.z);
 	}
 	return nullptr;
 }
 
 const Voxel::ICube* Voxel::VoxelWorld::GetCubeAt(BlockCoord coord) const
 {
-	std::shared_lock lock(m_ChunksMutex);
-	auto it = m_Chunks.find(coord.Chunk);
-	if (it != m_Chunks.end() && it->second)
-		return it->second->get(coord.Block.x, coord.Block.y, coord.Block.z);
+	if (auto chunk = m_Chunks.Get(coord.Chunk))
+		return chunk->get(coord.Block.x, coord.Block.y, coord.Block.z);
 	return nullptr;
 }
 
 Voxel::SerialBlock Voxel::VoxelWorld::GetCubeDataAt(BlockCoord coord) const
 {
-	std::shared_lock lock(m_ChunksMutex);
-	auto it = m_Chunks.find(coord.Chunk);
-	if (it != m_Chunks.end() && it->second)
+	if (auto chunk = m_Chunks.Get(coord.Chunk))
 	{
-		return it->second->get_data(coord.Block);
+		return chunk->get_data(coord.Block);
 	}
 	return VoxelStore::EmptyBlockData;
 }
 
+Voxel::ChunkNeighbourhood Voxel::VoxelWorld::GetNeighbourhood(ChunkCoord coord) const
+{
+	// Neither finding the chunks nor reading what they've published takes a lock
+	// Blocks set after the read are published before the chunks they dirty are remeshed, and stale light is caught by RelightSeams
+	ChunkNeighbourhood around;
+	for (auto& face : BlockFacesArray)
+	{
+		auto dir = BlockFaceHelper::GetDirectionI(face);
+		if (auto chunk = m_Chunks.Get(ChunkCoord{ coord.X + dir.x, coord.Y + dir.y, coord.Z + dir.z }))
+		{
+			around.Blocks[(size_t)face] = chunk->ReadBlocks();
+			around.Light[(size_t)face] = chunk->ReadLight();
+		}
+	}
+	return around;
+}
+
 bool Voxel::VoxelWorld::IsCubeAt(BlockCoord coord) const
 {
 	return GetCubeAt(coord) != nullptr;
@@ -672,9 +713,29 @@ void Voxel::VoxelWorld::RemoveEntity(Entity *entity)
 	this->m_ToRemoveEntities.emplace_back(entity);
 }
 
-void Voxel::VoxelWorld::ReloadChunkAt(ChunkCoord at, const ChunkData& srcData)
+void Voxel::VoxelWorld::ReloadChunkAt(ChunkCoord at, std::shared_ptr<const ChunkData> srcData, std::shared_ptr<const ChunkLightMap> light, std::vector<Vector::inty3> lightChanges, uint64_t lightRequest)
 {
-	m_LoadingStuff->ToRecompute.push(std::make_pair(at, std::make_unique<ChunkData>(srcData)));
+	PushOrOverflow(m_LoadingStuff->ToRecompute, m_RecomputeOverflow, RecomputeRequest{ at, std::move(srcData), Profiling::Now(), std::move(light), std::move(lightChanges), lightRequest });
+	m_LoadingStuff->WorkReady.NotifyOne();
+}
+
+void Voxel::VoxelWorld::QueueChunkPublish(ChunkCoord coord)
+{
+	m_EditedChunks.push_back(coord);
+}
+
+void Voxel::VoxelWorld::PublishChunkEdits()
+{
+	// Chunks unloaded since they were edited are skipped, the unloader saves their edits from the main thread's copy
+	for (auto& coord : m_EditedChunks)
+		if (auto chunk = m_Chunks.Get(coord))
+			chunk->PublishEdits();
+	m_EditedChunks.clear();
+}
+
+void Voxel::VoxelWorld::RetireChunkData(std::shared_ptr<const void> data)
+{
+	m_Chunks.RetireData(std::move(data));
 }
 
 void Voxel::VoxelWorld::UnloadChunk(std::unique_ptr<VoxelChunk> chunk)
@@ -697,19 +758,20 @@ void Voxel::VoxelWorld::Reset()
 {
 	m_UpdateBlockChanges.clear();
 	m_BlockChanges.clear();
-	m_Chunks.clear();
+	m_EditedChunks.clear();
+	m_Chunks.Clear();
+	m_Chunks.ReclaimAll();
 	m_PendingBlockSets.clear();
 	m_Stuff.m_ChunkMemory->Reset();
 }
 
 Voxel::VoxelWorld::ChunkStatus Voxel::VoxelWorld::GetChunkStatus(ChunkCoord coord)
 {
-	std::shared_lock lock(m_ChunksMutex);
-	auto it = m_Chunks.find(coord);
-	if (it == m_Chunks.end())
+	auto slot = m_Chunks.Find(coord);
+	if (!slot)
 		return NOT_IN_WORLD;
 
-	if (!it->second)
+	if (!slot->Chunk)
 		return IN_WORLD_NOT_LOADED;
 
 	return IN_WORLD_LOADED;
@@ -755,38 +817,53 @@ GLuint Voxel::VoxelWorld::CreateIBO()
 void Voxel::VoxelWorld::UpdateInstanceStuff(const std::vector<ProjInstanceData> &data)
 {
 	CHECK_GL_ERR("Before Update Of Instance Stuffs");
-	if (data.size() > m_InstanceBufferSize)
-	{
-		m_InstanceBufferSize = data.size();
+	if (data.empty())
+		return;
 
-		glBindVertexArray(m_ProjectileVAO.Get());
-		
-		GLuint newbuf = 0u;
-		glGenBuffers(1, &newbuf);
-		glBindBuffer(GL_ARRAY_BUFFER, newbuf);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(ProjInstanceData) * data.size(), data.data(), GL_DYNAMIC_DRAW);
-
-		glEnableVertexAttribArray(3);
-		glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Matrixy3x3), (GLvoid *)offsetof(Matrixy3x3, m11));
-		glEnableVertexAttribArray(4);
-		glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Matrixy3x3), (GLvoid *)offsetof(Matrixy3x3, m12));
-		glEnableVertexAttribArray(5);
-		glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, sizeof(Matrixy3x3), (GLvoid *)offsetof(Matrixy3x3, m13));
-
-		glVertexAttribDivisor(3, 1);
-		glVertexAttribDivisor(4, 1);
-		glVertexAttribDivisor(5, 1);
-
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		m_ProjectileInstanceBuf.Reset(newbuf);
-		glBindVertexArray(0);
+	GLuint buffer = 0;
+	GLintptr offset = 0;
+	if (auto alloc = Drawing::StreamData(data.data(), (GLsizeiptr)(sizeof(ProjInstanceData) * data.size()), alignof(ProjInstanceData)))
+	{
+		buffer = alloc.Buffer;
+		offset = alloc.Offset;
 	}
 	else
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_ProjectileInstanceBuf.Get());
-		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(Matrixy3x3) * data.size(), data.data());
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		if (data.size() > m_InstanceBufferSize)
+		{
+			m_InstanceBufferSize = data.size();
+
+			GLuint newbuf = 0u;
+			glGenBuffers(1, &newbuf);
+			glBindBuffer(GL_ARRAY_BUFFER, newbuf);
+			glBufferData(GL_ARRAY_BUFFER, sizeof(ProjInstanceData) * data.size(), data.data(), GL_DYNAMIC_DRAW);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			m_ProjectileInstanceBuf.Reset(newbuf);
+		}
+		else
+		{
+			glNamedBufferSubData(m_ProjectileInstanceBuf.Get(), 0, sizeof(ProjInstanceData) * data.size(), data.data());
+		}
+		buffer = m_ProjectileInstanceBuf.Get();
 	}
+
+	// Re-point the instance attributes at wherever the data ended up this frame
+	glBindVertexArray(m_ProjectileVAO.Get());
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+	glEnableVertexAttribArray(3);
+	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(ProjInstanceData), (GLvoid *)(offset + offsetof(ProjInstanceData, ProjectileScaleRotation) + offsetof(Matrixy3x3, m11)));
+	glEnableVertexAttribArray(4);
+	glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(ProjInstanceData), (GLvoid *)(offset + offsetof(ProjInstanceData, ProjectileScaleRotation) + offsetof(Matrixy3x3, m12)));
+	glEnableVertexAttribArray(5);
+	glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, sizeof(ProjInstanceData), (GLvoid *)(offset + offsetof(ProjInstanceData, ProjectileScaleRotation) + offsetof(Matrixy3x3, m13)));
+
+	glVertexAttribDivisor(3, 1);
+	glVertexAttribDivisor(4, 1);
+	glVertexAttribDivisor(5, 1);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
 	CHECK_GL_ERR("Done Instance Buffer Updating");
 }
 
@@ -797,14 +874,16 @@ void Voxel::VoxelWorld::ApplyChunkChanges()
 	for (auto& chunk_change_pair : m_BlockChanges)
 	{
 		auto& chunk = chunk_change_pair.first;
-		auto it = m_Chunks.find(chunk);
-		if (it == m_Chunks.end() || !it->second)
+		auto loaded = m_Chunks.Get(chunk);
+		if (!loaded)
 			continue;
 
 		auto& changes = chunk_change_pair.second;
 		for (auto& change : changes)
 		{
-			it->second->set(change.first, std::move(change.second));
+			auto before = loaded->get_data(change.first);
+			loaded->set(change.first, change.second);
+			DirtyNeighbours(BlockCoord{ chunk, change.first }, before, change.second);
 		}
 		changes.clear();
 		toRemove.push_back(chunk);
@@ -817,78 +896,142 @@ void Voxel::VoxelWorld::ApplyChunkChanges()
 	toRemove.clear();
 }
 
-void Voxel::VoxelWorld::CheckLoadingThread()
+void Voxel::VoxelWorld::DirtyNeighbours(BlockCoord coord, const SerialBlock& before, const SerialBlock& after)
 {
-	std::unique_ptr<Voxel::LoadedChunk> chunkDat;
-	while (m_LoadingStuff->Loaded.try_pop(chunkDat))
+	if (before == after)
+		return;
+
+	for (auto& face : BlockFacesArray)
 	{
-		if (!chunkDat)
+		auto dir = BlockFaceHelper::GetDirectionI(face);
+		auto x = coord.Block.x + dir.x, y = coord.Block.y + dir.y, z = coord.Block.z + dir.z;
+		if (x >= 0 && y >= 0 && z >= 0 && x < Chunk_Size && y < Chunk_Height && z < Chunk_Size)
 			continue;
+		if (auto neighbour = m_Chunks.Get(ChunkCoord{ coord.Chunk.X + dir.x, coord.Chunk.Y + dir.y, coord.Chunk.Z + dir.z }))
+			neighbour->MarkDirty();
+	}
+}
+
+void Voxel::VoxelWorld::RelightSeams(ChunkCoord coord)
+{
+	auto chunk = m_Chunks.Get(coord);
+	if (!chunk || !chunk->GetLight())
+		return;
 
+	auto& data = chunk->GetSerialChunkData();
+	for (auto& face : BlockFacesArray)
+	{
+		auto dir = BlockFaceHelper::GetDirectionI(face);
+		auto neighbour = m_Chunks.Get(ChunkCoord{ coord.X + dir.x, coord.Y + dir.y, coord.Z + dir.z });
+		auto neighbourLight = neighbour ? neighbour->GetLight() : nullptr;
+		auto neighbourData = neighbour ? &neighbour->GetSerialChunkData() : nullptr;
+
+		// Chunk relative bounds of the stale seeds, so within a block of the face
+		Vector::inty3 min, max;
+		if (FindStaleSeeds(*chunk->GetLight(), data, face, neighbourLight, neighbourData, min, max))
+		{
+			chunk->MarkLightChanged(min);
+			chunk->MarkLightChanged(max);
+		}
+		if (neighbourLight && FindStaleSeeds(*neighbourLight, *neighbourData, BlockFaceHelper::GetOpposite(face), chunk->GetLight(), &data, min, max))
 		{
-			std::shared_lock lock(m_ChunksMutex);
-			auto it = m_Chunks.find(chunkDat->Coord);
+			neighbour->MarkLightChanged(min);
+			neighbour->MarkLightChanged(max);
+		}
+	}
+}
 
-			// Skip if not an expected chunk (expected chunks are put into m_Chunks as nullptrs)
-			if (it == m_Chunks.end())
+void Voxel::VoxelWorld::CheckLoadingThread()
+{
+	FlushOverflow(m_LoadingStuff->ToLoad, m_LoadOverflow);
+	FlushOverflow(m_LoadingStuff->ToRecompute, m_RecomputeOverflow);
+	if (!m_LoadOverflow.empty() || !m_RecomputeOverflow.empty())
+		m_LoadingStuff->WorkReady.NotifyOne();
+
+	// Finished chunks are taken a batch at a time
+	std::array<std::unique_ptr<Voxel::LoadedChunk>, 16> batch;
+	while (size_t count = m_LoadingStuff->Loaded.try_pop_bulk(batch.data(), batch.size()))
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto chunkDat = std::move(batch[i]);
+			if (!chunkDat)
 				continue;
 
-			// If there's already a chunk, simply give it the new data
-			if (it->second)
-				continue;
-		}
+			{
+				auto slot = m_Chunks.Find(chunkDat->Coord);
+
+				// Skip if not an expected chunk (expected chunks are reserved in m_Chunks with null chunks)
+				if (!slot)
+					continue;
 
-		std::unique_lock lock(m_ChunksMutex);
-		auto coord = chunkDat->Coord;
-		auto chunkIt = m_Chunks.insert_or_assign(coord, std::make_unique<VoxelChunk>(GetContainer(), mResources, this, ChunkOrigin(coord), std::move(chunkDat)));
+				// If there's already a chunk, simply give it the new data
+				if (slot->Chunk)
+					continue;
+			}
 
-		chunkDat.reset();
+			// The chunk is only made visible to the loading thread once it is fully constructed
+			auto coord = chunkDat->Coord;
+			auto queuedAt = chunkDat->QueuedAt;
+			auto chunk = m_Chunks.Publish(coord, std::make_unique<VoxelChunk>(GetContainer(), mResources, this, ChunkOrigin(coord), std::move(chunkDat)));
+
+			// The chunk's draw call was submitted as it was constructed, so it's visible from the next draw
+			m_StreamingStats.AddLoaded((double)(Profiling::Now() - queuedAt) * 1e-6);
+
+			chunkDat.reset();
 
-		auto& chunk = chunkIt.first->second;
-		{
-			auto it = m_BlockChanges.find(coord);
-			if (it != m_BlockChanges.end())
 			{
-				// Apply chunk changes
-				for (auto& change : it->second)
+				auto it = m_BlockChanges.find(coord);
+				if (it != m_BlockChanges.end())
 				{
-					chunk->set(change.first, std::move(change.second));
+					// Apply chunk changes
+					for (auto& change : it->second)
+					{
+						auto before = chunk->get_data(change.first);
+						chunk->set(change.first, change.second);
+						DirtyNeighbours(BlockCoord{ coord, change.first }, before, change.second);
+					}
+					m_BlockChanges.erase(it);
 				}
-				m_BlockChanges.erase(it);
 			}
-		}
-		{
-			auto it = m_UpdateBlockChanges.find(coord);
-			if (it != m_UpdateBlockChanges.end())
 			{
-				for (auto& change : it->second)
+				auto it = m_UpdateBlockChanges.find(coord);
+				if (it != m_UpdateBlockChanges.end())
 				{
-					chunk->set(change.first, std::move(change.second));
+					for (auto& change : it->second)
+					{
+						chunk->set(change.first, std::move(change.second));
+					}
+					m_UpdateBlockChanges.erase(it);
 				}
-				m_UpdateBlockChanges.erase(it);
 			}
+
+			// Either this chunk or its neighbours may have been lit without the other's current light
+			RelightSeams(coord);
 		}
 	}
-	while (m_LoadingStuff->Recomputed.try_pop(chunkDat))
+	while (size_t count = m_LoadingStuff->Recomputed.try_pop_bulk(batch.data(), batch.size()))
 	{
-		if (!chunkDat)
-			continue;
-
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto chunkDat = std::move(batch[i]);
+			if (!chunkDat)
+				continue;
 
-		std::shared_lock lock(m_ChunksMutex);
-		auto it = m_Chunks.find(chunkDat->Coord);
 
-		// Skip if not an expected chunk (expected chunks are put into m_Chunks as nullptrs)
-		if (it == m_Chunks.end())
-			continue;
+			auto chunk = m_Chunks.Get(chunkDat->Coord);
 
-		// If the chunk is empty, don't do anything as recomputing only happens for existing chunks
-		if (!it->second)
-			continue;
+			// Skip if not loaded, recomputing only happens for existing chunks
+			if (!chunk)
+				continue;
 		
-		it->second->SetFrom(std::move(chunkDat), false);
-		chunkDat.reset();
-		continue;
+			auto lightBefore = chunk->GetLight();
+			chunk->SetFrom(std::move(chunkDat), false);
+			chunkDat.reset();
+			if (chunk->GetLight() != lightBefore)
+				RelightSeams(chunk->GetCoord());
+			continue;
+		}
 	}
 }
 
@@ -896,47 +1039,59 @@ void Voxel::VoxelWorld::Load(ChunkCoord at)
 {
 	PROFILE_PUSH_AGG("Load Chunk");
 	PROFILE_PUSH("Chunk Find");
-	std::shared_lock lock(m_ChunksMutex);
-	auto it = m_Chunks.find(at);
+	bool in_use = m_Chunks.SlotFor(at).InUse;
 	PROFILE_POP();
 
-	// If the chunk exists, it is either being loaded in the loading thread, or has already been loaded
-	if (it != m_Chunks.end())
+	// If the slot is in use, the chunk is either being loaded in the loading thread, or has already been loaded
+	if (in_use)
 	{
 		PROFILE_POP();
 		return;
 	}
 
-	// Chunk doesn't exist already, so queue it up for loading, and insert an empty pointer to the chunk container to indicate it is being loaded
-	lock.unlock();
-	{
-		std::unique_lock write_lock(m_ChunksMutex);
-		m_Chunks.emplace(std::make_pair(at, nullptr));
-	}
-	m_LoadingStuff->ToLoad.push(at);
+	// If this chunk was only just unloaded it may not have been saved yet, make sure it is before it's loaded again
+	if (auto stale = m_Chunks.ReclaimNow(at))
+		m_Stuff.m_ChunkUnloader->UnloadChunk(std::move(stale));
+
+	// Chunk doesn't exist already, so reserve its slot to indicate it is being loaded, and queue it up for loading
+	m_Chunks.Reserve(at);
+	PublishChunkEdits();
+	PushOrOverflow(m_LoadingStuff->ToLoad, m_LoadOverflow, LoadRequest{ at, Profiling::Now() });
+	m_LoadingStuff->WorkReady.NotifyOne();
+	++m_StreamingStats.Requested;
 	PROFILE_POP();
 }
 
+void Voxel::ChunkStreamingStats::AddLoaded(double latencyMs)
+{
+	++Loaded;
+	TotalLatencyMs += latencyMs;
+	MaxLatencyMs = std::max(MaxLatencyMs, latencyMs);
+
+	if (RecentLatenciesMs.size() < LatencyWindow)
+		RecentLatenciesMs.push_back((float)latencyMs);
+	else
+		RecentLatenciesMs[NextLatency] = (float)latencyMs;
+	NextLatency = (NextLatency + 1) % LatencyWindow;
+}
+
 void Voxel::VoxelWorld::Unload(ChunkCoord at)
 {
 	PROFILE_PUSH_AGG("Unload Chunk");
-	PROFILE_PUSH("Acquire Lock");
-	std::unique_lock lock(m_ChunksMutex);
+	// Remove the chunk from the chunks container, it is retired rather than deleted as the loading thread may still be reading it
+	// See ReclaimChunks
+	m_Chunks.Release(at);
 	PROFILE_POP();
-	if (auto it = m_Chunks.find(at); it != m_Chunks.end())
+}
+
+void Voxel::VoxelWorld::ReclaimChunks()
+{
+	for (auto& chunk : m_Chunks.Reclaim())
 	{
-		// Delete the chunk from the chunks container
-		PROFILE_PUSH("Moving/Erasing");
-		std::unique_ptr<VoxelChunk> tmp = std::move(it->second);
-		m_Chunks.erase(it);
-		PROFILE_POP();
-		PROFILE_PUSH("Chunk Unloader");
 		// Give the removed chunk to a deleting interface, this decouples any special logic (like saving the chunk's state) from the voxel world
 		// Though note the VoxelWorld is currently it's own IChunkUnloader
-		m_Stuff.m_ChunkUnloader->UnloadChunk(std::move(tmp));
-		PROFILE_POP();
+		m_Stuff.m_ChunkUnloader->UnloadChunk(std::move(chunk));
 	}
-	PROFILE_POP();
 }
 
 floaty3 Voxel::VoxelWorld::ChunkOrigin(ChunkCoord of)
@@ -983,26 +1138,71 @@ void Voxel::VoxelWorld::AddProjectile<Voxel::HitScanProjectile, floaty3, floaty3
 /// <param name="other">Container for the functions to generate/lookup block data</param>
 void Voxel::DoChunkLoading(std::shared_ptr<LoadingStuff> stuff, LoadingOtherStuff other)
 {
-	using namespace std::chrono;
+	Profiling::SetThreadName("Chunk Loader");
+	auto readers = other.ChunkReaders;
+	auto reader = readers ? readers->RegisterReader() : Threading::EpochDomain::InvalidReader;
 	while (!stuff->QuitVal.load())
 	{
-		if (Voxel::ChunkCoord toLoad; stuff->ToLoad.try_pop(toLoad, 10ms))
+		// Nothing from the world is held while waiting for work
+		if (readers)
+			readers->Offline(reader);
+
+		LoadRequest toLoad;
+		RecomputeRequest toRecompute;
+		bool hasLoad = stuff->ToLoad.try_pop(toLoad);
+		bool hasRecompute = stuff->ToRecompute.try_pop(toRecompute);
+		if (!hasLoad && !hasRecompute)
 		{
-			auto data = other.GetChunkDataFunc(toLoad);
-
-			auto loaded = Voxel::GenerateChunkMesh(*data, toLoad, other.GetBlockIdFunc);
-			loaded->ChunkDat = std::move(*data);
+			// Sleep until the main thread queues something, re-checking after announcing the wait so a push in between isn't missed
+			TRACE_ZONE("Wait For Chunk Work");
+			auto key = stuff->WorkReady.PrepareWait();
+			if (stuff->QuitVal.load() || !stuff->ToLoad.empty_approx() || !stuff->ToRecompute.empty_approx())
+				stuff->WorkReady.CancelWait();
+			else
+				stuff->WorkReady.Wait(key);
+			continue;
+		}
 
+		if (hasLoad)
+		{
+			TRACE_WAIT("Load Queue Wait", toLoad.QueuedAt);
+			TRACE_ZONE("Load Chunk");
+			if (readers)
+				readers->Quiescent(reader);
+
+			TRACE_PUSH("Fetch Chunk Data");
+			auto data = other.GetChunkDataFunc(toLoad.Coord);
+			auto around = other.GetNeighboursFunc(toLoad.Coord);
+			TRACE_POP();
+
+			auto loaded = Voxel::GenerateChunkMesh(*data, toLoad.Coord, around);
+			loaded->ChunkDat = std::move(data);
+			loaded->QueuedAt = toLoad.QueuedAt;
+
+			// push sleeps while the queue is full, and the main thread may be waiting to reclaim a chunk before it pops anything
+			if (readers)
+				readers->Offline(reader);
 			stuff->Loaded.push(std::move(loaded));
 		}
-		if (std::pair<ChunkCoord, std::unique_ptr<ChunkData>> toRecompute; stuff->ToRecompute.try_pop(toRecompute, 10ms))
+		if (hasRecompute)
 		{
-			const auto coord = toRecompute.first;
-			const auto& data = *toRecompute.second;
+			TRACE_WAIT("Recompute Queue Wait", toRecompute.QueuedAt);
+			TRACE_ZONE("Recompute Chunk");
+			if (readers)
+				readers->Quiescent(reader);
+
+
+			const auto coord = toRecompute.Coord;
+			const auto& data = *toRecompute.Data;
 
-			auto recomputed = Voxel::GenerateChunkMesh(data, coord, other.GetBlockIdFunc);
+			auto recomputed = Voxel::GenerateChunkMesh(data, coord, other.GetNeighboursFunc(coord), std::move(toRecompute.Light), toRecompute.LightChanges);
+			recomputed->LightRequest = toRecompute.LightRequest;
 
+			if (readers)
+				readers->Offline(reader);
 			stuff->Recomputed.push(std::move(recomputed));
 		}
 	}
+	if (readers)
+		readers->UnregisterReader(reader);
 }
@@ -3,10 +3,12 @@
 #include "Helpers/GLHelper.h"
 
 #include "Systems/Events/EventsBase.h"
-#include "Systems/Threading/ThreadedQueue.h"
+#include "Systems/Threading/BoundedQueue.h"
 
 #include "VoxelChunk.h"
+#include "VoxelChunkGrid.h"
 #include "VoxelMemoryLevel.h"
+#include "VoxelTickScheduler.h"
 #include "Entities/VoxelProjectiles.h"
 
 #include <unordered_set>
@@ -27,21 +29,47 @@ namespace Voxel
 		virtual void DisplaceWorld(floaty3 by) = 0;
 	};
 
+	// Jobs for the loading thread are stamped (with Profiling::Now) when queued, so the time they wait shows up in traces
+	struct LoadRequest
+	{
+		ChunkCoord Coord;
+		uint64_t QueuedAt;
+	};
+
+	struct RecomputeRequest
+	{
+		ChunkCoord Coord;
+		// The chunk's published blocks, shared rather than copied as they're never written once published
+		std::shared_ptr<const ChunkData> Data;
+		uint64_t QueuedAt;
+		// The chunk's current light and the blocks whose light changed since, see GenerateChunkMesh
+		std::shared_ptr<const ChunkLightMap> Light;
+		std::vector<Vector::inty3> LightChanges;
+		uint64_t LightRequest;
+	};
+
 	struct LoadingStuff
 	{
-		Threading::ThreadedQueue<ChunkCoord> ToLoad;
-		Threading::ThreadedQueue<std::pair<ChunkCoord, std::unique_ptr<ChunkData>>> ToRecompute;
+		// Outstanding loads are bounded by the loaded area, anything that doesn't fit waits in the world's overflow lists
+		Threading::BoundedQueue<LoadRequest> ToLoad{ 1024 };
+		Threading::BoundedQueue<RecomputeRequest> ToRecompute{ 256 };
 
-		Threading::ThreadedQueue<std::unique_ptr<LoadedChunk>> Loaded;
-		Threading::ThreadedQueue<std::unique_ptr<LoadedChunk>> Recomputed;
+		// The loading thread blocks while these are full, the main thread empties them every frame
+		Threading::BoundedQueue<std::unique_ptr<LoadedChunk>> Loaded{ 256 };
+		Threading::BoundedQueue<std::unique_ptr<LoadedChunk>> Recomputed{ 256 };
+
+		// Notified after queueing into ToLoad/ToRecompute (and on quit), the loading thread sleeps on it while both are empty
+		Threading::EventCount WorkReady;
 		std::atomic<bool> QuitVal;
 	};
 
 	struct LoadingOtherStuff
 	{
-		// Must be a thread-safe function that determines whether there is a block at specified position
-		std::function<SerialBlock(BlockCoord coord)> GetBlockIdFunc;
+		// Must be a thread-safe function that gathers the published blocks and light of a chunk's neighbours
+		std::function<ChunkNeighbourhood(ChunkCoord coord)> GetNeighboursFunc;
 		std::function<std::unique_ptr<ChunkData>(ChunkCoord coord)> GetChunkDataFunc;
+		// The loading thread registers itself as a reader of the world's chunks, announcing quiescent states between jobs
+		Threading::EpochDomain* ChunkReaders = nullptr;
 	};
 
 	void DoChunkLoading(std::shared_ptr<LoadingStuff> stuff, LoadingOtherStuff other);
@@ -59,6 +87,24 @@ namespace Voxel
 		size_t HalfBonusDepth = 4;
 
 		size_t ChunkLeniance = 1; // The number of chunks the centre must be away from the middle loaded chunk to load/unload new/old chunks
+
+		double BlockTickBudget = 0.002; // Seconds per frame update blocks may spend ticking before the rest are deferred to the next frame, 0 for no limit
+	};
+
+	// Counts of the chunks a world has streamed in, latencies are from a chunk being queued for loading until it's published (and so drawn)
+	struct ChunkStreamingStats
+	{
+		static constexpr size_t LatencyWindow = 4096;
+
+		size_t Requested = 0;
+		size_t Loaded = 0;
+		double TotalLatencyMs = 0.0;
+		double MaxLatencyMs = 0.0;
+		// The last LatencyWindow latencies, in no particular order once full
+		std::vector<float> RecentLatenciesMs;
+		size_t NextLatency = 0;
+
+		void AddLoaded(double latencyMs);
 	};
 
 	// VoxelWorld is a class designed to load*, unload chunks, and displace the physics world in order to keep the player at the centre of world
@@ -90,7 +136,8 @@ namespace Voxel
 
 		ICube* GetCubeAt(BlockCoord coord); // Get is thread-safe, modification via returned pointer not thread-safe
 		const ICube* GetCubeAt(BlockCoord coord) const; // Thread-safe
-		SerialBlock GetCubeDataAt(BlockCoord coord) const; // Thread-safe
+		SerialBlock GetCubeDataAt(BlockCoord coord) const; // Main thread only
+		ChunkNeighbourhood GetNeighbourhood(ChunkCoord coord) const; // Lock-free, only sees published blocks and light (see PublishChunkEdits)
 		bool IsCubeAt(BlockCoord coord) const; // Thread-safe
 
 		// Get the coords of a block/chunk given by position, in Displaced Physics space
@@ -108,7 +155,14 @@ namespace Voxel
 
 		// Publicly accessible chunk recomputing
 		// Possibly move to a protected interface and give to consumers?
-		void ReloadChunkAt(ChunkCoord at, const ChunkData& srcData);
+		void ReloadChunkAt(ChunkCoord at, std::shared_ptr<const ChunkData> srcData, std::shared_ptr<const ChunkLightMap> light, std::vector<Vector::inty3> lightChanges, uint64_t lightRequest);
+
+		// Blocks set on the main thread are copied into the chunk and only become visible to the loading thread when published
+		// Chunks queue themselves when first edited, and every queued chunk is published before work is queued for the loading thread
+		void QueueChunkPublish(ChunkCoord coord);
+		void PublishChunkEdits();
+		// Keeps a chunk's replaced blocks or light alive until the loading thread can't be reading them
+		void RetireChunkData(std::shared_ptr<const void> data);
 
 
 		// Chunk Unloading
@@ -128,21 +182,36 @@ namespace Voxel
 
 		ChunkStatus GetChunkStatus(ChunkCoord coord);
 
+		inline const ChunkStreamingStats& GetStreamingStats() const { return m_StreamingStats; }
+
+		inline BlockTickScheduler& GetBlockTicks() { return m_BlockTicks; }
+		inline const BlockTickScheduler& GetBlockTicks() const { return m_BlockTicks; }
+
 	protected:
 
 		WorldStuff m_Stuff;
 		std::shared_ptr<LoadingStuff> m_LoadingStuff;
 		std::thread m_LoadingThread;
-		mutable std::shared_mutex m_ChunksMutex; // Synchronise access to chunks to allow for reading from a separate loading thread
 		mutable std::shared_mutex m_ChunkMemoryMutex; // Synchronise access to chunk memory to allow for reading from a separate loading thread
 		// CODESMELL ^ VoxelWorld holding the mutex guarding access to the Chunk Memory seems fishy when it doesn't even own the memory (it's given a pointer that's assumed to live at least as long as the world)
 
 		// Store a list of pre-calculated offsets from the centre/player to load as the player/centre moves
 		std::vector<ChunkCoord> m_ChunkLoadingOffsets;
 
-		// Store the actual chunks in an unordered_map
-		// Storing them as unique_ptrs is perhaps not necessary
-		std::unordered_map<ChunkCoord, std::unique_ptr<VoxelChunk>> m_Chunks;
+		ChunkStreamingStats m_StreamingStats;
+
+		// Requests that didn't fit in the loading thread's queues, retried (oldest first) every frame
+		std::vector<LoadRequest> m_LoadOverflow;
+		std::vector<RecomputeRequest> m_RecomputeOverflow;
+
+		// Ticks the awake update blocks of every chunk, declared before m_Chunks so it outlives the chunks' blocks
+		BlockTickScheduler m_BlockTicks;
+
+		// Store the actual chunks in a toroidal grid the size of the loaded area
+		// Only modified on the main thread, chunk lookups are lock-free so the loading thread can read blocks without blocking it
+		ChunkGrid m_Chunks;
+		// Chunks with blocks set since they were last published, see PublishChunkEdits
+		std::vector<ChunkCoord> m_EditedChunks;
 		
 		// Temporary measure to store changes and prevent them being unloaded
 		std::unordered_map<ChunkCoord, std::vector<std::pair<ChunkBlockCoord, std::unique_ptr<ICube>>>> m_UpdateBlockChanges;
@@ -183,11 +252,21 @@ namespace Voxel
 
 		void ApplyChunkChanges();
 
+		// Marks the neighbouring chunks a changed block on the side of its chunk is culled against as dirty
+		// Their light is checked once the block's chunk is re-lit, see RelightSeams
+		void DirtyNeighbours(BlockCoord coord, const SerialBlock& before, const SerialBlock& after);
+
+		// Compares the light each side of a chunk's faces were seeded with against its neighbours' current light
+		// Either chunk is re-lit along the face wherever that difference reaches its blocks
+		void RelightSeams(ChunkCoord coord);
+
 		void CheckLoadingThread();
 
 		// Begins loading chunk at specific coord
 		void Load(ChunkCoord at);
 		void Unload(ChunkCoord at);
+		// Hands released chunks that no reader can still be using to the chunk unloader
+		void ReclaimChunks();
 
 		floaty3 ChunkOrigin(ChunkCoord of);
 
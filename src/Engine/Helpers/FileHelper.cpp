@@ -9,6 +9,18 @@ namespace fs = std::filesystem;
 #endif
 
 #include <fstream>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 std::string FileHelper::WorkingDirectory()
 {
@@ -92,3 +104,95 @@ bool FileHelper::PathExists(std::string path)
 {
 	return fs::exists(path);
 }
+
+FileHelper::MappedFile::MappedFile(const std::string& path)
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return;
+	_file = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || !size.QuadPart)
+	{
+		Close();
+		return;
+	}
+
+	_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!_mapping)
+	{
+		Close();
+		return;
+	}
+
+	_data = (const unsigned char*)MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!_data)
+	{
+		Close();
+		return;
+	}
+	_size = (size_t)size.QuadPart;
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return;
+
+	struct stat info;
+	if (fstat(fd, &info) == 0 && info.st_size > 0)
+	{
+		void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data != MAP_FAILED)
+		{
+			_data = (const unsigned char*)data;
+			_size = (size_t)info.st_size;
+		}
+	}
+	close(fd); // The mapping stays valid after the descriptor is closed
+#endif
+}
+
+FileHelper::MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+	*this = std::move(other);
+}
+
+FileHelper::MappedFile::~MappedFile()
+{
+	Close();
+}
+
+FileHelper::MappedFile& FileHelper::MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this == &other)
+		return *this;
+
+	Close();
+	std::swap(_data, other._data);
+	std::swap(_size, other._size);
+#ifdef _WIN32
+	std::swap(_file, other._file);
+	std::swap(_mapping, other._mapping);
+#endif
+	return *this;
+}
+
+void FileHelper::MappedFile::Close()
+{
+#ifdef _WIN32
+	if (_data)
+		UnmapViewOfFile(_data);
+	if (_mapping)
+		CloseHandle(_mapping);
+	if (_file)
+		CloseHandle(_file);
+	_mapping = nullptr;
+	_file = nullptr;
+#else
+	if (_data)
+		munmap((void*)_data, _size);
+#endif
+	_data = nullptr;
+	_size = 0;
+}
@@ -12,4 +12,33 @@ namespace FileHelper
 	bool DirectoryExists(std::string path);
 	bool FileExists(std::string path);
 	bool PathExists(std::string path);
+
+	/**
+	* A read only memory mapping of an entire file.
+	* Evaluates to false if the file could not be opened or mapped (or is empty).
+	*/
+	class MappedFile
+	{
+		const unsigned char* _data = nullptr;
+		size_t _size = 0;
+#ifdef _WIN32
+		void* _file = nullptr;
+		void* _mapping = nullptr;
+#endif
+
+		void Close();
+	public:
+		MappedFile() = default;
+		explicit MappedFile(const std::string& path);
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile(const MappedFile& other) = delete;
+		~MappedFile();
+
+		MappedFile& operator=(MappedFile&& other) noexcept;
+		MappedFile& operator=(const MappedFile& other) = delete;
+
+		inline const unsigned char* Data() const { return _data; }
+		inline size_t Size() const { return _size; }
+		inline explicit operator bool() const { return _data; }
+	};
 }
\ No newline at end of file
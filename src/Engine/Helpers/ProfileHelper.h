@@ -2,39 +2,50 @@
 
 #include "Systems/Timer/Timer.h"
 
+#include "TraceHelper.h"
+
+// Every zone is also recorded by the trace profiler (see TraceHelper.h), which unlike ProfileMcGee stays on without EC_PROFILE
+// Names given to PROFILE_PUSH must be known at compile time, use PROFILE_PUSH_DYNAMIC for names built at runtime
+// or PROFILE_PUSH_CACHED (with a Profiling::CachedZone kept by the object being profiled) for runtime names pushed every frame
 #ifdef EC_PROFILE
 #ifdef NDEBUG
-#define PROFILE_PUSH(x) mResources->Profile->Push(x)
-#define PROFILE_PUSH_WITH(prof, x) prof->Push(x)
-#define PROFILE_PUSH_AGG(x) mResources->Profile->PushAggregate(x)
-#define PROFILE_PUSH_AGG_WITH(prof, x) prof->PushAggregate(x)
-#define PROFILE_POP() mResources->Profile->Pop()
-#define PROFILE_POP_WITH(prof) prof->Pop()
-
-#define PROFILE_EVENT(x, agg) ProfileEvent{ mResources->Profile, x, agg }
-#define PROFILE_EVENT_WITH(prof, x, agg) ProfileEvent{ prof, x, agg }
+#define PROFILE_PUSH(x) (mResources->Profile->Push(x), TRACE_PUSH(x))
+#define PROFILE_PUSH_WITH(prof, x) (prof->Push(x), TRACE_PUSH(x))
+#define PROFILE_PUSH_DYNAMIC(x) (mResources->Profile->Push(x), TRACE_PUSH_DYNAMIC(x))
+#define PROFILE_PUSH_CACHED(cache, x) (mResources->Profile->Push(x), TRACE_PUSH_CACHED(cache, x))
+#define PROFILE_PUSH_AGG(x) (mResources->Profile->PushAggregate(x), TRACE_PUSH(x))
+#define PROFILE_PUSH_AGG_WITH(prof, x) (prof->PushAggregate(x), TRACE_PUSH(x))
+#define PROFILE_POP() (mResources->Profile->Pop(), TRACE_POP())
+#define PROFILE_POP_WITH(prof) (prof->Pop(), TRACE_POP())
+
+#define PROFILE_EVENT(name, x, agg) TRACE_ZONE_NAMED(TRACE_CONCAT(name, Trace), x); auto name = ProfileEvent{ mResources->Profile, x, agg }
+#define PROFILE_EVENT_WITH(name, prof, x, agg) TRACE_ZONE_NAMED(TRACE_CONCAT(name, Trace), x); auto name = ProfileEvent{ prof, x, agg }
 #else
 #include "DebugHelper.h"
-#define PROFILE_PUSH(x) mResources->Profile->Push(x, __FUNCTION_NAME__, __LINE__)
-#define PROFILE_PUSH_WITH(prof, x) prof->Push(x, __FUNCTION_NAME__, __LINE__)
-#define PROFILE_PUSH_AGG(x) mResources->Profile->PushAggregate(x, __FUNCTION_NAME__, __LINE__)
-#define PROFILE_PUSH_AGG_WITH(prof, x) prof->PushAggregate(x, __FUNCTION_NAME__, __LINE__)
-#define PROFILE_POP() mResources->Profile->Pop(__FUNCTION_NAME__, __LINE__)
-#define PROFILE_POP_WITH(prof) prof->Pop(__FUNCTION_NAME__, __LINE__)
-
-#define PROFILE_EVENT(name, x, agg) auto name = ProfileEvent{ mResources->Profile, x, agg, __FUNCTION_NAME__, __LINE__ }
-#define PROFILE_EVENT_WITH(name, prof, x, agg) ProfileEvent{ prof, x, agg, __FUNCTION_NAME__, __LINE__ }
+#define PROFILE_PUSH(x) (mResources->Profile->Push(x, __FUNCTION_NAME__, __LINE__), TRACE_PUSH(x))
+#define PROFILE_PUSH_WITH(prof, x) (prof->Push(x, __FUNCTION_NAME__, __LINE__), TRACE_PUSH(x))
+#define PROFILE_PUSH_DYNAMIC(x) (mResources->Profile->Push(x, __FUNCTION_NAME__, __LINE__), TRACE_PUSH_DYNAMIC(x))
+#define PROFILE_PUSH_CACHED(cache, x) (mResources->Profile->Push(x, __FUNCTION_NAME__, __LINE__), TRACE_PUSH_CACHED(cache, x))
+#define PROFILE_PUSH_AGG(x) (mResources->Profile->PushAggregate(x, __FUNCTION_NAME__, __LINE__), TRACE_PUSH(x))
+#define PROFILE_PUSH_AGG_WITH(prof, x) (prof->PushAggregate(x, __FUNCTION_NAME__, __LINE__), TRACE_PUSH(x))
+#define PROFILE_POP() (mResources->Profile->Pop(__FUNCTION_NAME__, __LINE__), TRACE_POP())
+#define PROFILE_POP_WITH(prof) (prof->Pop(__FUNCTION_NAME__, __LINE__), TRACE_POP())
+
+#define PROFILE_EVENT(name, x, agg) TRACE_ZONE_NAMED(TRACE_CONCAT(name, Trace), x); auto name = ProfileEvent{ mResources->Profile, x, agg, __FUNCTION_NAME__, __LINE__ }
+#define PROFILE_EVENT_WITH(name, prof, x, agg) TRACE_ZONE_NAMED(TRACE_CONCAT(name, Trace), x); auto name = ProfileEvent{ prof, x, agg, __FUNCTION_NAME__, __LINE__ }
 #endif // _DEBUG
 #else
-#define PROFILE_PUSH(x) ((int)0)
-#define PROFILE_POP() ((int)0)
-#define PROFILE_PUSH_WITH(prof, x) ((int)0)
-#define PROFILE_PUSH_AGG(x) ((int)0)
-#define PROFILE_PUSH_AGG_WITH(prof, x) ((int)0)
-#define PROFILE_POP_WITH(prof) ((int)0)
-
-#define PROFILE_EVENT(name, x, agg) ((int)0)
-#define PROFILE_EVENT_WITH(name, prof, x, agg) ((int)0)
+#define PROFILE_PUSH(x) TRACE_PUSH(x)
+#define PROFILE_POP() TRACE_POP()
+#define PROFILE_PUSH_WITH(prof, x) TRACE_PUSH(x)
+#define PROFILE_PUSH_DYNAMIC(x) TRACE_PUSH_DYNAMIC(x)
+#define PROFILE_PUSH_CACHED(cache, x) TRACE_PUSH_CACHED(cache, x)
+#define PROFILE_PUSH_AGG(x) TRACE_PUSH(x)
+#define PROFILE_PUSH_AGG_WITH(prof, x) TRACE_PUSH(x)
+#define PROFILE_POP_WITH(prof) TRACE_POP()
+
+#define PROFILE_EVENT(name, x, agg) TRACE_ZONE_NAMED(name, x)
+#define PROFILE_EVENT_WITH(name, prof, x, agg) TRACE_ZONE_NAMED(name, x)
 #endif // EC_PROFILE
 
 #ifdef EC_PROFILE
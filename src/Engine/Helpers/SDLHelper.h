@@ -54,7 +54,7 @@ struct SimpleSurface
 		Delete();
 		Surface = ss.Surface;
 		ss.Surface = nullptr;
-		ss.OwnsSurface = ss.OwnsSurface;
+		OwnsSurface = ss.OwnsSurface;
 		return *this;
 	}
 
@@ -0,0 +1,363 @@
+#include "TraceHelper.h"
+
+#include "DebugHelper.h"
+
+#include <algorithm>
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	using namespace Profiling;
+
+	constexpr ZoneID DisabledZone = ~ZoneID(0);
+	const std::string UnknownZone = "Unknown";
+
+	struct ThreadTrace
+	{
+		struct OpenZone
+		{
+			ZoneID Zone;
+			uint64_t Begin;
+		};
+
+		// Only allocated once the thread records its first zone
+		std::unique_ptr<ZoneRecord[]> Records;
+		// Total records ever written, the next goes in Records[Written % RingCapacity]
+		std::atomic<uint64_t> Written{ 0 };
+
+		std::array<OpenZone, MaxDepth> Open;
+		uint32_t Depth = 0;
+		uint32_t Overflow = 0; // Zones begun past MaxDepth that haven't ended yet
+
+		uint32_t ThreadID = 0;
+		std::string Name; // Guarded by the registry lock
+		bool Exited = false; // Guarded by the registry lock
+	};
+
+	struct TraceRegistry
+	{
+		std::mutex Lock;
+		std::unordered_map<std::string, ZoneID> ZoneIDs;
+		std::deque<std::string> ZoneNames;
+		// Kept after their thread exits so what it recorded can still be exported,
+		// until the next export or until a new thread takes over the ring (so there are never more rings than threads running at once)
+		std::vector<std::unique_ptr<ThreadTrace>> Threads;
+		uint32_t LastThreadID = 0;
+
+		std::atomic<bool> Enabled{ true };
+		const std::chrono::steady_clock::time_point Epoch = std::chrono::steady_clock::now();
+	};
+
+	TraceRegistry &GetRegistry()
+	{
+		static TraceRegistry registry;
+		return registry;
+	}
+
+	// Must be called with the registry locked
+	ThreadTrace &AddTrace(TraceRegistry &registry, std::string name)
+	{
+		auto &added = registry.Threads.emplace_back(std::make_unique<ThreadTrace>());
+		added->ThreadID = ++registry.LastThreadID;
+		added->Name = name.empty() ? "Thread " + std::to_string(added->ThreadID) : std::move(name);
+		return *added;
+	}
+
+	// Marks the thread's trace as exited when the thread ends
+	struct ThreadTraceOwner
+	{
+		ThreadTrace *Trace = nullptr;
+
+		~ThreadTraceOwner()
+		{
+			if (!Trace)
+				return;
+			auto &registry = GetRegistry();
+			std::lock_guard<std::mutex> lock(registry.Lock);
+			Trace->Exited = true;
+		}
+	};
+
+	ThreadTrace &GetThreadTrace()
+	{
+		thread_local ThreadTraceOwner owner;
+		if (!owner.Trace)
+		{
+			auto &registry = GetRegistry();
+			std::lock_guard<std::mutex> lock(registry.Lock);
+
+			// Take the ring of the oldest exited thread (dropping what it recorded) rather than allocating another
+			std::unique_ptr<ZoneRecord[]> recycled;
+			auto exited = std::find_if(registry.Threads.begin(), registry.Threads.end(), [](const auto &thread) { return thread->Exited; });
+			if (exited != registry.Threads.end())
+			{
+				recycled = std::move((*exited)->Records);
+				registry.Threads.erase(exited);
+			}
+
+			owner.Trace = &AddTrace(registry, "");
+			owner.Trace->Records = std::move(recycled);
+		}
+		return *owner.Trace;
+	}
+
+	// Must be called with the registry locked
+	ThreadTrace *FindTrace(TraceRegistry &registry, uint32_t threadID)
+	{
+		for (auto &thread : registry.Threads)
+		{
+			if (thread->ThreadID == threadID)
+				return thread.get();
+		}
+		return nullptr;
+	}
+
+	void Append(ThreadTrace &trace, const ZoneRecord &record)
+	{
+		if (!trace.Records)
+			trace.Records.reset(new ZoneRecord[RingCapacity]);
+
+		auto index = trace.Written.load(std::memory_order_relaxed);
+		trace.Records[index % RingCapacity] = record;
+		trace.Written.store(index + 1, std::memory_order_release);
+	}
+
+	void WriteEscaped(std::ofstream &file, const std::string &str)
+	{
+		for (char c : str)
+		{
+			if (c == '"' || c == '\\')
+				file << '\\' << c;
+			else if ((unsigned char)c < 0x20)
+				file << ' ';
+			else
+				file << c;
+		}
+	}
+}
+
+Profiling::ZoneID Profiling::RegisterZone(const char *name)
+{
+	return RegisterZone(std::string(name ? name : ""));
+}
+
+Profiling::ZoneID Profiling::RegisterZone(const std::string &name)
+{
+	// Runtime named zones are looked up every time they're pushed, so keep the common case off the lock
+	thread_local std::unordered_map<std::string, ZoneID> cache;
+	auto cached = cache.find(name);
+	if (cached != cache.end())
+		return cached->second;
+
+	auto &registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.Lock);
+	auto it = registry.ZoneIDs.find(name);
+	if (it == registry.ZoneIDs.end())
+	{
+		it = registry.ZoneIDs.emplace(name, (ZoneID)registry.ZoneNames.size()).first;
+		registry.ZoneNames.push_back(name);
+	}
+	cache.emplace(name, it->second);
+	return it->second;
+}
+
+std::string Profiling::GetZoneName(ZoneID id)
+{
+	auto &registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.Lock);
+	if (id >= registry.ZoneNames.size())
+		return "Unknown";
+	return registry.ZoneNames[id];
+}
+
+uint64_t Profiling::Now()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - GetRegistry().Epoch).count();
+}
+
+void Profiling::BeginZone(ZoneID zone)
+{
+	auto &trace = GetThreadTrace();
+	if (trace.Depth >= MaxDepth)
+	{
+		++trace.Overflow;
+		return;
+	}
+
+	if (!GetRegistry().Enabled.load(std::memory_order_relaxed))
+		zone = DisabledZone;
+
+	trace.Open[trace.Depth++] = ThreadTrace::OpenZone{ zone, zone == DisabledZone ? 0 : Now() };
+}
+
+void Profiling::EndZone()
+{
+	auto &trace = GetThreadTrace();
+	if (trace.Overflow)
+	{
+		--trace.Overflow;
+		return;
+	}
+	if (!trace.Depth)
+		return;
+
+	auto &open = trace.Open[--trace.Depth];
+	if (open.Zone == DisabledZone)
+		return;
+
+	Append(trace, ZoneRecord{ open.Zone, trace.Depth, open.Begin, Now() });
+}
+
+void Profiling::RecordWait(ZoneID zone, uint64_t begin, uint64_t end)
+{
+	if (!IsEnabled())
+		return;
+
+	Append(GetThreadTrace(), ZoneRecord{ zone, WaitDepth, begin, end });
+}
+
+void Profiling::SetThreadName(const std::string &name)
+{
+	auto &trace = GetThreadTrace();
+	auto &registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.Lock);
+	trace.Name = name;
+}
+
+Profiling::TrackID Profiling::RegisterTrack(const std::string &name)
+{
+	auto &registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.Lock);
+	return AddTrace(registry, name).ThreadID;
+}
+
+void Profiling::RecordZones(TrackID track, const ZoneRecord *records, size_t count)
+{
+	if (!count || !IsEnabled())
+		return;
+
+	ThreadTrace *trace = nullptr;
+	{
+		auto &registry = GetRegistry();
+		std::lock_guard<std::mutex> lock(registry.Lock);
+		trace = FindTrace(registry, track);
+		if (!trace)
+			return;
+	}
+
+	for (size_t i = 0; i < count; ++i)
+		Append(*trace, records[i]);
+}
+
+void Profiling::SetEnabled(bool enabled)
+{
+	GetRegistry().Enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Profiling::IsEnabled()
+{
+	return GetRegistry().Enabled.load(std::memory_order_relaxed);
+}
+
+bool Profiling::WriteChromeTrace(const std::string &filename)
+{
+	std::ofstream file{ filename, std::ios::binary };
+	if (!file.good())
+	{
+		DWARNING("Could not open '" + filename + "' to write the trace to");
+		return false;
+	}
+
+	struct ThreadCopy
+	{
+		uint32_t ThreadID;
+		std::string Name;
+		std::vector<ZoneRecord> Records;
+	};
+
+	// Copied under the lock, so an exited thread's ring can't be recycled or freed part way through
+	auto &registry = GetRegistry();
+	std::vector<ThreadCopy> threads;
+	std::vector<std::string> names;
+	{
+		std::lock_guard<std::mutex> lock(registry.Lock);
+		for (auto &thread : registry.Threads)
+		{
+			auto &copy = threads.emplace_back(ThreadCopy{ thread->ThreadID, thread->Name, {} });
+
+			auto written = thread->Written.load(std::memory_order_acquire);
+			if (!written || !thread->Records)
+				continue;
+
+			// The thread may keep recording while this copies, anything it could have overwritten in the meantime is dropped
+			auto oldest = written > RingCapacity ? written - RingCapacity : 0;
+			copy.Records.reserve((size_t)(written - oldest));
+			for (auto i = oldest; i < written; ++i)
+				copy.Records.push_back(thread->Records[i % RingCapacity]);
+			auto after = thread->Written.load(std::memory_order_acquire);
+			auto safeFrom = after + 1 > RingCapacity ? after + 1 - RingCapacity : 0; // Including the slot it may be writing right now
+			if (safeFrom > oldest)
+				copy.Records.erase(copy.Records.begin(), copy.Records.begin() + (size_t)std::min(safeFrom - oldest, written - oldest));
+		}
+		names.assign(registry.ZoneNames.begin(), registry.ZoneNames.end());
+
+		// Exited threads have nothing more to record, now they've been written out their rings can go
+		registry.Threads.erase(std::remove_if(registry.Threads.begin(), registry.Threads.end(), [](const auto &thread) { return thread->Exited; }), registry.Threads.end());
+	}
+
+	file << std::fixed << std::setprecision(3);
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	auto separator = [&]() { if (!first) file << ",\n"; first = false; };
+
+	size_t total = 0;
+	uint64_t waitID = 0;
+	for (auto &thread : threads)
+	{
+		separator();
+		file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread.ThreadID << ",\"args\":{\"name\":\"";
+		WriteEscaped(file, thread.Name);
+		file << "\"}}";
+
+		for (auto &record : thread.Records)
+		{
+			auto &name = record.Zone < names.size() ? names[record.Zone] : UnknownZone;
+			separator();
+			if (record.Depth == WaitDepth)
+			{
+				// Waits are async begin/end pairs, which get their own rows so overlapping ones are readable
+				++waitID;
+				file << "{\"name\":\"";
+				WriteEscaped(file, name);
+				file << "\",\"cat\":\"wait\",\"ph\":\"b\",\"id\":" << waitID << ",\"pid\":1,\"tid\":" << thread.ThreadID
+					<< ",\"ts\":" << (double)record.Begin / 1000.0 << "},\n";
+				file << "{\"name\":\"";
+				WriteEscaped(file, name);
+				file << "\",\"cat\":\"wait\",\"ph\":\"e\",\"id\":" << waitID << ",\"pid\":1,\"tid\":" << thread.ThreadID
+					<< ",\"ts\":" << (double)record.End / 1000.0 << "}";
+			}
+			else
+			{
+				file << "{\"name\":\"";
+				WriteEscaped(file, name);
+				file << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread.ThreadID
+					<< ",\"ts\":" << (double)record.Begin / 1000.0
+					<< ",\"dur\":" << (double)(record.End - record.Begin) / 1000.0 << "}";
+			}
+			++total;
+		}
+	}
+	file << "]}" << std::endl;
+
+	DINFO("Wrote " + std::to_string(total) + " zones from " + std::to_string(threads.size()) + " thread(s) to '" + filename + "'");
+	return file.good();
+}
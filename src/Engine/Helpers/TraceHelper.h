@@ -0,0 +1,111 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef EC_TRACE
+// The zone ID of a name known at compile time (a literal, or a constant expression), registered once per call site
+#define TRACE_ZONE_ID(x) ([]() -> Profiling::ZoneID { static const Profiling::ZoneID id = Profiling::RegisterZone(x); return id; }())
+#define TRACE_PUSH(x) Profiling::BeginZone(TRACE_ZONE_ID(x))
+// For names built at runtime, these are looked up every time so keep them out of hot loops
+#define TRACE_PUSH_DYNAMIC(x) Profiling::BeginZone(Profiling::RegisterZone(x))
+// For names built at runtime that belong to an object, x is only evaluated the first time the object's Profiling::CachedZone is used
+#define TRACE_PUSH_CACHED(cache, x) Profiling::BeginZone((cache).Get([&]() { return x; }))
+#define TRACE_POP() Profiling::EndZone()
+#define TRACE_ZONE(x) Profiling::ScopedZone TRACE_CONCAT(traceZone_, __LINE__){ TRACE_ZONE_ID(x) }
+#define TRACE_ZONE_NAMED(name, x) Profiling::ScopedZone name{ TRACE_ZONE_ID(x) }
+// Records time spent waiting (e.g. in a queue) from begin (a Profiling::Now() timestamp) until now, waits may overlap each other
+#define TRACE_WAIT(x, begin) Profiling::RecordWait(TRACE_ZONE_ID(x), begin, Profiling::Now())
+#else
+#define TRACE_PUSH(x) ((int)0)
+#define TRACE_PUSH_DYNAMIC(x) ((int)0)
+#define TRACE_PUSH_CACHED(cache, x) ((int)0)
+#define TRACE_POP() ((int)0)
+#define TRACE_ZONE(x) ((int)0)
+#define TRACE_ZONE_NAMED(name, x) ((int)0)
+#define TRACE_WAIT(x, begin) ((int)0)
+#endif // EC_TRACE
+
+/**
+* A low overhead profiler that is cheap enough to leave on in release builds.
+* Each thread records closed zones (zone, begin, end) into its own fixed size ring buffer, so only the most recent zones are kept and nothing grows.
+* Zone names are registered once (per call site with TRACE_PUSH/TRACE_ZONE) and records only hold their IDs.
+* The buffers can be written out at any time as Chrome trace event JSON, viewable in chrome://tracing or ui.perfetto.dev.
+* Every thread shares one clock, so worker threads show up as their own tracks alongside the main thread's frames.
+*/
+namespace Profiling
+{
+	using ZoneID = uint32_t;
+
+	// One closed zone, times are in nanoseconds since the profiler was first used
+	struct ZoneRecord
+	{
+		ZoneID Zone;
+		uint32_t Depth; // WaitDepth for waits recorded with RecordWait
+		uint64_t Begin;
+		uint64_t End;
+	};
+	constexpr uint32_t WaitDepth = ~uint32_t(0);
+
+	// Records kept per thread, older ones are overwritten (24 bytes each)
+	constexpr size_t RingCapacity = 1 << 16;
+	// Zones nested deeper than this on one thread aren't recorded (but are still balanced)
+	constexpr uint32_t MaxDepth = 64;
+
+	// Returns the ID of a zone name, registering it the first time it's seen (thread safe)
+	ZoneID RegisterZone(const char *name);
+	ZoneID RegisterZone(const std::string &name);
+	std::string GetZoneName(ZoneID id);
+
+	void BeginZone(ZoneID zone);
+	void EndZone();
+	// Records a wait that has already finished on the calling thread's track, exported as an async span so overlapping waits stack instead of nesting
+	void RecordWait(ZoneID zone, uint64_t begin, uint64_t end);
+
+	// Names the calling thread in exported traces
+	void SetThreadName(const std::string &name);
+
+	// A track of zones that didn't run on a thread of their own (e.g. GPU timings), exported alongside the thread tracks
+	using TrackID = uint32_t;
+	TrackID RegisterTrack(const std::string &name);
+	// Appends zones that have already finished to a track, only one thread should record to a track at a time
+	void RecordZones(TrackID track, const ZoneRecord *records, size_t count);
+
+	// A zone named at runtime that is registered the first time it's used, for objects (like shapes) that push the same zone every frame
+	struct CachedZone
+	{
+		static constexpr ZoneID Unregistered = ~ZoneID(0);
+		ZoneID ID = Unregistered;
+
+		template<class NameFunc>
+		inline ZoneID Get(NameFunc &&name)
+		{
+			if (ID == Unregistered)
+				ID = RegisterZone(name());
+			return ID;
+		}
+		inline void Reset() { ID = Unregistered; }
+	};
+
+	// Zones begun while disabled aren't recorded
+	void SetEnabled(bool enabled);
+	bool IsEnabled();
+
+	// Nanoseconds since the profiler was first used, the clock every record is timed with
+	uint64_t Now();
+
+	// Writes every thread's retained zones as Chrome trace event JSON, returns false if the file couldn't be written
+	bool WriteChromeTrace(const std::string &filename);
+
+	struct ScopedZone
+	{
+		explicit ScopedZone(ZoneID zone) { BeginZone(zone); }
+		~ScopedZone() { EndZone(); }
+
+		ScopedZone(const ScopedZone &) = delete;
+		ScopedZone &operator=(const ScopedZone &) = delete;
+	};
+}
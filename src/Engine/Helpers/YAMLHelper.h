@@ -18,6 +18,7 @@ namespace YAMLNames
 		const std::string TangentTag = "tangent";
 		const std::string BinormalTag = "binormal";
 		const std::string TexCoordTag = "tex";
+		const std::string LightTag = "light";
 		const std::string TexturesTag = "textures";
 		const std::string DiffuseTextureTag = "diffuse";
 		const std::string SpecularTextureTag = "specular";
@@ -4,6 +4,8 @@
 #include "Helpers/SDLHelper.h"
 #include "Helpers/MathHelper.h"
 
+#include "simd.h"
+
 #include <LinearMath/btTransform.h>
 
 Matrixy3x3::Matrixy3x3(const btMatrix3x3& other)
@@ -163,7 +165,215 @@ PointRect Matrixy2x3::TransformRect(const PointRect& rect) const
 
 
 
+#ifdef EC_SIMD_SSE
+namespace
+{
+	// Column j of the result is a's columns weighted by the elements of b's column j,
+	// summed in the same order as MultiplyScalar so without FMA contraction both give bit identical results
+	// Everything is loaded before anything is stored so out may alias a or b
+	inline void MultiplySimd(const float* a, const float* b, float* out)
+	{
+#ifdef EC_SIMD_AVX
+		// Two result columns per 256 bit register, a's columns broadcast into both halves
+		__m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 0));
+		__m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 4));
+		__m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 8));
+		__m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 12));
+
+		__m256 b01 = _mm256_loadu_ps(b + 0);
+		__m256 b23 = _mm256_loadu_ps(b + 8);
+
+		__m256 out01 = _mm256_mul_ps(a0, _mm256_shuffle_ps(b01, b01, 0x00));
+		out01 = _mm256_add_ps(out01, _mm256_mul_ps(a1, _mm256_shuffle_ps(b01, b01, 0x55)));
+		out01 = _mm256_add_ps(out01, _mm256_mul_ps(a2, _mm256_shuffle_ps(b01, b01, 0xAA)));
+		out01 = _mm256_add_ps(out01, _mm256_mul_ps(a3, _mm256_shuffle_ps(b01, b01, 0xFF)));
+
+		__m256 out23 = _mm256_mul_ps(a0, _mm256_shuffle_ps(b23, b23, 0x00));
+		out23 = _mm256_add_ps(out23, _mm256_mul_ps(a1, _mm256_shuffle_ps(b23, b23, 0x55)));
+		out23 = _mm256_add_ps(out23, _mm256_mul_ps(a2, _mm256_shuffle_ps(b23, b23, 0xAA)));
+		out23 = _mm256_add_ps(out23, _mm256_mul_ps(a3, _mm256_shuffle_ps(b23, b23, 0xFF)));
+
+		_mm256_storeu_ps(out + 0, out01);
+		_mm256_storeu_ps(out + 8, out23);
+#else
+		__m128 a0 = _mm_loadu_ps(a + 0);
+		__m128 a1 = _mm_loadu_ps(a + 4);
+		__m128 a2 = _mm_loadu_ps(a + 8);
+		__m128 a3 = _mm_loadu_ps(a + 12);
+
+		__m128 cols[4];
+		for (int j = 0; j < 4; ++j)
+		{
+			__m128 bj = _mm_loadu_ps(b + 4 * j);
+			__m128 col = _mm_mul_ps(a0, _mm_shuffle_ps(bj, bj, _MM_SHUFFLE(0, 0, 0, 0)));
+			col = _mm_add_ps(col, _mm_mul_ps(a1, _mm_shuffle_ps(bj, bj, _MM_SHUFFLE(1, 1, 1, 1))));
+			col = _mm_add_ps(col, _mm_mul_ps(a2, _mm_shuffle_ps(bj, bj, _MM_SHUFFLE(2, 2, 2, 2))));
+			col = _mm_add_ps(col, _mm_mul_ps(a3, _mm_shuffle_ps(bj, bj, _MM_SHUFFLE(3, 3, 3, 3))));
+			cols[j] = col;
+		}
+
+		for (int j = 0; j < 4; ++j)
+			_mm_storeu_ps(out + 4 * j, cols[j]);
+#endif
+	}
+
+	// x * column 0 + y * column 1 + z * column 2 (+ w * column 3), the same order as the scalar versions
+	inline __m128 TransformSimd(const Matrixy4x4& mat, float x, float y, float z)
+	{
+		__m128 out = _mm_mul_ps(_mm_set1_ps(x), _mm_loadu_ps(mat.ma + 0));
+		out = _mm_add_ps(out, _mm_mul_ps(_mm_set1_ps(y), _mm_loadu_ps(mat.ma + 4)));
+		return _mm_add_ps(out, _mm_mul_ps(_mm_set1_ps(z), _mm_loadu_ps(mat.ma + 8)));
+	}
+
+	// Transforms 4 points at once with one register per coordinate (xxxx, yyyy, zzzz)
+	// The matrix's rows are broadcast so each lane does exactly the scalar Transform's sums
+	struct TransformSoA
+	{
+		TransformSoA(const Matrixy4x4& mat, bool translate)
+		{
+			for (int row = 0; row < 3; ++row)
+			{
+				Rows[row][0] = _mm_set1_ps(mat.m[0][row]);
+				Rows[row][1] = _mm_set1_ps(mat.m[1][row]);
+				Rows[row][2] = _mm_set1_ps(mat.m[2][row]);
+				Rows[row][3] = _mm_set1_ps(mat.m[3][row]);
+			}
+			Translate = translate;
+		}
+
+		inline void Transform4(const floaty3* in, floaty3* out) const
+		{
+			__m128 xs = _mm_setr_ps(in[0].x, in[1].x, in[2].x, in[3].x);
+			__m128 ys = _mm_setr_ps(in[0].y, in[1].y, in[2].y, in[3].y);
+			__m128 zs = _mm_setr_ps(in[0].z, in[1].z, in[2].z, in[3].z);
+
+			alignas(16) float results[3][4];
+			for (int row = 0; row < 3; ++row)
+			{
+				__m128 sum = _mm_mul_ps(xs, Rows[row][0]);
+				sum = _mm_add_ps(sum, _mm_mul_ps(ys, Rows[row][1]));
+				sum = _mm_add_ps(sum, _mm_mul_ps(zs, Rows[row][2]));
+				if (Translate)
+					sum = _mm_add_ps(sum, Rows[row][3]);
+				_mm_store_ps(results[row], sum);
+			}
+
+			for (int i = 0; i < 4; ++i)
+				out[i] = floaty3{ results[0][i], results[1][i], results[2][i] };
+		}
+
+		__m128 Rows[3][4];
+		bool Translate;
+	};
+}
+#endif
+
 Matrixy4x4 Matrixy4x4::Multiply(const Matrixy4x4& a, const Matrixy4x4& b)
+{
+#ifdef EC_SIMD_SSE
+	Matrixy4x4 out;
+	MultiplySimd(a.ma, b.ma, out.ma);
+	return out;
+#else
+	return MultiplyScalar(a, b);
+#endif
+}
+
+void Matrixy4x4::MultiplyBatch(const Matrixy4x4& a, const Matrixy4x4* b, Matrixy4x4* out, size_t count)
+{
+#ifdef EC_SIMD_SSE
+	// Copied so writing to out can never change a part way through
+	const Matrixy4x4 left = a;
+	for (size_t i = 0; i < count; ++i)
+		MultiplySimd(left.ma, b[i].ma, out[i].ma);
+#else
+	const Matrixy4x4 left = a;
+	for (size_t i = 0; i < count; ++i)
+		out[i] = MultiplyScalar(left, b[i]);
+#endif
+}
+
+void Matrixy4x4::MultiplyBatch(const Matrixy4x4* a, const Matrixy4x4* b, Matrixy4x4* out, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+#ifdef EC_SIMD_SSE
+		MultiplySimd(a[i].ma, b[i].ma, out[i].ma);
+#else
+		out[i] = MultiplyScalar(a[i], b[i]);
+#endif
+	}
+}
+
+floaty3 Matrixy4x4::Transform(const floaty3& vec, const Matrixy4x4& mat)
+{
+#ifdef EC_SIMD_SSE
+	alignas(16) float out[4];
+	_mm_store_ps(out, _mm_add_ps(TransformSimd(mat, vec.x, vec.y, vec.z), _mm_loadu_ps(mat.ma + 12)));
+	return floaty3{ out[0], out[1], out[2] };
+#else
+	return TransformScalar(vec, mat);
+#endif
+}
+
+floaty4 Matrixy4x4::Transform(const floaty4& vec, const Matrixy4x4& mat)
+{
+#ifdef EC_SIMD_SSE
+	floaty4 out;
+	_mm_storeu_ps(&out.x, _mm_add_ps(TransformSimd(mat, vec.x, vec.y, vec.z), _mm_mul_ps(_mm_set1_ps(vec.w), _mm_loadu_ps(mat.ma + 12))));
+	return out;
+#else
+	return TransformScalar(vec, mat);
+#endif
+}
+
+floaty3 Matrixy4x4::TransformNormal(const floaty3& vec, const Matrixy4x4& mat)
+{
+#ifdef EC_SIMD_SSE
+	alignas(16) float out[4];
+	_mm_store_ps(out, TransformSimd(mat, vec.x, vec.y, vec.z));
+	return floaty3{ out[0], out[1], out[2] };
+#else
+	floaty3 out;
+	out.x = vec.x * mat.m11 + vec.y * mat.m12 + vec.z * mat.m13;
+	out.y = vec.x * mat.m21 + vec.y * mat.m22 + vec.z * mat.m23;
+	out.z = vec.x * mat.m31 + vec.y * mat.m32 + vec.z * mat.m33;
+	return out;
+#endif
+}
+
+void Matrixy4x4::TransformBatch(const Matrixy4x4& mat, const floaty3* in, floaty3* out, size_t count)
+{
+	size_t i = 0;
+#ifdef EC_SIMD_SSE
+	TransformSoA soa{ mat, true };
+	for (; i + 4 <= count; i += 4)
+		soa.Transform4(in + i, out + i);
+#endif
+	for (; i < count; ++i)
+		out[i] = Transform(in[i], mat);
+}
+
+void Matrixy4x4::TransformBatch(const Matrixy4x4& mat, const floaty4* in, floaty4* out, size_t count)
+{
+	// A floaty4 already fills a register, so these go one at a time
+	for (size_t i = 0; i < count; ++i)
+		out[i] = Transform(in[i], mat);
+}
+
+void Matrixy4x4::TransformNormalBatch(const Matrixy4x4& mat, const floaty3* in, floaty3* out, size_t count)
+{
+	size_t i = 0;
+#ifdef EC_SIMD_SSE
+	TransformSoA soa{ mat, false };
+	for (; i + 4 <= count; i += 4)
+		soa.Transform4(in + i, out + i);
+#endif
+	for (; i < count; ++i)
+		out[i] = TransformNormal(in[i], mat);
+}
+
+Matrixy4x4 Matrixy4x4::MultiplyScalar(const Matrixy4x4& a, const Matrixy4x4& b)
 {
 	Matrixy4x4 out;
 
@@ -230,7 +440,7 @@ Matrixy4x4 Matrixy4x4::Multiply(const Matrixy4x4& a, const Matrixy4x4& b)
 	return out;
 }
 
-floaty3 Matrixy4x4::Transform(const floaty3& vec, const Matrixy4x4& mat)
+floaty3 Matrixy4x4::TransformScalar(const floaty3& vec, const Matrixy4x4& mat)
 {
 	floaty3 out;
 	out.x = vec.x * mat.m11 + vec.y * mat.m12 + vec.z * mat.m13 + mat.dx;
@@ -239,7 +449,7 @@ floaty3 Matrixy4x4::Transform(const floaty3& vec, const Matrixy4x4& mat)
 	return out;
 }
 
-floaty4 Matrixy4x4::Transform(const floaty4& vec, const Matrixy4x4& mat)
+floaty4 Matrixy4x4::TransformScalar(const floaty4& vec, const Matrixy4x4& mat)
 {
 	floaty4 out;
 	out.x = vec.x * mat.m11 + vec.y * mat.m12 + vec.z * mat.m13 + vec.w * mat.dx;
@@ -249,15 +459,6 @@ floaty4 Matrixy4x4::Transform(const floaty4& vec, const Matrixy4x4& mat)
 	return out;
 }
 
-floaty3 Matrixy4x4::TransformNormal(const floaty3& vec, const Matrixy4x4& mat)
-{
-	floaty3 out;
-	out.x = vec.x * mat.m11 + vec.y * mat.m12 + vec.z * mat.m13;
-	out.y = vec.x * mat.m21 + vec.y * mat.m22 + vec.z * mat.m23;
-	out.z = vec.x * mat.m31 + vec.y * mat.m32 + vec.z * mat.m33;
-	return out;
-}
-
 Matrixy4x4 Matrixy4x4::RotationAxisR(floaty3 axis, float angle)
 {
 	axis.safenorm();
@@ -492,6 +693,8 @@ Matrixy4x4::operator btTransform() const
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <vector>
+
 using namespace testing;
 
 TEST(MatrixTests, DefaultConstructorIdentity)
@@ -666,5 +869,132 @@ TEST(MatrixTests, ReflectionTest)
 	EXPECT_TRUE(ApproximatelyEqual(vec.z, 0.f));
 }
 
+// A spread of matrices (rotations, translations, a projection and some arbitrary values) for checking the SIMD paths against the scalar ones
+std::vector<Matrixy4x4> MakeTestMatrices()
+{
+	std::vector<Matrixy4x4> out;
+	out.push_back(Matrixy4x4::Identity());
+	out.push_back(Matrixy4x4::PerspectiveFovD(70.f, 16.f / 9.f, 0.1f, 500.f));
+	for (int i = 0; i < 16; ++i)
+	{
+		float f = (float)i;
+		out.push_back(Matrixy4x4::MultiplyE(Matrixy4x4::RotationAxisR({ 1.f, f, -0.5f * f }, 0.37f * f), Matrixy4x4::Translate(f * 3.f, -f, 100.f - f * f)));
+
+		float data[16];
+		for (int j = 0; j < 16; ++j)
+			data[j] = std::sin(f * 16.f + (float)j) * (1.f + f);
+		out.push_back(Matrixy4x4(data));
+	}
+	return out;
+}
+
+std::vector<floaty3> MakeTestPoints()
+{
+	std::vector<floaty3> out;
+	// 27 is not a multiple of 4, so the batches' leftover paths are covered too
+	for (int i = 0; i < 27; ++i)
+	{
+		float f = (float)i;
+		out.push_back(floaty3{ f - 13.f, std::cos(f) * 50.f, 0.125f * f * f });
+	}
+	return out;
+}
+
+void ExpectMatrixEqual(const Matrixy4x4& a, const Matrixy4x4& b)
+{
+	for (int i = 0; i < 16; ++i)
+		EXPECT_FLOAT_EQ(a.ma[i], b.ma[i]) << "at element " << i;
+}
+
+void ExpectFloatyEqual(const floaty3& a, const floaty3& b)
+{
+	EXPECT_FLOAT_EQ(a.x, b.x);
+	EXPECT_FLOAT_EQ(a.y, b.y);
+	EXPECT_FLOAT_EQ(a.z, b.z);
+}
+
+TEST(MatrixTests, MultiplyMatchesScalarTest)
+{
+	auto matrices = MakeTestMatrices();
+	for (auto& a : matrices)
+		for (auto& b : matrices)
+			ExpectMatrixEqual(Matrixy4x4::Multiply(a, b), Matrixy4x4::MultiplyScalar(a, b));
+}
+
+TEST(MatrixTests, MultiplyBatchTest)
+{
+	auto matrices = MakeTestMatrices();
+	auto viewProj = matrices[1];
+
+	std::vector<Matrixy4x4> out(matrices.size());
+	Matrixy4x4::MultiplyBatch(viewProj, matrices.data(), out.data(), matrices.size());
+	for (size_t i = 0; i < matrices.size(); ++i)
+		ExpectMatrixEqual(out[i], Matrixy4x4::Multiply(viewProj, matrices[i]));
+
+	std::vector<Matrixy4x4> reversed{ matrices.rbegin(), matrices.rend() };
+	Matrixy4x4::MultiplyBatch(matrices.data(), reversed.data(), out.data(), matrices.size());
+	for (size_t i = 0; i < matrices.size(); ++i)
+		ExpectMatrixEqual(out[i], Matrixy4x4::Multiply(matrices[i], reversed[i]));
+
+	// In place
+	auto inPlace = matrices;
+	Matrixy4x4::MultiplyBatch(inPlace.data(), reversed.data(), inPlace.data(), inPlace.size());
+	for (size_t i = 0; i < matrices.size(); ++i)
+		ExpectMatrixEqual(inPlace[i], Matrixy4x4::Multiply(matrices[i], reversed[i]));
+}
+
+TEST(MatrixTests, TransformMatchesScalarTest)
+{
+	auto matrices = MakeTestMatrices();
+	auto points = MakeTestPoints();
+	for (auto& mat : matrices)
+	{
+		for (auto& point : points)
+		{
+			ExpectFloatyEqual(Matrixy4x4::Transform(point, mat), Matrixy4x4::TransformScalar(point, mat));
+
+			floaty4 point4{ point, 0.5f };
+			floaty4 simd = Matrixy4x4::Transform(point4, mat), scalar = Matrixy4x4::TransformScalar(point4, mat);
+			EXPECT_FLOAT_EQ(simd.x, scalar.x);
+			EXPECT_FLOAT_EQ(simd.y, scalar.y);
+			EXPECT_FLOAT_EQ(simd.z, scalar.z);
+			EXPECT_FLOAT_EQ(simd.w, scalar.w);
+
+			floaty3 normal = Matrixy4x4::TransformScalar(floaty4{ point, 0.f }, mat).xyz();
+			ExpectFloatyEqual(Matrixy4x4::TransformNormal(point, mat), normal);
+		}
+	}
+}
+
+TEST(MatrixTests, TransformBatchTest)
+{
+	auto matrices = MakeTestMatrices();
+	auto points = MakeTestPoints();
+	std::vector<floaty3> out(points.size());
+	for (auto& mat : matrices)
+	{
+		Matrixy4x4::TransformBatch(mat, points.data(), out.data(), points.size());
+		for (size_t i = 0; i < points.size(); ++i)
+			ExpectFloatyEqual(out[i], Matrixy4x4::Transform(points[i], mat));
+
+		Matrixy4x4::TransformNormalBatch(mat, points.data(), out.data(), points.size());
+		for (size_t i = 0; i < points.size(); ++i)
+			ExpectFloatyEqual(out[i], Matrixy4x4::TransformNormal(points[i], mat));
+
+		std::vector<floaty4> points4, out4(points.size());
+		for (auto& point : points)
+			points4.emplace_back(point, 1.f);
+		Matrixy4x4::TransformBatch(mat, points4.data(), out4.data(), points4.size());
+		for (size_t i = 0; i < points4.size(); ++i)
+			EXPECT_EQ(out4[i], Matrixy4x4::Transform(points4[i], mat));
+
+		// In place
+		auto inPlace = points;
+		Matrixy4x4::TransformBatch(mat, inPlace.data(), inPlace.data(), inPlace.size());
+		for (size_t i = 0; i < points.size(); ++i)
+			ExpectFloatyEqual(inPlace[i], Matrixy4x4::Transform(points[i], mat));
+	}
+}
+
 #endif // CPP_ENGINE_TESTS
 
@@ -5,6 +5,7 @@
 
 #include <assimp/matrix4x4.h>
 
+#include <cstddef>
 #include <cstring>
 
 #pragma warning(push)
@@ -472,6 +473,29 @@ struct Matrixy4x4
 	*/
 	static Matrixy4x4 Multiply(const Matrixy4x4& a, const Matrixy4x4& b);
 
+	/**
+	* \brief Multiplies one matrix with an array of matrices
+	*
+	* Equivalent to out[i] = Multiply(a, b[i]) for every i, out may be the same array as b
+	*
+	* \sa Matrixy4x4::Multiply
+	*/
+	static void MultiplyBatch(const Matrixy4x4& a, const Matrixy4x4* b, Matrixy4x4* out, size_t count);
+
+	/**
+	* \brief Multiplies two arrays of matrices pairwise
+	*
+	* Equivalent to out[i] = Multiply(a[i], b[i]) for every i, out may be the same array as a or b
+	*
+	* \sa Matrixy4x4::Multiply
+	*/
+	static void MultiplyBatch(const Matrixy4x4* a, const Matrixy4x4* b, Matrixy4x4* out, size_t count);
+
+	// The plain float versions of Multiply and Transform, what they do when built without SIMD (and what the SIMD versions are tested against)
+	static Matrixy4x4 MultiplyScalar(const Matrixy4x4& a, const Matrixy4x4& b);
+	static floaty3 TransformScalar(const floaty3& vec, const Matrixy4x4& mat);
+	static floaty4 TransformScalar(const floaty4& vec, const Matrixy4x4& mat);
+
 	/**
 	* \brief Multiplies B with A
 	*
@@ -492,6 +516,11 @@ struct Matrixy4x4
 	inline floaty3 TransformNormal(const floaty3& vec) const { return TransformNormal(vec, *this); }
 	static floaty3 TransformNormal(const floaty3& vec, const Matrixy4x4& mat);
 
+	// Transforms every point/vector in the array, out may be the same array as in
+	static void TransformBatch(const Matrixy4x4& mat, const floaty3* in, floaty3* out, size_t count);
+	static void TransformBatch(const Matrixy4x4& mat, const floaty4* in, floaty4* out, size_t count);
+	static void TransformNormalBatch(const Matrixy4x4& mat, const floaty3* in, floaty3* out, size_t count);
+
 	constexpr static inline Matrixy4x4 Identity()
 	{
 		return
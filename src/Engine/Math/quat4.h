@@ -5,6 +5,7 @@
 #include "floaty.h"
 #include "inty.h"
 
+#include <cstddef>
 #include <ostream>
 
 // A quaternion struct
@@ -43,6 +44,8 @@ struct quat4
 	inline quat4& operator*=(const btQuaternion& other) { return *this = *this * other; }
 
 	floaty3 rotate(const floaty3& dir) const;
+	// Rotates every direction in the array, out may be the same array as in
+	void rotate(const floaty3* in, floaty3* out, size_t count) const;
 	Vector::inty3 rotate(const Vector::inty3& dir) const;
 
 	friend std::ostream& operator<<(std::ostream& os, const quat4& q)
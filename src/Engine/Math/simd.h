@@ -0,0 +1,16 @@
+#pragma once
+
+// Picks which SIMD paths the math code (matrix.cpp, quat4.cpp) is compiled with
+// EC_SIMD_SSE: SSE2, always available on x64
+// EC_SIMD_AVX: AVX, only when the compiler is allowed to use it (/arch:AVX or -mavx)
+// Defining EC_NO_SIMD (the EC_SIMD cmake option) builds the plain scalar versions everywhere instead
+
+#if !defined(EC_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define EC_SIMD_SSE 1
+#include <emmintrin.h>
+#endif
+
+#if defined(EC_SIMD_SSE) && defined(__AVX__)
+#define EC_SIMD_AVX 1
+#include <immintrin.h>
+#endif
@@ -143,22 +143,26 @@ void G1I::BasicGSpace::RequestGeometryCall(const std::vector<Geometry::Vertex>&
 	DebugVersion.push_back(Drawing::DrawCallDebugInfo{ enabled, indices });
 }*/
 
-Debug::DebugReturn G1I::BasicGSpace::Request(Requests::Request& action)
+void G1I::BasicGSpace::RegisterRequests(Requests::RequestRoutes& routes)
 {
-	if (action.Name == "UI" && action.Params.size() && action.Params[0] == "ToggleDebugDrawing")
+	PhysicsSpace::RegisterRequests(routes);
+
+	routes.Add("UI", [this](Requests::Request& action) -> Debug::DebugReturn
 	{
-		DebugDrawing = !DebugDrawing;
-		DINFO("Debug Drawing has been toggled");
-		return true;
-	}
-	else if (action.Name == "ToggleRealDraw")
+		if (action.Params.size() && action.Params[0] == "ToggleDebugDrawing")
+		{
+			DebugDrawing = !DebugDrawing;
+			DINFO("Debug Drawing has been toggled");
+			return true;
+		}
+		return false;
+	});
+	routes.Add("ToggleRealDraw", [this](Requests::Request&) -> Debug::DebugReturn
 	{
 		RealDrawing = !RealDrawing;
 		DINFO("Real Drawing has been toggled");
 		return true;
-	}
-	else
-		return PhysicsSpace::Request(action);
+	});
 }
 
 
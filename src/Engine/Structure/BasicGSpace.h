@@ -101,7 +101,7 @@ namespace G1I
 		using G1I::PhysicsSpace::RemoveRigidBody;
 		using G1I::PhysicsSpace::SimulatePhysics;
 
-		virtual Debug::DebugReturn Request(Requests::Request& action) override;
+		virtual void RegisterRequests(Requests::RequestRoutes& routes) override;
 		inline virtual std::string GetName() const override { return "BasicGSpace"; }
 	};
 #pragma warning(default:4250)
@@ -1049,14 +1049,13 @@ void G1I::ProfilerShape::Restart()
 #endif
 }
 
-Debug::DebugReturn G1I::ProfilerShape::Request(Requests::Request &req)
+void G1I::ProfilerShape::RegisterRequests(Requests::RequestRoutes &routes)
 {
-	if (req.Name == "StartSimpleProfile")
+	routes.Add("StartSimpleProfile", [this](Requests::Request &) -> Debug::DebugReturn
 	{
 		Restart();
 		return true;
-	}
-	return false;
+	});
 }
 
 void G1I::ProfilerShape::ReportProfiling()
@@ -1103,6 +1102,10 @@ void G1I::ProfilerShape::ReportProfiling(double time)
 
 	BigBoiStats::WriteToFile(stats, "profile.txt");
 
+	DINFO("Writing trace to file 'profile.json'");
+
+	Profiling::WriteChromeTrace("profile.json");
+
 	DINFO("-----------End Profiling----------------");
 #endif
 }
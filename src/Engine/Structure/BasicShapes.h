@@ -440,7 +440,7 @@ namespace G1I
 
 		void Restart();
 
-		virtual Debug::DebugReturn Request(Requests::Request &req) override;
+		virtual void RegisterRequests(Requests::RequestRoutes &routes) override;
 
 		inline virtual std::string GetName() const override { return "Profiler McGee"; }
 	protected:
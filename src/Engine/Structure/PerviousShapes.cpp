@@ -2582,7 +2582,8 @@ void Perviousity::Activators::Ender::AfterDraw()
 
 void Perviousity::Activators::Ender::Activate()
 {
-	mResources->Request->Request(Requests::Request{ "EndLevel" });
+	static const Requests::RequestID EndLevelRequest = Requests::Intern("EndLevel");
+	mResources->Request->Request(Requests::Request{ EndLevelRequest });
 }
 
 std::shared_ptr<Perviousity::Shapes::PlatformMaterial> Perviousity::Activators::GetActivatorMaterial()
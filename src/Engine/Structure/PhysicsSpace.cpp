@@ -166,24 +166,16 @@ void G1I::PhysicsSpace::RemoveContactListener(BulletThingo::IContactListener *li
 		}
 }
 
-Debug::DebugReturn G1I::PhysicsSpace::Request(Requests::Request& Action)
+void G1I::PhysicsSpace::RegisterRequests(Requests::RequestRoutes& routes)
 {
-	if (Action.Name == "PausePhysics")
+	auto obsolete = [](Requests::Request&) -> Debug::DebugReturn
 	{
 		DWARNING("Pausing physics has been obsoleted!");
 		return true;
-	}
-	else if (Action.Name == "ResumePhysics")
-	{
-		DWARNING("Pausing physics has been obsoleted!");
-		return true;
-	}
-	else if (Action.Name == "TogglePhysics")
-	{
-		DWARNING("Pausing physics has been obsoleted!");
-		return true;
-	}
-	return false;
+	};
+	routes.Add("PausePhysics", obsolete);
+	routes.Add("ResumePhysics", obsolete);
+	routes.Add("TogglePhysics", obsolete);
 }
 
 void G1I::PhysicsSpace::internalphysicsevent_guy::updateAction(btCollisionWorld * world, btScalar timestep)
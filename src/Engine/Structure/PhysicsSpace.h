@@ -61,6 +61,6 @@ namespace G1I
 		void AddContactListener(BulletThingo::IContactListener *listener) override;
 		void RemoveContactListener(BulletThingo::IContactListener *listener) override;
 
-		Debug::DebugReturn Request(Requests::Request& Action) override;
+		void RegisterRequests(Requests::RequestRoutes& routes) override;
 	};
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "Drawing/GLRen2.h"
 
 #include <filesystem>
+#include <array>
 
 std::vector<floaty3> SkyboxVertices =
 {
@@ -88,6 +89,9 @@ G1I::SkyBoxShape::SkyBoxShape(G1::IShapeThings tings, std::string px_img, std::s
 	if (px && nx && py && ny && pz && nz)
 	{
 		_tex = std::make_shared<Drawing::CubeMapTexture>(px, nx, py, ny, pz, nz);
+
+		// The faces are only kept on the GPU once uploaded
+		_tex->SetReleaseCPUAfterUpload(true);
 	}
 	else
 	{
@@ -1,5 +1,107 @@
 #include "Events.h"
 
+#include "Systems/Input/Input.h"
+#include "Systems/Input/Config1.h"
+#include "PhysicsEvent.h"
+
+Events::EventManager::EventManager() : m_FallTo(nullptr)
+{
+	ResolveAll(TypedEvents{});
+}
+
+template<class E>
+void Events::EventManager::Resolve()
+{
+	auto &resolved = m_Resolved[TypedEventIndex<E>];
+	resolved.Listeners = &Listeners[E::MyType];
+	resolved.GroupListeners = &GroupListeners[GetEventGroup(E::MyType)];
+}
+
+template<class ... Ts>
+void Events::EventManager::ResolveAll(EventTypeList<Ts...>)
+{
+	(Resolve<Ts>(), ...);
+}
+
+void Events::EventManager::DispatchQueued(
+#ifdef EC_PROFILE
+	ProfileMcGee *profiler
+#endif
+)
+{
+	if (m_QueueOrder.empty())
+		return;
+
+#ifdef EC_PROFILE
+	if (profiler)
+		EVENT_PROFILE_PUSH("Queued Events");
+#endif
+	std::swap(m_QueueOrder, m_DispatchOrder);
+	for (auto &queue : m_Queues)
+	{
+		if (queue)
+			queue->Swap();
+	}
+
+	std::array<size_t, TypedEvents::Count> next{};
+	for (size_t i = 0; i < m_DispatchOrder.size(); )
+	{
+		auto index = m_DispatchOrder[i];
+		size_t count = 1;
+		while (i + count < m_DispatchOrder.size() && m_DispatchOrder[i + count] == index)
+			++count;
+
+		m_Queues[index]->Dispatch(*this, next[index], count);
+		next[index] += count;
+		i += count;
+	}
+	m_DispatchOrder.clear();
+#ifdef EC_PROFILE
+	if (profiler)
+		EVENT_PROFILE_POP();
+#endif
+}
+
+void Events::EventManager::DrainPosted()
+{
+	// Taking the whole stack at once means the consumer never races a producer over a single node
+	auto *node = m_Inbox.exchange(nullptr, std::memory_order_acquire);
+	if (!node)
+		return;
+
+	// Newest first, so reverse to dispatch in the order they were posted
+	IPostedEvent *oldest = nullptr;
+	while (node)
+	{
+		auto *next = node->Next;
+		node->Next = oldest;
+		oldest = node;
+		node = next;
+	}
+
+	// Owns whatever hasn't been dispatched yet, so a throwing listener doesn't leak the rest
+	struct PostedChain
+	{
+		IPostedEvent *Head;
+		~PostedChain()
+		{
+			while (Head)
+			{
+				auto *next = Head->Next;
+				delete Head;
+				Head = next;
+			}
+		}
+	} remaining{ oldest };
+
+	while (remaining.Head)
+	{
+		std::unique_ptr<IPostedEvent> posted{ remaining.Head };
+		remaining.Head = posted->Next;
+		posted->Dispatch(*this);
+	}
+}
+
 void Events::EventManager::RemoveWithoutWarning(Events::Event &id, IEventListener *& listener)
 {
 	if (Listeners.find(id) != Listeners.end())
@@ -24,7 +126,7 @@ bool Events::EventManager::Send(IEvent *event
 {
 #ifdef EC_PROFILE
 	if (profiler)
-		EVENT_PROFILE_PUSH("Event: " + Events::EventName(event->Type), __FUNCTION_NAME__, __LINE__);
+		EVENT_PROFILE_PUSH(Events::EventCName(event->Type));
 #endif
 	bool sent = false;
 		
@@ -38,42 +140,26 @@ bool Events::EventManager::Send(IEvent *event
 
 	// Look through Listeners
 	// v
-	if (Listeners.find(event->Type) != Listeners.end())
+	auto it = Listeners.find(event->Type);
+	if (it != Listeners.end() && !it->second.empty())
 	{
 		// Send event to all Listeners, send warning in case a listener returns false (shouldn't happen)
 		// Do a check if the listener actually takes the poo (it will return true)
 		// Although it shouldn't happen that a listener doesn't take an poo that it is mapped to
 		// There's no guarantee
-		Events::Event &id = event->Type;
-		const std::vector<IEventListener*> &ass = Listeners[id];
+		const std::vector<IEventListener*> &ass = it->second;
 		for (auto i = ass.size(); i-- > 0; )
 		{
-#ifdef EC_PROFILE
-			if (profiler)
-				EVENT_PROFILE_PUSH(ass[i]->GetName() + " Receive", __FUNCTION_NAME__, __LINE__);
-#endif 
 			bool good = ass[i]->Receive(event);
 			sent |= good;
 			if (!good)
 			{
 				DERROR("Event Listener found in map which doesn't take correct Event");
 			}
-#ifdef EC_PROFILE
-			if (profiler)
-				EVENT_PROFILE_POP();
-#endif
 		}
 		for (auto i = ass.size(); i-- > 0; )
 		{
-#ifdef EC_PROFILE
-			if (profiler)
-				EVENT_PROFILE_PUSH(ass[i]->GetName() + " PostReceive", __FUNCTION_NAME__, __LINE__);
-#endif
 			ass[i]->PostReceive(event);
-#ifdef EC_PROFILE
-			if (profiler)
-				EVENT_PROFILE_POP();
-#endif
 		}
 	}
 	else // Not contained in Listeners, check the m_FallTo pointer, so far never used, although I'll probably forget to change this
@@ -314,6 +400,15 @@ void Events::EventManager::Remove(UINT count, IGroupListener * listeners[])
 
 Events::EventManager::~EventManager()
 {
+	// Anything posted but never drained is dropped
+	auto *posted = m_Inbox.exchange(nullptr, std::memory_order_acquire);
+	while (posted)
+	{
+		auto *next = posted->Next;
+		delete posted;
+		posted = next;
+	}
+
 	// Remove all listeners
 	for (auto& listens : Listeners)
 	{
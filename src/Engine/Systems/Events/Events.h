@@ -13,6 +13,9 @@
 #include <map>
 #include <unordered_map>
 #include <type_traits>
+#include <memory>
+#include <cstdint>
+#include <atomic>
 
 #ifdef EC_PROFILE
 #ifdef _DEBUG
@@ -77,7 +80,7 @@ namespace Events
 		return EventsVec[index];
 	}
 
-	inline Stringy EventName(const Event& e)
+	inline constexpr const char *EventCName(const Event& e)
 	{
 		switch (e)
 		{
@@ -119,6 +122,11 @@ namespace Events
 		}
 	}
 
+	inline Stringy EventName(const Event& e)
+	{
+		return EventCName(e);
+	}
+
 	inline Stringy GroupName(const EventGroup& e)
 	{
 		switch (e)
@@ -173,6 +181,11 @@ namespace Events
 		return e + "Event";
 	}
 
+	inline const char *EventCName(const Event& e)
+	{
+		return e.c_str();
+	}
+
 	inline Stringy GroupName(const EventGroup& e)
 	{
 		return e;
@@ -215,8 +228,120 @@ namespace Events
 		static constexpr bool value = gotem<std::is_same<T, Ts>::value...>::value;
 	};
 
+	template<class ... Ts>
+	struct EventTypeList
+	{
+		static constexpr size_t Count = sizeof...(Ts);
+	};
+
+	template<class E, class List>
+	struct EventTypeIndex;
+
+	template<class E, class ... Ts>
+	struct EventTypeIndex<E, EventTypeList<E, Ts...>>
+	{
+		static constexpr size_t value = 0;
+	};
+
+	template<class E, class T, class ... Ts>
+	struct EventTypeIndex<E, EventTypeList<T, Ts...>>
+	{
+		static constexpr size_t value = 1 + EventTypeIndex<E, EventTypeList<Ts...>>::value;
+	};
+
+	// Every event type that can be sent as itself (rather than as an IEvent), each gets its own listener table and queue in an EventManager
+	using TypedEvents = EventTypeList<::Event::KeyInput, ::Event::MouseMove, ::Event::MouseWheel, ::Event::MouseButton, ::Event::MouseWheelButton, ::Event::ResizeEvent, ::Event::ResizePreEvent, ::Event::ReleaseGraphicsEvent, ::Event::CreateGraphicsEvent, ::Event::DpiChangeEvent, ::Event::WindowFocusEvent, ::Event::BeforePhysicsEvent, ::Event::InternalPhysicsEvent, ::Event::AfterPhysicsEvent, ::Event::FontSizeEvent, ::Event::MarginChangeEvent>;
+
+	template<class E>
+	constexpr size_t TypedEventIndex = EventTypeIndex<E, TypedEvents>::value;
+
+	template<class E, class List>
+	struct EventTypeContains : std::false_type {};
+
+	template<class E, class ... Ts>
+	struct EventTypeContains<E, EventTypeList<Ts...>> : std::bool_constant<(std::is_same_v<E, Ts> || ...)> {};
+
+	template<class E>
+	constexpr bool IsTypedEvent = EventTypeContains<E, TypedEvents>::value;
+
 	class EventManager
 	{
+		// The listeners of one typed event, pointing into Listeners and GroupListeners (whose entries are never erased so never move)
+		struct ResolvedListeners
+		{
+			std::vector<IEventListener*> *Listeners = nullptr;
+			std::vector<IGroupListener*> *GroupListeners = nullptr;
+		};
+
+		struct IQueuedEvents
+		{
+			virtual ~IQueuedEvents() {}
+			virtual void Swap() = 0; // Moves the pending events to be dispatched, so events queued while dispatching wait for the next dispatch
+			virtual void Dispatch(EventManager &manager, size_t first, size_t count) = 0;
+		};
+
+		template<class E>
+		struct QueuedEvents : IQueuedEvents
+		{
+			std::vector<E> Pending;
+			std::vector<E> Dispatching;
+
+			inline void Swap() override
+			{
+				Dispatching.clear();
+				std::swap(Pending, Dispatching);
+			}
+
+			inline void Dispatch(EventManager &manager, size_t first, size_t count) override
+			{
+				for (size_t i = first; i < first + count; ++i)
+					manager.Dispatch(&Dispatching[i]);
+			}
+		};
+
+		// An event posted from another thread, linked into the inbox
+		struct IPostedEvent
+		{
+			IPostedEvent *Next = nullptr;
+			virtual ~IPostedEvent() {}
+			virtual void Dispatch(EventManager &manager) = 0;
+		};
+
+		template<class E>
+		struct PostedEvent : IPostedEvent
+		{
+			E Posted;
+
+			PostedEvent(E e) : Posted(std::move(e)) {}
+
+			inline void Dispatch(EventManager &manager) override
+			{
+				if constexpr (IsTypedEvent<E>)
+					manager.Dispatch(&Posted);
+				else
+					manager.Send(&Posted);
+			}
+		};
+
+		std::array<ResolvedListeners, TypedEvents::Count> m_Resolved;
+
+		// Lock-free stack of events posted from any thread, newest first, taken whole by DrainPosted
+		std::atomic<IPostedEvent*> m_Inbox{ nullptr };
+
+		// One contiguous buffer per event type, and the order types were queued in (so runs of one type are dispatched together without reordering anything)
+		std::array<std::unique_ptr<IQueuedEvents>, TypedEvents::Count> m_Queues;
+		std::vector<uint8_t> m_QueueOrder;
+		std::vector<uint8_t> m_DispatchOrder;
+
+		template<class E>
+		void Resolve();
+		template<class ... Ts>
+		void ResolveAll(EventTypeList<Ts...>);
+
+		// Delivers a typed event to its resolved listeners, without any lookups
+		template<class E>
+		bool Dispatch(E *e);
+
 	protected:
 		// Whether the window is focused right now
 		// When not focused default behaviour mutes any input based events
@@ -233,7 +358,7 @@ namespace Events
 
 		void RemoveWithoutWarning(Event &id, IEventListener *&listener);
 	public:
-		EventManager() : m_FallTo(nullptr) {};
+		EventManager();
 		virtual ~EventManager();
 
 		//bool Send(IEvent *event);
@@ -251,6 +376,29 @@ namespace Events
 		bool Send(IEvent *event);
 #endif
 
+		/// <summary> Copies a typed event to be sent by the next DispatchQueued, instead of straight away </summary>
+		/// Consecutive events of a type with an EventCoalescer are merged into one
+		template<class E>
+		void Queue(const E &e);
+
+		/// <summary> Sends every queued event, in the order they were queued, a run of one type at a time </summary>
+		/// Events queued by listeners during this are left for the next call
+#ifdef EC_PROFILE
+		void DispatchQueued(ProfileMcGee *profiler = nullptr);
+#else
+		void DispatchQueued();
+#endif
+		inline bool HasQueued() const { return !m_QueueOrder.empty(); }
+
+		/// <summary> Hands an event to the main thread, safe to call from any thread (the only call on an EventManager that is) </summary>
+		/// The event is sent to the usual listeners by the next DrainPosted, events from one thread arrive in the order they were posted.
+		/// Typed events go through the typed listener tables, any other IEvent is sent as an IEvent
+		template<class E>
+		void Post(E e);
+
+		/// <summary> Sends every event posted since the last call, oldest first. Main thread only </summary>
+		void DrainPosted();
+
 		// Note: no checks for duplicates in the Add functions
 		void Add(IEventListener *listener);
 		void Add(Event &id, IEventListener *listener);
@@ -294,8 +442,19 @@ namespace Events
 	{
 #ifdef EC_PROFILE
 		if (profiler)
-			EVENT_PROFILE_PUSH("Event: " + Events::EventName(e->Type));
+			EVENT_PROFILE_PUSH(Events::EventCName(E::MyType));
 #endif
+		bool sent = Dispatch(e);
+#ifdef EC_PROFILE
+		if (profiler)
+			EVENT_PROFILE_POP();
+#endif
+		return sent;
+	}
+
+	template<class E>
+	inline bool EventManager::Dispatch(E * e)
+	{
 		bool sent = false;
 
 		if constexpr (std::is_same_v<E, ::Event::WindowFocusEvent>)
@@ -309,39 +468,23 @@ namespace Events
 				return false;
 		}
 
-#ifdef EC_PROFILE
-		if (profiler)
-			EVENT_PROFILE_PUSH("Event " + Events::EventName(e->Type) + " Group Listeners");
-#endif
-		for (auto& glisten : GroupListeners[group])
+		auto &resolved = m_Resolved[TypedEventIndex<E>];
+		for (auto& glisten : *resolved.GroupListeners)
 		{
 			sent |= glisten->Receive(e);
 		}
-#ifdef EC_PROFILE
-		if (profiler)
-			EVENT_PROFILE_POP();
-#endif
 		
 		// Look through Listeners
 		// v
-#ifdef EC_PROFILE
-		if (profiler)
-			EVENT_PROFILE_PUSH("EventListeners");
-#endif
-		auto it = Listeners.find(E::MyType);
-		if (it != Listeners.end())
+		const std::vector<IEventListener*> &ass = *resolved.Listeners;
+		if (!ass.empty())
 		{
 			// Send event to all Listeners, send warning in case a listener returns false (shouldn't happen)
 			// Do a check if the listener actually takes the poo (it will return true)
 			// Although it shouldn't happen that a listener doesn't take an poo that it is mapped to
 			// There's no guarantee
-			const std::vector<IEventListener*> &ass = (*it).second;
 			for (auto i = ass.size(); i-- > 0; )
 			{
-#ifdef EC_PROFILE
-				if (profiler)
-					EVENT_PROFILE_PUSH(ass[i]->GetName() + " Receive");
-#endif
 				bool good = ass[i]->Receive(e);
 				sent |= good;
 				if constexpr (group != Events::InputGroup)
@@ -351,37 +494,52 @@ namespace Events
 						DERROR("Event Listener found in map which doesn't take correct Event");
 					}
 				}
-#ifdef EC_PROFILE
-				if (profiler)
-					EVENT_PROFILE_POP();
-#endif
 			}
 			for (auto i = ass.size(); i-- > 0; )
 			{
-#ifdef EC_PROFILE
-				if (profiler)
-					EVENT_PROFILE_PUSH(ass[i]->GetName() + " PostReceive");
-#endif
 				ass[i]->PostReceive(e);
-#ifdef EC_PROFILE
-				if (profiler)
-					EVENT_PROFILE_POP();
-#endif
 			}
 		}
-		else // Not contained in Listeners, check the m_FallTo pointer
+		else // No Listeners, check the m_FallTo pointer
 		{
 			if (m_FallTo)
 				sent = m_FallTo->Send(e);
 		}
-#ifdef EC_PROFILE
-		if (profiler)
+		return sent;
+	}
+
+	template<class E>
+	inline void EventManager::Queue(const E & e)
+	{
+		constexpr auto index = TypedEventIndex<E>;
+		auto &queue = m_Queues[index];
+		if (!queue)
+			queue = std::make_unique<QueuedEvents<E>>();
+		auto &pending = static_cast<QueuedEvents<E>&>(*queue).Pending;
+
+		if constexpr (EventCoalescer<E>::Enabled)
+		{
+			if (!m_QueueOrder.empty() && m_QueueOrder.back() == (uint8_t)index && !pending.empty())
+			{
+				EventCoalescer<E>::Merge(pending.back(), e);
+				return;
+			}
+		}
+
+		pending.push_back(e);
+		m_QueueOrder.push_back((uint8_t)index);
+	}
+
+	template<class E>
+	inline void EventManager::Post(E e)
+	{
+		static_assert(std::is_base_of_v<IEvent, E>, "Only events can be posted");
+
+		IPostedEvent *node = new PostedEvent<E>(std::move(e));
+		node->Next = m_Inbox.load(std::memory_order_relaxed);
+		while (!m_Inbox.compare_exchange_weak(node->Next, node, std::memory_order_release, std::memory_order_relaxed))
 		{
-			EVENT_PROFILE_POP();
-			EVENT_PROFILE_POP();
 		}
-#endif
-		return sent;
 	}
 
 	template<std::size_t size>
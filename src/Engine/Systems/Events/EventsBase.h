@@ -203,6 +203,14 @@ namespace Events
 	template<Event... args>
 	constexpr std::array<Event, sizeof...(args)> nukem_dukem{ args... };
 
+	/// <summary> Specialise to merge runs of the same queued event type (see EventManager::Queue) into one event </summary>
+	/// Merge(into, next) folds next into the previously queued event, leaving into as the single event that gets dispatched
+	template<class E>
+	struct EventCoalescer
+	{
+		static constexpr bool Enabled = false;
+	};
+
 	template<Event... args>
 	struct IEventListenerT : public IEventListener
 	{
@@ -43,7 +43,7 @@ void Engine::IEngine::OnDpiChanged()
 	// Not done yet (check 'removed unused code' commit for old content)
 }
 
-Engine::IWindowEngine::IWindowEngine() : Win("", "Config/windowconfig.xml", SDL_WINDOW_OPENGL | SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE), UIC(this), Ren(&Resources), Config(Config::GetDefaultConfigThrone())
+Engine::IWindowEngine::IWindowEngine(Uint32 windowFlags) : Win("", "Config/windowconfig.xml", windowFlags), UIC(this), Ren(&Resources), Config(Config::GetDefaultConfigThrone())
 {
 	Resources.Ren2 = &Ren;
 	Resources.Ren3 = &Ren;
@@ -104,6 +104,18 @@ void Engine::IWindowEngine::OnDeMaximize()
 	Win.Maximized = false;
 }
 
+void Engine::IWindowEngine::Present()
+{
+	if (Stats.IsGraphVisible())
+	{
+		constexpr float GraphMargin = 10.f, GraphWidth = 600.f, GraphHeight = 120.f;
+		auto left = std::max(GraphMargin, (float)Win.Width - GraphWidth - GraphMargin);
+		Stats.DrawGraph(Ren, PointRect{ left, GraphMargin, (float)Win.Width - GraphMargin, GraphMargin + GraphHeight });
+	}
+
+	Ren.Present(Win.Get());
+}
+
 void Engine::IWindowEngine::PreUpdate()
 {
 	if (Window_Focused)
@@ -2,6 +2,7 @@
 
 #include "Helpers/DebugHelper.h"
 #include "Helpers/TransferHelper.h"
+#include "Helpers/TraceHelper.h"
 #ifdef EC_PROFILE
 #include "Helpers/ProfileHelper.h"
 #endif
@@ -14,6 +15,7 @@
 #include "Systems/Input/Config1.h"
 #include "Systems/Events/Events.h"
 #include "Systems/Timer/Timer.h"
+#include "Systems/Timer/FrameStats.h"
 #include "Systems/Time/Time.h"
 
 #include "Drawing/GLRen.h"
@@ -26,15 +28,15 @@
 
 #ifdef EC_PROFILE
 #	ifdef _DEBUG
-#		define ENGINE_PROFILE_PUSH(x) Resources.Profile->Push(x, __FUNCTION_NAME__, __LINE__)
-#		define ENGINE_PROFILE_POP() Resources.Profile->Pop(__FUNCTION_NAME__, __LINE__)
+#		define ENGINE_PROFILE_PUSH(x) (Resources.Profile->Push(x, __FUNCTION_NAME__, __LINE__), TRACE_PUSH(x))
+#		define ENGINE_PROFILE_POP() (Resources.Profile->Pop(__FUNCTION_NAME__, __LINE__), TRACE_POP())
 #	else
-#		define ENGINE_PROFILE_PUSH(x) Resources.Profile->Push(x)
-#		define ENGINE_PROFILE_POP() Resources.Profile->Pop()
+#		define ENGINE_PROFILE_PUSH(x) (Resources.Profile->Push(x), TRACE_PUSH(x))
+#		define ENGINE_PROFILE_POP() (Resources.Profile->Pop(), TRACE_POP())
 #	endif
 #else
-#	define ENGINE_PROFILE_PUSH(x)
-#	define ENGINE_PROFILE_POP() 
+#	define ENGINE_PROFILE_PUSH(x) TRACE_PUSH(x)
+#	define ENGINE_PROFILE_POP() TRACE_POP()
 #endif
 
 namespace Engine
@@ -45,7 +47,7 @@ namespace Engine
 	///   - BeforeDraw
 	///   - Draw - D3D First, D2D Last (not forced)
 	///   - AfterDraw
-	///   - Present (Not an actual method, but the Swapchain->Present(1, 0))
+	///   - Present
 	struct IEngine : public Events::EventManager
 	{
 		IEngine();
@@ -57,28 +59,44 @@ namespace Engine
 		virtual void BeforeDraw()	= 0;
 		virtual void Draw()			= 0;
 		virtual void AfterDraw()	= 0;
+		virtual void Present()		{}
 		void ApplyScene();
 		
 		void Run()
 		{
 			++CurrentUpdateID;
+			auto updateBegin = Profiling::Now();
 			ENGINE_PROFILE_PUSH("PreUpdate");
 			PreUpdate();
 			ENGINE_PROFILE_POP();
+			ENGINE_PROFILE_PUSH("Events");
+			DrainPosted(); // Events posted by worker threads
+			DispatchQueued(); // Input queued while polling since the last frame
+			ENGINE_PROFILE_POP();
 			ENGINE_PROFILE_PUSH("BeforeDraw");
 			BeforeDraw();
 			ENGINE_PROFILE_POP();
+			auto drawBegin = Profiling::Now();
 			ENGINE_PROFILE_PUSH("Draw");
 			Draw();
 			ENGINE_PROFILE_POP();
 			ENGINE_PROFILE_PUSH("AfterDraw");
 			AfterDraw();
 			ENGINE_PROFILE_POP();
+			auto presentBegin = Profiling::Now();
+			ENGINE_PROFILE_PUSH("Present");
+			Present();
+			ENGINE_PROFILE_POP();
+			auto presentEnd = Profiling::Now();
 			ENGINE_PROFILE_PUSH("ApplyScene");
 			ApplyScene();
 			ENGINE_PROFILE_POP();
 			timmy.Tick();
 			Delta = timmy.DeltaTime();
+			Stats.Record(FramePhase::Update, (double)(drawBegin - updateBegin) * 1e-9);
+			Stats.Record(FramePhase::Draw, (double)(presentBegin - drawBegin) * 1e-9);
+			Stats.Record(FramePhase::Present, (double)(presentEnd - presentBegin) * 1e-9);
+			Stats.EndFrame(Delta);
 			Time.SetNextDeltaTime((Time::TimeType)Delta);
 			//DINFO("Frame time: " + std::to_wstring(timmy.DeltaTime() * 1000.f) + L"ms");
 		}
@@ -96,6 +114,7 @@ namespace Engine
 		Stringy WorkingDir;
 		GameTimer timmy;
 		double Delta;
+		FrameStats Stats;
 		Time::Time Time;
 		double TargetUpdateInterval;
 		CommonResources Resources;
@@ -118,13 +137,18 @@ namespace Engine
 
 	struct IWindowEngine : IEngine
 	{
-		IWindowEngine();
+		static constexpr Uint32 DefaultWindowFlags = SDL_WINDOW_OPENGL | SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE;
+
+		IWindowEngine(Uint32 windowFlags = DefaultWindowFlags);
 		virtual ~IWindowEngine() noexcept { CurrentScene = nullptr; }
 
 		virtual void OnResize(int width, int height) override;
 		virtual void OnMinimize() override;
 		virtual void OnMaximize() override;
 		virtual void OnDeMaximize() override;
+
+		// Draws the frame time graph (if it's shown) then swaps
+		virtual void Present() override;
 				
 	protected:
 		void PreUpdate() override;
@@ -12,6 +12,7 @@
 #include "Importer.h"
 
 #include "Drawing/Graphics1.h"
+#include "Drawing/GlyphAtlas.h"
 
 #include "Systems/Thing.h"
 
@@ -177,6 +178,8 @@ bool Config1::UIConfig::Receive(Events::IEvent *event)
 		DoFontSizes();
 		ResizeFonts(1.f);
 		NotifyFontSizeChange();
+		// Text has been laid out again at the new sizes, so atlases for the old sizes are no longer used
+		Drawing::GlyphAtlas::ReleaseUnused();
 		return Events::RelevantEvent;
 	}
 	else if (auto *sassy = Events::ConvertEvent<Event::ReleaseGraphicsEvent>(event))
@@ -207,6 +210,7 @@ SDLW::Font *Config1::UIConfig::RegisterNewTextFormat(const Stringy& Name, SDLW::
 		{
 			DINFO("Overwriting existing brush...");
 			it->second = SDLW::Font(fd);
+			Drawing::GlyphAtlas::ReleaseUnused();
 			return &it->second;
 		}
 	}
@@ -205,6 +205,29 @@ namespace Event
 	};
 }
 
+namespace Events
+{
+	// Bursts of mouse motion only need to be seen once per frame, at the latest position
+	template<>
+	struct EventCoalescer<::Event::MouseMove>
+	{
+		static constexpr bool Enabled = true;
+		static inline void Merge(::Event::MouseMove &into, const ::Event::MouseMove &next) { into = next; }
+	};
+
+	template<>
+	struct EventCoalescer<::Event::MouseWheel>
+	{
+		static constexpr bool Enabled = true;
+		static inline void Merge(::Event::MouseWheel &into, const ::Event::MouseWheel &next)
+		{
+			auto scrollage = into.Scrollage + next.Scrollage;
+			into = next;
+			into.Scrollage = scrollage;
+		}
+	};
+}
+
 namespace Input
 {
 	struct KeyTimeListener : public Events::IEventListener
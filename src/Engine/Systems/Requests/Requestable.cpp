@@ -1,6 +1,68 @@
 #include "Requestable.h"
 #include "Requester.h"
 
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+
+namespace
+{
+	// Read-mostly, names are interned once (usually at startup) then only looked up
+	struct InternTable
+	{
+		std::shared_mutex Lock;
+		std::unordered_map<Stringy, Requests::RequestID> IDs;
+		std::deque<Stringy> Names{ Stringy() }; // A deque so references handed out by GetRequestName survive more names being interned, index 0 is InvalidRequestID
+	};
+
+	InternTable &GetInternTable()
+	{
+		static InternTable table;
+		return table;
+	}
+}
+
+Requests::RequestID Requests::Intern(const Stringy &name)
+{
+	auto &table = GetInternTable();
+	{
+		std::shared_lock<std::shared_mutex> lock(table.Lock);
+		auto it = table.IDs.find(name);
+		if (it != table.IDs.end())
+			return it->second;
+	}
+
+	std::unique_lock<std::shared_mutex> lock(table.Lock);
+	// Someone else may have interned it between the locks
+	auto it = table.IDs.find(name);
+	if (it != table.IDs.end())
+		return it->second;
+
+	auto id = (RequestID)table.Names.size();
+	table.Names.push_back(name);
+	table.IDs.emplace(name, id);
+	return id;
+}
+
+const Stringy &Requests::GetRequestName(RequestID id)
+{
+	auto &table = GetInternTable();
+	std::shared_lock<std::shared_mutex> lock(table.Lock);
+	if (id >= table.Names.size())
+		return table.Names.front();
+	return table.Names[id];
+}
+
+void Requests::RequestRoutes::Add(RequestID id, RequestHandler handler)
+{
+	_requester.Routes[id].push_back(Requester::Route{ _owner, std::move(handler), ++_requester.LastRouteSerial });
+}
+
+void Requests::RequestRoutes::AddFallback()
+{
+	_requester.Fallbacks.push_back(_owner);
+}
+
 Requests::IRequestable::~IRequestable()
 {
 	if (master)
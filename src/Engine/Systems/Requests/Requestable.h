@@ -4,52 +4,147 @@
 
 #include <string>
 #include <vector>
+#include <array>
 #include <unordered_map>
 #include <functional>
+#include <initializer_list>
+#include <cstdint>
 
 struct CommonResources;
 
 namespace Requests
 {
 	class Requester;
+	struct IRequestable;
+
+	// Request names are interned once into these, so routing a request is a single integer hash lookup
+	using RequestID = uint32_t;
+	constexpr RequestID InvalidRequestID = 0;
+
+	// Returns the ID of a request name, interning it the first time it is seen (thread safe)
+	// Looking up a name still hashes it, code that sends a request often should intern it once into a static RequestID
+	RequestID Intern(const Stringy &name);
+	// The name a RequestID was interned from, or an empty string if it wasn't
+	const Stringy &GetRequestName(RequestID id);
 
 	struct IRequestData
 	{
 		virtual ~IRequestData() {}
 	};
 
+	/// <summary>
+	/// A request's parameters, the first InlineCount are stored in place so most requests never allocate for them
+	/// </summary>
+	/// <remarks>
+	/// Behaves like a read only span of Stringy (size, operator[], begin/end) once built.
+	/// Going past InlineCount moves every parameter into a vector so they stay contiguous.
+	/// </remarks>
+	class RequestParams
+	{
+	public:
+		static constexpr size_t InlineCount = 2;
+
+	private:
+		std::array<Stringy, InlineCount> _inline;
+		std::vector<Stringy> _overflow;
+		size_t _size = 0;
+
+	public:
+		RequestParams() = default;
+		RequestParams(std::initializer_list<Stringy> params) { for (auto &param : params) push_back(param); }
+		RequestParams(std::vector<Stringy> params)
+		{
+			if (params.size() > InlineCount)
+			{
+				_overflow = std::move(params);
+				_size = _overflow.size();
+			}
+			else
+				for (auto &param : params)
+					push_back(std::move(param));
+		}
+
+		void push_back(Stringy param)
+		{
+			if (_overflow.empty() && _size < InlineCount)
+			{
+				_inline[_size++] = std::move(param);
+				return;
+			}
+			if (_overflow.empty())
+			{
+				_overflow.reserve(InlineCount * 2);
+				for (size_t i = 0; i < _size; ++i)
+					_overflow.push_back(std::move(_inline[i]));
+			}
+			_overflow.push_back(std::move(param));
+			_size = _overflow.size();
+		}
+
+		inline const Stringy *data() const { return _overflow.empty() ? _inline.data() : _overflow.data(); }
+		inline size_t size() const { return _size; }
+		inline bool empty() const { return !_size; }
+		inline const Stringy &operator[](size_t i) const { return data()[i]; }
+		inline const Stringy *begin() const { return data(); }
+		inline const Stringy *end() const { return data() + _size; }
+	};
+
 	struct Request
 	{
-		Stringy Name;
-		std::vector<Stringy> Params;
+		RequestID ID;
+		RequestParams Params;
 		Requests::IRequestData *Data = nullptr;
 		CommonResources *Resources = nullptr;
 
-		Request(Stringy e) : Name(e) {}
-		Request(Stringy e, std::vector<Stringy> params, Requests::IRequestData *data = nullptr, CommonResources *resources = nullptr) : Name(e), Params(std::move(params)), Data(data), Resources(resources) {}
-		Request(Stringy e, std::vector<Stringy> params, CommonResources *resources) : Name(e), Params(params), Resources(resources) {}
-		Request(Stringy e, CommonResources *resources) : Name(e), Resources(resources) {}
+		Request(const Stringy &e) : ID(Intern(e)) {}
+		Request(const Stringy &e, RequestParams params, Requests::IRequestData *data = nullptr, CommonResources *resources = nullptr) : ID(Intern(e)), Params(std::move(params)), Data(data), Resources(resources) {}
+		Request(const Stringy &e, RequestParams params, CommonResources *resources) : ID(Intern(e)), Params(std::move(params)), Resources(resources) {}
+		Request(const Stringy &e, CommonResources *resources) : ID(Intern(e)), Resources(resources) {}
+		// For callers that interned their request name up front
+		Request(RequestID id, RequestParams params = {}, Requests::IRequestData *data = nullptr, CommonResources *resources = nullptr) : ID(id), Params(std::move(params)), Data(data), Resources(resources) {}
+
+		inline const Stringy &GetName() const { return GetRequestName(ID); }
 	};
 
 	// Request that can be sent to multiple Receivers
 	struct MultiRequest
 	{
-		Stringy Name;
-		std::vector<Stringy> Params;
+		RequestID ID;
+		RequestParams Params;
 		Requests::IRequestData *Data = nullptr;
 		CommonResources *Resources = nullptr;
 
-		MultiRequest(Stringy e) : Name(e) {}
-		MultiRequest(Stringy e, std::vector<Stringy> params, Requests::IRequestData *data = nullptr, CommonResources *resources = nullptr) : Name(e), Params(std::move(params)), Data(data), Resources(resources) {}
-		MultiRequest(Stringy e, std::vector<Stringy> params, CommonResources *resources) : Name(e), Params(params), Resources(resources) {}
-		MultiRequest(Stringy e, CommonResources *resources) : Name(e), Resources(resources) {}
+		MultiRequest(const Stringy &e) : ID(Intern(e)) {}
+		MultiRequest(const Stringy &e, RequestParams params, Requests::IRequestData *data = nullptr, CommonResources *resources = nullptr) : ID(Intern(e)), Params(std::move(params)), Data(data), Resources(resources) {}
+		MultiRequest(const Stringy &e, RequestParams params, CommonResources *resources) : ID(Intern(e)), Params(std::move(params)), Resources(resources) {}
+		MultiRequest(const Stringy &e, CommonResources *resources) : ID(Intern(e)), Resources(resources) {}
+
+		inline const Stringy &GetName() const { return GetRequestName(ID); }
 
 		inline operator Request() const
 		{
-			return Request(Name, Params, Data, Resources);
+			return Request(ID, Params, Data, Resources);
 		}
 	};
 
+	using RequestHandler = std::function<Debug::DebugReturn(Request &)>;
+
+	// Given to IRequestable::RegisterRequests when a requestable is added, binds the request names it handles to handlers
+	class RequestRoutes
+	{
+		friend class Requester;
+
+		Requester &_requester;
+		IRequestable *_owner;
+
+		RequestRoutes(Requester &requester, IRequestable *owner) : _requester(requester), _owner(owner) {}
+	public:
+		void Add(RequestID id, RequestHandler handler);
+		inline void Add(const Stringy &name, RequestHandler handler) { Add(Intern(name), std::move(handler)); }
+
+		// Offers every request without a route to the owner's Request method, for requestables that can't list what they handle
+		void AddFallback();
+	};
 
 	struct IRequestable
 	{
@@ -59,9 +154,11 @@ namespace Requests
 	protected:
 		inline std::add_cv<Requester*>::type GetMaster() const { return master; }
 	public:
-		virtual Debug::DebugReturn Request(Request& req) = 0;
+		// Called once by Requester::Add, registers a handler for each request this handles (by default everything goes through Request)
+		virtual void RegisterRequests(RequestRoutes &routes) { routes.AddFallback(); }
+		virtual Debug::DebugReturn Request(Request& req) { (void)req; return false; }
 		virtual Stringy GetName() const = 0;
 
 		virtual ~IRequestable();
 	};
-}
\ No newline at end of file
+}
@@ -1,9 +1,31 @@
 #include "Requester.h"
 
-Debug::DebugReturn Requests::Requester::Request(Requests::Request req)
+#include <algorithm>
+
+void Requests::Requester::Add(IRequestable *a)
+{
+	if (!a)
+		return;
+
+	a->master = this;
+	RequestRoutes routes{ *this, a };
+	a->RegisterRequests(routes);
+}
+
+void Requests::Requester::Remove(IRequestable *a)
+{
+	for (auto &pair : Routes)
+	{
+		auto &routes = pair.second;
+		routes.erase(std::remove_if(routes.begin(), routes.end(), [a](const Route &route) { return route.Owner == a; }), routes.end());
+	}
+	Fallbacks.erase(std::remove(Fallbacks.begin(), Fallbacks.end(), a), Fallbacks.end());
+}
+
+Stringy Requests::Requester::DescribeParams(const RequestParams &params)
 {
 	Stringy Parameters;
-	for (auto& param : req.Params)
+	for (auto& param : params)
 	{
 		Parameters += param + ", ";
 	}
@@ -12,29 +34,62 @@ Debug::DebugReturn Requests::Requester::Request(Requests::Request req)
 		Parameters.pop_back();
 		Parameters.pop_back();
 	}
-	DINFO("Requesting '" + req.Name + "' with parameters of '" + Parameters + "'");
-	for (size_t i = Requestables.size(); i-- > 0; )
+	return Parameters;
+}
+
+Debug::DebugReturn Requests::Requester::Request(Requests::Request req)
+{
+	// Handlers may add or remove requestables while they run, which can rehash Routes and move routes around,
+	// so the routes are looked up again before each handler, and the next one asked is the newest route older than the last one asked.
+	// Routes added meanwhile are newer so never asked, removed ones are simply gone
+	uint64_t olderThan = UINT64_MAX;
+	for (;;)
 	{
-		auto *requestable = Requestables[i];
-		if (!requestable)
+		auto it = Routes.find(req.ID);
+		if (it == Routes.end())
+			break;
+
+		auto &routes = it->second;
+		auto next = std::lower_bound(routes.begin(), routes.end(), olderThan, [](const Route &route, uint64_t serial) { return route.Serial < serial; });
+		if (next == routes.begin())
+			break;
+
+		auto route = *--next;
+		olderThan = route.Serial;
+		auto out = route.Handler(req);
+		if (out)
+			return true;
+		else if (out.HasErrors())
 		{
-			DWARNING("Null requestable found");
-			continue;
+			DINFO("Requestable '" + route.Owner->GetName() + "' attempted to resolve '" + req.GetName() + "' (request was aborted) and failed with error: " + out.AsString());
+			return out;
 		}
+	}
+
+	// Fallbacks are rare, asked from a copy and skipped if an earlier one removed them
+	auto fallbacks = Fallbacks;
+	for (size_t i = fallbacks.size(); i-- > 0; )
+	{
+		auto *requestable = fallbacks[i];
+		if (std::find(Fallbacks.begin(), Fallbacks.end(), requestable) == Fallbacks.end())
+			continue;
+
 		auto out = requestable->Request(req);
 		if (out)
 		{
-			DINFO("Request resolved by '" + requestable->GetName() + "'");
+			DINFO("Request '" + req.GetName() + "' resolved by fallback '" + requestable->GetName() + "'");
 			return true;
 		}
 		else if (out.HasErrors())
 		{
-			DINFO("Requestable '" + requestable->GetName() + "' attempted to resolve (request was aborted) and failed with error: " + out.AsString());
+			DINFO("Requestable '" + requestable->GetName() + "' attempted to resolve '" + req.GetName() + "' (request was aborted) and failed with error: " + out.AsString());
 			return out;
 		}
 	}
-	DINFO("No Requestable found that takes Request by : (Name: '" + req.Name + "', Parameters : '" + Parameters + "')");
-	return "No Requestable found that takes Request by: (Name: '" + req.Name + "', Parameters: '" + Parameters + "')";
+
+	auto Parameters = DescribeParams(req.Params);
+	DINFO("No Requestable found that takes Request by : (Name: '" + req.GetName() + "', Parameters : '" + Parameters + "')");
+	return "No Requestable found that takes Request by: (Name: '" + req.GetName() + "', Parameters: '" + Parameters + "')";
 }
 
 Debug::DebugReturn Requests::Requester::Request(const MultiRequest && r)
@@ -44,33 +99,42 @@ Debug::DebugReturn Requests::Requester::Request(const MultiRequest && r)
 
 Debug::DebugReturn Requests::Requester::Request(MultiRequest r)
 {
-	Stringy Parameters;
-	for (auto& param : r.Params)
-	{
-		Parameters += param + ", ";
-	}
-	if (Parameters.size())
-	{
-		Parameters.pop_back();
-		Parameters.pop_back();
-	}
-	DINFO("Requesting (Multi) '" + r.Name + "' with parameters of '" + Parameters + "'");
-	
 	Debug::DebugReturn Errors;
 	unsigned int numsent = 0, numfailed = 0u;
 
 	Requests::Request req = r;
-	for (auto& requestable : Requestables)
+
+	auto it = Routes.find(req.ID);
+	if (it != Routes.end())
+	{
+		auto routes = it->second;
+		for (auto &route : routes)
+		{
+			auto out = route.Handler(req);
+			if (out)
+				++numsent;
+			else if (out.HasErrors())
+				++numfailed;
+
+			Errors += out;
+		}
+	}
+
+	auto fallbacks = Fallbacks;
+	for (auto *requestable : fallbacks)
 	{
 		auto out = requestable->Request(req);
 		if (out)
 			++numsent;
+		else if (out.HasErrors())
+			++numfailed;
 
 		Errors += out;
 	}
+
 	if (numsent)
 	{
-		DINFO("Request resolved by '" + std::to_string(numsent) + "' Requestable(s)");
+		DINFO("Request '" + req.GetName() + "' resolved by '" + std::to_string(numsent) + "' Requestable(s)");
 		if (Errors.HasErrors())
 		{
 			DINFO("Request also failed to resolve with '" + std::to_string(Errors.Errors.size()) + "' Requestable(s), with error(s): '" + Errors.AsString() + "'");
@@ -84,6 +148,7 @@ Debug::DebugReturn Requests::Requester::Request(MultiRequest r)
 		DINFO("Request completely failed to resolve with '" + std::to_string(Errors.Errors.size()) + "' Requestable(s) attempting, with error(s): '" + Errors.AsString() + "'");
 		return "Request failed by '" + std::to_string(numfailed) + "' Requestables";
 	}
-	DINFO("No Requestable found that takes Request by : (Name: '" + req.Name + "', Parameters : '" + Parameters + "')");
-	return "No Requestable found that takes Request by: (Name: '" + req.Name + "', Parameters: '" + Parameters + "')";
+	auto Parameters = DescribeParams(req.Params);
+	DINFO("No Requestable found that takes Request by : (Name: '" + req.GetName() + "', Parameters : '" + Parameters + "')");
+	return "No Requestable found that takes Request by: (Name: '" + req.GetName() + "', Parameters: '" + Parameters + "')";
 }
@@ -8,15 +8,26 @@ namespace Requests
 {
 	class Requester
 	{
-		std::vector<IRequestable*> Requestables;
+		friend class RequestRoutes;
 
-	public:
-		inline void Add(IRequestable *a) { Requestables.push_back(a); a->master = this; }
-		inline void Remove(IRequestable *a) 
+		struct Route
 		{
-			for (auto i = Requestables.size(); i-- > 0; ) 
-				if (Requestables[i] == a) { std::swap(Requestables[i], Requestables.back()); Requestables.pop_back(); }
-		}
+			IRequestable *Owner;
+			RequestHandler Handler;
+			uint64_t Serial; // Increases with every route added, so each vector is sorted by it
+		};
+
+		// Built as requestables are added, later routes are tried first
+		std::unordered_map<RequestID, std::vector<Route>> Routes;
+		uint64_t LastRouteSerial = 0;
+		// Requestables that registered a fallback, only asked about requests nothing has a route for
+		std::vector<IRequestable*> Fallbacks;
+
+		static Stringy DescribeParams(const RequestParams &params);
+
+	public:
+		void Add(IRequestable *a);
+		void Remove(IRequestable *a);
 
 		Debug::DebugReturn Request(Requests::Request req);
 		Debug::DebugReturn Request(const MultiRequest &&req);
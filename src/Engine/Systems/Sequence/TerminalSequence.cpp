@@ -37,7 +37,7 @@ void Sequence::TerminalSequencev2::DrawTheText(std::string amount)
 		glClear(GL_COLOR_BUFFER_BIT);
 
 		// Draw Tex
-		TextDrawing DrawnText{ mResources, amount, "Terminal", "Terminal" };
+		DrawnText.SetText(amount);
 		mResources->Ren2->SetTransform(Matrixy2x3::Identity());
 
 		PointRect rect;
@@ -48,7 +48,7 @@ void Sequence::TerminalSequencev2::DrawTheText(std::string amount)
 		rect.bottom = bottomright.y;
 		rect.right = bottomright.x;
 
-		mResources->Ren2->DrawImage(&DrawnText, rect);
+		mResources->Ren2->DrawText(&DrawnText, rect);
 
 		SDLW::Font *font = mResources->UIConfig->GetTextFormat("Terminal");
 		if (!font)
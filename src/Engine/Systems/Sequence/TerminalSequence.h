@@ -4,6 +4,8 @@
 
 #include "Systems/Execution/ResourceHolder.h"
 
+#include "Drawing/TextDrawing.h"
+
 #include "Math/floaty.h"
 
 namespace Sequence
@@ -21,7 +23,7 @@ namespace Sequence
 
 	struct TerminalSequencev2 : ITimedSequenceElement, virtual FullResourceHolder, TextBrushHolder, NormalFontHolder
 	{
-		TerminalSequencev2(CommonResources *resources) : FullResourceHolder(resources), TextBrushHolder("Terminal"), NormalFontHolder("Terminal") { EnsureFormat(); EnsureBrush(); CaretTimer.Reset(); CaretTimer.Start(); }
+		TerminalSequencev2(CommonResources *resources) : FullResourceHolder(resources), TextBrushHolder("Terminal"), NormalFontHolder("Terminal"), DrawnText(resources, "", "Terminal", "Terminal") { EnsureFormat(); EnsureBrush(); CaretTimer.Reset(); CaretTimer.Start(); }
 		//TerminalSequencev2(CommonResources *resources, std::vector<std::unique_ptr<TerminalSequenceElement>>&& vec) : FullResourceHolder(resources), TextBrushHolder(L"Terminal"), NormalFontHolder(L"Terminal"), Elements(vec) { EnsureFormat(); EnsureBrush(); }
 
 		virtual double Apply(double localtime) override;
@@ -54,6 +56,7 @@ namespace Sequence
 		std::string CompletedString;
 		GameTimer CaretTimer;
 		bool DisplayCursor{ true };
+		TextDrawing DrawnText; // Kept between frames so its layout is only redone when the text changes
 	};
 
 	struct NormalTextTerminalElement : TerminalSequenceElement
@@ -0,0 +1,92 @@
+#include "AtomicWait.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#elif defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <climits>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+#ifdef _WIN32
+// WaitOnAddress lives in Synchronization.lib, linked in src/Engine/CMakeLists.txt
+
+void Threading::AtomicWait(const std::atomic<uint32_t>& word, uint32_t expected)
+{
+	WaitOnAddress(const_cast<std::atomic<uint32_t>*>(&word), &expected, sizeof(expected), INFINITE);
+}
+
+void Threading::AtomicNotifyOne(std::atomic<uint32_t>& word)
+{
+	WakeByAddressSingle(&word);
+}
+
+void Threading::AtomicNotifyAll(std::atomic<uint32_t>& word)
+{
+	WakeByAddressAll(&word);
+}
+
+#elif defined(__linux__)
+
+namespace
+{
+	long Futex(const std::atomic<uint32_t>& word, int op, uint32_t val)
+	{
+		// Process private, none of these are ever shared with another process
+		return syscall(SYS_futex, reinterpret_cast<const uint32_t*>(&word), op | FUTEX_PRIVATE_FLAG, val, nullptr, nullptr, 0);
+	}
+}
+
+void Threading::AtomicWait(const std::atomic<uint32_t>& word, uint32_t expected)
+{
+	// Returns immediately (EAGAIN) if the word no longer holds expected
+	Futex(word, FUTEX_WAIT, expected);
+}
+
+void Threading::AtomicNotifyOne(std::atomic<uint32_t>& word)
+{
+	Futex(word, FUTEX_WAKE, 1);
+}
+
+void Threading::AtomicNotifyAll(std::atomic<uint32_t>& word)
+{
+	Futex(word, FUTEX_WAKE, INT_MAX);
+}
+
+#else
+
+// No address waiting available, fall back to one shared condition variable (waking everyone, they re-check their own words)
+namespace
+{
+	std::mutex g_WaitMutex;
+	std::condition_variable g_WaitCV;
+}
+
+void Threading::AtomicWait(const std::atomic<uint32_t>& word, uint32_t expected)
+{
+	std::unique_lock<std::mutex> lock(g_WaitMutex);
+	if (word.load(std::memory_order_acquire) == expected)
+		g_WaitCV.wait(lock);
+}
+
+void Threading::AtomicNotifyOne(std::atomic<uint32_t>& word)
+{
+	AtomicNotifyAll(word);
+}
+
+void Threading::AtomicNotifyAll(std::atomic<uint32_t>&)
+{
+	// Taking the lock orders this after any waiter's check, so it can't miss the wake
+	{
+		std::lock_guard<std::mutex> lock(g_WaitMutex);
+	}
+	g_WaitCV.notify_all();
+}
+
+#endif
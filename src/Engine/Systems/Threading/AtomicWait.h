@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace Threading
+{
+	static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "The OS wait functions need an atomic that is laid out like a plain uint32_t");
+
+	// Sleeps the calling thread while word holds expected, using the OS's address wait (a futex on Linux, WaitOnAddress on Windows)
+	// Can return spuriously, callers re-check whatever they are waiting for
+	void AtomicWait(const std::atomic<uint32_t>& word, uint32_t expected);
+	// Wakes one/all threads sleeping in AtomicWait on word
+	void AtomicNotifyOne(std::atomic<uint32_t>& word);
+	void AtomicNotifyAll(std::atomic<uint32_t>& word);
+
+	/// <summary>
+	/// Lets threads sleep until some lock-free condition (like a queue being non-empty) may have changed, without polling
+	/// </summary>
+	/// <remarks>
+	/// A waiter calls <see cref="PrepareWait"/>, re-checks its condition, then either <see cref="CancelWait"/>s or <see cref="Wait"/>s with the key.
+	/// Whoever changes the condition calls <see cref="NotifyOne"/>/<see cref="NotifyAll"/> afterwards, which cost one fence and a load when nobody is waiting.
+	/// A notify that lands between PrepareWait and Wait makes the Wait return straight away, so no wake-up is lost.
+	/// </remarks>
+	class EventCount
+	{
+		std::atomic<uint32_t> _epoch{ 0 };
+		std::atomic<uint32_t> _waiters{ 0 };
+
+	public:
+		using Key = uint32_t;
+
+		EventCount() = default;
+		EventCount(const EventCount&) = delete;
+		EventCount& operator=(const EventCount&) = delete;
+
+		inline Key PrepareWait()
+		{
+			// Pairs with the fence in Notify, either the notifier sees this waiter or the re-check after this sees the notifier's change
+			_waiters.fetch_add(1, std::memory_order_seq_cst);
+			return _epoch.load(std::memory_order_acquire);
+		}
+
+		inline void CancelWait()
+		{
+			_waiters.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		inline void Wait(Key key)
+		{
+			while (_epoch.load(std::memory_order_acquire) == key)
+				AtomicWait(_epoch, key);
+			_waiters.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		inline void NotifyOne()
+		{
+			if (Bump())
+				AtomicNotifyOne(_epoch);
+		}
+
+		inline void NotifyAll()
+		{
+			if (Bump())
+				AtomicNotifyAll(_epoch);
+		}
+
+	private:
+		// Returns whether anyone needs waking
+		inline bool Bump()
+		{
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (_waiters.load(std::memory_order_relaxed) == 0)
+				return false;
+			_epoch.fetch_add(1, std::memory_order_release);
+			return true;
+		}
+	};
+}
@@ -0,0 +1,248 @@
+#pragma once
+
+#include "AtomicWait.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace Threading
+{
+	/// <summary>
+	/// A fixed capacity multi-producer multi-consumer queue that never takes a lock
+	/// </summary>
+	/// <remarks>
+	/// A ring of cells, each with a sequence number saying which lap of the ring it is ready for (Dmitry Vyukov's bounded MPMC queue).
+	/// Producers and consumers each claim positions with a CAS on their own counter, then publish the cell through its sequence number.
+	/// The bulk versions claim a whole run of ready cells with one CAS, so moving a batch costs about the same as moving one item.
+	/// The try_ functions never block, <see cref="push"/> and <see cref="pop"/> sleep on an <see cref="EventCount"/> (a futex/WaitOnAddress) while full/empty,
+	/// and <see cref="close"/> wakes them so threads can be shut down.
+	/// </remarks>
+	template<class T>
+	class BoundedQueue
+	{
+		struct Cell
+		{
+			std::atomic<size_t> Sequence;
+			alignas(T) unsigned char Storage[sizeof(T)];
+
+			inline T* Get() { return std::launder(reinterpret_cast<T*>(Storage)); }
+		};
+
+		std::unique_ptr<Cell[]> _cells;
+		size_t _mask;
+
+		// Producers and consumers hammer different counters, keep them off each other's cache lines
+		alignas(64) std::atomic<size_t> _enqueuePos{ 0 };
+		alignas(64) std::atomic<size_t> _dequeuePos{ 0 };
+
+		alignas(64) EventCount _notEmpty;
+		EventCount _notFull;
+		std::atomic<bool> _closed{ false };
+
+	public:
+		// The capacity is rounded up to a power of two
+		explicit BoundedQueue(size_t capacity)
+		{
+			size_t size = 2;
+			while (size < capacity)
+				size *= 2;
+
+			_cells = std::make_unique<Cell[]>(size);
+			_mask = size - 1;
+			for (size_t i = 0; i < size; ++i)
+				_cells[i].Sequence.store(i, std::memory_order_relaxed);
+		}
+
+		BoundedQueue(const BoundedQueue& other) = delete;
+		BoundedQueue(BoundedQueue&& other) = delete;
+		BoundedQueue& operator=(const BoundedQueue& other) = delete;
+		BoundedQueue& operator=(BoundedQueue&& other) = delete;
+
+		~BoundedQueue()
+		{
+			// Nothing else can be using the queue any more, destroy whatever was left in it
+			size_t end = _enqueuePos.load(std::memory_order_relaxed);
+			for (size_t pos = _dequeuePos.load(std::memory_order_relaxed); pos != end; ++pos)
+				_cells[pos & _mask].Get()->~T();
+		}
+
+		inline size_t capacity() const { return _mask + 1; }
+
+		// Only a snapshot when other threads are using the queue
+		inline size_t size_approx() const
+		{
+			size_t dequeued = _dequeuePos.load(std::memory_order_acquire);
+			size_t enqueued = _enqueuePos.load(std::memory_order_acquire);
+			return enqueued > dequeued ? enqueued - dequeued : 0;
+		}
+
+		inline bool empty_approx() const { return size_approx() == 0; }
+
+		// Moves from val only if it was pushed
+		inline bool try_push(T& val)
+		{
+			return try_push_bulk(&val, 1) == 1;
+		}
+
+		inline bool try_push(T&& val)
+		{
+			return try_push_bulk(&val, 1) == 1;
+		}
+
+		// Moves as many of the items (from the front) as there is room for, returns how many were pushed
+		size_t try_push_bulk(T* items, size_t count)
+		{
+			if (!count)
+				return 0;
+
+			size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+			size_t claimed = 0;
+			for (;;)
+			{
+				claimed = CountCells(pos, count, 0);
+				if (claimed)
+				{
+					if (_enqueuePos.compare_exchange_weak(pos, pos + claimed, std::memory_order_relaxed))
+						break;
+					continue;
+				}
+
+				// The first cell still holds an item from the last lap, the queue is full
+				auto seq = _cells[pos & _mask].Sequence.load(std::memory_order_acquire);
+				if ((std::intptr_t)(seq - pos) < 0)
+					return 0;
+
+				// Someone else claimed it first
+				pos = _enqueuePos.load(std::memory_order_relaxed);
+			}
+
+			for (size_t i = 0; i < claimed; ++i)
+			{
+				auto& cell = _cells[(pos + i) & _mask];
+				new (cell.Storage) T(std::move(items[i]));
+				cell.Sequence.store(pos + i + 1, std::memory_order_release);
+			}
+
+			if (claimed == 1)
+				_notEmpty.NotifyOne();
+			else
+				_notEmpty.NotifyAll();
+			return claimed;
+		}
+
+		inline bool try_pop(T& outVal)
+		{
+			return try_pop_bulk(&outVal, 1) == 1;
+		}
+
+		// Moves up to maxCount items into out, returns how many were popped
+		size_t try_pop_bulk(T* out, size_t maxCount)
+		{
+			if (!maxCount)
+				return 0;
+
+			size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+			size_t claimed = 0;
+			for (;;)
+			{
+				claimed = CountCells(pos, maxCount, 1);
+				if (claimed)
+				{
+					if (_dequeuePos.compare_exchange_weak(pos, pos + claimed, std::memory_order_relaxed))
+						break;
+					continue;
+				}
+
+				// The first cell hasn't been published this lap, the queue is empty (or its producer is part way through pushing)
+				auto seq = _cells[pos & _mask].Sequence.load(std::memory_order_acquire);
+				if ((std::intptr_t)(seq - (pos + 1)) < 0)
+					return 0;
+
+				pos = _dequeuePos.load(std::memory_order_relaxed);
+			}
+
+			for (size_t i = 0; i < claimed; ++i)
+			{
+				auto& cell = _cells[(pos + i) & _mask];
+				auto item = cell.Get();
+				out[i] = std::move(*item);
+				item->~T();
+				// Ready for the producer on the next lap
+				cell.Sequence.store(pos + i + _mask + 1, std::memory_order_release);
+			}
+
+			if (claimed == 1)
+				_notFull.NotifyOne();
+			else
+				_notFull.NotifyAll();
+			return claimed;
+		}
+
+		// Sleeps while the queue is full, returns false (without pushing) if the queue is closed
+		bool push(T val)
+		{
+			for (;;)
+			{
+				if (_closed.load(std::memory_order_acquire))
+					return false;
+				if (try_push(val))
+					return true;
+
+				auto key = _notFull.PrepareWait();
+				if (_closed.load(std::memory_order_acquire) || try_push(val))
+				{
+					_notFull.CancelWait();
+					continue;
+				}
+				_notFull.Wait(key);
+			}
+		}
+
+		// Sleeps while the queue is empty, returns false once the queue is closed and has nothing left in it
+		bool pop(T& outVal)
+		{
+			for (;;)
+			{
+				if (try_pop(outVal))
+					return true;
+
+				auto key = _notEmpty.PrepareWait();
+				if (try_pop(outVal))
+				{
+					_notEmpty.CancelWait();
+					return true;
+				}
+				if (_closed.load(std::memory_order_acquire))
+				{
+					_notEmpty.CancelWait();
+					return false;
+				}
+				_notEmpty.Wait(key);
+			}
+		}
+
+		// Wakes every thread blocked in push/pop, push fails from now on while pop drains what is left
+		void close()
+		{
+			_closed.store(true, std::memory_order_release);
+			_notEmpty.NotifyAll();
+			_notFull.NotifyAll();
+		}
+
+		inline bool closed() const { return _closed.load(std::memory_order_acquire); }
+
+	private:
+		// How many cells in a row from pos are ready for this side (offset 0 for producers, 1 for consumers), up to max
+		inline size_t CountCells(size_t pos, size_t max, size_t offset)
+		{
+			size_t count = 0;
+			while (count < max && _cells[(pos + count) & _mask].Sequence.load(std::memory_order_acquire) == pos + count + offset)
+				++count;
+			return count;
+		}
+	};
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <limits>
+#include <thread>
+#include <cstdint>
+
+namespace Threading
+{
+	/// <summary>
+	/// Quiescent state based reclamation for data read without locks by a small number of registered reader threads
+	/// </summary>
+	/// <remarks>
+	/// Readers never write anything while reading, instead every reader periodically announces a quiescent state (a point where it holds no pointers to shared data) with <see cref="Quiescent"/>.
+	/// The writer unpublishes a pointer, then calls <see cref="Retire"/> to get the epoch it was retired in.
+	/// Once <see cref="IsSafe"/> returns true for that epoch every reader has passed through a quiescent state since, and the object can be freed.
+	/// Readers that are about to block should go <see cref="Offline"/> so they don't hold back reclamation, and call <see cref="Quiescent"/> again once they resume.
+	/// The writer thread itself never needs to register, as it only frees objects between its own reads.
+	/// </remarks>
+	class EpochDomain
+	{
+	public:
+		static constexpr size_t MaxReaders = 16;
+		static constexpr uint64_t OfflineEpoch = std::numeric_limits<uint64_t>::max();
+		static constexpr size_t InvalidReader = std::numeric_limits<size_t>::max();
+
+	private:
+		struct alignas(64) ReaderRecord
+		{
+			std::atomic<uint64_t> Epoch{ OfflineEpoch };
+			std::atomic<bool> Registered{ false };
+		};
+
+		alignas(64) std::atomic<uint64_t> _epoch{ 1 };
+		std::array<ReaderRecord, MaxReaders> _readers;
+
+	public:
+		EpochDomain() = default;
+		EpochDomain(const EpochDomain&) = delete;
+		EpochDomain& operator=(const EpochDomain&) = delete;
+
+		// Returns a reader index to pass to Quiescent/Offline, or InvalidReader if there are too many readers
+		inline size_t RegisterReader()
+		{
+			for (size_t i = 0; i < MaxReaders; ++i)
+			{
+				bool expected = false;
+				if (_readers[i].Registered.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+				{
+					Quiescent(i);
+					return i;
+				}
+			}
+			return InvalidReader;
+		}
+
+		inline void UnregisterReader(size_t reader)
+		{
+			if (reader >= MaxReaders)
+				return;
+			Offline(reader);
+			_readers[reader].Registered.store(false, std::memory_order_release);
+		}
+
+		// Announce that the reader holds no references to shared data
+		inline void Quiescent(size_t reader)
+		{
+			if (reader >= MaxReaders)
+				return;
+			_readers[reader].Epoch.store(_epoch.load(std::memory_order_acquire), std::memory_order_release);
+			// Pairs with the fence in IsSafe, so a reader coming back online either is seen by the writer or sees the writer's unpublishing
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+		}
+
+		// Announce that the reader will hold no references until it next calls Quiescent
+		inline void Offline(size_t reader)
+		{
+			if (reader >= MaxReaders)
+				return;
+			_readers[reader].Epoch.store(OfflineEpoch, std::memory_order_release);
+		}
+
+		// Call after unpublishing an object, returns the epoch to wait on before freeing it
+		inline uint64_t Retire()
+		{
+			return _epoch.fetch_add(1, std::memory_order_acq_rel) + 1;
+		}
+
+		inline bool IsSafe(uint64_t retiredEpoch) const
+		{
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			for (auto& reader : _readers)
+			{
+				if (!reader.Registered.load(std::memory_order_acquire))
+					continue;
+				if (reader.Epoch.load(std::memory_order_acquire) < retiredEpoch)
+					return false;
+			}
+			return true;
+		}
+
+		// Blocks until every reader has passed a quiescent state after retiredEpoch
+		inline void WaitUntilSafe(uint64_t retiredEpoch) const
+		{
+			while (!IsSafe(retiredEpoch))
+				std::this_thread::yield();
+		}
+	};
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "ThreadedQueue.h"
+
+#include "Helpers/TraceHelper.h"
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <algorithm>
+
+namespace Threading
+{
+	/// <summary>
+	/// A fixed set of worker threads pulling tasks from a shared queue
+	/// </summary>
+	/// <remarks>
+	/// Intended for fanning out batches of independent CPU work (file parsing, image decoding etc.), tasks must not touch GL.
+	/// The destructor finishes every queued task before joining the workers.
+	/// </remarks>
+	class ThreadPool
+	{
+		std::vector<std::thread> _threads;
+		ThreadedQueue<std::function<void()>> _tasks;
+
+	public:
+		// A thread count of 0 uses one worker per hardware thread, minus one for the thread that owns the pool
+		// Workers are named after the pool in profiler traces
+		ThreadPool(size_t threadCount = 0, std::string name = "Pool")
+		{
+			if (!threadCount)
+				threadCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+			threadCount = std::max<size_t>(threadCount, 1);
+
+			_threads.reserve(threadCount);
+			for (size_t i = 0; i < threadCount; ++i)
+			{
+				_threads.emplace_back([this, name, i]()
+					{
+						Profiling::SetThreadName(name + " " + std::to_string(i));
+						while (auto task = _tasks.pop())
+						{
+							TRACE_ZONE("Pool Task");
+							task();
+						}
+					});
+			}
+		}
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		~ThreadPool()
+		{
+			// An empty task tells a worker to stop, as the queue is FIFO everything queued before runs first
+			for (size_t i = 0; i < _threads.size(); ++i)
+				_tasks.push(std::function<void()>{});
+			for (auto& thread : _threads)
+				thread.join();
+		}
+
+		inline size_t GetThreadCount() const { return _threads.size(); }
+
+		// Queues a task, the returned future holds its result (or exception)
+		template<class Func>
+		auto Submit(Func&& func) -> std::future<std::invoke_result_t<std::decay_t<Func>>>
+		{
+			using Result = std::invoke_result_t<std::decay_t<Func>>;
+			auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+			auto future = task->get_future();
+			_tasks.push([task]() { (*task)(); });
+			return future;
+		}
+
+		// Calls func(i) for every i in [0, count) across the workers and the calling thread, returning once all calls are done
+		// Exceptions thrown by func are rethrown here (after every call has finished)
+		template<class Func>
+		void ParallelFor(size_t count, Func&& func)
+		{
+			if (!count)
+				return;
+
+			std::atomic<size_t> next{ 0 };
+			auto work = [&next, &func, count]()
+			{
+				for (size_t i = next.fetch_add(1, std::memory_order_relaxed); i < count; i = next.fetch_add(1, std::memory_order_relaxed))
+					func(i);
+			};
+
+			std::vector<std::future<void>> helpers;
+			auto helperCount = std::min(_threads.size(), count - 1);
+			helpers.reserve(helperCount);
+			for (size_t i = 0; i < helperCount; ++i)
+				helpers.emplace_back(Submit(work));
+
+			std::exception_ptr error;
+			try
+			{
+				work();
+			}
+			catch (...)
+			{
+				error = std::current_exception();
+			}
+
+			for (auto& helper : helpers)
+			{
+				try
+				{
+					helper.get();
+				}
+				catch (...)
+				{
+					if (!error)
+						error = std::current_exception();
+				}
+			}
+
+			if (error)
+				std::rethrow_exception(error);
+		}
+	};
+}
@@ -0,0 +1,154 @@
+#include "FrameStats.h"
+
+#include "Drawing/Graphics2D.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <sstream>
+#include <iomanip>
+
+const char *GetFramePhaseName(FramePhase phase)
+{
+	switch (phase)
+	{
+	case FramePhase::Frame:
+		return "Frame";
+	case FramePhase::Update:
+		return "Update";
+	case FramePhase::Draw:
+		return "Draw";
+	case FramePhase::Present:
+		return "Present";
+	default:
+		return "Unknown";
+	}
+}
+
+void FrameStats::EndFrame(double frameSeconds)
+{
+	m_Current[(size_t)FramePhase::Frame] = frameSeconds * 1000.0;
+	for (size_t i = 0; i < PhaseCount; ++i)
+		m_Samples[i][m_Next] = (float)m_Current[i];
+
+	auto frameMs = m_Current[(size_t)FramePhase::Frame];
+	if (frameMs > m_HitchThresholdMs)
+		++m_Hitches;
+	m_WorstFrameMs = std::max(m_WorstFrameMs, frameMs);
+	++m_TotalFrames;
+
+	m_Next = (m_Next + 1) % WindowSize;
+	m_Count = std::min(m_Count + 1, WindowSize);
+	m_Current.fill(0.0);
+}
+
+void FrameStats::Reset()
+{
+	m_Current.fill(0.0);
+	m_Next = 0;
+	m_Count = 0;
+	m_Hitches = 0;
+	m_TotalFrames = 0;
+	m_WorstFrameMs = 0.0;
+}
+
+FrameTimeSummary SummarizeTimes(std::vector<float> sorted)
+{
+	FrameTimeSummary out;
+	if (sorted.empty())
+		return out;
+
+	std::sort(sorted.begin(), sorted.end());
+
+	double total = 0.0;
+	for (auto sample : sorted)
+		total += sample;
+
+	auto percentile = [&](double p) { return (double)sorted[std::min(sorted.size() - 1, (size_t)std::ceil(p * (double)sorted.size()) - 1)]; };
+
+	out.Mean = total / (double)sorted.size();
+	out.P50 = percentile(0.50);
+	out.P95 = percentile(0.95);
+	out.P99 = percentile(0.99);
+	out.Max = sorted.back();
+	return out;
+}
+
+FrameTimeSummary FrameStats::Summarize(FramePhase phase) const
+{
+	auto &samples = m_Samples[(size_t)phase];
+	return SummarizeTimes(std::vector<float>(samples.begin(), samples.begin() + m_Count));
+}
+
+float FrameStats::GetSample(FramePhase phase, size_t framesAgo) const
+{
+	if (framesAgo >= m_Count)
+		return 0.f;
+	return m_Samples[(size_t)phase][(m_Next + WindowSize - 1 - framesAgo) % WindowSize];
+}
+
+size_t FrameStats::GetHitchesInWindow() const
+{
+	auto &frames = m_Samples[(size_t)FramePhase::Frame];
+	return (size_t)std::count_if(frames.begin(), frames.begin() + m_Count, [this](float ms) { return ms > m_HitchThresholdMs; });
+}
+
+std::string FrameStats::Describe() const
+{
+	std::ostringstream out;
+	out << std::fixed << std::setprecision(2);
+	out << "Frame stats over the last " << m_Count << " frames (ms):";
+	for (size_t i = 0; i < PhaseCount; ++i)
+	{
+		auto summary = Summarize((FramePhase)i);
+		out << "\n" << std::setw(8) << GetFramePhaseName((FramePhase)i)
+			<< ": mean " << summary.Mean
+			<< ", p50 " << summary.P50
+			<< ", p95 " << summary.P95
+			<< ", p99 " << summary.P99
+			<< ", max " << summary.Max;
+	}
+	out << "\nHitches (frames over " << m_HitchThresholdMs << "ms): " << GetHitchesInWindow() << " in the window, "
+		<< m_Hitches << " of " << m_TotalFrames << " frames overall (worst " << m_WorstFrameMs << "ms)";
+	return out.str();
+}
+
+void FrameStats::DrawGraph(IRen2D &ren, PointRect area) const
+{
+	// Bars are scaled so twice the hitch threshold fills the graph, anything longer is clipped
+	const float scaleMs = (float)m_HitchThresholdMs * 2.f;
+	const float width = area.right - area.left;
+	const float height = area.bottom - area.top;
+	const float barWidth = width / (float)WindowSize;
+	constexpr float BudgetMs = 1000.f / 60.f;
+
+	auto toHeight = [&](float ms) { return std::min(ms / scaleMs, 1.f) * height; };
+	auto fill = [&](float left, float top, float right, float bottom, floaty4 color)
+	{
+		ren.FillRectangle(ren.ToGLCoords(floaty2{ left, top }), ren.ToGLCoords(floaty2{ right, bottom }), color);
+	};
+
+	ren.SetTransform(Matrixy2x3::Identity());
+	ren.BeginBatch();
+
+	fill(area.left, area.top, area.right, area.bottom, { 0.f, 0.f, 0.f, 0.5f });
+
+	// Newest on the right
+	for (size_t i = 0; i < m_Count; ++i)
+	{
+		auto ms = GetSample(FramePhase::Frame, i);
+		floaty4 color = ms > m_HitchThresholdMs ? floaty4{ 1.f, 0.2f, 0.2f, 1.f } : ms > BudgetMs ? floaty4{ 1.f, 0.8f, 0.2f, 1.f } : floaty4{ 0.2f, 0.9f, 0.3f, 1.f };
+		auto right = area.right - barWidth * (float)i;
+		fill(right - barWidth, area.bottom - toHeight(ms), right, area.bottom, color);
+	}
+
+	auto line = [&](float ms, floaty4 color)
+	{
+		auto y = area.bottom - toHeight(ms);
+		fill(area.left, y - 0.5f, area.right, y + 0.5f, color);
+	};
+	line(BudgetMs, { 1.f, 1.f, 1.f, 0.6f });
+	line((float)m_HitchThresholdMs, { 1.f, 0.2f, 0.2f, 0.8f });
+
+	ren.EndBatch();
+}
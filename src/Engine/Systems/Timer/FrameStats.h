@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Helpers/VectorHelper.h"
+
+#include <array>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+struct IRen2D;
+
+// The parts of a frame FrameStats keeps times for, Frame being the whole thing (including everything between engine updates)
+enum class FramePhase : size_t
+{
+	Frame = 0,
+	Update,
+	Draw,
+	Present,
+	Count,
+};
+
+const char *GetFramePhaseName(FramePhase phase);
+
+// Summary of one phase's times over the window, all in milliseconds
+struct FrameTimeSummary
+{
+	double Mean = 0.0;
+	double P50 = 0.0;
+	double P95 = 0.0;
+	double P99 = 0.0;
+	double Max = 0.0;
+};
+
+// Summarizes a set of times (in milliseconds), percentiles are nearest rank so each is a time that was actually taken
+FrameTimeSummary SummarizeTimes(std::vector<float> samplesMs);
+
+/// <summary>
+/// Keeps a rolling window of the last WindowSize frames' phase times so frame time spikes (e.g. chunk streaming hitches) can be seen and measured
+/// </summary>
+/// <remarks>
+/// Phases are recorded as they finish each frame with Record, then EndFrame pushes them into the window with the frame's total time.
+/// Any frame longer than the hitch threshold counts as a hitch, the count covers every frame since the last Reset not just the window.
+/// Summarize sorts a copy of the window, so it's meant for reports and overlays rather than calling every frame for every phase.
+/// </remarks>
+class FrameStats
+{
+public:
+	static constexpr size_t WindowSize = 600;
+	static constexpr size_t PhaseCount = (size_t)FramePhase::Count;
+	static constexpr double DefaultHitchThresholdMs = 50.0;
+
+private:
+	std::array<std::array<float, WindowSize>, PhaseCount> m_Samples{}; // Milliseconds
+	std::array<double, PhaseCount> m_Current{};
+	size_t m_Next = 0;
+	size_t m_Count = 0;
+
+	double m_HitchThresholdMs = DefaultHitchThresholdMs;
+	size_t m_Hitches = 0;
+	size_t m_TotalFrames = 0;
+	double m_WorstFrameMs = 0.0;
+
+	bool m_ShowGraph = false;
+
+public:
+	// Adds to the time the current frame spent in a phase
+	inline void Record(FramePhase phase, double seconds) { m_Current[(size_t)phase] += seconds * 1000.0; }
+	void EndFrame(double frameSeconds);
+
+	void Reset();
+
+	FrameTimeSummary Summarize(FramePhase phase) const;
+	// Time a phase took in a frame in the window, 0 being the most recent, in milliseconds
+	float GetSample(FramePhase phase, size_t framesAgo) const;
+	inline size_t GetSampleCount() const { return m_Count; }
+
+	inline void SetHitchThreshold(double milliseconds) { m_HitchThresholdMs = milliseconds; }
+	inline double GetHitchThreshold() const { return m_HitchThresholdMs; }
+	inline size_t GetHitchCount() const { return m_Hitches; }
+	size_t GetHitchesInWindow() const;
+	inline size_t GetTotalFrames() const { return m_TotalFrames; }
+
+	// A multi line report of every phase's summary and the hitches
+	std::string Describe() const;
+
+	inline void SetGraphVisible(bool visible) { m_ShowGraph = visible; }
+	inline bool IsGraphVisible() const { return m_ShowGraph; }
+	// Draws the window's frame times as a bar graph, area is in pixels from the top left of the window
+	void DrawGraph(IRen2D &ren, PointRect area) const;
+};
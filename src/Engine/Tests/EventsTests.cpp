@@ -0,0 +1,234 @@
+#ifdef CPP_ENGINE_TESTS
+
+#include "Systems/Events/Events.h"
+#include "Systems/Input/Input.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	struct SeenEvent
+	{
+		Events::Event Type;
+		int A;
+		int B;
+
+		inline bool operator==(const SeenEvent& other) const { return Type == other.Type && A == other.A && B == other.B; }
+	};
+
+	// Writes down every key, mouse move and mouse wheel event it is sent
+	struct RecordingListener : Events::IEventListener
+	{
+		RecordingListener() : IEventListener({ Events::KeyEvent, Events::MouseMoveEvent, Events::MouseScrollEvent }) {}
+
+		std::vector<SeenEvent> Seen;
+		std::function<void(Events::IEvent *event)> OnReceive;
+
+		bool Receive(::Event::KeyInput *event) override { return Record(event, { event->Type, (int)event->KeyCode, event->State }); }
+		bool Receive(::Event::MouseMove *event) override { return Record(event, { event->Type, event->_X, event->_Y }); }
+		bool Receive(::Event::MouseWheel *event) override { return Record(event, { event->Type, event->_X, event->Scrollage }); }
+		bool Receive(Events::IEvent *event) override { return Record(event, { event->Type, 0, 0 }); }
+
+	private:
+		inline bool Record(Events::IEvent *event, SeenEvent seen)
+		{
+			Seen.push_back(seen);
+			if (OnReceive)
+				OnReceive(event);
+			return Events::RelevantEvent;
+		}
+	};
+
+	// Not a typed event, so it is sent as an IEvent, keeps a reference to Alive for as long as it exists
+	struct TrackedEvent : Events::IEvent
+	{
+		TrackedEvent(std::shared_ptr<int> alive) : IEvent(Events::KeyEvent), Alive(std::move(alive)) {}
+		bool operator==(Events::IEvent *other) override { return other == this; }
+
+		std::shared_ptr<int> Alive;
+	};
+}
+
+TEST(EventsTests, QueuedEventsKeepTheirOrder)
+{
+	Events::EventManager manager;
+	RecordingListener listener;
+	manager.Add(&listener);
+
+	manager.Queue(::Event::KeyInput{ 1, true });
+	manager.Queue(::Event::KeyInput{ 2, true });
+	manager.Queue(::Event::MouseMove{ 10, 20 });
+	manager.Queue(::Event::KeyInput{ 1, false });
+	manager.Queue(::Event::MouseWheel{ 5, 6, 1 });
+	manager.Queue(::Event::KeyInput{ 3, true });
+
+	// Nothing is sent until the queue is dispatched
+	ASSERT_TRUE(manager.HasQueued());
+	ASSERT_TRUE(listener.Seen.empty());
+
+	manager.DispatchQueued();
+	ASSERT_FALSE(manager.HasQueued());
+
+	std::vector<SeenEvent> expected{
+		{ Events::KeyEvent, 1, 1 },
+		{ Events::KeyEvent, 2, 1 },
+		{ Events::MouseMoveEvent, 10, 20 },
+		{ Events::KeyEvent, 1, 0 },
+		{ Events::MouseScrollEvent, 5, 1 },
+		{ Events::KeyEvent, 3, 1 },
+	};
+	ASSERT_EQ(listener.Seen, expected);
+
+	// Everything was sent, a second dispatch has nothing to do
+	manager.DispatchQueued();
+	ASSERT_EQ(listener.Seen.size(), expected.size());
+}
+
+TEST(EventsTests, QueuedRunsAreCoalesced)
+{
+	Events::EventManager manager;
+	RecordingListener listener;
+	manager.Add(&listener);
+
+	// A run of moves becomes the last move
+	manager.Queue(::Event::MouseMove{ 1, 1 });
+	manager.Queue(::Event::MouseMove{ 2, 2 });
+	manager.Queue(::Event::MouseMove{ 3, 4 });
+	// A run of wheel events keeps the last position and adds up the scrolling
+	manager.Queue(::Event::MouseWheel{ 7, 7, 1 });
+	manager.Queue(::Event::MouseWheel{ 8, 8, -3 });
+	manager.Queue(::Event::MouseWheel{ 9, 9, 5 });
+	// Another event in between ends a run, moves on either side of a key stay separate
+	manager.Queue(::Event::MouseMove{ 5, 5 });
+	manager.Queue(::Event::KeyInput{ 4, true });
+	manager.Queue(::Event::MouseMove{ 6, 6 });
+	// Keys have no coalescer, so none are lost
+	manager.Queue(::Event::KeyInput{ 4, false });
+	manager.Queue(::Event::KeyInput{ 4, false });
+
+	manager.DispatchQueued();
+
+	std::vector<SeenEvent> expected{
+		{ Events::MouseMoveEvent, 3, 4 },
+		{ Events::MouseScrollEvent, 9, 3 },
+		{ Events::MouseMoveEvent, 5, 5 },
+		{ Events::KeyEvent, 4, 1 },
+		{ Events::MouseMoveEvent, 6, 6 },
+		{ Events::KeyEvent, 4, 0 },
+		{ Events::KeyEvent, 4, 0 },
+	};
+	ASSERT_EQ(listener.Seen, expected);
+}
+
+TEST(EventsTests, EventsQueuedWhileDispatchingWait)
+{
+	Events::EventManager manager;
+	RecordingListener listener;
+	manager.Add(&listener);
+
+	// Every key queues a move, which must not be sent (or merged into anything) until the next dispatch
+	listener.OnReceive = [&manager](Events::IEvent *event)
+	{
+		if (event->Type == Events::KeyEvent)
+			manager.Queue(::Event::MouseMove{ 100, (int)static_cast<::Event::KeyInput*>(event)->KeyCode });
+	};
+
+	manager.Queue(::Event::MouseMove{ 1, 1 });
+	manager.Queue(::Event::KeyInput{ 1, true });
+	manager.Queue(::Event::KeyInput{ 2, true });
+	manager.DispatchQueued();
+
+	std::vector<SeenEvent> expected{
+		{ Events::MouseMoveEvent, 1, 1 },
+		{ Events::KeyEvent, 1, 1 },
+		{ Events::KeyEvent, 2, 1 },
+	};
+	ASSERT_EQ(listener.Seen, expected);
+	ASSERT_TRUE(manager.HasQueued());
+
+	// The two moves were queued back to back, so they arrive as one
+	manager.DispatchQueued();
+	expected.push_back({ Events::MouseMoveEvent, 100, 2 });
+	ASSERT_EQ(listener.Seen, expected);
+	ASSERT_FALSE(manager.HasQueued());
+}
+
+TEST(EventsTests, PostedFromManyThreads)
+{
+	constexpr int Threads = 4;
+	constexpr int PerThread = 5000;
+
+	Events::EventManager manager;
+	RecordingListener listener;
+	manager.Add(&listener);
+
+	std::atomic<int> finished{ 0 };
+	std::vector<std::thread> producers;
+	for (int t = 0; t < Threads; ++t)
+	{
+		producers.emplace_back([&manager, &finished, t]()
+			{
+				for (int i = 0; i < PerThread; ++i)
+					manager.Post(::Event::KeyInput{ (UINT)(t * PerThread + i), true });
+				finished.fetch_add(1);
+			});
+	}
+
+	// Drain while the producers are still posting, like the main loop would
+	while (finished.load() < Threads)
+		manager.DrainPosted();
+	for (auto& producer : producers)
+		producer.join();
+	manager.DrainPosted();
+
+	ASSERT_EQ(listener.Seen.size(), (size_t)(Threads * PerThread));
+
+	// Every event arrives exactly once, and each thread's events arrive in the order it posted them
+	std::vector<int> next(Threads);
+	for (int t = 0; t < Threads; ++t)
+		next[t] = t * PerThread;
+	for (auto& seen : listener.Seen)
+	{
+		ASSERT_EQ(seen.Type, Events::KeyEvent);
+		int thread = seen.A / PerThread;
+		ASSERT_EQ(seen.A, next[thread]);
+		++next[thread];
+	}
+	for (int t = 0; t < Threads; ++t)
+		ASSERT_EQ(next[t], (t + 1) * PerThread);
+}
+
+TEST(EventsTests, DrainPostedFreesEventsAfterAThrow)
+{
+	Events::EventManager manager;
+	RecordingListener listener;
+	manager.Add(&listener);
+
+	auto alive = std::make_shared<int>(0);
+	for (int i = 0; i < 4; ++i)
+		manager.Post(TrackedEvent{ alive });
+	ASSERT_EQ(alive.use_count(), 5);
+
+	listener.OnReceive = [&listener](Events::IEvent *)
+	{
+		if (listener.Seen.size() == 2)
+			throw std::runtime_error("Listener failed");
+	};
+
+	ASSERT_THROW(manager.DrainPosted(), std::runtime_error);
+	// The event that threw and the two never sent are all gone
+	ASSERT_EQ(alive.use_count(), 1);
+	ASSERT_EQ(listener.Seen.size(), 2u);
+
+	manager.DrainPosted();
+	ASSERT_EQ(listener.Seen.size(), 2u);
+}
+
+#endif // CPP_ENGINE_TESTS
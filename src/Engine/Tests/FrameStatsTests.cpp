@@ -0,0 +1,106 @@
+#ifdef CPP_ENGINE_TESTS
+
+#include "Systems/Timer/FrameStats.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+TEST(FrameStatsTests, SummarizePercentiles)
+{
+	std::vector<float> samples;
+	for (int i = 1; i <= 100; ++i)
+		samples.push_back((float)i);
+	std::shuffle(samples.begin(), samples.end(), std::mt19937{ 7 });
+
+	// Nearest rank, so each percentile is one of the samples
+	auto summary = SummarizeTimes(samples);
+	ASSERT_DOUBLE_EQ(summary.Mean, 50.5);
+	ASSERT_DOUBLE_EQ(summary.P50, 50.0);
+	ASSERT_DOUBLE_EQ(summary.P95, 95.0);
+	ASSERT_DOUBLE_EQ(summary.P99, 99.0);
+	ASSERT_DOUBLE_EQ(summary.Max, 100.0);
+
+	// With only a few samples the high percentiles are the slowest one
+	auto few = SummarizeTimes({ 4.f, 1.f, 3.f, 2.f });
+	ASSERT_DOUBLE_EQ(few.P50, 2.0);
+	ASSERT_DOUBLE_EQ(few.P95, 4.0);
+	ASSERT_DOUBLE_EQ(few.P99, 4.0);
+
+	auto one = SummarizeTimes({ 16.f });
+	ASSERT_DOUBLE_EQ(one.P50, 16.0);
+	ASSERT_DOUBLE_EQ(one.Max, 16.0);
+
+	auto none = SummarizeTimes({});
+	ASSERT_DOUBLE_EQ(none.Mean, 0.0);
+	ASSERT_DOUBLE_EQ(none.Max, 0.0);
+}
+
+TEST(FrameStatsTests, WindowWrapsAround)
+{
+	// Too big for the stack
+	auto stats = std::make_unique<FrameStats>();
+	ASSERT_EQ(stats->GetSampleCount(), 0u);
+	ASSERT_FLOAT_EQ(stats->GetSample(FramePhase::Frame, 0), 0.f);
+
+	// Frame i takes i ms, a quarter of it in Update
+	constexpr size_t Extra = 25;
+	for (size_t i = 1; i <= FrameStats::WindowSize + Extra; ++i)
+	{
+		stats->Record(FramePhase::Update, (double)i / 4000.0);
+		stats->EndFrame((double)i / 1000.0);
+	}
+
+	ASSERT_EQ(stats->GetSampleCount(), FrameStats::WindowSize);
+	ASSERT_EQ(stats->GetTotalFrames(), FrameStats::WindowSize + Extra);
+
+	// Only the newest WindowSize frames are kept, newest first
+	ASSERT_NEAR(stats->GetSample(FramePhase::Frame, 0), (float)(FrameStats::WindowSize + Extra), 1e-3f);
+	ASSERT_NEAR(stats->GetSample(FramePhase::Frame, FrameStats::WindowSize - 1), (float)(Extra + 1), 1e-3f);
+	ASSERT_FLOAT_EQ(stats->GetSample(FramePhase::Frame, FrameStats::WindowSize), 0.f);
+	ASSERT_NEAR(stats->GetSample(FramePhase::Update, 0), (float)(FrameStats::WindowSize + Extra) / 4.f, 1e-3f);
+	// Phases that weren't recorded are 0
+	ASSERT_FLOAT_EQ(stats->GetSample(FramePhase::Draw, 0), 0.f);
+
+	auto summary = stats->Summarize(FramePhase::Frame);
+	ASSERT_NEAR(summary.Max, (double)(FrameStats::WindowSize + Extra), 1e-3);
+	ASSERT_NEAR(summary.Mean, (double)(Extra + 1 + FrameStats::WindowSize + Extra) / 2.0, 1e-3);
+	ASSERT_NEAR(summary.P50, (double)(Extra + FrameStats::WindowSize / 2), 1e-3);
+
+	stats->Reset();
+	ASSERT_EQ(stats->GetSampleCount(), 0u);
+	ASSERT_DOUBLE_EQ(stats->Summarize(FramePhase::Frame).Max, 0.0);
+}
+
+TEST(FrameStatsTests, HitchesInWindow)
+{
+	auto stats = std::make_unique<FrameStats>();
+	stats->SetHitchThreshold(50.0);
+
+	// Two hitches, then enough smooth frames to push one of them out of the window
+	stats->EndFrame(0.080);
+	stats->EndFrame(0.010);
+	stats->EndFrame(0.051);
+	for (size_t i = 0; i < FrameStats::WindowSize - 1; ++i)
+		stats->EndFrame(i == 100 ? 0.050 : 0.016); // Exactly on the threshold isn't a hitch
+
+	ASSERT_EQ(stats->GetHitchCount(), 2u);
+	ASSERT_EQ(stats->GetHitchesInWindow(), 1u);
+
+	stats->EndFrame(0.016);
+	ASSERT_EQ(stats->GetHitchesInWindow(), 0u);
+	ASSERT_EQ(stats->GetHitchCount(), 2u);
+
+	// Lowering the threshold applies to the frames already in the window
+	stats->SetHitchThreshold(15.0);
+	ASSERT_EQ(stats->GetHitchesInWindow(), FrameStats::WindowSize);
+
+	stats->Reset();
+	ASSERT_EQ(stats->GetHitchCount(), 0u);
+	ASSERT_EQ(stats->GetHitchesInWindow(), 0u);
+}
+
+#endif // CPP_ENGINE_TESTS
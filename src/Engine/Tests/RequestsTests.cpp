@@ -0,0 +1,201 @@
+#ifdef CPP_ENGINE_TESTS
+
+#include "Systems/Requests/Requester.h"
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	// Handles one request name with whatever handler it is given, writing its name down each time it is asked
+	struct TestRequestable : Requests::IRequestable
+	{
+		TestRequestable(Stringy name, Stringy handles, std::vector<Stringy> &asked, std::function<Debug::DebugReturn(Requests::Request &)> handler)
+			: Name(std::move(name)), Handles(std::move(handles)), Asked(asked), Handler(std::move(handler)) {}
+
+		Stringy Name;
+		Stringy Handles;
+		std::vector<Stringy> &Asked;
+		std::function<Debug::DebugReturn(Requests::Request &)> Handler;
+		bool Fallback = false;
+
+		void RegisterRequests(Requests::RequestRoutes &routes) override
+		{
+			if (Fallback)
+				routes.AddFallback();
+			else
+				routes.Add(Handles, [this](Requests::Request &req) { return Request(req); });
+		}
+
+		Debug::DebugReturn Request(Requests::Request &req) override
+		{
+			Asked.push_back(Name);
+			return Handler(req);
+		}
+
+		Stringy GetName() const override { return Name; }
+	};
+
+	// True if ptr points inside obj, ie the parameters are still stored inline
+	template<class T>
+	bool PointsInside(const T &obj, const void *ptr)
+	{
+		auto *begin = reinterpret_cast<const unsigned char*>(&obj);
+		auto *p = reinterpret_cast<const unsigned char*>(ptr);
+		return p >= begin && p < begin + sizeof(T);
+	}
+}
+
+TEST(RequestsTests, RequestParamsInlineThenOverflow)
+{
+	Requests::RequestParams params;
+	ASSERT_TRUE(params.empty());
+	ASSERT_EQ(params.begin(), params.end());
+
+	params.push_back("a");
+	params.push_back("b");
+	ASSERT_EQ(params.size(), Requests::RequestParams::InlineCount);
+	ASSERT_TRUE(PointsInside(params, params.data()));
+
+	// One past the inline storage moves everything into the vector, keeping the order
+	params.push_back("c");
+	params.push_back("d");
+	ASSERT_EQ(params.size(), 4u);
+	ASSERT_FALSE(PointsInside(params, params.data()));
+	std::vector<Stringy> all(params.begin(), params.end());
+	ASSERT_EQ(all, (std::vector<Stringy>{ "a", "b", "c", "d" }));
+
+	// Copies keep their own storage
+	Requests::RequestParams copy = params;
+	ASSERT_EQ(copy.size(), 4u);
+	ASSERT_NE(copy.data(), params.data());
+	ASSERT_EQ(copy[3], "d");
+
+	Requests::RequestParams small{ "x", "y" };
+	ASSERT_TRUE(PointsInside(small, small.data()));
+	Requests::RequestParams smallCopy = small;
+	ASSERT_TRUE(PointsInside(smallCopy, smallCopy.data()));
+	ASSERT_EQ(smallCopy[1], "y");
+
+	// Built from a vector, only kept in it when there are too many to store inline
+	Requests::RequestParams fromShort{ std::vector<Stringy>{ "1" } };
+	ASSERT_TRUE(PointsInside(fromShort, fromShort.data()));
+	ASSERT_EQ(fromShort.size(), 1u);
+	Requests::RequestParams fromLong{ std::vector<Stringy>{ "1", "2", "3" } };
+	ASSERT_FALSE(PointsInside(fromLong, fromLong.data()));
+	ASSERT_EQ(fromLong.size(), 3u);
+	ASSERT_EQ(fromLong[2], "3");
+}
+
+TEST(RequestsTests, LaterRoutesAreTriedFirst)
+{
+	std::vector<Stringy> asked;
+	Requests::Requester requester;
+	auto unresolved = [](Requests::Request &) { return Debug::DebugReturn(false); };
+	auto resolved = [](Requests::Request &) { return Debug::DebugReturn(true); };
+
+	TestRequestable first{ "First", "Priority", asked, resolved };
+	TestRequestable second{ "Second", "Priority", asked, unresolved };
+	TestRequestable third{ "Third", "Priority", asked, unresolved };
+	TestRequestable fallback{ "Fallback", "", asked, resolved };
+	fallback.Fallback = true;
+
+	requester.Add(&fallback);
+	requester.Add(&first);
+	requester.Add(&second);
+	requester.Add(&third);
+
+	// Routes go newest first, stopping at the first that resolves, the fallback is never needed
+	ASSERT_TRUE((bool)requester.Request(Requests::Request{ "Priority" }));
+	ASSERT_EQ(asked, (std::vector<Stringy>{ "Third", "Second", "First" }));
+
+	// Nothing has a route for this, so only the fallback is asked
+	asked.clear();
+	ASSERT_TRUE((bool)requester.Request(Requests::Request{ "NoRoute" }));
+	ASSERT_EQ(asked, (std::vector<Stringy>{ "Fallback" }));
+
+	// An error stops the request there
+	asked.clear();
+	second.Handler = [](Requests::Request &) { return Debug::DebugReturn(Stringy("Broken")); };
+	auto out = requester.Request(Requests::Request{ "Priority" });
+	ASSERT_FALSE((bool)out);
+	ASSERT_TRUE(out.HasErrors());
+	ASSERT_EQ(asked, (std::vector<Stringy>{ "Third", "Second" }));
+
+	// Removed requestables are skipped
+	asked.clear();
+	requester.Remove(&third);
+	requester.Remove(&second);
+	ASSERT_TRUE((bool)requester.Request(Requests::Request{ "Priority" }));
+	ASSERT_EQ(asked, (std::vector<Stringy>{ "First" }));
+}
+
+TEST(RequestsTests, HandlersCanAddAndRemoveRequestables)
+{
+	std::vector<Stringy> asked;
+	Requests::Requester requester;
+	std::vector<std::unique_ptr<TestRequestable>> added;
+
+	auto unresolved = [](Requests::Request &) { return Debug::DebugReturn(false); };
+	TestRequestable first{ "First", "Grow", asked, [](Requests::Request &) { return Debug::DebugReturn(true); } };
+	TestRequestable removed{ "Removed", "Grow", asked, unresolved };
+	// Adds enough routes to other requests that Routes has to rehash, and removes the route that would have been asked next
+	TestRequestable grower{ "Grower", "Grow", asked, [&](Requests::Request &)
+		{
+			for (int i = 0; i < 100; ++i)
+			{
+				added.push_back(std::make_unique<TestRequestable>("Added", "Grow" + std::to_string(i), asked, unresolved));
+				requester.Add(added.back().get());
+			}
+			requester.Remove(&removed);
+			return Debug::DebugReturn(false);
+		} };
+
+	requester.Add(&first);
+	requester.Add(&removed);
+	requester.Add(&grower);
+
+	ASSERT_TRUE((bool)requester.Request(Requests::Request{ "Grow" }));
+	ASSERT_EQ(asked, (std::vector<Stringy>{ "Grower", "First" }));
+}
+
+TEST(RequestsTests, InternFromManyThreads)
+{
+	constexpr int Threads = 4;
+	constexpr int Names = 200;
+
+	// Every thread interns the same new names (and some already known) at once, they must all agree on each ID
+	auto known = Requests::Intern("InternKnown");
+	std::vector<std::vector<Requests::RequestID>> ids(Threads);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < Threads; ++t)
+	{
+		threads.emplace_back([&ids, known, t]()
+			{
+				for (int i = 0; i < Names; ++i)
+				{
+					ids[t].push_back(Requests::Intern("InternThreaded" + std::to_string(i)));
+					if (Requests::Intern("InternKnown") != known)
+						ids[t].push_back(Requests::InvalidRequestID);
+				}
+			});
+	}
+	for (auto &thread : threads)
+		thread.join();
+
+	for (int t = 0; t < Threads; ++t)
+		ASSERT_EQ(ids[t], ids[0]);
+	for (int i = 0; i < Names; ++i)
+	{
+		ASSERT_NE(ids[0][i], Requests::InvalidRequestID);
+		ASSERT_EQ(Requests::GetRequestName(ids[0][i]), "InternThreaded" + std::to_string(i));
+	}
+	ASSERT_EQ(Requests::GetRequestName(known), "InternKnown");
+}
+
+#endif // CPP_ENGINE_TESTS
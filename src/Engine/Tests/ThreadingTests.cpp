@@ -0,0 +1,167 @@
+#ifdef CPP_ENGINE_TESTS
+
+#include "Systems/Threading/BoundedQueue.h"
+#include "Systems/Threading/EpochDomain.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEST(ThreadingTests, BoundedQueueOrderAndCapacity)
+{
+	Threading::BoundedQueue<int> queue{ 5 };
+	ASSERT_EQ(queue.capacity(), 8u);
+
+	for (int i = 0; i < 8; ++i)
+		ASSERT_TRUE(queue.try_push(i));
+	ASSERT_FALSE(queue.try_push(8));
+
+	int val = -1;
+	ASSERT_TRUE(queue.try_pop(val));
+	ASSERT_EQ(val, 0);
+
+	// Only one cell is free, the rest of the batch stays behind
+	std::vector<int> batch{ 8, 9, 10 };
+	ASSERT_EQ(queue.try_push_bulk(batch.data(), batch.size()), 1u);
+
+	std::vector<int> out(16);
+	ASSERT_EQ(queue.try_pop_bulk(out.data(), out.size()), 8u);
+	for (int i = 0; i < 8; ++i)
+		ASSERT_EQ(out[i], i + 1);
+	ASSERT_FALSE(queue.try_pop(val));
+	ASSERT_TRUE(queue.empty_approx());
+}
+
+TEST(ThreadingTests, BoundedQueueMoveOnlyAndLeftovers)
+{
+	auto alive = std::make_shared<int>(0);
+	{
+		Threading::BoundedQueue<std::shared_ptr<int>> queue{ 4 };
+		ASSERT_TRUE(queue.try_push(std::shared_ptr<int>(alive)));
+		ASSERT_TRUE(queue.try_push(std::shared_ptr<int>(alive)));
+		ASSERT_EQ(alive.use_count(), 3);
+
+		std::shared_ptr<int> out;
+		ASSERT_TRUE(queue.try_pop(out));
+		out.reset();
+		ASSERT_EQ(alive.use_count(), 2);
+	}
+	// The queue destroys whatever was still in it
+	ASSERT_EQ(alive.use_count(), 1);
+}
+
+TEST(ThreadingTests, BoundedQueueCloseWakesPop)
+{
+	Threading::BoundedQueue<int> queue{ 4 };
+	bool popped = true;
+	std::thread waiter([&]() { int val; popped = queue.pop(val); });
+
+	queue.close();
+	waiter.join();
+	ASSERT_FALSE(popped);
+	ASSERT_FALSE(queue.push(1));
+}
+
+TEST(ThreadingTests, BoundedQueueManyProducersAndConsumers)
+{
+	constexpr int Threads = 4;
+	constexpr int PerThread = 20000;
+	// Small enough that producers regularly find it full and block
+	Threading::BoundedQueue<int> queue{ 64 };
+
+	std::vector<std::thread> producers, consumers;
+	std::vector<long long> sums(Threads, 0);
+	for (int t = 0; t < Threads; ++t)
+	{
+		producers.emplace_back([&queue]()
+			{
+				std::vector<int> batch;
+				for (int i = 1; i <= PerThread; ++i)
+				{
+					// Alternate between single and bulk pushes
+					if (i % 3)
+					{
+						ASSERT_TRUE(queue.push(i));
+						continue;
+					}
+					batch.assign(4, i);
+					size_t pushed = 0;
+					while (pushed < batch.size())
+						pushed += queue.try_push_bulk(batch.data() + pushed, batch.size() - pushed);
+				}
+			});
+		consumers.emplace_back([&queue, &sums, t]()
+			{
+				std::vector<int> out(8);
+				int val;
+				while (queue.pop(val))
+				{
+					sums[t] += val;
+					size_t count = queue.try_pop_bulk(out.data(), out.size());
+					for (size_t i = 0; i < count; ++i)
+						sums[t] += out[i];
+				}
+			});
+	}
+
+	for (auto& producer : producers)
+		producer.join();
+	queue.close();
+	for (auto& consumer : consumers)
+		consumer.join();
+
+	long long expected = 0;
+	for (int i = 1; i <= PerThread; ++i)
+		expected += (i % 3) ? i : 4ll * i;
+	expected *= Threads;
+
+	long long total = 0;
+	for (auto sum : sums)
+		total += sum;
+	ASSERT_EQ(total, expected);
+}
+
+TEST(ThreadingTests, ReaderBlockedOnFullQueueDoesNotHoldBackReclaim)
+{
+	// Like the chunk loader, a reader pushes its results into a queue the writer only drains after reclaiming
+	Threading::EpochDomain domain;
+	Threading::BoundedQueue<int> results{ 2 };
+	while (results.try_push(0)) {}
+
+	std::atomic<bool> pushing{ false };
+	std::thread loader([&]()
+		{
+			auto reader = domain.RegisterReader();
+			domain.Quiescent(reader);
+			// Done reading shared data, go offline before push can sleep on the full queue
+			domain.Offline(reader);
+			pushing.store(true);
+			results.push(1);
+			domain.UnregisterReader(reader);
+		});
+
+	while (!pushing.load())
+		std::this_thread::yield();
+
+	// The writer retires something while the loader is stuck in push, it must not have to wait for the loader
+	auto retired = domain.Retire();
+	auto giveUp = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	bool safe = false;
+	while (!(safe = domain.IsSafe(retired)) && std::chrono::steady_clock::now() < giveUp)
+		std::this_thread::yield();
+
+	// Take out what filled the queue so the loader can finish whether or not that worked
+	int val;
+	for (size_t i = 0; i < results.capacity(); ++i)
+		ASSERT_TRUE(results.pop(val));
+	loader.join();
+	ASSERT_TRUE(safe);
+	ASSERT_TRUE(results.try_pop(val));
+	ASSERT_EQ(val, 1);
+}
+
+#endif // CPP_ENGINE_TESTS
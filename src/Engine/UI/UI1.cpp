@@ -7,6 +7,7 @@
 #include "Systems/Input/Input.h"
 #include "Systems/Input/Config1.h"
 #include "Drawing/Graphics2D.h"
+#include "Drawing/GpuProfiler.h"
 
 #include <algorithm>
 
@@ -350,11 +351,22 @@ void UI1::UIElement::BeforeDraw()
 
 void UI1::UIElement::Draw()
 {
+	// Children go one batch layer above their parent, so they draw over it however the batch gets sorted
+	auto* ren = mResources->Ren2;
+	auto layer = ren->GetBatchLayer();
+	ren->SetBatchLayer(layer);
+
 	IDraw();
 
 	for (auto& child : Children)
+	{
 		if (child->IsUIEnabled())
+		{
+			ren->SetBatchLayer(layer + 1);
 			child->Draw();
+		}
+	}
+	ren->SetBatchLayer(layer);
 }
 
 void UI1::UIElement::AfterDraw()
@@ -440,14 +452,27 @@ void UI1::RootElement::BeforeDraw()
 
 void UI1::RootElement::Draw()
 {
+	TRACE_ZONE("UI");
+	GPU_ZONE("UI");
+
+	// The whole tree is submitted as one batch, so every element's rects, images and text are drawn together in a handful of calls
+	mResources->Ren2->BeginBatch();
+	mResources->Ren2->SetBatchLayer(0);
+
 	UIElement::Draw();
 
 	for (auto& schild : FloatElements)
 	{
 		if (schild->IsUIEnabled())
+		{
+			// Float elements draw over the tree and every float before them
+			mResources->Ren2->SetBatchLayer(mResources->Ren2->GetTopBatchLayer() + 1);
 			schild->Draw();
+		}
 	}
 
+	mResources->Ren2->EndBatch();
+
 	if (DebugDraw)
 	{
 		for (auto& child : Children)
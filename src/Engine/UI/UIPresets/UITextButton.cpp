@@ -45,7 +45,7 @@ bool UI1I::UITextBox::Receive(Event::MarginChangeEvent * e)
 void UI1I::UITextBox::IDraw()
 {
 	mResources->Ren2->SetTransform(this->LocalToWorld);
-	mResources->Ren2->DrawImage(&Text, LocalBounds);
+	mResources->Ren2->DrawText(&Text, LocalBounds);
 }
 
 void UI1I::UITextBox::SetTextFormat(Stringy Name)
@@ -64,14 +64,14 @@ void UI1I::UITextButtonE::IDraw()
 	mResources->Ren2->SetTransform(LocalToWorld);
 	if (BeingClicked())
 	{
-		mResources->Ren2->DrawImage(&MouseDownText, LocalBounds);
+		mResources->Ren2->DrawText(&MouseDownText, LocalBounds);
 	}
 	else if (BeingHovered(*mResources->UpdateID))
 	{
-		mResources->Ren2->DrawImage(&HoveredText, LocalBounds);
+		mResources->Ren2->DrawText(&HoveredText, LocalBounds);
 	}
 	else
 	{
-		mResources->Ren2->DrawImage(&Text, LocalBounds);
+		mResources->Ren2->DrawText(&Text, LocalBounds);
 	}
 }
@@ -0,0 +1,340 @@
+#include <Helpers/DebugHelper.h>
+#include <Helpers/TraceHelper.h>
+
+#include <Game/GameEngine.h>
+#include <Game/Scene/VoxelScene.h>
+#include <Systems/Timer/FrameStats.h>
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+
+#ifdef WIN32
+#	ifndef _WINDOWS_
+#		define WIN32_MEAN_AND_LEAN
+#		include <Windows.h>
+#	endif
+#	include <psapi.h>
+#else
+#	include <sys/resource.h>
+#endif
+
+#include <memory>
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <filesystem>
+
+#include "ParkourScene.h"
+
+/**
+* Headless flythrough benchmark
+* Flies the player along a fixed, seeded path through a voxel world with nothing else driving it,
+* so frame times, chunk streaming and draw call counts can be compared run to run.
+* Results are written as JSON (see WriteResults), nothing is interactive.
+* Run it without a display with e.g.
+*   LIBGL_ALWAYS_SOFTWARE=1 xvfb-run -s "-screen 0 1280x720x24" ./cpp_engine_flythrough --scene parkour --frames 1800
+*/
+
+std::unique_ptr<Engine::IEngine> g_Engine;
+
+bool Quit = false; // Quit flag
+
+void QuitDatAss()
+{
+	Quit = true;
+}
+
+namespace
+{
+	struct FlythroughOptions
+	{
+		std::string Scene = "parkour";
+		size_t Frames = 1800;
+		size_t Warmup = 60;
+		uint64_t Seed = 1;
+		std::string Out = "flythrough.json";
+	};
+
+	// Exposes what the benchmark reads back each frame
+	struct FlythroughEngine : Engine::GameEngine
+	{
+		FlythroughEngine() : GameEngine(SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN) {}
+
+		inline Drawing::DrawCallRenderer& GetRenderer() { return *Ren.Getv2(); }
+		inline Scene::IScene* GetCurrentScene() const { return CurrentScene.get(); }
+	};
+
+	struct FrameSample
+	{
+		float FrameMs;
+		size_t DrawCalls;
+		size_t Indices;
+		size_t Vertices;
+	};
+
+	bool ParseOptions(int argc, char *args[], FlythroughOptions &out)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string arg = args[i];
+			if (i + 1 >= argc)
+			{
+				std::cerr << "Missing value for '" << arg << "'" << std::endl;
+				return false;
+			}
+			std::string value = args[++i];
+
+			try
+			{
+				if (arg == "--scene")
+					out.Scene = value;
+				else if (arg == "--frames")
+					out.Frames = std::stoull(value);
+				else if (arg == "--warmup")
+					out.Warmup = std::stoull(value);
+				else if (arg == "--seed")
+					out.Seed = std::stoull(value);
+				else if (arg == "--out")
+					out.Out = value;
+				else
+				{
+					std::cerr << "Unknown argument '" << arg << "'" << std::endl;
+					return false;
+				}
+			}
+			catch (const std::exception &)
+			{
+				std::cerr << "Invalid value '" << value << "' for '" << arg << "'" << std::endl;
+				return false;
+			}
+		}
+
+		if (out.Scene != "parkour" && out.Scene != "voxel")
+		{
+			std::cerr << "Unknown scene '" << out.Scene << "', expected parkour or voxel" << std::endl;
+			return false;
+		}
+		if (!out.Frames)
+		{
+			std::cerr << "--frames must be at least 1" << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	// Where the camera is t of the way along the path, a long run forward (to keep new chunks streaming in) that weaves side to side and bobs up and down
+	floaty3 PathPosition(float t)
+	{
+		return floaty3{ 24.f * std::sin(4.f * Math::PiF * t), 12.f + 4.f * std::sin(6.f * Math::PiF * t), -400.f * t };
+	}
+
+	size_t GetPeakRSS()
+	{
+#ifdef WIN32
+		PROCESS_MEMORY_COUNTERS counters;
+		if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+			return (size_t)counters.PeakWorkingSetSize;
+		return 0;
+#else
+		rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) == 0)
+			return (size_t)usage.ru_maxrss * 1024; // ru_maxrss is in kilobytes on Linux
+		return 0;
+#endif
+	}
+
+	void WriteSummary(std::ofstream &file, const char *name, const FrameTimeSummary &summary)
+	{
+		file << "\t\"" << name << "\": { \"mean\": " << summary.Mean << ", \"p50\": " << summary.P50 << ", \"p95\": " << summary.P95
+			<< ", \"p99\": " << summary.P99 << ", \"max\": " << summary.Max << " },\n";
+	}
+
+	bool WriteResults(const FlythroughOptions &options, const std::vector<FrameSample> &samples, double seconds, size_t chunksLoaded, const Voxel::ChunkStreamingStats &streaming)
+	{
+		std::vector<float> frameTimes;
+		frameTimes.reserve(samples.size());
+		size_t totalCalls = 0, maxCalls = 0, totalIndices = 0, maxIndices = 0, totalVertices = 0, maxVertices = 0;
+		for (auto &sample : samples)
+		{
+			frameTimes.push_back(sample.FrameMs);
+			totalCalls += sample.DrawCalls;
+			maxCalls = std::max(maxCalls, sample.DrawCalls);
+			totalIndices += sample.Indices;
+			maxIndices = std::max(maxIndices, sample.Indices);
+			totalVertices += sample.Vertices;
+			maxVertices = std::max(maxVertices, sample.Vertices);
+		}
+		auto count = (double)std::max<size_t>(samples.size(), 1);
+
+		std::ofstream file{ options.Out };
+		if (!file.good())
+		{
+			DERROR("Could not open '" + options.Out + "' to write the flythrough results to");
+			return false;
+		}
+
+		file << std::fixed << std::setprecision(3);
+		file << "{\n";
+		file << "\t\"scene\": \"" << options.Scene << "\",\n";
+		file << "\t\"seed\": " << options.Seed << ",\n";
+		file << "\t\"frames\": " << samples.size() << ",\n";
+		file << "\t\"warmup_frames\": " << options.Warmup << ",\n";
+		file << "\t\"seconds\": " << seconds << ",\n";
+		WriteSummary(file, "frame_ms", SummarizeTimes(frameTimes));
+		file << "\t\"chunks_loaded\": " << chunksLoaded << ",\n";
+		file << "\t\"chunks_loaded_per_second\": " << (seconds > 0.0 ? (double)chunksLoaded / seconds : 0.0) << ",\n";
+		// Only the most recent LatencyWindow loads are kept, which is every load of a normal length run
+		WriteSummary(file, "chunk_latency_ms", SummarizeTimes(streaming.RecentLatenciesMs));
+		file << "\t\"draw_calls\": { \"mean\": " << (double)totalCalls / count << ", \"max\": " << maxCalls << " },\n";
+		file << "\t\"vertices\": { \"mean\": " << (double)totalVertices / count << ", \"max\": " << maxVertices << " },\n";
+		file << "\t\"indices\": { \"mean\": " << (double)totalIndices / count << ", \"max\": " << maxIndices << " },\n";
+		file << "\t\"peak_rss_bytes\": " << GetPeakRSS() << "\n";
+		file << "}" << std::endl;
+
+		DINFO("Wrote flythrough results to '" + options.Out + "'");
+		return file.good();
+	}
+
+	bool RunFlythrough(const FlythroughOptions &options)
+	{
+		auto engine = std::make_unique<FlythroughEngine>();
+		auto &bench = *engine;
+		g_Engine = std::move(engine);
+
+		// Don't let the display's refresh rate cap the frame rate
+		SDL_GL_SetSwapInterval(0);
+		// The parkour is generated from the engine's generator, anything left on std::rand gets the seed too
+		g_Engine->m_RandomGen.seed(options.Seed);
+		std::srand((unsigned int)options.Seed);
+
+		Voxel::VoxelPlayer *player = nullptr;
+		Voxel::VoxelWorld *world = nullptr;
+		Scene::IScene *scene = nullptr;
+		if (options.Scene == "voxel")
+		{
+			auto voxel = std::make_unique<Voxel::VoxelScene>(&g_Engine->Resources);
+			player = voxel->GetPlayer();
+			world = voxel->GetWorld();
+			scene = voxel.get();
+			g_Engine->SwitchScene(std::move(voxel));
+		}
+		else
+		{
+			auto parkour = std::make_unique<Parkour::ParkourScene>(&g_Engine->Resources, 0);
+			player = parkour->GetPlayer();
+			world = parkour->GetWorld();
+			scene = parkour.get();
+			g_Engine->SwitchScene(std::move(parkour));
+		}
+
+		Profiling::SetThreadName("Main");
+
+		std::vector<FrameSample> samples;
+		samples.reserve(options.Frames);
+		size_t loadedAtStart = 0;
+		uint64_t start = 0;
+		size_t total = options.Warmup + options.Frames;
+		SDL_Event e = { 0 };
+		for (size_t frame = 0; frame < total && !Quit; ++frame)
+		{
+			TRACE_ZONE("Frame");
+			while (SDL_PollEvent(&e))
+			{
+				if (e.type == SDL_QUIT)
+					Quit = true;
+			}
+
+			// Scenes switch at the end of an update, so the first frame is still on whatever the engine started with
+			if (frame > 0 && bench.GetCurrentScene() != scene)
+			{
+				DWARNING("The flythrough scene switched itself out after " + std::to_string(frame) + " frames, stopping early");
+				break;
+			}
+
+			if (frame == options.Warmup)
+			{
+				loadedAtStart = world->GetStreamingStats().Loaded;
+				start = Profiling::Now();
+			}
+
+			// Every frame is placed explicitly, so the path doesn't depend on how long frames take
+			float t = (float)frame / (float)total;
+			floaty3 pos = PathPosition(t);
+			floaty3 ahead = PathPosition(t + 1.f / (float)total);
+			player->SetPosition(pos);
+			player->SetVelocity({ 0.f, 0.f, 0.f });
+			player->SetLookUp(floaty3::Normalized(ahead - pos), { 0.f, 1.f, 0.f });
+
+			auto frameStart = Profiling::Now();
+			g_Engine->Run();
+			auto frameEnd = Profiling::Now();
+
+			if (frame >= options.Warmup)
+			{
+				auto &stats = bench.GetRenderer().GetLastDrawStats();
+				samples.push_back(FrameSample{ (float)((double)(frameEnd - frameStart) * 1e-6), stats.DrawCalls, stats.Indices, stats.Vertices });
+			}
+		}
+
+		double seconds = start ? (double)(Profiling::Now() - start) * 1e-9 : 0.0;
+		auto &streaming = world->GetStreamingStats();
+		bool written = WriteResults(options, samples, seconds, streaming.Loaded - loadedAtStart, streaming);
+
+		g_Engine = nullptr;
+		return written;
+	}
+}
+
+int main(int argc, char *args[])
+{
+	FlythroughOptions options;
+	if (!ParseOptions(argc, args, options))
+	{
+		std::cerr << "Usage: cpp_engine_flythrough [--scene parkour|voxel] [--frames N] [--warmup N] [--seed S] [--out file.json]" << std::endl;
+		return 2;
+	}
+
+	if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER) < 0)
+	{
+		printf("SDL Could not initialize! SDL_Error: %s\n", SDL_GetError());
+		return 1;
+	}
+	int imgFlags = IMG_INIT_PNG;
+	if ((IMG_Init(imgFlags) & imgFlags) != imgFlags)
+		printf("SDL Imaging Could not Initialize. IMG Error: %s\n", IMG_GetError());
+	if (TTF_Init() < 0)
+		printf("TTF Could not Initialize with: %s\n", TTF_GetError());
+
+	auto *base_path = SDL_GetBasePath();
+	if (base_path)
+	{
+		// Resolve the output before moving to the executable's directory (where the assets are)
+		options.Out = std::filesystem::absolute(options.Out).string();
+		std::filesystem::current_path(base_path);
+		SDL_free(base_path);
+	}
+
+	bool succeeded = false;
+	try
+	{
+		succeeded = RunFlythrough(options);
+	}
+	catch (Debug::GLExc &e)
+	{
+		DERROR(std::string("OpenGL ran into an error: ") + e.what());
+	}
+	catch (Debug::SDLException &e)
+	{
+		DERROR(std::string("SDL ran into an error: ") + e.what());
+	}
+	g_Engine = nullptr;
+
+	TTF_Quit();
+	IMG_Quit();
+	SDL_Quit();
+	return succeeded ? 0 : 1;
+}
@@ -111,22 +111,24 @@ void EventProc(const SDL_Event *e);
 
 #ifdef EC_PROFILE
 #	ifdef _DEBUG
-#		define RUN_PROFILE_PUSH(x) g_Engine->Resources.Profile->Push(x, __FUNCTION_NAME__, __LINE__)
-#		define RUN_PROFILE_POP() g_Engine->Resources.Profile->Pop(__FUNCTION_NAME__, __LINE__)
+#		define RUN_PROFILE_PUSH(x) (g_Engine->Resources.Profile->Push(x, __FUNCTION_NAME__, __LINE__), TRACE_PUSH(x))
+#		define RUN_PROFILE_POP() (g_Engine->Resources.Profile->Pop(__FUNCTION_NAME__, __LINE__), TRACE_POP())
 #	else
-#		define RUN_PROFILE_PUSH(x) g_Engine->Resources.Profile->Push(x)
-#		define RUN_PROFILE_POP() g_Engine->Resources.Profile->Pop()
+#		define RUN_PROFILE_PUSH(x) (g_Engine->Resources.Profile->Push(x), TRACE_PUSH(x))
+#		define RUN_PROFILE_POP() (g_Engine->Resources.Profile->Pop(), TRACE_POP())
 #	endif
 #else
-#	define RUN_PROFILE_PUSH(x) ((int)0)
-#	define RUN_PROFILE_POP() ((int)0)
+#	define RUN_PROFILE_PUSH(x) TRACE_PUSH(x)
+#	define RUN_PROFILE_POP() TRACE_POP()
 #endif
 
 void Run()
 {
 	SDL_Event e = { 0 };
+	Profiling::SetThreadName("Main");
 	while (!Quit)
 	{
+		TRACE_ZONE("Frame");
 #ifdef EC_PROFILE
 		g_Engine->Resources.Profile->BeginFrame();
 #endif 
@@ -727,21 +729,13 @@ void EventProc(const SDL_Event *e)
 			case SDL_WINDOWEVENT_LEAVE:
 			{
 				Event::WindowFocusEvent ass(false, *g_Engine->Resources.UpdateID);
-#ifdef EC_PROFILE
-				g_Engine->Send(&ass, g_Engine->Resources.Profile);
-#else
-				g_Engine->Send(&ass);
-#endif // EC_PROFILE
+				g_Engine->Queue(ass);
 				break;
 			}
 			case SDL_WINDOWEVENT_ENTER:
 			{
 				Event::WindowFocusEvent ass(true, *g_Engine->Resources.UpdateID);
-#ifdef EC_PROFILE
-				g_Engine->Send(&ass, g_Engine->Resources.Profile);
-#else
-				g_Engine->Send(&ass);
-#endif // EC_PROFILE
+				g_Engine->Queue(ass);
 				break;
 			}
 			case SDL_WINDOWEVENT_SHOWN:
@@ -749,11 +743,7 @@ void EventProc(const SDL_Event *e)
 				// Unpause if its not inactive (assuming that means its active)
 				Paused = false;
 				Event::WindowFocusEvent ass(true, *g_Engine->Resources.UpdateID);
-#ifdef EC_PROFILE
-				g_Engine->Send(&ass, g_Engine->Resources.Profile);
-#else
-				g_Engine->Send(&ass);
-#endif // EC_PROFILE
+				g_Engine->Queue(ass);
 				break;
 			}
 			case SDL_WINDOWEVENT_MINIMIZED:
@@ -821,11 +811,7 @@ void EventProc(const SDL_Event *e)
 			return;
 		}
 		Event::KeyInput key = Event::KeyInput(e->key.keysym.sym, true, 0ul);// *g_Engine->Resources.FrameID);
-#ifdef EC_PROFILE
-		g_Engine->Send(&key, g_Engine->Resources.Profile);
-#else
-		g_Engine->Send(&key);
-#endif // EC_PROFILE
+		g_Engine->Queue(key);
 		PROFILE_POP();
 		break;
 	}
@@ -840,37 +826,52 @@ void EventProc(const SDL_Event *e)
 		}
 		else if (e->key.keysym.sym == SDLK_F7)
 		{
-			Requests::Request ass("UI", { "ToggleDebugDrawing" });
+			static const Requests::RequestID UIRequest = Requests::Intern("UI");
+			Requests::Request ass(UIRequest, { "ToggleDebugDrawing" });
 			g_Engine->Req.Request(ass);
 			DINFO("DebugDraw has been toggled");
 		}
 		else if (e->key.keysym.sym == SDLK_F8)
 		{
-			Requests::Request ass("UI", { "ToggleMouseMovement" });
+			static const Requests::RequestID UIRequest = Requests::Intern("UI");
+			Requests::Request ass(UIRequest, { "ToggleMouseMovement" });
 			g_Engine->Req.Request(ass);
-			ass = Requests::Request("UI", { "ToggleHover" });
+			ass = Requests::Request(UIRequest, { "ToggleHover" });
 			g_Engine->Req.Request(ass);
 			DINFO("UI Mouse Movement and Hover has been toggled");
 		}
 		else if (e->key.keysym.sym == SDLK_i)
 		{
-			Requests::Request ass("EndLevel");
+			static const Requests::RequestID EndLevelRequest = Requests::Intern("EndLevel");
+			Requests::Request ass(EndLevelRequest);
 			g_Engine->Req.Request(ass);
 			DINFO("Ended Level");
 		}
 		else if (e->key.keysym.sym == SDLK_l)
 		{
-			Requests::Request ass("StartSimpleProfile");
+			static const Requests::RequestID StartProfileRequest = Requests::Intern("StartSimpleProfile");
+			Requests::Request ass(StartProfileRequest);
 			g_Engine->Req.Request(ass);
 			DINFO("Started Profile");
 		}
+		else if (e->key.keysym.sym == SDLK_F6)
+		{
+			static const Requests::RequestID WriteTraceRequest = Requests::Intern("WriteTrace");
+			Requests::Request ass(WriteTraceRequest);
+			g_Engine->Req.Request(ass);
+		}
+		else if (e->key.keysym.sym == SDLK_F5)
+		{
+			static const Requests::RequestID ToggleGraphRequest = Requests::Intern("ToggleFrameGraph");
+			static const Requests::RequestID FrameStatsRequest = Requests::Intern("FrameStats");
+			Requests::Request ass(ToggleGraphRequest);
+			g_Engine->Req.Request(ass);
+			ass = Requests::Request(FrameStatsRequest);
+			g_Engine->Req.Request(ass);
+		}
 #endif
 		Event::KeyInput key = Event::KeyInput(e->key.keysym.sym, false, 0ul);// *g_Engine->Resources.FrameID);
-#ifdef EC_PROFILE
-		g_Engine->Send(&key, g_Engine->Resources.Profile);
-#else
-		g_Engine->Send(&key);
-#endif // EC_PROFILE
+		g_Engine->Queue(key);
 		PROFILE_POP();
 		break;
 	}
@@ -882,31 +883,19 @@ void EventProc(const SDL_Event *e)
 		case SDL_BUTTON_LEFT:
 		{
 			Event::MouseButton ass = Event::MouseButton(e->button.x, e->button.y, LMB, true, *g_Engine->Resources.UpdateID);
-#ifdef EC_PROFILE
-			g_Engine->Send(&ass, g_Engine->Resources.Profile);
-#else
-			g_Engine->Send(&ass);
-#endif // EC_PROFILE
+			g_Engine->Queue(ass);
 			break;
 		}
 		case SDL_BUTTON_MIDDLE:
 		{
 			Event::MouseWheelButton ass = Event::MouseWheelButton(e->button.x, e->button.y, true, *g_Engine->Resources.UpdateID);
-#ifdef EC_PROFILE
-			g_Engine->Send(&ass, g_Engine->Resources.Profile);
-#else
-			g_Engine->Send(&ass);
-#endif // EC_PROFILE
+			g_Engine->Queue(ass);
 			break;
 		}
 		case SDL_BUTTON_RIGHT:
 		{
 			Event::MouseButton ass = Event::MouseButton(e->button.x, e->button.y, RMB, true, *g_Engine->Resources.UpdateID);
-#ifdef EC_PROFILE
-			g_Engine->Send(&ass, g_Engine->Resources.Profile);
-#else
-			g_Engine->Send(&ass);
-#endif // EC_PROFILE
+			g_Engine->Queue(ass);
 			break;
 		}
 		default:
@@ -922,31 +911,19 @@ void EventProc(const SDL_Event *e)
 		case SDL_BUTTON_LEFT:
 		{
 			Event::MouseButton ass = Event::MouseButton(e->button.x, e->button.y, LMB, false, 0ul);// *g_Engine->Resources.FrameID);
-#ifdef EC_PROFILE
-			g_Engine->Send(&ass, g_Engine->Resources.Profile);
-#else
-			g_Engine->Send(&ass);
-#endif // EC_PROFILE
+			g_Engine->Queue(ass);
 			break;
 		}
 		case SDL_BUTTON_MIDDLE:
 		{
 			Event::MouseWheelButton ass = Event::MouseWheelButton(e->button.x, e->button.y, false, 0ul);// *g_Engine->Resources.FrameID);
-#ifdef EC_PROFILE
-			g_Engine->Send(&ass, g_Engine->Resources.Profile);
-#else
-			g_Engine->Send(&ass);
-#endif // EC_PROFILE
+			g_Engine->Queue(ass);
 			break;
 		}
 		case SDL_BUTTON_RIGHT:
 		{
 			Event::MouseButton ass = Event::MouseButton(e->button.x, e->button.y, RMB, false, 0ul);// *g_Engine->Resources.FrameID);
-#ifdef EC_PROFILE
-			g_Engine->Send(&ass, g_Engine->Resources.Profile);
-#else
-			g_Engine->Send(&ass);
-#endif // EC_PROFILE
+			g_Engine->Queue(ass);
 			break;
 		}
 		}
@@ -956,11 +933,7 @@ void EventProc(const SDL_Event *e)
 	{
 		PROFILE_PUSH("MouseMotion Event");
 		Event::MouseMove ass = Event::MouseMove(e->motion.x, e->motion.y, 0ul);// *g_Engine->Resources.FrameID);
-#ifdef EC_PROFILE
-		g_Engine->Send(&ass, g_Engine->Resources.Profile);
-#else	
-		g_Engine->Send(&ass);
-#endif
+		g_Engine->Queue(ass);
 		PROFILE_POP();
 		break;
 	}
@@ -969,11 +942,7 @@ void EventProc(const SDL_Event *e)
 		int mousex, mousey;
 		SDL_GetMouseState(&mousex, &mousey);
 		Event::MouseWheel ass = Event::MouseWheel(mousex, mousey, (e->wheel.direction == SDL_MOUSEWHEEL_NORMAL ? e->wheel.y : e->wheel.y * -1), 0ul);// *g_Engine->Resources.FrameID);
-#ifdef EC_PROFILE
-		g_Engine->Send(&ass, g_Engine->Resources.Profile);
-#else
-		g_Engine->Send(&ass);
-#endif // EC_PROFILE
+		g_Engine->Queue(ass);
 		break;
 	}
 	case SDL_QUIT:
@@ -47,7 +47,7 @@ namespace Parkour
 		}
 
 		std::default_random_engine generator;
-		generator.seed(std::random_device()());
+		generator.seed((std::default_random_engine::result_type)(genInfo.Seed ? *genInfo.Seed : std::random_device()()));
 		std::uniform_int_distribution<size_t> stepDistribution(0, realSteps.size() - 1);
 		std::uniform_real_distribution<float> distanceDistribution(0, totalDistanceWeights);
 		std::uniform_real_distribution<float> altitudeDistribution(0, totalAltitudeWeights);
@@ -708,6 +708,37 @@ TEST(GenerateParkourTests, ComplexParkourTests)
 	}
 }
 
+TEST(GenerateParkourTests, SeededGeneration)
+{
+	using namespace Voxel;
+	using namespace Vector;
+	using namespace Parkour;
+
+	// A step that can leave forwards or to the right, with a few distances, so every pick is random
+	ParkourGenerationInfo info;
+	ParkourStep step;
+	step.Blocks.emplace_back(std::make_pair(NamedBlock{ "wood", CubeData{ quat4() } }, inty3(0, 0, 0)));
+	step.Blocks.emplace_back(std::make_pair(NamedBlock{ "wood", CubeData{ quat4() } }, inty3(0, 0, -1)));
+	step.Exits.emplace_back(LookingPoint{ inty3(0, 0, -1), ParkourForwardDirection });
+	step.Exits.emplace_back(LookingPoint{ inty3(0, 0, -1), ParkourRightDirection });
+	info.UsableSteps.push_back(step);
+	info.WeightedDistances.emplace_back(std::make_pair(1.f, 1));
+	info.WeightedDistances.emplace_back(std::make_pair(1.f, 2));
+	info.WeightedDistances.emplace_back(std::make_pair(1.f, 3));
+	info.NumGeneratedSteps = 12;
+	info.Seed = 1234;
+
+	const auto first = GenerateParkour(info);
+	const auto second = GenerateParkour(info);
+
+	// The same seed lays out the same blocks
+	EXPECT_EQ(first.Blocks.size(), second.Blocks.size());
+	for (auto& block : first.Blocks)
+		EXPECT_EQ(second.Blocks.count(block.first), 1);
+	EXPECT_EQ(first.EndPosition, second.EndPosition);
+	EXPECT_EQ(first.EndDirection, second.EndDirection);
+}
+
 TEST(ParkourTests, ConversionFuncTests)
 {
 	using namespace Voxel;
@@ -6,6 +6,8 @@
 
 #include <vector>
 #include <unordered_map>
+#include <optional>
+#include <cstdint>
 
 namespace Parkour
 {
@@ -84,6 +86,7 @@ namespace Parkour
 		std::vector<std::pair<float, int>> WeightedDistances;
 		std::vector<std::pair<float, int>> WeightedAltitudes;
 		size_t NumGeneratedSteps;
+		std::optional<uint64_t> Seed; // The same seed generates the same parkour, a random one is used when not set
 	};
 
 	GeneratedParkour GenerateParkour(const ParkourGenerationInfo& other);
@@ -68,7 +68,6 @@ Parkour::ParkourScene::ParkourScene(CommonResources *resources, int level)
 	}
 
 	auto& voxelStore = Voxel::VoxelStore::GetMutable();
-	voxelStore.RegisterUpdateBlock("lamp-light", std::make_unique<ParkourLightBlock>(&m_GSpace, mResources, m_WorldShape.get(), nullptr, Voxel::ChunkBlockCoord{}));
 	voxelStore.RegisterUpdateBlock("checkpoint", std::make_unique<ParkourCheckpointBlock>(&m_GSpace, mResources, m_WorldShape.get(), nullptr, Voxel::ChunkBlockCoord{}));
 
 	m_UI.AddChildBottom(&m_Crosshair);
@@ -118,18 +117,21 @@ bool Parkour::ParkourScene::Receive(Events::IEvent* event)
 		{
 			if (key_event->KeyCode == SDLK_r)
 			{
-				mResources->Request->Request(Requests::Request{ "ReloadMaterials" });
+				static const Requests::RequestID ReloadMaterialsRequest = Requests::Intern("ReloadMaterials");
+				mResources->Request->Request(Requests::Request{ ReloadMaterialsRequest });
 				DINFO("Reloading Materials");
 			}
 			else if (key_event->KeyCode == SDLK_COMMA)
 			{
 				DINFO("Sending record time request");
-				mResources->Request->Request(Requests::Request{ "RecordTime" });
+				static const Requests::RequestID RecordTimeRequest = Requests::Intern("RecordTime");
+				mResources->Request->Request(Requests::Request{ RecordTimeRequest });
 			}
 			else if (key_event->KeyCode == SDLK_PERIOD)
 			{
 				DINFO("Reloading meshes...");
-				mResources->Request->Request(Requests::Request{ "ReloadMeshes" });
+				static const Requests::RequestID ReloadMeshesRequest = Requests::Intern("ReloadMeshes");
+				mResources->Request->Request(Requests::Request{ ReloadMeshesRequest });
 			}
 		}
 	}
@@ -165,27 +167,27 @@ std::unique_ptr<Scene::IScene> Parkour::ParkourScene::Clone()
 	return std::make_unique<ParkourScene>(mResources, m_Level);
 }
 
-Debug::DebugReturn Parkour::ParkourScene::Request(Requests::Request& req)
+void Parkour::ParkourScene::RegisterRequests(Requests::RequestRoutes& routes)
 {
-	if (req.Name == "Resume")
+	routes.Add("Resume", [this](Requests::Request&) -> Debug::DebugReturn
 	{
 		if (!m_FinishMenu.IsEnabled())
 			Resume();
 		return true;
-	}
-	else if (req.Name == "Pause")
+	});
+	routes.Add("Pause", [this](Requests::Request&) -> Debug::DebugReturn
 	{
 		Pause();
 		return true;
-	}
-	else if (req.Name == "WinRun")
+	});
+	routes.Add("WinRun", [this](Requests::Request&) -> Debug::DebugReturn
 	{
 		m_FinishMenu.Enable();
 		Pause();
 		m_Menu.Disable();
 		return true;
-	}
-	else if (req.Name == "RestartRun")
+	});
+	routes.Add("RestartRun", [this](Requests::Request&) -> Debug::DebugReturn
 	{
 		m_WorldShape->Reset();
 		m_PlayerShape->SetPosition(floaty3{ 0.f, 2.f, 0.f });
@@ -196,13 +198,12 @@ Debug::DebugReturn Parkour::ParkourScene::Request(Requests::Request& req)
 		m_TrackerShape->Reset();
 		Resume();
 		return true;
-	}
-	else if (req.Name == "ReturnToMenu")
+	});
+	routes.Add("ReturnToMenu", [this](Requests::Request&) -> Debug::DebugReturn
 	{
 		mResources->Engine->SwitchScene(std::make_unique<Parkour::ParkourStartingScene>(mResources, std::unique_ptr<Parkour::IParkourDifficultyScene>(new Parkour::ParkourScene(mResources, 0))));
 		return true;
-	}
-	return false;
+	});
 }
 
 Stringy Parkour::ParkourScene::GetName() const
@@ -305,27 +306,27 @@ void Parkour::ParkourStartingScene::AfterDraw()
 	UIRoot.AfterDraw();
 }
 
-Debug::DebugReturn Parkour::ParkourStartingScene::Request(Requests::Request& action)
+void Parkour::ParkourStartingScene::RegisterRequests(Requests::RequestRoutes& routes)
 {
-	if (action.Name == "BeginEasyRun")
+	routes.Add("BeginEasyRun", [this](Requests::Request&) -> Debug::DebugReturn
 	{
 		NextScene->SetDifficulty(0);
 		NewGame();
 		return true;
-	}
-	else if (action.Name == "BeginMediumRun")
+	});
+	routes.Add("BeginMediumRun", [this](Requests::Request&) -> Debug::DebugReturn
 	{
 		NextScene->SetDifficulty(1);
 		NewGame();
 		return true;
-	}
-	else if (action.Name == "BeginHardRun")
+	});
+	routes.Add("BeginHardRun", [this](Requests::Request&) -> Debug::DebugReturn
 	{
 		NextScene->SetDifficulty(2);
 		NewGame();
 		return true;
-	}
-	else if (action.Name == "UI")
+	});
+	routes.Add("UI", [this](Requests::Request& action) -> Debug::DebugReturn
 	{
 		if (action.Params.size())
 		{
@@ -345,9 +346,8 @@ Debug::DebugReturn Parkour::ParkourStartingScene::Request(Requests::Request& act
 				return true;
 			}
 		}
-	}
-
-	return false;
+		return false;
+	});
 }
 
 void Parkour::ParkourStartingScene::NewGame()
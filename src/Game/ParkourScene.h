@@ -54,7 +54,7 @@ namespace Parkour
 
 		virtual std::unique_ptr<IScene> Clone() override;
 
-		virtual Debug::DebugReturn Request(Requests::Request& req) override;
+		virtual void RegisterRequests(Requests::RequestRoutes& routes) override;
 		virtual Stringy GetName() const override;
 
 		void Pause();
@@ -62,6 +62,9 @@ namespace Parkour
 
 		virtual void SetDifficulty(int difficulty) override;
 
+		inline Voxel::VoxelPlayer* GetPlayer() { return m_PlayerShape.get(); }
+		inline Voxel::VoxelWorld* GetWorld() { return m_WorldShape.get(); }
+
 	protected:
 		int m_Level = 0;
 
@@ -104,7 +107,7 @@ namespace Parkour
 
 		inline virtual std::unique_ptr<IScene> Clone() override { return std::make_unique<ParkourStartingScene>(mResources, std::unique_ptr<IParkourDifficultyScene>(dynamic_cast<IParkourDifficultyScene*>((NextScene ? NextScene->Clone().release() : nullptr)))); }
 
-		virtual Debug::DebugReturn Request(Requests::Request& action) override;
+		virtual void RegisterRequests(Requests::RequestRoutes& routes) override;
 		inline virtual Stringy GetName() const override { return "ParkourStartingScene instance"; }
 
 	protected:
@@ -49,6 +49,8 @@ void Parkour::ParkourGeneratorShape::Generate()
 	info.UsableSteps = levelDat.UsableSteps;
 	info.WeightedAltitudes = levelDat.WeightedAltitudes;
 	info.WeightedDistances = levelDat.WeightedDistances;
+	// From the engine's generator, so seeding that (as the flythrough benchmark does) makes the parkour repeatable
+	info.Seed = (*mResources->RandomGen)();
 	
 	auto gen = Parkour::GenerateParkour(info);
 	DINFO("Parkour: Generated '" + std::to_string(gen.Blocks.size()) + "' blocks");
@@ -85,7 +87,8 @@ void Parkour::PlayerTrackerShape::BeforeDraw()
 		auto diff = m_Data.Player->GetPosition() - m_Data.World->GetPhysPosFromBlockCoord(m_Data.Level->GetLevelData().GoalPosition);
 		if (diff.mag2() < GoalDistanceSq)
 		{
-			mResources->Request->Request(Requests::Request{ "WinRun" });
+			static const Requests::RequestID WinRunRequest = Requests::Intern("WinRun");
+			mResources->Request->Request(Requests::Request{ WinRunRequest });
 			m_HasSentWinRequest = true;
 		}
 	}
@@ -162,9 +165,9 @@ void Parkour::ParkourTimeMeasuringShape::BeforeDraw()
 	}
 }
 
-Debug::DebugReturn Parkour::ParkourTimeMeasuringShape::Request(Requests::Request& req)
+void Parkour::ParkourTimeMeasuringShape::RegisterRequests(Requests::RequestRoutes& routes)
 {
-	if (req.Name == "RecordTime")
+	routes.Add("RecordTime", [this](Requests::Request&) -> Debug::DebugReturn
 	{
 		DINFO("Beginning recording over " + std::to_string(m_Period) + "s");
 		m_StartTime = mResources->Time->GetUnscaledRunningTime();
@@ -172,9 +175,7 @@ Debug::DebugReturn Parkour::ParkourTimeMeasuringShape::Request(Requests::Request
 		m_RunNumber = 1;
 		m_Recording = true;
 		return true;
-	}
-
-	return false;
+	});
 }
 
 Parkour::ParkourUIToggleShape::ParkourUIToggleShape(G1::IShapeThings things, Input::Key inputKey, std::vector<std::weak_ptr<UI1::UIElement>> ui)
@@ -128,7 +128,7 @@ namespace Parkour
 		virtual void BeforeDraw() override;
 		inline virtual void AfterDraw() override {}
 
-		virtual Debug::DebugReturn Request(Requests::Request& req) override;
+		virtual void RegisterRequests(Requests::RequestRoutes& routes) override;
 		inline virtual std::string GetName() const override { return "ParkourTimeMeasurer"; }
 	protected:
 		bool m_Recording = false;